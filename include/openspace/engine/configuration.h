@@ -68,6 +68,7 @@ struct Configuration {
 
     std::string versionCheckUrl;
     bool useMultithreadedInitialization = false;
+    bool useParallelSceneUpdate = false;
 
     struct LoadingScreen {
         bool isShowingMessages = true;
@@ -36,6 +36,7 @@ namespace openspace {
 class Dashboard;
 class DeferredcasterManager;
 class DownloadManager;
+class JobSystem;
 class LuaConsole;
 class MemoryManager;
 class MissionManager;
@@ -75,6 +76,7 @@ ghoul::fontrendering::FontManager& gFontManager();
 Dashboard& gDashboard();
 DeferredcasterManager& gDeferredcasterManager();
 DownloadManager& gDownloadManager();
+JobSystem& gJobSystem();
 LuaConsole& gLuaConsole();
 MemoryManager& gMemoryManager();
 MissionManager& gMissionManager();
@@ -109,6 +111,7 @@ static ghoul::fontrendering::FontManager& fontManager = detail::gFontManager();
 static Dashboard& dashboard = detail::gDashboard();
 static DeferredcasterManager& deferredcasterManager = detail::gDeferredcasterManager();
 static DownloadManager& downloadManager = detail::gDownloadManager();
+static JobSystem& jobSystem = detail::gJobSystem();
 static LuaConsole& luaConsole = detail::gLuaConsole();
 static MemoryManager& memoryManager = detail::gMemoryManager();
 static MissionManager& missionManager = detail::gMissionManager();
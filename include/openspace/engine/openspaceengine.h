@@ -87,7 +87,7 @@ public:
     void touchUpdateCallback(TouchInput input);
     void touchExitCallback(TouchInput input);
     std::vector<std::byte> encode();
-    void decode(std::vector<std::byte> data);
+    void decode(const std::vector<std::byte>& data);
 
     void scheduleLoadSingleAsset(std::string assetPath);
     void toggleShutdownMode();
@@ -112,7 +112,6 @@ private:
     void runGlobalCustomizationScripts();
     void configureLogging();
     std::string generateFilePath(std::string openspaceRelativePath);
-    void resetPropertyChangeFlagsOfSubowners(openspace::properties::PropertyOwner* po);
 
     std::unique_ptr<Scene> _scene;
     std::unique_ptr<AssetManager> _assetManager;
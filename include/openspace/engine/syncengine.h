@@ -38,11 +38,20 @@ class Syncable;
 /**
  * Manages a collection of <code>Syncable</code>s and ensures they are synchronized
  * over SGCT nodes. Encoding/Decoding order is handles internally.
+ *
+ * The data of each Syncable is sent relative to the data of the previous frame. If it is
+ * unchanged and the Syncable supports it, nothing but a single byte is sent and the
+ * Syncable is not decoded on the client nodes. Otherwise only the ranges of bytes that
+ * have changed are sent, unless sending the full data is smaller. Every
+ * #KeyframeInterval frames, the full data of all Syncables is sent.
  */
 class SyncEngine {
 public:
     BooleanType(IsMaster);
 
+    /// The number of frames after which the full data of all Syncables is sent
+    static constexpr const int KeyframeInterval = 256;
+
     /**
      * Creates a new SyncEngine which a buffer size of \p syncBufferSize
      * \pre syncBufferSize must be bigger than 0
@@ -56,10 +65,11 @@ public:
     std::vector<std::byte> encodeSyncables();
 
     /**
-     * Decodes the <code>SyncBuffer</code> into the added Syncables.
+     * Decodes the \p data, which was created by #encodeSyncables, into the added
+     * Syncables. The data is read in place without being copied.
      * This method is only called on the SGCT slave nodes
      */
-    void decodeSyncables(std::vector<std::byte> data);
+    void decodeSyncables(const std::vector<std::byte>& data);
 
     /**
      * Invokes the presync method of all added Syncables
@@ -103,6 +113,21 @@ private:
      * Databuffer used in encoding/decoding
      */
     SyncBuffer _syncBuffer;
+
+    /**
+     * The data of each Syncable in the previous frame, which is the reference for the
+     * changes that are sent in the next frame
+     */
+    std::vector<std::vector<std::byte>> _previousData;
+
+    /// Temporary storage for the changes of a single Syncable
+    std::vector<std::byte> _delta;
+
+    /// The size of the previous frame, which is used to reserve the memory of the next
+    size_t _previousFrameSize = 0;
+
+    /// The number of frames that have been encoded since the last keyframe
+    int _nFramesSinceKeyframe = 0;
 };
 
 } // namespace openspace
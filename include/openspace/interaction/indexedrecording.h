@@ -0,0 +1,184 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___INDEXEDRECORDING___H__
+#define __OPENSPACE_CORE___INDEXEDRECORDING___H__
+
+#include <openspace/util/memorymappedfile.h>
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openspace::interaction {
+
+/**
+ * Reads and writes version 2 of the session recording file format. The version 1 ASCII
+ * and binary formats are a stream of variable-sized entries that have to be parsed from
+ * the beginning of the file. Opposed to that, a version 2 file contains a table of
+ * fixed-size entries that are sorted by the recorded time, so that the offset of the
+ * entry that belongs to a specific time can be found with a binary search. The names of
+ * the focus nodes are interned into a separate table, as they are repeated in almost
+ * every camera keyframe, and the texts of all scripts are stored in a third table. The
+ * file is read through a memory map. The layout of the file is:
+ *
+ *  - The header that is shared with version 1 files, with the version "02.00" and the
+ *    data format tag #DataFormatTag
+ *  - The entry table, which contains <code>nEntries</code> values of type Entry
+ *  - The node name table, which contains the length (as <code>uint32_t</code>) and the
+ *    characters of every node name
+ *  - The script table, which is stored in the same way as the node name table
+ *  - The Footer, which contains the location and the size of the three tables
+ *
+ * Just as for the version 1 binary format, all values are stored in the byte order of
+ * the machine that wrote the file.
+ */
+class IndexedRecording {
+public:
+    /// The data format tag that follows the version in the header of the file
+    static constexpr const char DataFormatTag = 'I';
+
+    enum class EntryType : uint8_t {
+        Camera = 'c',
+        Time = 't',
+        Script = 's'
+    };
+
+    struct Entry {
+        double timeOs = 0.0;
+        double timeRec = 0.0;
+        double timeSim = 0.0;
+
+        // Only used by camera keyframes
+        double position[3] = { 0.0, 0.0, 0.0 };
+        double rotation[4] = { 0.0, 0.0, 0.0, 1.0 }; // x, y, z, w
+        float scale = 0.f;
+
+        // Index into the node name table for camera keyframes and into the script
+        // table for script keyframes
+        uint32_t index = 0;
+
+        // Only used by time keyframes
+        double deltaTime = 0.0;
+
+        EntryType type = EntryType::Camera;
+        bool followNodeRotation = false;
+        bool paused = false;
+        bool requiresTimeJump = false;
+    };
+
+    struct Footer {
+        uint64_t entryTableOffset = 0;
+        uint64_t nEntries = 0;
+        uint64_t nodeNameTableOffset = 0;
+        uint64_t nNodeNames = 0;
+        uint64_t scriptTableOffset = 0;
+        uint64_t nScripts = 0;
+        char magic[8] = { 'O', 'S', 'R', 'E', 'C', 'I', 'D', 'X' };
+    };
+
+    /**
+     * Collects the keyframes of a recording and writes them into a version 2 file. The
+     * keyframes can be added in any order, as they are sorted by their recorded time
+     * when the file is written.
+     */
+    class Builder {
+    public:
+        void addCamera(double timeOs, double timeRec, double timeSim,
+            const glm::dvec3& position, const glm::dquat& rotation, float scale,
+            bool followNodeRotation, const std::string& focusNode);
+        void addTime(double timeOs, double timeRec, double timeSim, double deltaTime,
+            bool paused, bool requiresTimeJump);
+        void addScript(double timeOs, double timeRec, double timeSim,
+            std::string script);
+
+        /**
+         * Writes the collected keyframes to the file at \p path.
+         *
+         * \throw ghoul::RuntimeError If the file could not be written
+         */
+        void save(const std::string& path);
+
+    private:
+        std::vector<Entry> _entries;
+        std::vector<std::string> _nodeNames;
+        std::map<std::string, uint32_t, std::less<>> _nodeNameIndices;
+        std::vector<std::string> _scripts;
+    };
+
+    /**
+     * Maps the version 2 recording at \p path into memory.
+     *
+     * \throw ghoul::RuntimeError If the file could not be opened or is not a valid
+     *        version 2 recording
+     */
+    explicit IndexedRecording(const std::string& path);
+
+    size_t nEntries() const;
+    size_t nNodeNames() const;
+    size_t nScripts() const;
+
+    /// Returns the entry with the provided \p index
+    Entry entry(size_t index) const;
+
+    /// Returns the recorded time of the entry with the provided \p index
+    double recordedTime(size_t index) const;
+
+    /// Returns the node name that a camera Entry refers to with its \p index
+    std::string_view nodeName(uint32_t index) const;
+
+    /// Returns the script that a script Entry refers to with its \p index
+    std::string_view script(uint32_t index) const;
+
+    /**
+     * Returns the index of the first entry whose recorded time is larger than
+     * \p recordedTime, or #nEntries if there is no such entry. As the entries are sorted
+     * by their recorded time, this is a binary search on the entry table.
+     */
+    size_t findEntry(double recordedTime) const;
+
+    /**
+     * Converts the version 1 ASCII or binary recording at \p source into a version 2
+     * recording that is written to \p destination.
+     *
+     * \throw ghoul::RuntimeError If \p source could not be read or \p destination could
+     *        not be written
+     */
+    static void convert(const std::string& source, const std::string& destination);
+
+private:
+    /// Splits the table at \p offset into the \p count strings that are stored in it
+    std::vector<std::string_view> readStringTable(uint64_t offset, uint64_t count) const;
+
+    MemoryMappedFile _file;
+    Footer _footer;
+    std::vector<std::string_view> _nodeNames;
+    std::vector<std::string_view> _scripts;
+};
+
+} // namespace openspace::interaction
+
+#endif // __OPENSPACE_CORE___INDEXEDRECORDING___H__
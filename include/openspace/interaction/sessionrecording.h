@@ -29,6 +29,7 @@
 #include <openspace/interaction/keyframenavigator.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/scripting/lualibrary.h>
+#include <openspace/util/asyncfilewriter.h>
 #include <vector>
 
 namespace openspace::interaction {
@@ -49,6 +50,34 @@ public:
     using CallbackHandle = int;
     using StateChangeCallback = std::function<void()>;
 
+    enum class RecordedType {
+        Camera = 0,
+        Time,
+        Script,
+        Invalid
+    };
+    struct timelineEntry {
+        RecordedType keyframeType;
+        unsigned int idxIntoKeyframeTypeArray;
+        double timestamp;
+        /// The simulation time at which the entry was recorded
+        double timeSim;
+    };
+
+    /// The position in the timeline from which a playback continues after a seek
+    struct SeekPosition {
+        /// The index of the first entry that lies after the requested time
+        unsigned int next = 0;
+        /// The index of the last camera entry that does not lie after the requested
+        /// time, or of the first camera entry if all of them lie after it
+        unsigned int camera = 0;
+        /// Whether any camera entries lie after the requested time
+        bool hasRemainingCameraEntries = false;
+        /// The simulation time of the last entry that does not lie after the requested
+        /// time, or of the first entry if all of them lie after it
+        double simulationTime = 0.0;
+    };
+
     SessionRecording();
 
     ~SessionRecording();
@@ -104,8 +133,10 @@ public:
     void setRecordDataFormat(RecordedDataMode dataMode);
 
     /**
-     * Used to stop a recording in progress. If open, the recording file will be closed,
-     * and all keyframes deleted from memory.
+     * Used to stop a recording in progress. The keyframes are written to the recording
+     * file by a background thread. This function waits until all of them have been
+     * written before the file is closed, so the recording file is complete once this
+     * function returns.
      */
     void stopRecording();
 
@@ -136,6 +167,46 @@ public:
      */
     void stopPlayback();
 
+    /**
+     * Moves the playback that is currently in progress to the provided \p recordedTime,
+     * which is measured in seconds since the start of the recording. The keyframes of
+     * the playback are sorted by time, so the new position is found with a binary search.
+     * Scripts between the previous and the new position are not executed. Seeking is only
+     * possible for playbacks that are relative to the recorded time.
+     *
+     * \param recordedTime the time since the start of the recording to move to
+     *
+     * \return \c true if the playback was moved to the new time
+     */
+    bool seekPlayback(double recordedTime);
+
+    /**
+     * Finds the position in the \p timeline from which a playback continues when it is
+     * moved to the \p recordedTime. The entries of the \p timeline must be sorted by
+     * their timestamp and the \p timeline must not be empty.
+     *
+     * \param timeline the entries of the playback
+     * \param recordedTime the time since the start of the recording to move to
+     *
+     * \return the position from which the playback continues
+     */
+    static SeekPosition findSeekPosition(const std::vector<timelineEntry>& timeline,
+        double recordedTime);
+
+    /**
+     * Converts the version 1 ASCII or binary recording \p source into the indexed version
+     * 2 format, which is written to \p destination. Both files are located in the
+     * recordings folder. The indexed format can be played back like all other formats,
+     * but does not have to be parsed entry by entry when the playback starts.
+     *
+     * \param source the recording that is converted
+     * \param destination the file to which the converted recording is written
+     *
+     * \return \c true if the recording was converted without errors
+     */
+    bool convertToIndexedFormat(const std::string& source,
+        const std::string& destination) const;
+
     /**
      * Enables that rendered frames should be saved during playback
      * \param fps Number of frames per second.
@@ -217,18 +288,8 @@ public:
 
 private:
     properties::BoolProperty _renderPlaybackInformation;
+    properties::BoolProperty _skipUnchangedCameraKeyframes;
 
-    enum class RecordedType {
-        Camera = 0,
-        Time,
-        Script,
-        Invalid
-    };
-    struct timelineEntry {
-        RecordedType keyframeType;
-        unsigned int idxIntoKeyframeTypeArray;
-        double timestamp;
-    };
     ExternInteraction _externInteract;
     double _timestampRecordStarted = 0.0;
     double _timestampPlaybackStarted_application = 0.0;
@@ -243,20 +304,26 @@ private:
     void playbackTimeChange();
     void playbackScript();
     bool playbackAddEntriesToTimeline();
+    bool playbackAddIndexedEntriesToTimeline();
     void signalPlaybackFinishedForComponent(RecordedType type);
     void writeToFileBuffer(double src);
     void writeToFileBuffer(std::vector<char>& cvec);
     void writeToFileBuffer(unsigned char c);
     void writeToFileBuffer(bool b);
     void saveStringToFile(const std::string& s);
-    void saveKeyframeToFileBinary(unsigned char* bufferSource, size_t size);
+    bool saveKeyframeToFileBinary(unsigned char* bufferSource, size_t size,
+        AsyncFileWriter::DropIfFull drop = AsyncFileWriter::DropIfFull::No);
     void findFirstCameraKeyframeInTimeline();
-    void saveKeyframeToFile(std::string entry);
+    bool saveKeyframeToFile(std::string entry,
+        AsyncFileWriter::DropIfFull drop = AsyncFileWriter::DropIfFull::No);
+    bool saveCameraKeyframeToFile(const datamessagestructures::CameraKeyframe& kf,
+        double simulationTime);
 
-    void addKeyframe(double timestamp,
+    void addKeyframe(double timestamp, double timeSim,
         interaction::KeyframeNavigator::CameraPose keyframe);
-    void addKeyframe(double timestamp, datamessagestructures::TimeKeyframe keyframe);
-    void addKeyframe(double timestamp, std::string scriptToQueue);
+    void addKeyframe(double timestamp, double timeSim,
+        datamessagestructures::TimeKeyframe keyframe);
+    void addKeyframe(double timestamp, double timeSim, std::string scriptToQueue);
     void moveAheadInTime();
     void lookForNonCameraKeyframesThatHaveComeDue(double currTime);
     void updateCameraWithOrWithoutNewKeyframes(double currTime);
@@ -277,15 +344,25 @@ private:
     void cleanUpPlayback();
 
     RecordedDataMode _recordingDataMode = RecordedDataMode::Binary;
+    bool _isPlaybackIndexed = false;
     SessionState _state = SessionState::Idle;
     SessionState _lastState = SessionState::Idle;
     std::string _playbackFilename;
     std::ifstream _playbackFile;
     std::string _playbackLineParsing;
-    std::ofstream _recordFile;
+    AsyncFileWriter _recordFile;
     int _playbackLineNum = 1;
     KeyframeTimeRef _playbackTimeReferenceMode;
     datamessagestructures::CameraKeyframe _prevRecordedCameraKeyframe;
+
+    // The last camera keyframe that was written to the recording file and the last one
+    // that was skipped as the camera had not moved since, together with its simulation
+    // time
+    datamessagestructures::CameraKeyframe _lastSavedCameraKeyframe;
+    bool _hasSavedCameraKeyframe = false;
+    datamessagestructures::CameraKeyframe _skippedCameraKeyframe;
+    double _skippedCameraKeyframeSimulationTime = 0.0;
+    bool _hasSkippedCameraKeyframe = false;
     bool _playbackActive_camera = false;
     bool _playbackActive_time = false;
     bool _playbackActive_script = false;
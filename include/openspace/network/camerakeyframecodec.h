@@ -0,0 +1,140 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___CAMERAKEYFRAMECODEC___H__
+#define __OPENSPACE_CORE___CAMERAKEYFRAMECODEC___H__
+
+#include <openspace/network/messagestructures.h>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Encodes camera keyframes into the compact wire format that the ParallelPeer uses for
+ * datamessagestructures::Type::CompactCameraData messages, and decodes them again. The
+ * full CameraKeyframe contains the name of the focus node, three doubles for the
+ * position, four doubles for the rotation, and a timestamp, which is repeated by the
+ * DataMessage that carries it. Opposed to that, the compact format:
+ *
+ *  - Refers to the focus node through an index into a table of node names. The table
+ *    is only sent with full keyframes, which are sent for the first keyframe, whenever a
+ *    new focus node appears, and every #FullKeyframeInterval keyframes
+ *  - Stores the rotation as the three smallest quaternion components, quantized to
+ *    integers with a resolution of about a microradian
+ *  - Stores the position as the difference to the previous keyframe, quantized to a
+ *    resolution that is relative to the distance to the focus node
+ *  - Stores all integers as variable-length integers, so that small changes only
+ *    require a single byte per component
+ *  - Omits the scale unless it has changed
+ *  - Stores the timestamp as the difference in microseconds to a reference timestamp,
+ *    which is the timestamp of the DataMessage that carries the keyframe
+ *
+ * The Encoder and the Decoder both compute the next keyframe from the quantized values
+ * of the previous one, so the quantization errors do not accumulate. As the parallel
+ * connection is a TCP connection, all keyframes arrive in order and the previous keyframe
+ * that was sent is always the one that the Decoder has received last. A Decoder that
+ * started listening in the middle of a stream ignores all keyframes until it receives a
+ * full keyframe.
+ */
+class CameraKeyframeCodec {
+public:
+    using CameraKeyframe = datamessagestructures::CameraKeyframe;
+
+    /// The number of keyframes after which a full keyframe is sent in any case
+    static constexpr const int FullKeyframeInterval = 100;
+
+    class Encoder {
+    public:
+        /**
+         * Appends the compact encoding of \p keyframe to the \p buffer. The timestamp of
+         * the \p keyframe is encoded relative to the \p referenceTimestamp, which has to
+         * be passed to Decoder::decode as well.
+         */
+        void encode(const CameraKeyframe& keyframe, double referenceTimestamp,
+            std::vector<char>& buffer);
+
+        /**
+         * Returns whether the \p keyframe differs from the last encoded keyframe by more
+         * than the \p threshold, or whether the next keyframe has to be a full keyframe.
+         * The \p threshold is compared both to the distance that the camera has moved,
+         * relative to its distance to the focus node, and to the angle (in radians) that
+         * the camera has rotated. Changes of the focus node, the follow flag, or the
+         * scale are always significant.
+         */
+        bool hasChanged(const CameraKeyframe& keyframe, double threshold) const;
+
+        /**
+         * Makes the next encoded keyframe a full keyframe that includes the node name
+         * table. This has to be called whenever a new Decoder might have started
+         * listening.
+         */
+        void reset();
+
+    private:
+        std::vector<std::string> _nodeNames;
+        std::map<std::string, uint32_t, std::less<>> _nodeIndices;
+
+        bool _needsFullKeyframe = true;
+        int _nKeyframesSinceFull = 0;
+
+        // The last keyframe as the Decoder has reconstructed it
+        CameraKeyframe _previous;
+        std::array<int32_t, 3> _previousRotation = { 0, 0, 0 };
+    };
+
+    class Decoder {
+    public:
+        /**
+         * Decodes the \p size bytes at \p data into the \p keyframe, using the same
+         * \p referenceTimestamp that was passed to Encoder::encode. The previous contents
+         * of the \p keyframe are overwritten, so that the same object can be reused for
+         * every message.
+         *
+         * \return <code>true</code> if the \p keyframe was decoded, <code>false</code>
+         *         if the data was malformed or if it depends on a previous keyframe that
+         *         this Decoder has not received
+         */
+        bool decode(const char* data, size_t size, double referenceTimestamp,
+            CameraKeyframe& keyframe);
+
+        /// Discards the received node names and waits for the next full keyframe
+        void reset();
+
+    private:
+        std::vector<std::string> _nodeNames;
+
+        bool _hasFullKeyframe = false;
+        glm::dvec3 _previousPosition = glm::dvec3(0.0);
+        float _previousScale = 0.f;
+        std::array<int32_t, 3> _previousRotation = { 0, 0, 0 };
+    };
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___CAMERAKEYFRAMECODEC___H__
@@ -36,7 +36,9 @@ namespace openspace::datamessagestructures {
 enum class Type : uint32_t {
     CameraData = 0,
     TimelineData,
-    ScriptData
+    ScriptData,
+    // A camera keyframe in the format of the CameraKeyframeCodec
+    CompactCameraData
 };
 
 struct CameraKeyframe {
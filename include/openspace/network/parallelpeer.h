@@ -27,6 +27,7 @@
 
 #include <openspace/network/parallelconnection.h>
 #include <openspace/interaction/externinteraction.h>
+#include <openspace/network/camerakeyframecodec.h>
 #include <openspace/network/messagestructures.h>
 #include <openspace/util/timemanager.h>
 
@@ -34,6 +35,7 @@
 
 #include <openspace/network/parallelconnection.h>
 #include <openspace/properties/stringproperty.h>
+#include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
 #include <ghoul/designpattern/event.h>
 #include <atomic>
@@ -89,8 +91,22 @@ private:
     void nConnectionsMessageReceived(const std::vector<char>& message);
 
     void sendCameraKeyframe();
+    void sendCompactCameraKeyframe(const datamessagestructures::CameraKeyframe& kf);
     void sendTimeTimeline();
 
+    /// Adds the received \p kf to the KeyframeNavigator at the local
+    /// \p convertedTimestamp
+    void addCameraKeyframe(const datamessagestructures::CameraKeyframe& kf,
+        double convertedTimestamp);
+
+    /**
+     * Repeats the last received compact camera keyframe if the KeyframeNavigator has
+     * reached it. The host does not send compact camera keyframes while the camera is
+     * not moving, and without a following keyframe the KeyframeNavigator would stop
+     * updating the camera, for example to follow the rotation of the focus node.
+     */
+    void holdCameraKeyframe();
+
     void setStatus(ParallelConnection::Status status);
     void setHostName(const std::string& hostName);
     void setNConnections(size_t nConnections);
@@ -109,10 +125,25 @@ private:
     properties::FloatProperty _bufferTime;
     properties::FloatProperty _timeKeyframeInterval;
     properties::FloatProperty _cameraKeyframeInterval;
+    properties::BoolProperty _compactCameraKeyframes;
+    properties::FloatProperty _cameraMotionThreshold;
 
     double _lastTimeKeyframeTimestamp = 0.0;
     double _lastCameraKeyframeTimestamp = 0.0;
 
+    // Used by the host in the compact mode. The last keyframe that was not sent as the
+    // camera had not moved is sent before the next one, so that the clients start to
+    // interpolate from the right time
+    CameraKeyframeCodec::Encoder _cameraKeyframeEncoder;
+    datamessagestructures::CameraKeyframe _skippedCameraKeyframe;
+    bool _hasSkippedCameraKeyframe = false;
+
+    // Used by the clients in the compact mode. The keyframe is reused for every message
+    CameraKeyframeCodec::Decoder _cameraKeyframeDecoder;
+    datamessagestructures::CameraKeyframe _receivedCameraKeyframe;
+    bool _isHoldingCameraKeyframe = false;
+    double _lastCameraKeyframeConvertedTimestamp = 0.0;
+
     std::atomic_bool _shouldDisconnect = false;
 
     std::atomic<size_t> _nConnections = 0;
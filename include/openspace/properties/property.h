@@ -27,8 +27,10 @@
 
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/misc/easing.h>
+#include <atomic>
 #include <functional>
 #include <string>
+#include <vector>
 
 struct lua_State;
 
@@ -507,6 +509,25 @@ public:
      */
     void resetToUnchanged();
 
+    /**
+     * Returns all properties whose value has changed since their change flag was reset.
+     * A Property registers itself the first time its value changes, so the cost of this
+     * function depends only on the number of changed properties rather than on the total
+     * number of properties.
+     *
+     * \return All properties for which #hasChanged returns <code>true</code>
+     */
+    static std::vector<Property*> changedProperties();
+
+    /**
+     * Resets the change flag of all changed properties that are directly or indirectly
+     * owned by the \p owner, or of all changed properties if \p owner is
+     * <code>nullptr</code>.
+     *
+     * \param owner The PropertyOwner whose changed properties are reset
+     */
+    static void resetChangedProperties(const PropertyOwner* owner = nullptr);
+
 protected:
     static const char* IdentifierKey;
     static const char* NameKey;
@@ -522,6 +543,13 @@ protected:
      */
     void notifyChangeListeners();
 
+    /**
+     * This method must be called by all subclasses whenever the encapsulated value has
+     * changed. It sets the change flag and registers this Property in the list of changed
+     * properties if it was not changed before.
+     */
+    void markAsChanged();
+
     /// The PropetyOwner this Property belongs to, or <code>nullptr</code>
     PropertyOwner* _owner = nullptr;
 
@@ -544,7 +572,7 @@ protected:
     std::vector<std::pair<OnDeleteHandle, std::function<void()>>> _onDeleteCallbacks;
 
     /// Flag indicating that this property value has been changed after initialization
-    bool _isValueDirty = false;
+    std::atomic<bool> _isValueDirty = false;
 
 private:
     void notifyDeleteListeners();
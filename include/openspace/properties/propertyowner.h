@@ -27,8 +27,11 @@
 
 #include <openspace/documentation/documentationgenerator.h>
 
+#include <cstdint>
 #include <map>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace openspace::properties {
@@ -47,7 +50,9 @@ class Property;
  * Stored properties can be accessed using the Property::properties method or the
  * Property::property method, providing an URI for the location of the property. If the
  * URI contains separators (<code>.</code>), the first name before the separator will be
- * used as a subOwner's name and the search will proceed recursively.
+ * used as a subOwner's name and the search will proceed recursively. The Propertys and
+ * sub-owners are indexed by their identifiers, so that the lookup of a URI only depends
+ * on the number of its components.
  */
 class PropertyOwner : public DocumentationGenerator {
 public:
@@ -147,7 +152,7 @@ public:
      * \return If the Property cannot be found, \c nullptr is returned, otherwise the
      *         pointer to the Property is returned
      */
-    Property* property(const std::string& uri) const;
+    Property* property(std::string_view uri) const;
 
     /**
      * This method checks if a Property with the provided \p uri exists in this
@@ -188,7 +193,7 @@ public:
      * \param identifier The identifier of the sub-owner that should be returned
      * \return The PropertyOwner with the given \p name, or \c nullptr
      */
-    PropertyOwner* propertySubOwner(const std::string& identifier) const;
+    PropertyOwner* propertySubOwner(std::string_view identifier) const;
 
     /**
      * Returns \c true if this PropertyOwner owns a sub-owner with the provided
@@ -294,6 +299,17 @@ public:
     // Generate JSON for documentation
     std::string generateJson() const override;
 
+    /**
+     * Returns a counter that is incremented whenever a Property or a sub-owner is added
+     * to or removed from any PropertyOwner, or when the identifier or the tags of any
+     * PropertyOwner change. Caches that store the results of Property lookups are valid
+     * as long as this value does not change.
+     */
+    static uint64_t hierarchyVersion();
+
+    /// Increments the #hierarchyVersion, for example when a Property is destroyed
+    static void invalidateHierarchy();
+
 
 protected:
     /// The unique identifier of this PropertyOwner
@@ -309,6 +325,10 @@ protected:
     std::vector<Property*> _properties;
     /// A list of all sub-owners
     std::vector<PropertyOwner*> _subOwners;
+    /// The registered Property's indexed by their identifiers
+    std::unordered_map<std::string, Property*> _propertyIndex;
+    /// The sub-owners indexed by their identifiers
+    std::unordered_map<std::string, PropertyOwner*> _subOwnerIndex;
     /// The associations between group identifiers of Property's and human-readable names
     std::map<std::string, std::string> _groupNames;
     /// Collection of string tag(s) assigned to this property
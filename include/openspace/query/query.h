@@ -44,6 +44,28 @@ const Renderable* renderable(const std::string& name);
 properties::Property* property(const std::string& uri);
 std::vector<properties::Property*> allProperties();
 
+/**
+ * Returns whether the \p uri can be used as a pattern for #matchingProperties, which is
+ * the case if it does not contain any regular expression syntax other than
+ * <code>*</code>.
+ */
+bool isWildcardPattern(const std::string& uri);
+
+/**
+ * Returns all properties whose fully qualified identifier matches the \p uriPattern, in
+ * which each <code>*</code> matches any sequence of characters and all other characters
+ * have to match exactly. If \p groupTag is not empty, only properties with an owner
+ * that is tagged with \p groupTag are returned. The properties are returned in the same
+ * order as by #allProperties.
+ *
+ * The owner hierarchy is only traversed below owners whose URI is compatible with the
+ * beginning of the \p uriPattern and the results are cached until the hierarchy changes
+ * (see properties::PropertyOwner::hierarchyVersion), so that repeated calls with the same
+ * pattern only cost time proportional to the number of matches.
+ */
+std::vector<properties::Property*> matchingProperties(const std::string& uriPattern,
+    const std::string& groupTag = "");
+
 } // namespace openspace
 
 #endif // __OPENSPACE_CORE___QUERY___H__
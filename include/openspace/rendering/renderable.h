@@ -74,6 +74,14 @@ public:
     bool isEnabled() const;
     bool shouldUpdateIfDisabled() const;
 
+    /**
+     * Returns whether the #update function of this Renderable has to be called from the
+     * main thread, for example because it accesses the OpenGL context. Only Renderables
+     * that return \c false are updated in parallel if the scene's parallel update is
+     * enabled.
+     */
+    bool requiresMainThreadUpdate() const;
+
     void setBoundingSphere(float boundingSphere);
     float boundingSphere() const;
 
@@ -101,6 +109,7 @@ protected:
     properties::StringProperty _renderableType;
 
     bool _shouldUpdateIfDisabled = false;
+    bool _requiresMainThreadUpdate = true;
 
     void setRenderBinFromOpacity();
     void registerUpdateRenderBinFromOpacity();
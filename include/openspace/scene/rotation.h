@@ -53,6 +53,13 @@ public:
     virtual glm::dmat3 matrix(const UpdateData& time) const = 0;
     void update(const UpdateData& data);
 
+    /**
+     * Returns whether the #update function has to be called from the main thread, for
+     * example because it calls into SPICE or Lua, which are not thread-safe. The default
+     * implementation returns \c false.
+     */
+    virtual bool requiresMainThreadUpdate() const;
+
     static documentation::Documentation Documentation();
 
 protected:
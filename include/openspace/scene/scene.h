@@ -61,6 +61,15 @@ public:
         explicit InvalidSceneError(std::string msg, std::string comp = "");
     };
 
+    /// Timing information about one level of the scene graph in the parallel update
+    struct UpdateLevelTiming {
+        /// The number of nodes whose transformation was updated on a worker thread
+        size_t nParallelNodes = 0;
+        /// The number of nodes that had to be updated (partially) on the main thread
+        size_t nMainThreadNodes = 0;
+        std::chrono::microseconds duration = std::chrono::microseconds(0);
+    };
+
     /// This struct describes a time that has some intrinsic interesting-ness to this
     /// scene.
     struct InterestingTime {
@@ -103,6 +112,21 @@ public:
      */
     void update(const UpdateData& data);
 
+    /**
+     * Enables or disables the parallel update of the scene graph. If it is enabled, the
+     * nodes are grouped into levels such that each node only depends on nodes in
+     * previous levels (through its parent or its dependencies). The nodes of each level
+     * are then updated in parallel on the engine's JobSystem, except for those parts of
+     * a node that report that they have to be updated on the main thread.
+     */
+    void setParallelUpdate(bool enabled);
+
+    /**
+     * Returns the per-level timings of the last parallel update. The vector is empty if
+     * the parallel update is disabled.
+     */
+    const std::vector<UpdateLevelTiming>& updateLevelTimings() const;
+
     /**
      * Render visible SceneGraphNodes using the provided camera.
      */
@@ -241,11 +265,30 @@ private:
 
     void sortTopologically();
 
+    /**
+     * Groups the topologically sorted nodes into the levels for the parallel update.
+     */
+    void computeUpdateLevels();
+
+    void updateParallel(const UpdateData& data);
+
     std::unique_ptr<Camera> _camera;
     std::vector<SceneGraphNode*> _topologicallySortedNodes;
     std::vector<SceneGraphNode*> _circularNodes;
     std::unordered_map<std::string, SceneGraphNode*> _nodesByIdentifier;
     bool _dirtyNodeRegistry = false;
+
+    struct UpdateLevel {
+        /// Nodes whose transformation can be updated on any thread
+        std::vector<SceneGraphNode*> parallelNodes;
+        /// Nodes whose transformation has to be updated on the main thread
+        std::vector<SceneGraphNode*> mainThreadNodes;
+        /// Nodes of this level whose Renderable has to be updated on the main thread
+        std::vector<SceneGraphNode*> mainThreadRenderables;
+    };
+    bool _useParallelUpdate = false;
+    std::vector<UpdateLevel> _updateLevels;
+    std::vector<UpdateLevelTiming> _updateLevelTimings;
     SceneGraphNode _rootDummy;
     std::unique_ptr<SceneInitializer> _initializer;
 
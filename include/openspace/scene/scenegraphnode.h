@@ -92,6 +92,31 @@ public:
     void traversePreOrder(const std::function<void(SceneGraphNode*)>& fn);
     void traversePostOrder(const std::function<void(SceneGraphNode*)>& fn);
     void update(const UpdateData& data);
+
+    /**
+     * Updates the translation, rotation, and scale of this node and recomputes the
+     * cached world transformation. The parent node and all dependencies must already
+     * have been updated. This is the first half of #update.
+     */
+    void updateTransform(const UpdateData& data);
+
+    /**
+     * Updates the Renderable of this node using the world transformation that was
+     * computed in the last call to #updateTransform. This is the second half of #update.
+     */
+    void updateRenderable(const UpdateData& data);
+
+    /**
+     * Returns whether the translation, rotation, or scale of this node have to be updated
+     * on the main thread.
+     */
+    bool requiresMainThreadTransformUpdate() const;
+
+    /**
+     * Returns whether the Renderable of this node has to be updated on the main thread.
+     */
+    bool requiresMainThreadRenderableUpdate() const;
+
     void render(const RenderData& data, RendererTasks& tasks);
 
     void attachChild(ghoul::mm_unique_ptr<SceneGraphNode> child);
@@ -32,6 +32,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace ghoul { class Dictionary; }
 
@@ -43,6 +44,9 @@ namespace documentation {  struct Documentation; }
 
 class Translation : public properties::PropertyOwner {
 public:
+    using PositionSampler =
+        std::function<std::vector<glm::dvec3>(const std::vector<double>&)>;
+
     static ghoul::mm_unique_ptr<Translation> createFromDictionary(
         const ghoul::Dictionary& dictionary);
 
@@ -55,6 +59,32 @@ public:
 
     virtual glm::dvec3 position(const UpdateData& data) const = 0;
 
+    /**
+     * Returns the positions at all of the \p times, which are given in seconds past the
+     * J2000 epoch. The default implementation calls #position once for each time, but
+     * subclasses can override it if they can compute many positions more efficiently at
+     * once. Unless #requiresMainThreadUpdate returns \c true, this function might be
+     * called concurrently from multiple threads, for example when sampling trails.
+     */
+    virtual std::vector<glm::dvec3> positions(const std::vector<double>& times) const;
+
+    /**
+     * Returns a function that computes the same positions as #positions for the current
+     * parameters of this translation. The function is created on the main thread and can
+     * be called from other threads afterwards, even while the properties of this
+     * translation are being changed. The default implementation calls #positions, so
+     * subclasses whose positions depend on properties have to override it and capture a
+     * copy of the values that they need.
+     */
+    virtual PositionSampler positionSampler() const;
+
+    /**
+     * Returns whether the #update function has to be called from the main thread, for
+     * example because it calls into SPICE or Lua, which are not thread-safe. The default
+     * implementation returns \c false.
+     */
+    virtual bool requiresMainThreadUpdate() const;
+
     // Registers a callback that gets called when a significant change has been made that
     // invalidates potentially stored points, for example in trails
     void onParameterChange(std::function<void()> callback);
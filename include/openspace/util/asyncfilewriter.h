@@ -0,0 +1,147 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___ASYNCFILEWRITER___H__
+#define __OPENSPACE_CORE___ASYNCFILEWRITER___H__
+
+#include <ghoul/misc/boolean.h>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace openspace {
+
+/**
+ * Writes data to a file from a background thread. The data that is passed to #write is
+ * copied into a fixed-size ring buffer without taking a lock, and the background thread
+ * writes the buffered data to the file in large blocks. This keeps slow disks or network
+ * drives from stalling the thread that produces the data.
+ *
+ * If the ring buffer is full, #write either drops the data or waits until the background
+ * thread has made enough room, depending on its arguments. The number of dropped and
+ * blocked writes is counted. All data that was not dropped is written to the file before
+ * #close returns.
+ *
+ * Only a single thread at a time is allowed to call #open, #write, and #close.
+ */
+class AsyncFileWriter {
+public:
+    BooleanType(Binary);
+    BooleanType(DropIfFull);
+
+    /// The default size of the ring buffer in bytes
+    static constexpr const size_t DefaultBufferSize = 4 * 1024 * 1024;
+
+    /**
+     * Creates a writer whose ring buffer can hold \p bufferSize bytes. The background
+     * thread writes the buffered data as soon as a quarter of the buffer is filled, but
+     * at least every 100 ms.
+     *
+     * \pre \p bufferSize must be positive
+     */
+    explicit AsyncFileWriter(size_t bufferSize = DefaultBufferSize);
+
+    /// Closes the file if it is still open, see #close
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /**
+     * Opens the file at \p path for writing and starts the background thread. Existing
+     * contents of the file are overwritten.
+     *
+     * \return <code>true</code> if the file was opened successfully
+     * \pre No file must be open
+     */
+    bool open(const std::string& path, Binary binary = Binary::Yes);
+
+    /**
+     * Appends \p size bytes of \p data to the file. If the ring buffer does not have
+     * enough room for the data, it is either dropped if \p drop is <code>Yes</code>, or
+     * the call blocks until the background thread has written enough of the buffer.
+     *
+     * \return <code>true</code> if the data was added, <code>false</code> if it was
+     *         dropped
+     * \pre The file must be open
+     */
+    bool write(const char* data, size_t size, DropIfFull drop = DropIfFull::No);
+
+    /**
+     * Writes all remaining buffered data to the file, stops the background thread and
+     * closes the file. Calling this function if no file is open has no effect.
+     *
+     * \return <code>false</code> if any data could not be written to the file
+     */
+    bool close();
+
+    bool isOpen() const;
+
+    /// Returns the number of writes that were dropped since the file was opened
+    size_t nDroppedWrites() const;
+
+    /// Returns the number of writes that had to wait for the background thread since the
+    /// file was opened
+    size_t nBlockedWrites() const;
+
+private:
+    /// The function executed by the background thread
+    void run();
+
+    /// Writes all data that is currently in the ring buffer to the file
+    void flush();
+
+    size_t nBufferedBytes() const;
+
+    std::ofstream _file;
+    std::thread _thread;
+    bool _isOpen = false;
+    std::atomic_bool _hasFailed = false;
+
+    const size_t _bufferSize;
+    std::unique_ptr<char[]> _buffer;
+
+    // The total number of bytes that were added to and removed from the ring buffer. The
+    // position in the ring buffer is these values modulo its size. _head is only modified
+    // by the producer, _tail only by the background thread
+    alignas(64) std::atomic<size_t> _head = 0;
+    alignas(64) std::atomic<size_t> _tail = 0;
+
+    // The mutex is only used for waking up the background thread, the data in the ring
+    // buffer is accessed without it
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _shouldStop = false;
+
+    size_t _nDroppedWrites = 0;
+    size_t _nBlockedWrites = 0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___ASYNCFILEWRITER___H__
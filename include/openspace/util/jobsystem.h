@@ -0,0 +1,154 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___JOBSYSTEM___H__
+#define __OPENSPACE_CORE___JOBSYSTEM___H__
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The JobSystem is a pool of worker threads that executes arbitrary jobs. Each worker
+ * owns its own set of queues, one per Priority, which are protected by a per-worker lock.
+ * Jobs that are enqueued from a worker thread are placed in that worker's queue, jobs
+ * from other threads are distributed in a round-robin fashion. Workers that run out of
+ * jobs steal from the other workers, always preferring jobs with a higher priority, so
+ * that no single lock is shared between all producers and consumers.
+ *
+ * Every job can be tagged with a Key, which makes it possible to cancel all enqueued
+ * jobs with that key at once. Jobs that have already started executing are not affected
+ * by a cancellation.
+ *
+ * The worker threads are started lazily when the first job is enqueued, which makes it
+ * possible to create an instance during static initialization.
+ */
+class JobSystem {
+public:
+    enum class Priority {
+        /// Jobs whose results are needed for the current or the next frame
+        FrameCritical = 0,
+        /// Jobs that speculatively load data that might be needed in the future
+        Prefetch,
+        /// Everything else, for example initialization or data preprocessing
+        Background
+    };
+
+    using Key = uint64_t;
+
+    /// Jobs that are enqueued with this key can only be removed by #clear
+    static constexpr const Key NoKey = 0;
+
+    /**
+     * Creates a JobSystem that will run \p numThreads worker threads. If \p numThreads
+     * is 0, one less than the number of hardware threads (but at least one) is used.
+     */
+    explicit JobSystem(size_t numThreads = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * Enqueues the \p job with the provided \p priority. If the \p key is not #NoKey, the
+     * job can later be removed from the queues by calling #cancel with the same key.
+     */
+    void enqueue(std::function<void()> job, Priority priority = Priority::Background,
+        Key key = NoKey);
+
+    /**
+     * Calls the \p task for every index in [0, \p nTasks) using up to #numThreads
+     * threads with the provided \p priority and returns once all tasks have finished.
+     * The calling thread executes tasks itself, so it only ever waits for tasks that are
+     * currently executed by a worker. This function can therefore also be called from
+     * within a job. The \p task must not throw an exception.
+     */
+    void parallelFor(size_t nTasks, std::function<void(size_t)> task,
+        Priority priority = Priority::Background);
+
+    /**
+     * Removes all jobs with the provided \p key that have not been started yet.
+     *
+     * \return The number of jobs that were removed
+     */
+    size_t cancel(Key key);
+
+    /**
+     * Removes all jobs that have not been started yet, regardless of their key.
+     *
+     * \return The number of jobs that were removed
+     */
+    size_t clear();
+
+    /**
+     * Returns a new key that is unique for this JobSystem and that is never #NoKey.
+     */
+    Key createKey();
+
+    size_t numThreads() const;
+    size_t numPendingJobs() const;
+
+private:
+    struct Task {
+        std::function<void()> function;
+        Key key = NoKey;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::array<std::deque<Task>, 3> tasks;
+    };
+
+    void startWorkers();
+    void workerLoop(size_t index);
+
+    /// Tries to pop a job of the \p priority from the worker's own queue first and then
+    /// tries to steal one from all other workers
+    bool popTask(size_t index, Priority priority, Task& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+    std::vector<std::thread> _workers;
+
+    std::atomic<size_t> _nPendingJobs = 0;
+    std::atomic<size_t> _nextQueue = 0;
+    std::atomic<Key> _nextKey = NoKey + 1;
+
+    std::once_flag _startFlag;
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    bool _stop = false;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___JOBSYSTEM___H__
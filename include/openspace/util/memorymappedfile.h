@@ -0,0 +1,87 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
+#define __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
+
+#include <cstddef>
+#include <string>
+
+namespace openspace {
+
+/**
+ * A read-only view of the contents of a file that is mapped into the address space of
+ * the process. Reading from the view causes the operating system to page in the file
+ * contents on demand, which avoids the copies of a stream-based read and allows multiple
+ * threads to access different parts of the file at the same time. The file can still be
+ * written to while it is mapped and changes within the mapped range become visible
+ * through the view, but the view does not grow if the file is extended.
+ */
+class MemoryMappedFile {
+public:
+    /// Hints to the operating system how the file contents will be accessed
+    enum class AccessPattern {
+        Sequential = 0,
+        Random
+    };
+
+    /**
+     * Opens and maps the file at \p path. If the file cannot be opened or mapped,
+     * #isOpen will return <code>false</code>. An empty file is opened successfully but
+     * has no data.
+     */
+    explicit MemoryMappedFile(const std::string& path,
+        AccessPattern pattern = AccessPattern::Sequential);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    bool isOpen() const;
+    const char* data() const;
+    size_t size() const;
+
+    /**
+     * Removes the pages that are fully covered by the range starting at \p offset with
+     * \p size bytes from the working set of the process. The file contents remain in the
+     * file system cache, so accessing the range again is still cheap.
+     */
+    void release(size_t offset, size_t size) const;
+
+private:
+    void unmap();
+
+    const char* _data = nullptr;
+    size_t _size = 0;
+    bool _isOpen = false;
+
+#ifdef WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#endif // WIN32
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
@@ -0,0 +1,85 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___MPSCQUEUE___H__
+#define __OPENSPACE_CORE___MPSCQUEUE___H__
+
+#include <atomic>
+#include <utility>
+
+namespace openspace {
+
+/**
+ * A lock-free, unbounded queue for multiple producers and a single consumer. Any number
+ * of threads can #push values concurrently without blocking each other, but only one
+ * thread at a time is allowed to call #pop. This makes the queue suitable for collecting
+ * work from many threads that is consumed once per frame on the main thread.
+ *
+ * A value that is pushed might not become visible to the consumer until all pushes that
+ * started earlier have completed, so #pop can return <code>false</code> even though a
+ * concurrent #push has already returned. The values of each producer are always popped
+ * in the order in which they were pushed.
+ *
+ * The type \p T has to be default-constructible and move-assignable.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue();
+    ~MpscQueue();
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /// Adds the \p value to the end of the queue. This function can be called from any
+    /// thread
+    void push(T value);
+
+    /**
+     * Removes the value at the front of the queue and moves it into \p value.
+     *
+     * \return <code>true</code> if a value was removed, <code>false</code> if the queue
+     *         was empty
+     * \pre This function must only be called by a single thread at a time
+     */
+    bool pop(T& value);
+
+private:
+    struct Node {
+        std::atomic<Node*> next = nullptr;
+        T value = T();
+    };
+
+    /// The most recently pushed node, which is modified by all producers
+    alignas(64) std::atomic<Node*> _head;
+
+    /// The node before the front of the queue, which is only accessed by the consumer
+    alignas(64) Node* _tail;
+};
+
+} // namespace openspace
+
+#include "mpscqueue.inl"
+
+#endif // __OPENSPACE_CORE___MPSCQUEUE___H__
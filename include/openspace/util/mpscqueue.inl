@@ -0,0 +1,68 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+namespace openspace {
+
+template <typename T>
+MpscQueue<T>::MpscQueue() {
+    // The queue always contains one node whose value has already been consumed, which
+    // means that producers and the consumer never modify the same node
+    Node* stub = new Node;
+    _head = stub;
+    _tail = stub;
+}
+
+template <typename T>
+MpscQueue<T>::~MpscQueue() {
+    Node* node = _tail;
+    while (node) {
+        Node* next = node->next.load(std::memory_order_relaxed);
+        delete node;
+        node = next;
+    }
+}
+
+template <typename T>
+void MpscQueue<T>::push(T value) {
+    Node* node = new Node;
+    node->value = std::move(value);
+
+    Node* previous = _head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+template <typename T>
+bool MpscQueue<T>::pop(T& value) {
+    Node* next = _tail->next.load(std::memory_order_acquire);
+    if (!next) {
+        return false;
+    }
+
+    value = std::move(next->value);
+    delete _tail;
+    _tail = next;
+    return true;
+}
+
+} // namespace openspace
@@ -0,0 +1,127 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SPECKFILE___H__
+#define __OPENSPACE_CORE___SPECKFILE___H__
+
+#include <openspace/util/memorymappedfile.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Reads files in the SPECK format that is used by the Digital Universe catalogs and by
+ * Partiview. A SPECK file starts with a header that consists of comments (signaled by a
+ * preceding '#') and commands that describe the structure of the file, such as
+ * <code>datavar</code>, <code>texturevar</code>, <code>texture</code>,
+ * <code>polyorivar</code>, and <code>maxcomment</code>. Every following line contains the
+ * values of one object, starting with its x, y, and z position.
+ *
+ * The file is memory mapped, the header is parsed in the constructor and the data is
+ * only parsed when requested by #readData. All lines are parsed in place without any
+ * intermediate string or stream objects.
+ */
+class SpeckFile {
+public:
+    struct Variable {
+        /// The index of the variable as written in the file, not counting x, y, and z
+        int index;
+        std::string name;
+    };
+
+    struct Texture {
+        int index;
+        std::string file;
+    };
+
+    /**
+     * Opens the SPECK file at \p path and parses its header. If the file cannot be
+     * opened, #isOpen returns <code>false</code>.
+     */
+    explicit SpeckFile(const std::string& path);
+
+    bool isOpen() const;
+
+    /// The variables declared by <code>datavar</code> commands in the order of the file
+    const std::vector<Variable>& variables() const;
+
+    /// The textures declared by <code>texture</code> commands in the order of the file
+    const std::vector<Texture>& textures() const;
+
+    /// The index declared by the <code>texturevar</code> command or -1
+    int textureVariable() const;
+
+    /// The index declared by the <code>polyorivar</code> command or -1
+    int polygonOrientationVariable() const;
+
+    /**
+     * Returns the number of values per object if each variable has a single value, which
+     * is the highest variable index plus one, plus three for the position.
+     */
+    int nValuesPerObject() const;
+
+    /**
+     * Parses all data lines of the file and returns their values in a single vector
+     * that contains \p nValuesPerObject values for each line. Values that are missing in
+     * a line are set to 0 and additional values are ignored, just as any text that
+     * follows the last number. Empty lines and comments are skipped. If \p useThreads is
+     * <code>true</code>, the data section is split into chunks at line boundaries that
+     * are parsed concurrently on the JobSystem.
+     */
+    std::vector<float> readData(int nValuesPerObject, bool useThreads = true) const;
+
+    /// Returns the contents of the file after the header
+    std::string_view dataSection() const;
+
+private:
+    MemoryMappedFile _file;
+    std::vector<Variable> _variables;
+    std::vector<Texture> _textures;
+    int _textureVariable = -1;
+    int _polygonOrientationVariable = -1;
+    size_t _dataOffset = 0;
+};
+
+namespace speck {
+
+/**
+ * Removes and returns the first line of \p text without the line ending. Both "\n" and
+ * "\r\n" line endings are supported.
+ */
+std::string_view nextLine(std::string_view& text);
+
+/**
+ * Parses up to \p nValues whitespace-separated numbers from the beginning of \p line into
+ * \p values and returns the number of values that were parsed. Parsing stops at the
+ * first token that is not a number.
+ */
+size_t parseNumbers(std::string_view line, float* values, size_t nValues);
+
+} // namespace speck
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___SPECKFILE___H__
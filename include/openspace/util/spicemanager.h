@@ -31,10 +31,15 @@
 #include <ghoul/misc/boolean.h>
 #include <ghoul/misc/exception.h>
 #include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
-#include <set>
+#include <unordered_map>
 #include "SpiceUsr.h"
 #include "SpiceZpr.h"
 
@@ -44,6 +49,14 @@ namespace scripting { struct LuaLibrary; }
 
 void throwSpiceError(const std::string& errorMessage);
 
+/**
+ * The SpiceManager is the only interface to the CSPICE library. As CSPICE is not
+ * reentrant, all functions that access it are serialized by an internal lock, which makes
+ * it safe to call the SpiceManager from any thread. Callers that need many values, for
+ * example the positions of a trail, should request them as a batch using
+ * #targetPositions, #positionTransformMatrices, or #surfaceIntercepts, which acquire the
+ * lock only once, or submit the batch with #submit to receive a future instead.
+ */
 class SpiceManager {
 public:
     BooleanType(UseException);
@@ -152,6 +165,21 @@ public:
      */
     static TerminatorType terminatorTypeFromString(const std::string& type);
 
+    /**
+     * A body or reference frame whose NAIF ID has been looked up in advance. Classes
+     * that query SPICE repeatedly for the same objects, for example every frame, should
+     * hold on to NaifObjects that are created by #body and #frame, as the functions that
+     * accept NaifObjects do not have to look up the name again.
+     */
+    struct NaifObject {
+        std::string name;
+        int id = 0;
+        /// Whether the #id is valid. If the \c name could not be resolved when the
+        /// NaifObject was created, for example because the kernel that defines it had not
+        /// been loaded yet, the \c name is looked up whenever the object is used
+        bool isResolved = false;
+    };
+
     static void initialize();
     static void deinitialize();
     static bool isInitialized();
@@ -226,6 +254,17 @@ public:
      */
     bool hasSpkCoverage(const std::string& target, double et) const;
 
+    /**
+     * Returns whether the object with the NAIF \p id has an Spk kernel covering it at
+     * the designated \p et ephemeris time.
+     *
+     * \param id The NAIF ID of the object to be examined
+     * \param et The time for which the coverage should be checked
+     * \return \c true if SPK kernels have been loaded to cover the object at the time
+     *         \p et, \c false otherwise.
+     */
+    bool hasSpkCoverage(int id, double et) const;
+
     /**
      * Returns whether a given \p frame has a CK kernel covering it at the designated
      * \p et ephemeris time.
@@ -242,6 +281,17 @@ public:
      */
     bool hasCkCoverage(const std::string& frame, double et) const;
 
+    /**
+     * Returns whether the frame with the NAIF \p id has a CK kernel covering it at the
+     * designated \p et ephemeris time.
+     *
+     * \param id The NAIF ID of the frame to be examined
+     * \param et The time for which the coverage should be checked
+     * \return \c true if CK kernels have been loaded to cover the frame at the time
+     *         \p et, \c false otherwise.
+     */
+    bool hasCkCoverage(int id, double et) const;
+
     /**
      * Determines whether values exist for some \p item for any body, identified by its
      * \p naifId, in the kernel pool by passing it to the \c bodfnd_c function.
@@ -322,6 +372,24 @@ public:
      */
     bool hasFrameId(const std::string& frame) const;
 
+    /**
+     * Returns the NaifObject for the \p body. If the \p body does not have a NAIF ID
+     * with the currently loaded kernels, the returned object is not resolved.
+     *
+     * \param body The name of the body
+     * \return The NaifObject for the \p body
+     */
+    NaifObject body(const std::string& body) const;
+
+    /**
+     * Returns the NaifObject for the \p frame. If the \p frame does not have a NAIF ID
+     * with the currently loaded kernels, the returned object is not resolved.
+     *
+     * \param frame The name of the reference frame
+     * \return The NaifObject for the \p frame
+     */
+    NaifObject frame(const std::string& frame) const;
+
     /**
      * Retrieves a single \p value for a certain \p body. This method succeeds iff \p body
      * is the name of a valid body, \p value is a value associated with the body, and the
@@ -502,6 +570,7 @@ public:
         static_assert(N != 0, "Format must not be empty");
         ghoul_assert(N >= bufferSize - 1, "Buffer size too small");
 
+        std::lock_guard lock(_mutex);
         timout_c(ephemerisTime, format, bufferSize, outBuf);
         if (failed_c()) {
             throwSpiceError(fmt::format(
@@ -574,6 +643,16 @@ public:
         const std::string& observer, const std::string& referenceFrame,
         AberrationCorrection aberrationCorrection, double ephemerisTime) const;
 
+    /**
+     * Returns the same position as #targetPosition, but for the NaifObjects, which saves
+     * the lookup of their names.
+     *
+     * \sa #targetPosition
+     */
+    glm::dvec3 targetPosition(const NaifObject& target, const NaifObject& observer,
+        const NaifObject& referenceFrame, AberrationCorrection aberrationCorrection,
+        double ephemerisTime, double& lightTime) const;
+
     /**
      * This method returns the transformation matrix that defines the transformation from
      * the reference frame \p from to the reference frame \p to. As both reference frames
@@ -653,6 +732,18 @@ public:
         const std::string& referenceFrame, AberrationCorrection aberrationCorrection,
         double ephemerisTime, const glm::dvec3& directionVector) const;
 
+    /**
+     * Computes the #surfaceIntercept for each of the \p directionVectors at the same
+     * time while acquiring the lock for CSPICE only once. The results are returned in the
+     * order of the \p directionVectors.
+     *
+     * \sa #surfaceIntercept
+     */
+    std::vector<SurfaceInterceptResult> surfaceIntercepts(const std::string& target,
+        const std::string& observer, const std::string& fovFrame,
+        const std::string& referenceFrame, AberrationCorrection aberrationCorrection,
+        double ephemerisTime, const std::vector<glm::dvec3>& directionVectors) const;
+
     /**
      * Determine whether a specific \p target is in the field-of-view of a specified
      * \p instrument or an \p observer at a given time, using the reference frame
@@ -795,6 +886,154 @@ public:
         const std::string& destinationFrame, double ephemerisTimeFrom,
         double ephemerisTimeTo) const;
 
+    /**
+     * Returns the same position as #targetPosition, but answers the query from a cache of
+     * cubic Hermite segments that are sampled from the SPICE state of the \p target. The
+     * segments are created on demand with an adaptive length, such that the error of
+     * the interpolation at the center of each segment is smaller than the provided
+     * \p tolerance. Subsequent queries that fall into an existing segment do not call
+     * into SPICE at all. If a segment cannot be created, for example because the target
+     * or the observer are not covered by the loaded SPK kernels, the result of
+     * #targetPosition is returned instead.
+     *
+     * \param target The target body name or the target body's NAIF ID
+     * \param observer The observing body name or the observing body's NAIF ID
+     * \param referenceFrame The reference frame of the output position vector
+     * \param aberrationCorrection The aberration correction used for the position
+     *        calculation
+     * \param ephemerisTime The time at which the position is to be queried
+     * \param tolerance The maximum allowed interpolation error in km. If the
+     *        \p tolerance is not positive, no interpolation is performed
+     * \param lightTime If the \p aberrationCorrection is different from
+     *        AbberationCorrection::Type::None, this variable will contain the
+     *        interpolated light time between the observer and the target.
+     * \return The position of the \p target relative to the \p observer in the specified
+     *         \p referenceFrame
+     *
+     * \throw SpiceException For the same reasons as #targetPosition
+     * \pre \p target must not be empty.
+     * \pre \p observer must not be empty.
+     * \pre \p referenceFrame must not be empty.
+     */
+    glm::dvec3 interpolatedTargetPosition(const std::string& target,
+        const std::string& observer, const std::string& referenceFrame,
+        AberrationCorrection aberrationCorrection, double ephemerisTime,
+        double tolerance, double& lightTime) const;
+
+    /**
+     * Returns the same position as #interpolatedTargetPosition, but for the NaifObjects,
+     * which saves the lookup of their names.
+     *
+     * \sa #interpolatedTargetPosition
+     */
+    glm::dvec3 interpolatedTargetPosition(const NaifObject& target,
+        const NaifObject& observer, const NaifObject& referenceFrame,
+        AberrationCorrection aberrationCorrection, double ephemerisTime,
+        double tolerance, double& lightTime) const;
+
+    /**
+     * Returns the same matrix as #positionTransformMatrix, but answers the query from a
+     * cache of segments in which the rotation is interpolated spherically. The segments
+     * are created on demand with an adaptive length, such that the angular error of the
+     * interpolation at the center of each segment is smaller than the provided
+     * \p tolerance. If a segment cannot be created, for example because SPICE cannot
+     * provide the angular velocity of the frames, the result of #positionTransformMatrix
+     * is returned instead.
+     *
+     * \param sourceFrame The name of the source reference frame
+     * \param destinationFrame The name of the destination reference frame
+     * \param ephemerisTime The time at which the transformation matrix is to be queried
+     * \param tolerance The maximum allowed interpolation error in radians. If the
+     *        \p tolerance is not positive, no interpolation is performed
+     * \return The transformation matrix that defines the transformation from the
+     *         \p sourceFrame to the \p destinationFrame
+     *
+     * \throw SpiceException For the same reasons as #positionTransformMatrix
+     * \pre \p sourceFrame must not be empty
+     * \pre \p destinationFrame must not be empty
+     */
+    glm::dmat3 interpolatedPositionTransformMatrix(const std::string& sourceFrame,
+        const std::string& destinationFrame, double ephemerisTime,
+        double tolerance) const;
+
+    /**
+     * Returns the same matrix as #interpolatedPositionTransformMatrix, but for the
+     * NaifObjects, which saves the lookup of their names.
+     *
+     * \sa #interpolatedPositionTransformMatrix
+     */
+    glm::dmat3 interpolatedPositionTransformMatrix(const NaifObject& sourceFrame,
+        const NaifObject& destinationFrame, double ephemerisTime,
+        double tolerance) const;
+
+    /**
+     * Removes all segments that were created by #interpolatedTargetPosition and
+     * #interpolatedPositionTransformMatrix as well as all cached NAIF and frame ids. This
+     * function is called automatically whenever a kernel is loaded or unloaded.
+     */
+    void clearInterpolationCache();
+
+    /// The positions of a single \c target relative to an \c observer at many times
+    struct PositionBatch {
+        NaifObject target;
+        NaifObject observer;
+        NaifObject referenceFrame;
+        AberrationCorrection aberrationCorrection;
+        /// If this is larger than 0, the positions are computed by
+        /// #interpolatedTargetPosition with this tolerance
+        double tolerance = 0.0;
+        std::vector<double> times;
+    };
+
+    /// The rotations from a \c sourceFrame to a \c destinationFrame at many times
+    struct TransformBatch {
+        NaifObject sourceFrame;
+        NaifObject destinationFrame;
+        /// If this is larger than 0, the matrices are computed by
+        /// #interpolatedPositionTransformMatrix with this tolerance
+        double tolerance = 0.0;
+        std::vector<double> times;
+    };
+
+    /**
+     * Returns the position for each of the times in the \p batch in the same order. The
+     * lock that serializes the access to CSPICE is only acquired once for the batch.
+     *
+     * \param batch The target, observer, and times for which to compute the positions
+     * \return The positions in km
+     *
+     * \throw SpiceException If any of the positions could not be computed
+     */
+    std::vector<glm::dvec3> targetPositions(const PositionBatch& batch) const;
+
+    /**
+     * Returns the rotation matrix for each of the times in the \p batch in the same
+     * order. The lock that serializes the access to CSPICE is only acquired once for the
+     * batch.
+     *
+     * \param batch The frames and times for which to compute the rotation matrices
+     * \return The rotation matrices
+     *
+     * \throw SpiceException If any of the matrices could not be computed
+     */
+    std::vector<glm::dmat3> positionTransformMatrices(const TransformBatch& batch) const;
+
+    /**
+     * Submits the \p batch to be computed by #targetPositions on the JobSystem. All
+     * submitted batches are executed one after another, so that at most one worker is
+     * waiting for the CSPICE lock. Exceptions are passed on through the returned future.
+     * Jobs that are running on the JobSystem themselves should call #targetPositions
+     * directly instead of waiting for the future.
+     */
+    std::future<std::vector<glm::dvec3>> submit(PositionBatch batch) const;
+
+    /**
+     * Submits the \p batch to be computed by #positionTransformMatrices on the JobSystem.
+     *
+     * \sa #submit(PositionBatch)
+     */
+    std::future<std::vector<glm::dmat3>> submit(TransformBatch batch) const;
+
     /// The structure returned by the #fieldOfView methods
     struct FieldOfViewResult {
         /// The rough shape of the returned field of view
@@ -940,6 +1179,13 @@ private:
     /// Default destructor that resets the SPICE settings
     ~SpiceManager();
 
+    /// Adds the \p request to the queue of submitted batches and makes sure that a job
+    /// is processing the queue
+    void enqueueRequest(std::function<void()> request) const;
+
+    /// Executes submitted batches until the queue is empty
+    void processRequests() const;
+
     /**
      * Function to find and store the intervals covered by a ck file, this is done
      * by using mainly the \c ckcov_c and \c ckobj_c functions.
@@ -1022,14 +1268,114 @@ private:
     glm::dmat3 getEstimatedTransformMatrix(const std::string& fromFrame,
         const std::string& toFrame, double time) const;
 
+    /// Identifies a cached interpolation by the NAIF ids of the involved objects
+    struct InterpolationKey {
+        /// The target body or the source frame
+        int source;
+        /// The observer or the destination frame
+        int destination;
+        /// The reference frame of a position or 0 for a rotation
+        int frame;
+        /// The aberration correction of a position or 0 for a rotation
+        int aberrationCorrection;
+        double tolerance;
+
+        bool operator==(const InterpolationKey& rhs) const;
+    };
+
+    struct InterpolationKeyHash {
+        size_t operator()(const InterpolationKey& key) const;
+    };
+
+    struct PositionSample {
+        double time;
+        glm::dvec3 position;
+        glm::dvec3 velocity;
+        double lightTime;
+    };
+
+    struct RotationSample {
+        double time;
+        glm::dquat rotation;
+        glm::dvec3 angularVelocity;
+    };
+
+    /// The segments of one interpolation, sorted by the time at which they start
+    template <typename Sample>
+    using Segments = std::map<double, std::pair<Sample, Sample>>;
+
+    template <typename Sample>
+    using SegmentCache = std::unordered_map<
+        InterpolationKey, Segments<Sample>, InterpolationKeyHash
+    >;
+
+
+    /// Implements both #targetPosition overloads with the resolved NAIF IDs
+    glm::dvec3 computeTargetPosition(const std::string& target, int targetId,
+        const std::string& observer, int observerId, const std::string& referenceFrame,
+        AberrationCorrection aberrationCorrection, double ephemerisTime,
+        double& lightTime) const;
+
+    /// Implements both #interpolatedTargetPosition overloads with the resolved NAIF IDs
+    glm::dvec3 computeInterpolatedTargetPosition(const std::string& target,
+        int targetId, const std::string& observer, int observerId,
+        const std::string& referenceFrame, int referenceFrameId,
+        AberrationCorrection aberrationCorrection, double ephemerisTime,
+        double tolerance, double& lightTime) const;
+
+    /// Implements both #interpolatedPositionTransformMatrix overloads with the resolved
+    /// NAIF IDs
+    glm::dmat3 computeInterpolatedTransformMatrix(const std::string& sourceFrame,
+        int sourceFrameId, const std::string& destinationFrame, int destinationFrameId,
+        double ephemerisTime, double tolerance) const;
+
+    /**
+     * Samples the state of the target described by \p key at the time \p et into
+     * \p sample. Returns <code>false</code> if either of the bodies is not covered or if
+     * SPICE fails to compute the state.
+     */
+    bool samplePosition(const InterpolationKey& key, const std::string& referenceFrame,
+        AberrationCorrection aberrationCorrection, double et,
+        PositionSample& sample) const;
+
+    /**
+     * Samples the rotation between the frames in \p key and its angular velocity at the
+     * time \p et into \p sample. Returns <code>false</code> if SPICE fails to compute
+     * the state transformation.
+     */
+    bool sampleRotation(const std::string& sourceFrame,
+        const std::string& destinationFrame, double et, RotationSample& sample) const;
+
+    /// Serializes all accesses to CSPICE and to the caches. The lock is recursive as the
+    /// public functions call each other
+    mutable std::recursive_mutex _mutex;
+
+    /// The batches that were passed to #submit and have not been started yet
+    mutable std::deque<std::function<void()>> _requests;
+    mutable std::mutex _requestMutex;
+    mutable std::condition_variable _requestCondition;
+    mutable bool _isProcessingRequests = false;
+
     /// A list of all loaded kernels
     std::vector<KernelInformation> _loadedKernels;
 
-    // Map: id, vector of pairs. Pair: Start time, end time;
-    std::map<int, std::vector< std::pair<double, double>>> _ckIntervals;
-    std::map<int, std::vector< std::pair<double, double>>> _spkIntervals;
-    std::map<int, std::set<double>> _ckCoverageTimes;
-    std::map<int, std::set<double>> _spkCoverageTimes;
+    /// The coverage of a NAIF object consists of the start and end times of all its
+    /// intervals in increasing order, such that the intervals are [t0, t1], [t2, t3], ...
+    /// Intervals that overlap are merged, so the times are sorted and each lookup is a
+    /// binary search
+    using Coverage = std::vector<double>;
+
+    /// Maps from the NAIF id of a frame or body to its coverage
+    std::unordered_map<int, Coverage> _ckCoverage;
+    std::unordered_map<int, Coverage> _spkCoverage;
+
+    /// The NAIF ids of all bodies and frames that were looked up since the last kernel
+    /// was loaded or unloaded
+    mutable std::unordered_map<std::string, int> _naifIds;
+    mutable std::unordered_map<std::string, int> _frameIds;
+
+    mutable SegmentCache<PositionSample> _positionSegments;
+    mutable SegmentCache<RotationSample> _rotationSegments;
 
     /// Stores whether the SpiceManager throws exceptions (Yes) or fails silently (No)
     UseException _useExceptions = UseException::Yes;
@@ -47,6 +47,14 @@ protected:
     virtual void encode(SyncBuffer* /*syncBuffer*/) = 0;
     virtual void decode(SyncBuffer* /*syncBuffer*/) = 0;
     virtual void postSync(bool /*isMaster*/) {};
+
+    /**
+     * Returns whether this Syncable stays in the correct state if #decode is not called
+     * in a frame in which the encoded data is identical to the previous frame. This is
+     * the case for Syncables that encode their current state, but not for those that
+     * encode events, such as scripts that should be executed.
+     */
+    virtual bool canSkipUnchangedData() const { return false; };
 };
 
 } // namespace openspace
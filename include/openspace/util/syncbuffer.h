@@ -25,12 +25,19 @@
 #ifndef __OPENSPACE_CORE___SYNCBUFFER___H__
 #define __OPENSPACE_CORE___SYNCBUFFER___H__
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace openspace {
 
+/**
+ * The buffer into which Syncables encode their state on the master node and from which
+ * they decode it on the client nodes. Integral values are stored as variable-length
+ * integers, which only require a single byte for values between -64 and 63, all other
+ * values are stored by copying their bytes.
+ */
 class SyncBuffer {
 public:
     SyncBuffer(size_t n);
@@ -42,6 +49,12 @@ public:
     template <typename T>
     void encode(const T& v);
 
+    /**
+     * Encodes the \p value with 7 bits per byte, where the highest bit of each byte
+     * signals whether more bytes follow. Values smaller than 128 only require one byte.
+     */
+    void encodeVarint(uint64_t value);
+
     std::string decode();
 
     template <typename T>
@@ -52,19 +65,46 @@ public:
     template <typename T>
     void decode(T& value);
 
+    /// Decodes a value that was encoded with #encodeVarint
+    uint64_t decodeVarint();
+
     void reset();
 
     //void write();
     //void read();
 
     void setData(std::vector<std::byte> data);
+
+    /**
+     * Sets the \p size bytes at \p data as the data that is decoded next without copying
+     * them. The memory has to stay valid until the decoding is finished.
+     */
+    void setData(const std::byte* data, size_t size);
+
     std::vector<std::byte> data();
 
+    /// Returns a pointer to the data that has been encoded since the last #reset
+    const std::byte* encodedData() const;
+
+    /// Returns the number of bytes that have been encoded since the last #reset
+    size_t encodedSize() const;
+
 private:
+    /// Makes space for \p size more bytes to be encoded and returns a pointer to them
+    std::byte* encodeSpace(size_t size);
+
+    /// Returns a pointer to the next \p size bytes to be decoded and advances past them
+    const std::byte* decodeSpace(size_t size);
+
     size_t _n;
     size_t _encodeOffset = 0;
     size_t _decodeOffset = 0;
     std::vector<std::byte> _dataStream;
+
+    // The data that is decoded, which is either owned by the _dataStream or by the caller
+    // of setData
+    const std::byte* _decodeData = nullptr;
+    size_t _decodeSize = 0;
 };
 
 } // namespace openspace
@@ -24,38 +24,51 @@
 
 #include <ghoul/misc/assert.h>
 #include <cstring>
+#include <type_traits>
 
 namespace openspace {
 
 template <typename T>
 void SyncBuffer::encode(const T& v) {
-    const size_t size = sizeof(T);
-
-    size_t anticpatedBufferSize = _encodeOffset + size;
-    if (anticpatedBufferSize >= _n) {
-        _dataStream.resize(anticpatedBufferSize);
+    if constexpr (std::is_integral_v<T> && sizeof(T) > 1) {
+        // Zigzag encoding maps signed values with a small magnitude to small unsigned
+        // values, so that they can be stored in few bytes
+        if constexpr (std::is_signed_v<T>) {
+            const int64_t value = static_cast<int64_t>(v);
+            const uint64_t sign = value < 0 ? ~uint64_t(0) : uint64_t(0);
+            encodeVarint((static_cast<uint64_t>(value) << 1) ^ sign);
+        }
+        else {
+            encodeVarint(static_cast<uint64_t>(v));
+        }
+    }
+    else {
+        memcpy(encodeSpace(sizeof(T)), &v, sizeof(T));
     }
-
-    memcpy(_dataStream.data() + _encodeOffset, &v, size);
-    _encodeOffset += size;
 }
 
 template <typename T>
 T SyncBuffer::decode() {
-    const size_t size = sizeof(T);
-    ghoul_assert(_decodeOffset + size < _n, "");
     T value;
-    memcpy(&value, _dataStream.data() + _decodeOffset, size);
-    _decodeOffset += size;
+    decode(value);
     return value;
 }
 
 template <typename T>
 void SyncBuffer::decode(T& value) {
-    const size_t size = sizeof(T);
-    ghoul_assert(_decodeOffset + size < _n, "");
-    memcpy(&value, _dataStream.data() + _decodeOffset, size);
-    _decodeOffset += size;
+    if constexpr (std::is_integral_v<T> && sizeof(T) > 1) {
+        const uint64_t v = decodeVarint();
+        if constexpr (std::is_signed_v<T>) {
+            const int64_t sign = -static_cast<int64_t>(v & 1);
+            value = static_cast<T>(static_cast<int64_t>(v >> 1) ^ sign);
+        }
+        else {
+            value = static_cast<T>(v);
+        }
+    }
+    else {
+        memcpy(&value, decodeSpace(sizeof(T)), sizeof(T));
+    }
 }
 
 } // namespace openspace
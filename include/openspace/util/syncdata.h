@@ -79,6 +79,7 @@ protected:
     virtual void encode(SyncBuffer* syncBuffer) override;
     virtual void decode(SyncBuffer* syncBuffer) override;
     virtual void postSync(bool isMaster) override;
+    virtual bool canSkipUnchangedData() const override;
 
     T _data;
     T _doubleBufferedData;
@@ -82,4 +82,10 @@ void SyncData<T>::postSync(bool isMaster) {
     }
 }
 
+template<class T>
+bool SyncData<T>::canSkipUnchangedData() const {
+    // The last decoded value is applied again in every postSync
+    return true;
+}
+
 } // namespace openspace
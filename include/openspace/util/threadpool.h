@@ -25,31 +25,27 @@
 #ifndef __OPENSPACE_CORE___THREAD_POOL___H__
 #define __OPENSPACE_CORE___THREAD_POOL___H__
 
+#include <openspace/util/jobsystem.h>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
-#include <thread>
-#include <vector>
-
-// Implementation based on http://progsch.net/wordpress/?p=81
 
 namespace openspace {
 
-class ThreadPool;
-
-class Worker {
-public:
-    Worker(ThreadPool& p);
-    void operator()();
-
-private:
-    ThreadPool& pool;
-};
-
+/**
+ * A ThreadPool is a view onto a JobSystem that keeps track of the jobs that were enqueued
+ * through it, so that they can be cleared without affecting other users of the same
+ * JobSystem. A ThreadPool can either create its own private JobSystem with a fixed number
+ * of threads, or it can share an existing one, such as the engine-wide
+ * <code>global::jobSystem</code>. In both cases, the destructor removes all jobs that
+ * have not been started and waits for the ones that are currently running.
+ */
 class ThreadPool {
 public:
     ThreadPool(size_t numThreads);
+    ThreadPool(JobSystem& jobSystem,
+        JobSystem::Priority priority = JobSystem::Priority::Background);
     ThreadPool(const ThreadPool& toCopy);
     ~ThreadPool();
 
@@ -57,16 +53,17 @@ public:
     void clearTasks();
 
 private:
-    friend class Worker;
-
-    std::vector<std::thread> workers;
-
-    std::deque<std::function<void()>> tasks;
+    void finishTasks(size_t n);
 
-    std::mutex queue_mutex;
-    std::condition_variable condition;
+    std::unique_ptr<JobSystem> _ownedJobSystem;
+    JobSystem& _jobSystem;
+    const JobSystem::Priority _priority;
+    const JobSystem::Key _key;
 
-    bool stop;
+    /// The number of jobs that have been enqueued and are either waiting or running
+    size_t _nOutstandingTasks = 0;
+    std::mutex _outstandingMutex;
+    std::condition_variable _outstandingCondition;
 };
 
 } // namespace openspace
@@ -117,6 +117,8 @@ RenderableCartesianAxes::RenderableCartesianAxes(const ghoul::Dictionary& dictio
         "RenderableCartesianAxes"
     );
 
+    _requiresMainThreadUpdate = false;
+
     if (dictionary.hasKey(XColorInfo.identifier)) {
         _xColor = dictionary.value<glm::vec3>(XColorInfo.identifier);
     }
@@ -339,6 +339,8 @@ RenderableLabels::RenderableLabels(const ghoul::Dictionary& dictionary)
         "RenderableLabels"
     );
 
+    _requiresMainThreadUpdate = false;
+
     addProperty(_opacity);
     registerUpdateRenderBinFromOpacity();
 
@@ -135,6 +135,8 @@ RenderableNodeLine::RenderableNodeLine(const ghoul::Dictionary& dictionary)
         "RenderableNodeLine"
     );
 
+    _requiresMainThreadUpdate = false;
+
     if (dictionary.hasKey(StartNodeInfo.identifier)) {
         _start = dictionary.value<std::string>(StartNodeInfo.identifier);
     }
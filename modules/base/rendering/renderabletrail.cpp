@@ -30,8 +30,10 @@
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/translation.h>
+#include <openspace/util/jobsystem.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/profiling.h>
 #include <ghoul/opengl/programobject.h>
 
@@ -41,6 +43,10 @@ namespace {
     constexpr const char* ProgramName = "EphemerisProgram";
     constexpr const char* KeyTranslation = "Translation";
 
+    // The number of trail positions that are sampled by one job. Large enough that a
+    // batched Translation, such as the SpiceTranslation, can amortize its overhead
+    constexpr const size_t SampleChunkSize = 4096;
+
 #ifdef __APPLE__
     constexpr const std::array<const char*, 12> UniformNames = {
         "opacity", "modelViewTransform", "projectionTransform", "color", "useLineFade",
@@ -325,6 +331,55 @@ bool RenderableTrail::isReady() const {
     return _programObject != nullptr;
 }
 
+bool RenderableTrail::samplePositions(const Translation::PositionSampler& sampler,
+                                      const std::vector<double>& times,
+                                      TrailVBOLayout* vertices,
+                                      const std::atomic<bool>* isCancelled) const
+{
+    ZoneScoped
+
+    // This function is called from background jobs, so an exception must not escape a
+    // chunk; the positions of a chunk that failed are left at their previous values
+    auto sampleChunk = [&sampler, &times, vertices](size_t chunk) {
+        const size_t begin = chunk * SampleChunkSize;
+        const size_t end = std::min(begin + SampleChunkSize, times.size());
+        const std::vector<double> chunkTimes(times.begin() + begin, times.begin() + end);
+        try {
+            const std::vector<glm::dvec3> positions = sampler(chunkTimes);
+            for (size_t i = 0; i < positions.size(); ++i) {
+                const glm::vec3 p = positions[i];
+                vertices[begin + i] = { p.x, p.y, p.z };
+            }
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.message);
+        }
+    };
+    auto cancelled = [isCancelled]() { return isCancelled && *isCancelled; };
+
+    const size_t nChunks = (times.size() + SampleChunkSize - 1) / SampleChunkSize;
+    if (_translation->requiresMainThreadUpdate()) {
+        for (size_t i = 0; i < nChunks; ++i) {
+            if (cancelled()) {
+                return false;
+            }
+            sampleChunk(i);
+        }
+        return true;
+    }
+
+    // Cancelled chunks are skipped, which lets the remaining chunks finish quickly
+    global::jobSystem.parallelFor(
+        nChunks,
+        [&sampleChunk, &cancelled](size_t i) {
+            if (!cancelled()) {
+                sampleChunk(i);
+            }
+        }
+    );
+    return !cancelled();
+}
+
 void RenderableTrail::internalRender(bool renderLines, bool renderPoints,
                                      const RenderData& data,
                                      const glm::dmat4& modelTransform, 
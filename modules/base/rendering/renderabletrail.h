@@ -33,9 +33,12 @@
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/vector/vec3property.h>
+#include <openspace/scene/translation.h>
 #include <ghoul/misc/managedmemoryuniqueptr.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
+#include <atomic>
+#include <vector>
 
 namespace ghoul::opengl {
     class ProgramObject;
@@ -46,8 +49,6 @@ namespace openspace {
 
 namespace documentation { struct Documentation; }
 
-class Translation;
-
 /**
  * This is the base class for a trail that is drawn behind an arbitrary object. The two
  * concreate implementations are RenderableTrailOrbit, for objects that have a (roughly)
@@ -117,6 +118,26 @@ protected:
         float x, y, z;
     };
 
+    /**
+     * Writes the positions of the #_translation at the \p times into the \p vertices,
+     * which must have room for as many values as there are \p times. If the Translation
+     * can be evaluated on any thread, the times are split into chunks that are sampled
+     * concurrently on the JobSystem. The calling thread takes part in the sampling, so
+     * this function can be called from a job as well.
+     *
+     * \param sampler The Translation::positionSampler of the #_translation, which has
+     *        to be created on the main thread
+     * \param times The times in seconds past the J2000 epoch
+     * \param vertices The destination for the positions
+     * \param isCancelled If this is provided and becomes \c true, the remaining chunks
+     *        are skipped
+     * \return \c true if all positions were sampled, \c false if the sampling was
+     *         cancelled
+     */
+    bool samplePositions(const Translation::PositionSampler& sampler,
+        const std::vector<double>& times, TrailVBOLayout* vertices,
+        const std::atomic<bool>* isCancelled = nullptr) const;
+
     /// The backend storage for the vertex buffer object containing all points for this
     /// trail.
     std::vector<TrailVBOLayout> _vertexArray;
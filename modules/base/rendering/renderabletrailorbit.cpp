@@ -513,17 +513,16 @@ void RenderableTrailOrbit::fullSweep(double time) {
 
     const double secondsPerPoint = _period / (_resolution - 1);
     // starting at 1 because the first position is a floating current one
-    for (int i = 1; i < _resolution; ++i) {
-        const glm::vec3 p = _translation->position({ {}, Time(time), Time(0.0) });
-        _vertexArray[i] = { p.x, p.y, p.z };
-
-        time -= secondsPerPoint;
+    std::vector<double> times(_resolution - 1);
+    for (size_t i = 0; i < times.size(); ++i) {
+        times[i] = time - i * secondsPerPoint;
     }
+    samplePositions(_translation->positionSampler(), times, _vertexArray.data() + 1);
 
     _primaryRenderInformation.first = 0;
     _primaryRenderInformation.count = _resolution;
 
-    _firstPointTime = time + secondsPerPoint;
+    _firstPointTime = times.empty() ? time : times.back();
     _needsFullSweep = false;
 }
 
@@ -26,9 +26,16 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
 #include <openspace/scene/translation.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/updatestructures.h>
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 
 // This class creates the entire trajectory at once and keeps it in memory the entire
 // time. This means that there is no need for updating the trail at runtime, but also that
@@ -41,8 +48,23 @@
 // bucket that contains the line from the last shown point to the current location of the
 // object iff not the entire path is shown and the object is between _startTime and
 // _endTime. This buffer is updated every frame.
+// Long trails are not sampled in the update function directly. Instead, a coarse preview
+// with PreviewSamples vertices is sampled immediately and the full trail is sampled by a
+// background job of the JobSystem. Whenever the full sweep has finished, its vertices
+// replace the preview. A new sweep (for example caused by a property change) cancels the
+// sweep that is currently running.
 
 namespace {
+    constexpr const char* _loggerCat = "RenderableTrailTrajectory";
+
+    // Trails with fewer samples than this are sampled directly in the update function
+    constexpr const int MinimumBackgroundSamples = 16384;
+
+    // The number of samples that are used to preview the trail during a background sweep
+    constexpr const int PreviewSamples = 512;
+
+    constexpr const int8_t CurrentCacheVersion = 1;
+
     constexpr openspace::properties::Property::PropertyInfo StartTimeInfo = {
         "StartTime",
         "Start Time",
@@ -81,6 +103,70 @@ namespace {
         "If this value is set to 'true', the entire trail will be rendered; if it is "
         "'false', only the trail until the current time in the application will be shown."
     };
+
+    constexpr const char* KeyCache = "Cache";
+
+    bool loadCachedFile(const std::string& file,
+                        std::vector<openspace::RenderableTrail::TrailVBOLayout>& vertices)
+    {
+        std::ifstream fileStream(file, std::ifstream::binary);
+        if (!fileStream.good()) {
+            return false;
+        }
+
+        int8_t version = 0;
+        fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
+        if (version != CurrentCacheVersion) {
+            LINFO("The format of the cached file has changed: deleting old cache");
+            fileStream.close();
+            FileSys.deleteFile(file);
+            return false;
+        }
+
+        uint64_t nVertices = 0;
+        fileStream.read(reinterpret_cast<char*>(&nVertices), sizeof(uint64_t));
+
+        // A truncated or corrupted cache file must not make us allocate more vertices
+        // than the file can hold
+        constexpr const uint64_t HeaderSize = sizeof(int8_t) + sizeof(uint64_t);
+        std::error_code ec;
+        const uint64_t fileSize = std::filesystem::file_size(file, ec);
+        if (!fileStream.good() || ec || fileSize < HeaderSize ||
+            nVertices > (fileSize - HeaderSize) /
+                        sizeof(openspace::RenderableTrail::TrailVBOLayout))
+        {
+            LWARNING(fmt::format("Cached file '{}' is corrupted: ignoring it", file));
+            return false;
+        }
+
+        vertices.resize(nVertices);
+        fileStream.read(
+            reinterpret_cast<char*>(vertices.data()),
+            nVertices * sizeof(openspace::RenderableTrail::TrailVBOLayout)
+        );
+        return fileStream.good();
+    }
+
+    void saveCachedFile(const std::string& file,
+                  const std::vector<openspace::RenderableTrail::TrailVBOLayout>& vertices)
+    {
+        std::ofstream fileStream(file, std::ofstream::binary);
+        if (!fileStream.good()) {
+            LERROR(fmt::format("Error opening file '{}' for save cache file", file));
+            return;
+        }
+
+        fileStream.write(
+            reinterpret_cast<const char*>(&CurrentCacheVersion),
+            sizeof(int8_t)
+        );
+        const uint64_t nVertices = vertices.size();
+        fileStream.write(reinterpret_cast<const char*>(&nVertices), sizeof(uint64_t));
+        fileStream.write(
+            reinterpret_cast<const char*>(vertices.data()),
+            nVertices * sizeof(openspace::RenderableTrail::TrailVBOLayout)
+        );
+    }
 } // namespace
 
 namespace openspace {
@@ -121,6 +207,17 @@ documentation::Documentation RenderableTrailTrajectory::Documentation() {
                 new BoolVerifier,
                 Optional::Yes,
                 RenderFullPathInfo.description
+            },
+            {
+                KeyCache,
+                new BoolVerifier,
+                Optional::Yes,
+                "If this value is set to 'true', the sampled trail is stored in the "
+                "cache and reused the next time the trail is sampled with the same "
+                "parameters of the translation and the same time range. Changes to "
+                "loaded data, such as SPICE kernels, are not detected, so this should "
+                "only be enabled for trails whose data does not change. The default "
+                "value is 'false'."
             }
         }
     };
@@ -145,6 +242,7 @@ RenderableTrailTrajectory::RenderableTrailTrajectory(const ghoul::Dictionary& di
     , _sampleInterval(SampleIntervalInfo, 2.0, 2.0, 1e6)
     , _timeStampSubsamplingFactor(TimeSubSampleInfo, 1, 1, 1000000000)
     , _renderFullTrail(RenderFullPathInfo, false)
+    , _sweepKey(global::jobSystem.createKey())
 {
     documentation::testSpecificationAndThrow(
         Documentation(),
@@ -152,18 +250,25 @@ RenderableTrailTrajectory::RenderableTrailTrajectory(const ghoul::Dictionary& di
         "RenderableTrailTrajectory"
     );
 
-    _translation->onParameterChange([this]() { _needsFullSweep = true; });
+    // A sweep that is running in the background samples with the old parameters, so it
+    // has to be stopped before the parameters are changed
+    auto requestFullSweep = [this]() {
+        cancelFullSweep();
+        _needsFullSweep = true;
+    };
+
+    _translation->onParameterChange(requestFullSweep);
 
     _startTime = dictionary.value<std::string>(StartTimeInfo.identifier);
-    _startTime.onChange([this] { _needsFullSweep = true; });
+    _startTime.onChange(requestFullSweep);
     addProperty(_startTime);
 
     _endTime = dictionary.value<std::string>(EndTimeInfo.identifier);
-    _endTime.onChange([this] { _needsFullSweep = true; });
+    _endTime.onChange(requestFullSweep);
     addProperty(_endTime);
 
     _sampleInterval = dictionary.value<double>(SampleIntervalInfo.identifier);
-    _sampleInterval.onChange([this] { _needsFullSweep = true; });
+    _sampleInterval.onChange(requestFullSweep);
     addProperty(_sampleInterval);
 
     if (dictionary.hasKeyAndValue<double>(TimeSubSampleInfo.identifier)) {
@@ -179,10 +284,19 @@ RenderableTrailTrajectory::RenderableTrailTrajectory(const ghoul::Dictionary& di
     }
     addProperty(_renderFullTrail);
 
+    if (dictionary.hasKeyAndValue<bool>(KeyCache)) {
+        _useCache = dictionary.value<bool>(KeyCache);
+    }
+
     // We store the vertices with ascending temporal order
     _primaryRenderInformation.sorting = RenderInformation::VertexSorting::OldestFirst;
 }
 
+RenderableTrailTrajectory::~RenderableTrailTrajectory() {
+    // The background job accesses the translation, so it has to finish before we go away
+    cancelFullSweep();
+}
+
 void RenderableTrailTrajectory::initializeGL() {
     RenderableTrail::initializeGL();
 
@@ -198,6 +312,8 @@ void RenderableTrailTrajectory::initializeGL() {
 }
 
 void RenderableTrailTrajectory::deinitializeGL() {
+    cancelFullSweep();
+
     glDeleteVertexArrays(1, &_primaryRenderInformation._vaoID);
     glDeleteBuffers(1, &_primaryRenderInformation._vBufferID);
 
@@ -207,52 +323,161 @@ void RenderableTrailTrajectory::deinitializeGL() {
     RenderableTrail::deinitializeGL();
 }
 
-void RenderableTrailTrajectory::update(const UpdateData& data) {
-    if (_needsFullSweep) {
-        // Convert the start and end time from string representations to J2000 seconds
-        _start = SpiceManager::ref().ephemerisTimeFromDate(_startTime);
-        _end = SpiceManager::ref().ephemerisTimeFromDate(_endTime);
+void RenderableTrailTrajectory::startFullSweep() {
+    cancelFullSweep();
 
-        const double totalSampleInterval = _sampleInterval / _timeStampSubsamplingFactor;
-        // How many values do we need to compute given the distance between the start and
-        // end date and the desired sample interval
-        const int nValues = static_cast<int>((_end - _start) / totalSampleInterval);
+    // Convert the start and end time from string representations to J2000 seconds
+    _start = SpiceManager::ref().ephemerisTimeFromDate(_startTime);
+    _end = SpiceManager::ref().ephemerisTimeFromDate(_endTime);
+
+    const double totalSampleInterval = _sampleInterval / _timeStampSubsamplingFactor;
+    // How many values do we need to compute given the distance between the start and
+    // end date and the desired sample interval
+    const int nValues = std::max(
+        static_cast<int>((_end - _start) / totalSampleInterval),
+        0
+    );
 
-        // Make space for the vertices
+    std::vector<double> times(nValues);
+    for (int i = 0; i < nValues; ++i) {
+        times[i] = _start + i * totalSampleInterval;
+    }
+
+    std::string cacheFile;
+    if (_useCache) {
+        cacheFile = FileSys.cacheManager()->cachedFilename(
+            "RenderableTrailTrajectory",
+            cacheInformation(),
+            ghoul::filesystem::CacheManager::Persistent::Yes
+        );
+        if (FileSys.fileExists(cacheFile) && loadCachedFile(cacheFile, _vertexArray) &&
+            _vertexArray.size() == static_cast<size_t>(nValues))
+        {
+            uploadVertices();
+            return;
+        }
+    }
+
+    // Translations that have to be updated on the main thread can't be sampled in the
+    // background and short trails are not worth the added latency of a background job
+    if (_translation->requiresMainThreadUpdate() || nValues < MinimumBackgroundSamples) {
         _vertexArray.clear();
         _vertexArray.resize(nValues);
-
-        // ... fill all of the values
-        for (int i = 0; i < nValues; ++i) {
-            const glm::vec3 p = _translation->position({
-                {},
-                Time(_start + i * totalSampleInterval),
-                Time(0.0)
-            });
-            _vertexArray[i] = { p.x, p.y, p.z };
+        samplePositions(_translation->positionSampler(), times, _vertexArray.data());
+        if (!cacheFile.empty()) {
+            saveCachedFile(cacheFile, _vertexArray);
         }
+        uploadVertices();
+        return;
+    }
 
-        // ... and upload them to the GPU
-        glBindVertexArray(_primaryRenderInformation._vaoID);
-        glBindBuffer(GL_ARRAY_BUFFER, _primaryRenderInformation._vBufferID);
-        glBufferData(
-            GL_ARRAY_BUFFER,
-            _vertexArray.size() * sizeof(TrailVBOLayout),
-            _vertexArray.data(),
-            GL_STATIC_DRAW
-        );
+    // Show a coarse preview of the entire trail while the full sweep is being computed
+    std::vector<double> previewTimes(PreviewSamples);
+    for (int i = 0; i < PreviewSamples; ++i) {
+        previewTimes[i] = _start + (_end - _start) * i / (PreviewSamples - 1);
+    }
+    _vertexArray.clear();
+    _vertexArray.resize(PreviewSamples);
+    const Translation::PositionSampler sampler = _translation->positionSampler();
+    samplePositions(sampler, previewTimes, _vertexArray.data());
+    uploadVertices();
+
+    _sweep = std::make_shared<Sweep>();
+    _sweep->times = std::move(times);
+    _sweep->vertices.resize(nValues);
+
+    // If the job is cancelled before it starts, the promise is destroyed together with
+    // the job, which makes the future ready as well
+    auto promise = std::make_shared<std::promise<void>>();
+    _sweepResult = promise->get_future();
+    // The job only uses the sampler, which was created here on the main thread, so the
+    // translation can be changed while the sweep is running
+    global::jobSystem.enqueue(
+        [this, sweep = _sweep, promise, sampler, cacheFile]() {
+            const bool isComplete = samplePositions(
+                sampler,
+                sweep->times,
+                sweep->vertices.data(),
+                &sweep->isCancelled
+            );
+            if (isComplete && !cacheFile.empty()) {
+                saveCachedFile(cacheFile, sweep->vertices);
+            }
+            promise->set_value();
+        },
+        JobSystem::Priority::Background,
+        _sweepKey
+    );
+}
 
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+void RenderableTrailTrajectory::cancelFullSweep() {
+    if (!_sweep) {
+        return;
+    }
 
-        // We clear the indexArray just in case. The base class will take care not to use
-        // it if it is empty
-        _indexArray.clear();
+    _sweep->isCancelled = true;
+    global::jobSystem.cancel(_sweepKey);
+    _sweepResult.wait();
+    _sweepResult = std::future<void>();
+    _sweep = nullptr;
+}
+
+void RenderableTrailTrajectory::uploadVertices() {
+    glBindVertexArray(_primaryRenderInformation._vaoID);
+    glBindBuffer(GL_ARRAY_BUFFER, _primaryRenderInformation._vBufferID);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        _vertexArray.size() * sizeof(TrailVBOLayout),
+        _vertexArray.data(),
+        GL_STATIC_DRAW
+    );
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    // We clear the indexArray just in case. The base class will take care not to use
+    // it if it is empty
+    _indexArray.clear();
+
+    _subsamplingIsDirty = true;
+}
+
+std::string RenderableTrailTrajectory::cacheInformation() const {
+    std::string info = fmt::format(
+        "{}|{}|{}",
+        _startTime.value(),
+        _endTime.value(),
+        _sampleInterval / _timeStampSubsamplingFactor
+    );
+    for (const properties::Property* p : _translation->propertiesRecursive()) {
+        info += fmt::format("|{}={}", p->fullyQualifiedIdentifier(), p->getStringValue());
+    }
+    return info;
+}
 
-        _subsamplingIsDirty = true;
+void RenderableTrailTrajectory::update(const UpdateData& data) {
+    if (_needsFullSweep) {
+        startFullSweep();
         _needsFullSweep = false;
     }
 
+    const bool hasFinishedSweep = _sweep &&
+        _sweepResult.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    if (hasFinishedSweep) {
+        // Replace the preview with the full trail
+        _vertexArray = std::move(_sweep->vertices);
+        _sweepResult = std::future<void>();
+        _sweep = nullptr;
+        uploadVertices();
+    }
+
+    if (_vertexArray.empty()) {
+        _primaryRenderInformation.count = 0;
+        _floatingRenderInformation.count = 0;
+        setBoundingSphere(0.f);
+        return;
+    }
+
     // This has to be done every update step;
     if (_renderFullTrail) {
         // If the full trail should be rendered at all times, we can directly render the
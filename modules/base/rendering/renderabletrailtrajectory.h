@@ -31,7 +31,11 @@
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/doubleproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
+#include <openspace/util/jobsystem.h>
 #include <array>
+#include <atomic>
+#include <future>
+#include <memory>
 
 namespace openspace {
 
@@ -47,10 +51,16 @@ namespace documentation { struct Documentation; }
  * trail in the future. If _renderFullTrail is false, the current position of the object
  * has to be updated constantly to make the trail connect to the object that has the
  * trail.
+ *
+ * Long trails are sampled in the background: a coarse preview of the trail is shown
+ * immediately and replaced by the full trail once all samples have been computed. If
+ * caching is enabled, the sampled trail is stored on disk and reused as long as the
+ * parameters of the translation and the time range do not change.
  */
 class RenderableTrailTrajectory : public RenderableTrail {
 public:
     explicit RenderableTrailTrajectory(const ghoul::Dictionary& dictionary);
+    ~RenderableTrailTrajectory() override;
 
     void initializeGL() override;
     void deinitializeGL() override;
@@ -60,6 +70,29 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    /// The state of a full sweep of the trail that is sampled in the background
+    struct Sweep {
+        std::vector<TrailVBOLayout> vertices;
+        std::vector<double> times;
+        std::atomic<bool> isCancelled = false;
+    };
+
+    /**
+     * Samples the trail between the _startTime and the _endTime. The trail is either
+     * loaded from the cache, sampled directly, or previewed with a coarse set of samples
+     * while the full sweep is computed in the background.
+     */
+    void startFullSweep();
+
+    /// Cancels a running background sweep and waits until it no longer runs
+    void cancelFullSweep();
+
+    /// Uploads the contents of the _vertexArray to the GPU
+    void uploadVertices();
+
+    /// Returns a string that uniquely describes the translation and the time range
+    std::string cacheInformation() const;
+
     /// The start time of the trail
     properties::StringProperty _startTime;
     /// The end time of the trail
@@ -84,6 +117,16 @@ private:
     double _start = 0.0;
     /// The conversion of the _endTime into the internal time format
     double _end = 0.0;
+
+    /// Determines whether sampled trails are stored in and loaded from the cache
+    bool _useCache = false;
+
+    /// The sweep that is currently sampled in the background or nullptr
+    std::shared_ptr<Sweep> _sweep;
+    /// Becomes ready when the background job of the _sweep has finished
+    std::future<void> _sweepResult;
+    /// The key with which background sweeps are enqueued in the JobSystem
+    JobSystem::Key _sweepKey;
 };
 
 } // namespace openspace
@@ -750,4 +750,9 @@ glm::vec3 FixedRotation::zAxis() const {
     }
 }
 
+bool FixedRotation::requiresMainThreadUpdate() const {
+    // The rotation depends on the positions of other, unrelated scene graph nodes
+    return true;
+}
+
 } // namespace openspace
@@ -137,4 +137,9 @@ glm::dmat3 LuaRotation::matrix(const UpdateData& data) const {
     return glm::make_mat3(values);
 }
 
+bool LuaRotation::requiresMainThreadUpdate() const {
+    // The Lua state must only be accessed from a single thread
+    return true;
+}
+
 } // namespace openspace
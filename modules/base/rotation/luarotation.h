@@ -43,6 +43,7 @@ public:
     LuaRotation(const ghoul::Dictionary& dictionary);
 
     glm::dmat3 matrix(const UpdateData& data) const override;
+    bool requiresMainThreadUpdate() const override;
 
     static documentation::Documentation Documentation();
 
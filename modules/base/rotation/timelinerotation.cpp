@@ -115,4 +115,9 @@ glm::dmat3 TimelineRotation::matrix(const UpdateData& data) const {
     return glm::dmat3(glm::slerp(prevRot, nextRot, t));
 }
 
+bool TimelineRotation::requiresMainThreadUpdate() const {
+    // The keyframes can be of any rotation type
+    return true;
+}
+
 } // namespace openspace
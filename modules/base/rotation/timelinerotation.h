@@ -38,6 +38,7 @@ class TimelineRotation : public Rotation {
 public:
     TimelineRotation(const ghoul::Dictionary& dictionary);
     glm::dmat3 matrix(const UpdateData& data) const override;
+    bool requiresMainThreadUpdate() const override;
     static documentation::Documentation Documentation();
 
 private:
@@ -127,4 +127,9 @@ glm::dvec3 LuaScale::scaleValue(const UpdateData& data) const {
     return glm::dvec3(x, y, z);
 }
 
+bool LuaScale::requiresMainThreadUpdate() const {
+    // The Lua state must only be accessed from a single thread
+    return true;
+}
+
 } // namespace openspace
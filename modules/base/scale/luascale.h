@@ -42,6 +42,7 @@ public:
     LuaScale(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 scaleValue(const UpdateData& data) const override;
+    bool requiresMainThreadUpdate() const override;
 
     static documentation::Documentation Documentation();
 
@@ -143,4 +143,9 @@ glm::dvec3 LuaTranslation::position(const UpdateData& data) const {
     return glm::make_vec3(values);
 }
 
+bool LuaTranslation::requiresMainThreadUpdate() const {
+    // The Lua state must only be accessed from a single thread
+    return true;
+}
+
 } // namespace openspace
@@ -43,6 +43,7 @@ public:
     LuaTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    bool requiresMainThreadUpdate() const override;
 
     static documentation::Documentation Documentation();
 
@@ -111,4 +111,9 @@ glm::dvec3 TimelineTranslation::position(const UpdateData& data) const {
     return t * next->data->position(data) + (1.0 - t) * prev->data->position(data);
 }
 
+bool TimelineTranslation::requiresMainThreadUpdate() const {
+    // The keyframes can be of any translation type
+    return true;
+}
+
 } // namespace openspace
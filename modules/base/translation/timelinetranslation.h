@@ -40,6 +40,7 @@ public:
     TimelineTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    bool requiresMainThreadUpdate() const override;
     static documentation::Documentation Documentation();
 
 private:
@@ -30,6 +30,7 @@
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/util/updatestructures.h>
+#include <openspace/util/speckfile.h>
 #include <openspace/rendering/renderengine.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -1271,94 +1272,19 @@ bool RenderableBillboardsCloud::loadLabelData() {
 }
 
 bool RenderableBillboardsCloud::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
+    SpeckFile file(_speckFile);
+    if (!file.isOpen()) {
         LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
         return false;
     }
 
-    _nValuesPerAstronomicalObject = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture" &&
-            line.substr(0, 10) != "polyorivar" &&
-            line.substr(0, 10) != "maxcomment")
-        {
-            // Started reading data
-            break;
-        }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy; // command
-            str >> _nValuesPerAstronomicalObject; // variable index
-            dummy.clear();
-            str >> dummy; // variable name
-
-            _variableDataPositionMap.insert({ dummy, _nValuesPerAstronomicalObject });
-
-            // We want the number, but the index is 0 based
-            _nValuesPerAstronomicalObject += 1;
-        }
+    for (const SpeckFile::Variable& variable : file.variables()) {
+        _variableDataPositionMap.insert({ variable.name, variable.index });
     }
+    _nValuesPerAstronomicalObject = file.nValuesPerObject();
 
-    _nValuesPerAstronomicalObject += 3; // X Y Z are not counted in the Speck file indices
-
-
-
-    do {
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
-
-        if (line.empty()) {
-            std::getline(file, line);
-            continue;
-        }
-        else if (line[0] == '#') {
-            std::getline(file, line);
-            continue;
-        }
-
-        std::stringstream str(line);
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        for (int i = 0; i < _nValuesPerAstronomicalObject; ++i) {
-            str >> values[i];
-        }
-
-        _fullData.insert(_fullData.end(), values.begin(), values.end());
-
-        // reads new line
-        std::getline(file, line);
-    } while (!file.eof());
+    std::vector<float> data = file.readData(_nValuesPerAstronomicalObject);
+    _fullData.insert(_fullData.end(), data.begin(), data.end());
 
     return true;
 }
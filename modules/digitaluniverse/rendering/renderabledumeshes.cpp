@@ -31,6 +31,7 @@
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/speckfile.h>
 #include <ghoul/glm.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/font/fontmanager.h>
@@ -619,126 +620,93 @@ bool RenderableDUMeshes::loadData() {
 }
 
 bool RenderableDUMeshes::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
+    SpeckFile file(_speckFile);
+    if (!file.isOpen()) {
         LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
         return false;
     }
 
     int meshIndex = 0;
 
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (file.eof()) {
-            break;
-        }
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
-
+    std::string_view text = file.dataSection();
+    while (!text.empty()) {
+        std::string_view line = speck::nextLine(text);
         if (line.empty() || line[0] == '#') {
             continue;
         }
 
-        std::size_t found = line.find("mesh");
-        if (found == std::string::npos) {
-        //if (line.substr(0, 4) != "mesh") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            //file.seekg(position);
-            //break;
+        if (line.find("mesh") == std::string_view::npos) {
             continue;
         }
-        else {
 
-        //if (line.substr(0, 4) == "mesh") {
-            // mesh lines are structured as follows:
-            // mesh -t texnum -c colorindex -s style {
-            // where textnum is the index of the texture;
-            // colorindex is the index of the color for the mesh
-            // and style is solid, wire or point (for now we support only wire)
-            std::stringstream str(line);
+        // mesh lines are structured as follows:
+        // mesh -t texnum -c colorindex -s style {
+        // where textnum is the index of the texture;
+        // colorindex is the index of the color for the mesh
+        // and style is solid, wire or point (for now we support only wire)
+        std::stringstream str{ std::string(line) };
 
-            RenderingMesh mesh;
-            mesh.meshIndex = meshIndex;
+        RenderingMesh mesh;
+        mesh.meshIndex = meshIndex;
 
-            std::string dummy;
-            str >> dummy; // mesh command
-            dummy.clear();
-            str >> dummy; // texture index command?
-            do {
-                if (dummy == "-t") {
-                    dummy.clear();
-                    str >> mesh.textureIndex; // texture index
-                }
-                else if (dummy == "-c") {
-                    dummy.clear();
-                    str >> mesh.colorIndex; // color index command
+        std::string dummy;
+        str >> dummy; // mesh command
+        dummy.clear();
+        str >> dummy; // texture index command?
+        do {
+            if (dummy == "-t") {
+                dummy.clear();
+                str >> mesh.textureIndex; // texture index
+            }
+            else if (dummy == "-c") {
+                dummy.clear();
+                str >> mesh.colorIndex; // color index command
+            }
+            else if (dummy == "-s") {
+                dummy.clear();
+                str >> dummy; // style value command
+                if (dummy == "solid") {
+                    mesh.style = Solid;
                 }
-                else if (dummy == "-s") {
-                    dummy.clear();
-                    str >> dummy; // style value command
-                    if (dummy == "solid") {
-                        mesh.style = Solid;
-                    }
-                    else if (dummy == "wire") {
-                        mesh.style = Wire;
-                    }
-                    else if (dummy == "point") {
-                        mesh.style = Point;
-                    }
-                    else {
-                        mesh.style = INVALID;
-                        break;
-                    }
+                else if (dummy == "wire") {
+                    mesh.style = Wire;
                 }
-                dummy.clear();
-                str >> dummy;
-            } while (dummy != "{");
-
-            std::getline(file, line);
-            std::stringstream dim(line);
-            dim >> mesh.numU; // numU
-            dim >> mesh.numV; // numV
-
-            // We can now read the vertices data:
-            for (int l = 0; l < mesh.numU * mesh.numV; ++l) {
-                std::getline(file, line);
-                if (line.substr(0, 1) != "}") {
-                    std::stringstream lineData(line);
-                    for (int i = 0; i < 7; ++i) {
-                        GLfloat value;
-                        lineData >> value;
-                        bool errorReading = lineData.rdstate() & std::ifstream::failbit;
-                        if (!errorReading) {
-                            mesh.vertices.push_back(value);
-                        }
-                        else {
-                            break;
-                        }
-                    }
+                else if (dummy == "point") {
+                    mesh.style = Point;
                 }
                 else {
+                    mesh.style = INVALID;
                     break;
                 }
             }
-
-            std::getline(file, line);
-            if (line.substr(0, 1) == "}") {
-                _renderingMeshesMap.insert({ meshIndex++, mesh });
-            }
-            else {
-                return false;
+            dummy.clear();
+            str >> dummy;
+        } while (dummy != "{");
+
+        std::array<float, 2> dimensions = { 0.f, 0.f };
+        speck::parseNumbers(speck::nextLine(text), dimensions.data(), dimensions.size());
+        mesh.numU = static_cast<int>(dimensions[0]);
+        mesh.numV = static_cast<int>(dimensions[1]);
+
+        // We can now read the vertices data:
+        mesh.vertices.reserve(static_cast<size_t>(mesh.numU * mesh.numV) * 7);
+        for (int l = 0; l < mesh.numU * mesh.numV; ++l) {
+            line = speck::nextLine(text);
+            if (!line.empty() && line[0] == '}') {
+                break;
             }
+
+            std::array<float, 7> v;
+            const size_t nValues = speck::parseNumbers(line, v.data(), v.size());
+            mesh.vertices.insert(mesh.vertices.end(), v.begin(), v.begin() + nValues);
+        }
+
+        line = speck::nextLine(text);
+        if (!line.empty() && line[0] == '}') {
+            _renderingMeshesMap.insert({ meshIndex++, mesh });
+        }
+        else {
+            return false;
         }
     }
 
@@ -29,6 +29,7 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/speckfile.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/font/fontmanager.h>
@@ -847,189 +848,50 @@ bool RenderablePlanesCloud::loadTextures() {
 }
 
 bool RenderablePlanesCloud::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
+    SpeckFile file(_speckFile);
+    if (!file.isOpen()) {
         LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
         return false;
     }
 
     _nValuesPerAstronomicalObject = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture" &&
-            line.substr(0, 10) != "polyorivar" &&
-            line.substr(0, 10) != "maxcomment")
-        {
-            // Started reading data
-            break;
-        }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy; // command
-            str >> _nValuesPerAstronomicalObject; // variable index
-            dummy.clear();
-            str >> dummy; // variable name
-
-            // +3 because of the x, y and z at the begining of each line.
-            _variableDataPositionMap.insert({ dummy, _nValuesPerAstronomicalObject + 3});
-
-            if ((dummy == "orientation") || (dummy == "ori")) { // 3d vectors u and v
-                // We want the number, but the index is 0 based
-                _nValuesPerAstronomicalObject += 6;
-            }
-            else {
-                // We want the number, but the index is 0 based
-                _nValuesPerAstronomicalObject += 1;
-            }
-        }
-
-        if (line.substr(0, 10) == "polyorivar") {
-            _planeStartingIndexPos = 0;
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy; // command
-            str >> _planeStartingIndexPos;
-            _planeStartingIndexPos += 3; // 3 for xyz
-        }
-
-        if (line.substr(0, 10) == "texturevar") {
-            _textureVariableIndex = 0;
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy; // command
-            str >> _textureVariableIndex;
-            _textureVariableIndex += 3; // 3 for xyz
-        }
-
-        if (line.substr(0, 8) == "texture ") {
-            std::stringstream str(line);
-
-            std::size_t found = line.find('-');
-
-            int textureIndex = 0;
-
-            std::string dummy;
-            str >> dummy; // command
-
-            if (found != std::string::npos) {
-                std::string option; // Not being used right now.
-                str >> option;
-            }
-
-            str >> textureIndex;
-            std::string fileName;
-            str >> fileName; // texture file name
-
-            std::string fullPath = absPath(_texturesPath + '/' + fileName);
-            std::string pngPath =
-                ghoul::filesystem::File(fullPath).fullBaseName() + ".png";
-
-            if (FileSys.fileExists(fullPath)) {
-                _textureFileMap.insert({ textureIndex, fullPath });
-
-            }
-            else if (FileSys.fileExists(pngPath)) {
-                _textureFileMap.insert({ textureIndex, pngPath });
-            }
-            else {
-                LWARNING(fmt::format("Could not find image file {}", fileName));
-                _textureFileMap.insert({ textureIndex, "" });
-            }
-        }
+    for (const SpeckFile::Variable& variable : file.variables()) {
+        // +3 because of the x, y and z at the begining of each line.
+        _variableDataPositionMap.insert({ variable.name, variable.index + 3 });
+
+        // 3d vectors u and v occupy six values
+        const int nValues = (variable.name == "orientation" || variable.name == "ori") ?
+            6 :
+            1;
+        _nValuesPerAstronomicalObject = variable.index + nValues;
     }
-
     _nValuesPerAstronomicalObject += 3; // X Y Z are not counted in the Speck file indices
 
-    do {
+    if (file.polygonOrientationVariable() != -1) {
+        _planeStartingIndexPos = file.polygonOrientationVariable() + 3; // 3 for xyz
+    }
+    if (file.textureVariable() != -1) {
+        _textureVariableIndex = file.textureVariable() + 3; // 3 for xyz
+    }
 
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
+    for (const SpeckFile::Texture& texture : file.textures()) {
+        std::string fullPath = absPath(_texturesPath + '/' + texture.file);
+        std::string pngPath = ghoul::filesystem::File(fullPath).fullBaseName() + ".png";
 
-        if (line.empty()) {
-            std::getline(file, line);
-            continue;
+        if (FileSys.fileExists(fullPath)) {
+            _textureFileMap.insert({ texture.index, fullPath });
         }
-        else if (line[0] == '#') {
-            std::getline(file, line);
-            continue;
+        else if (FileSys.fileExists(pngPath)) {
+            _textureFileMap.insert({ texture.index, pngPath });
         }
-
-        std::stringstream str(line);
-
-        glm::vec3 u(0.f);
-        glm::vec3 v(0.f);
-        int textureIndex = 0;
-
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        for (int i = 0; i < _nValuesPerAstronomicalObject; ++i) {
-            str >> values[i];
-            if ((i >= _planeStartingIndexPos) &&
-                (i <= _planeStartingIndexPos + 6)) { // vectors u and v
-                int index = i - _planeStartingIndexPos;
-                switch (index) {
-                    case 0:
-                        u.x = values[i];
-                        break;
-                    case 1:
-                        u.y = values[i];
-                        break;
-                    case 2:
-                        u.z = values[i];
-                        break;
-                    case 3:
-                        v.x = values[i];
-                        break;
-                    case 4:
-                        v.y = values[i];
-                        break;
-                    case 5:
-                        v.z = values[i];
-                        break;
-                }
-            }
-
-            // JCC: This should be moved to the RenderablePlanesCloud:
-            if (i == _textureVariableIndex) {
-                textureIndex = static_cast<int>(values[i]);
-            }
+        else {
+            LWARNING(fmt::format("Could not find image file {}", texture.file));
+            _textureFileMap.insert({ texture.index, "" });
         }
-        _fullData.insert(_fullData.end(), values.begin(), values.end());
+    }
 
-        // reads new line
-        std::getline(file, line);
-    } while (!file.eof());
+    std::vector<float> data = file.readData(_nValuesPerAstronomicalObject);
+    _fullData.insert(_fullData.end(), data.begin(), data.end());
 
     return true;
 }
@@ -29,6 +29,7 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/speckfile.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -465,68 +466,16 @@ bool RenderablePoints::loadData() {
 }
 
 bool RenderablePoints::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
+    SpeckFile file(_speckFile);
+    if (!file.isOpen()) {
         LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
         return false;
     }
 
-    _nValuesPerAstronomicalObject = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (line[0] == '#' || line.empty()) {
-            continue;
-        }
-
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture")
-        {
-            // we read a line that doesn't belong to the header, so we have to jump
-            // back before the beginning of the current line
-            file.seekg(position);
-            break;
-        }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly
-            // overwrite the 'nValues' variable with the latest index, we will end up
-            // with the total number of values (+3 since X Y Z are not counted in the
-            // Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy;
-            str >> _nValuesPerAstronomicalObject;
-            // We want the number, but the index is 0 based
-            _nValuesPerAstronomicalObject += 1;
-        }
-    }
-
-    // X Y Z are not counted in the Speck file indices
-    _nValuesPerAstronomicalObject += 3;
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-        std::stringstream str(line);
-
-        for (int i = 0; i < _nValuesPerAstronomicalObject; ++i) {
-            str >> values[i];
-        }
+    _nValuesPerAstronomicalObject = file.nValuesPerObject();
 
-        _fullData.insert(_fullData.end(), values.begin(), values.end());
-    } while (!file.eof());
+    std::vector<float> data = file.readData(_nValuesPerAstronomicalObject);
+    _fullData.insert(_fullData.end(), data.begin(), data.end());
 
     return true;
 }
@@ -25,6 +25,8 @@
 #include <modules/fieldlinessequence/fieldlinessequencemodule.h>
 
 #include <modules/fieldlinessequence/rendering/renderablefieldlinessequence.h>
+#include <modules/fieldlinessequence/tasks/convertosflstask.h>
+#include <openspace/documentation/documentation.h>
 #include <openspace/util/factorymanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/assert.h>
@@ -61,6 +63,16 @@ void FieldlinesSequenceModule::internalInitialize(const ghoul::Dictionary&) {
     ghoul_assert(factory, "No renderable factory existed");
 
     factory->registerClass<RenderableFieldlinesSequence>("RenderableFieldlinesSequence");
+
+    auto fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "No task factory existed");
+    fTask->registerClass<ConvertOsflsTask>("ConvertOsflsTask");
+}
+
+std::vector<documentation::Documentation>
+FieldlinesSequenceModule::documentations() const
+{
+    return { ConvertOsflsTask::documentation() };
 }
 
 } // namespace openspace
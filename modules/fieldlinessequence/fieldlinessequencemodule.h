@@ -26,6 +26,7 @@
 #define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSEQUENCEMODULE___H__
 
 #include <openspace/util/openspacemodule.h>
+#include <vector>
 
 namespace openspace {
 
@@ -37,6 +38,8 @@ public:
 
     static std::string DefaultTransferFunctionFile;
 
+    std::vector<documentation::Documentation> documentations() const override;
+
 private:
     void internalInitialize(const ghoul::Dictionary&) override;
 };
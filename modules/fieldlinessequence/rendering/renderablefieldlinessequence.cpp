@@ -26,6 +26,7 @@
 
 #include <modules/fieldlinessequence/fieldlinessequencemodule.h>
 #include <modules/fieldlinessequence/util/kameleonfieldlinehelper.h>
+#include <modules/fieldlinessequence/util/osflsfile.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/interaction/navigationhandler.h>
@@ -38,8 +39,8 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
 #include <fstream>
-#include <thread>
 
 namespace {
     constexpr const char* _loggerCat = "RenderableFieldlinesSequence";
@@ -70,6 +71,8 @@ namespace {
     constexpr const char* KeyJsonScalingFactor = "ScaleToMeters";
     // [BOOLEAN] If value False => Load in initializing step and store in RAM
     constexpr const char* KeyOslfsLoadAtRuntime = "LoadAtRuntime";
+    // [INT] Number of states that are loaded ahead of time if LoadAtRuntime is true
+    constexpr const char* KeyOslfsPrefetchStates = "PrefetchStates";
 
     // ---------------------------- OPTIONAL MODFILE KEYS  ---------------------------- //
     // [STRING ARRAY] Values should be paths to .txt files
@@ -87,6 +90,8 @@ namespace {
     constexpr const char* ValueInputFileTypeJson = "json";
     constexpr const char* ValueInputFileTypeOsfls = "osfls";
 
+    constexpr const int DefaultPrefetchStates = 4;
+
     // --------------------------------- Property Info -------------------------------- //
     constexpr openspace::properties::Property::PropertyInfo ColorMethodInfo = {
         "colorMethod",
@@ -213,6 +218,12 @@ namespace {
         "Jump to Start Of Sequence",
         "Performs a time jump to the start of the sequence."
     };
+    constexpr openspace::properties::Property::PropertyInfo PrefetchHitRateInfo = {
+        "prefetchHitRate",
+        "Prefetch Hit Rate",
+        "The ratio of states that were already loaded when they were needed, if the "
+        "states are loaded at runtime."
+    };
 
     enum class SourceFileType : int {
         Cdf = 0,
@@ -234,6 +245,29 @@ namespace {
         }
         return tmp;
     }
+
+    // Returns the number of vertices of the state, whose arrays might be stored in a
+    // memory mapped file
+    size_t nVertices(const openspace::FieldlinesState& state) {
+        const openspace::OsflsFile* file = state.osflsFile();
+        return file ? file->nPoints() : state.vertexPositions().size();
+    }
+
+    // Returns the values of the extra quantity with the provided index without copying
+    // them, or nullptr if the index is out of scope. Quantities that are stored without
+    // encoding in a memory mapped file are read from the file, the others from the state
+    const float* extraQuantityData(const openspace::FieldlinesState& state,
+                                   size_t index)
+    {
+        if (index >= state.nExtraQuantities()) {
+            LERROR("Provided Index was out of scope!");
+            return nullptr;
+        }
+
+        const openspace::OsflsFile* file = state.osflsFile();
+        const float* values = file ? file->extraQuantity(index) : nullptr;
+        return values ? values : state.extraQuantities()[index].data();
+    }
 } // namespace
 
 namespace openspace {
@@ -280,6 +314,7 @@ RenderableFieldlinesSequence::RenderableFieldlinesSequence(
     , _pMaskingQuantity(MaskingQuantityInfo, OptionProperty::DisplayType::Dropdown)
     , _pFocusOnOriginBtn(OriginButtonInfo)
     , _pJumpToStartBtn(TimeJumpButtonInfo)
+    , _pPrefetchHitRate(PrefetchHitRateInfo, 0.f, 0.f, 1.f)
 {
     _dictionary = std::make_unique<ghoul::Dictionary>(dictionary);
 }
@@ -587,6 +622,12 @@ bool RenderableFieldlinesSequence::prepareForOsflsStreaming() {
     _states.push_back(newState);
     _nStates = _startTimes.size();
     _activeStateIndex = 0;
+
+    _stateStreamer = std::make_unique<FieldlinesStateStreamer>(
+        _sourceFiles,
+        _startTimes,
+        _nPrefetchStates
+    );
     return true;
 }
 
@@ -619,6 +660,10 @@ void RenderableFieldlinesSequence::extractOsflsInfoFromDictionary() {
             _identifier, KeyOslfsLoadAtRuntime
         ));
     }
+
+    double nPrefetchStates = DefaultPrefetchStates;
+    _dictionary->getValue(KeyOslfsPrefetchStates, nPrefetchStates);
+    _nPrefetchStates = static_cast<size_t>(std::max(nPrefetchStates, 0.0));
 }
 
 void RenderableFieldlinesSequence::setupProperties() {
@@ -633,6 +678,10 @@ void RenderableFieldlinesSequence::setupProperties() {
     }
     addProperty(_pFocusOnOriginBtn);
     addProperty(_pJumpToStartBtn);
+    if (_loadingStatesDynamically) {
+        _pPrefetchHitRate.setReadOnly(true);
+        addProperty(_pPrefetchHitRate);
+    }
 
     // ----------------------------- Add Property Groups ----------------------------- //
     addPropertySubOwner(_pColorGroup);
@@ -1031,15 +1080,8 @@ void RenderableFieldlinesSequence::deinitializeGL() {
         _shaderProgram = nullptr;
     }
 
-    // Stall main thread until thread that's loading states is done!
-    bool printedWarning = false;
-    while (_isLoadingStateFromDisk) {
-        if (!printedWarning) {
-            LWARNING("Trying to destroy class when an active thread is still using it");
-            printedWarning = true;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
-    }
+    // Waits for the states that are currently being loaded
+    _stateStreamer = nullptr;
 }
 
 bool RenderableFieldlinesSequence::isReady() const {
@@ -1115,12 +1157,17 @@ void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&
             }
         }
 
+        // The line arrays of states that are loaded from version 1 files are used
+        // directly from the memory mapped file
+        const FieldlinesState& state = _states[_activeStateIndex];
+        const OsflsFile* file = state.osflsFile();
+
         glBindVertexArray(_vertexArrayObject);
         glMultiDrawArrays(
             GL_LINE_STRIP, //_drawingOutputType,
-            _states[_activeStateIndex].lineStart().data(),
-            _states[_activeStateIndex].lineCount().data(),
-            static_cast<GLsizei>(_states[_activeStateIndex].lineStart().size())
+            file ? file->lineStart() : state.lineStart().data(),
+            file ? file->lineCount() : state.lineCount().data(),
+            static_cast<GLsizei>(file ? file->nLines() : state.lineStart().size())
         );
 
         glBindVertexArray(0);
@@ -1171,23 +1218,24 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
         _needsUpdate              = false;
     }
 
-    if (_mustLoadNewStateFromDisk) {
-        if (!_isLoadingStateFromDisk && !_newStateIsReady) {
-            _isLoadingStateFromDisk    = true;
-            _mustLoadNewStateFromDisk  = false;
-            std::string filePath = _sourceFiles[_activeTriggerTimeIndex];
-            std::thread readBinaryThread([this, f = std::move(filePath)] {
-                readNewState(f);
-            });
-            readBinaryThread.detach();
-        }
-    }
+    if (_loadingStatesDynamically && _activeTriggerTimeIndex != -1) {
+        _stateStreamer->update(
+            _activeTriggerTimeIndex,
+            currentTime,
+            global::timeManager.deltaTime()
+        );
+        _pPrefetchHitRate = _stateStreamer->hitRate();
 
-    if (_needsUpdate || _newStateIsReady) {
-        if (_loadingStatesDynamically) {
-            _states[0] = std::move(*_newState);
+        // The previous state is shown until the new one has been loaded
+        if (_mustLoadNewStateFromDisk &&
+            _stateStreamer->takeState(_activeTriggerTimeIndex, _states[0]))
+        {
+            _mustLoadNewStateFromDisk = false;
+            _needsUpdate = true;
         }
+    }
 
+    if (_needsUpdate) {
         updateVertexPositionBuffer();
 
         if (_states[_activeStateIndex].nExtraQuantities() > 0) {
@@ -1197,7 +1245,6 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
 
         // Everything is set and ready for rendering!
         _needsUpdate = false;
-        _newStateIsReady = false;
     }
 
     if (_shouldUpdateColorBuffer) {
@@ -1229,15 +1276,6 @@ void RenderableFieldlinesSequence::updateActiveTriggerTimeIndex(double currentTi
     }
 }
 
-// Reading state from disk. Must be thread safe!
-void RenderableFieldlinesSequence::readNewState(const std::string& filePath) {
-    _newState = std::make_unique<FieldlinesState>();
-    if (_newState->loadStateFromOsfls(filePath)) {
-        _newStateIsReady = true;
-    }
-    _isLoadingStateFromDisk = false;
-}
-
 // Unbind buffers and arrays
 inline void unbindGL() {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -1248,12 +1286,13 @@ void RenderableFieldlinesSequence::updateVertexPositionBuffer() {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
 
-    const std::vector<glm::vec3>& vertPos = _states[_activeStateIndex].vertexPositions();
+    const FieldlinesState& state = _states[_activeStateIndex];
+    const OsflsFile* file = state.osflsFile();
 
     glBufferData(
         GL_ARRAY_BUFFER,
-        vertPos.size() * sizeof(glm::vec3),
-        vertPos.data(),
+        nVertices(state) * sizeof(glm::vec3),
+        file ? file->vertexPositions() : state.vertexPositions().data(),
         GL_STATIC_DRAW
     );
 
@@ -1267,17 +1306,14 @@ void RenderableFieldlinesSequence::updateVertexColorBuffer() {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexColorBuffer);
 
-    bool isSuccessful;
-    const std::vector<float>& quantities = _states[_activeStateIndex].extraQuantity(
-        _pColorQuantity,
-        isSuccessful
-    );
+    const FieldlinesState& state = _states[_activeStateIndex];
+    const float* quantities = extraQuantityData(state, _pColorQuantity);
 
-    if (isSuccessful) {
+    if (quantities) {
         glBufferData(
             GL_ARRAY_BUFFER,
-            quantities.size() * sizeof(float),
-            quantities.data(),
+            nVertices(state) * sizeof(float),
+            quantities,
             GL_STATIC_DRAW
         );
 
@@ -1292,17 +1328,14 @@ void RenderableFieldlinesSequence::updateVertexMaskingBuffer() {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexMaskingBuffer);
 
-    bool isSuccessful;
-    const std::vector<float>& maskings = _states[_activeStateIndex].extraQuantity(
-        _pMaskingQuantity,
-        isSuccessful
-    );
+    const FieldlinesState& state = _states[_activeStateIndex];
+    const float* maskings = extraQuantityData(state, _pMaskingQuantity);
 
-    if (isSuccessful) {
+    if (maskings) {
         glBufferData(
             GL_ARRAY_BUFFER,
-            maskings.size() * sizeof(float),
-            maskings.data(),
+            nVertices(state) * sizeof(float),
+            maskings,
             GL_STATIC_DRAW
         );
 
@@ -28,14 +28,15 @@
 #include <openspace/rendering/renderable.h>
 
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <modules/fieldlinessequence/util/fieldlinesstatestreamer.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/triggerproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/vector/vec2property.h>
 #include <openspace/properties/vector/vec4property.h>
 #include <openspace/rendering/transferfunction.h>
-#include <atomic>
 
 namespace { enum class SourceFileType; }
 
@@ -65,21 +66,15 @@ private:
     std::string _identifier;                               // Name of the Node!
 
     // ------------------------------------- FLAGS -------------------------------------//
-    // Used for 'runtime-states'. True when loading a new state from disk on another
-    // thread.
-    std::atomic_bool _isLoadingStateFromDisk = false;
     // False => states are stored in RAM (using 'in-RAM-states'), True => states are
     // loaded from disk during runtime (using 'runtime-states')
     bool _loadingStatesDynamically  = false;
     // Used for 'runtime-states': True if new 'runtime-state' must be loaded from disk.
     // False => the previous frame's state should still be shown
     bool _mustLoadNewStateFromDisk  = false;
-    // Used for 'in-RAM-states' : True if new 'in-RAM-state'  must be loaded.
-    // False => the previous frame's state should still be shown
+    // True if a new 'in-RAM-state' must be loaded or if a new 'runtime-state' has been
+    // loaded. False => the previous frame's state should still be shown
     bool _needsUpdate = false;
-    // Used for 'runtime-states'. True when finished loading a new state from disk on
-    // another thread.
-    std::atomic_bool _newStateIsReady = false;
     // True when new state is loaded or user change which quantity to color the lines by
     bool _shouldUpdateColorBuffer   = false;
     // True when new state is loaded or user change which quantity used for masking out
@@ -95,6 +90,8 @@ private:
     int _activeTriggerTimeIndex = -1;
     // Number of states in the sequence
     size_t _nStates = 0;
+    // Used for 'runtime-states': Number of states that are loaded ahead of time
+    size_t _nPrefetchStates = 0;
     // In setup it is used to scale JSON coordinates. During runtime it is used to scale
     // domain limits.
     float _scalingFactor = 1.f;
@@ -114,8 +111,8 @@ private:
     // ----------------------------------- POINTERS ------------------------------------//
     // The Lua-Modfile-Dictionary used during initialization
     std::unique_ptr<ghoul::Dictionary> _dictionary;
-    // Used for 'runtime-states' when switching out current state to a new state
-    std::unique_ptr<FieldlinesState> _newState;
+    // Used for 'runtime-states' to load the states in the background
+    std::unique_ptr<FieldlinesStateStreamer> _stateStreamer;
     std::unique_ptr<ghoul::opengl::ProgramObject> _shaderProgram;
     // Transfer function used to color lines when _pColorMethod is set to BY_QUANTITY
     std::unique_ptr<TransferFunction> _transferFunction;
@@ -196,6 +193,8 @@ private:
     properties::TriggerProperty _pFocusOnOriginBtn;
     // Button which executes a time jump to start of sequence
     properties::TriggerProperty _pJumpToStartBtn;
+    // Ratio of 'runtime-states' that were prefetched before they were needed
+    properties::FloatProperty _pPrefetchHitRate;
 
     // --------------------- FUNCTIONS USED DURING INITIALIZATION --------------------- //
     void addStateToSequence(FieldlinesState& STATE);
@@ -220,7 +219,6 @@ private:
     bool prepareForOsflsStreaming();
 
     // ------------------------- FUNCTIONS USED DURING RUNTIME ------------------------ //
-    void readNewState(const std::string& filePath);
     void updateActiveTriggerTimeIndex(double currentTime);
     void updateVertexPositionBuffer();
     void updateVertexColorBuffer();
@@ -0,0 +1,155 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/fieldlinessequence/tasks/convertosflstask.h>
+
+#include <openspace/documentation/verifier.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace {
+    constexpr const char* _loggerCat = "ConvertOsflsTask";
+
+    constexpr const char* KeyInput = "Input";
+    constexpr const char* KeyOutput = "Output";
+    constexpr const char* KeyEncoding = "Encoding";
+
+    constexpr const char* EncodingFloat32 = "Float32";
+    constexpr const char* EncodingFloat16 = "Float16";
+    constexpr const char* EncodingQuantized16 = "Quantized16";
+} // namespace
+
+namespace openspace {
+
+ConvertOsflsTask::ConvertOsflsTask(const ghoul::Dictionary& dictionary) {
+    openspace::documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "ConvertOsflsTask"
+    );
+
+    _inputPath = absPath(dictionary.value<std::string>(KeyInput));
+    _outputPath = absPath(dictionary.value<std::string>(KeyOutput));
+
+    if (dictionary.hasKey(KeyEncoding)) {
+        const std::string encoding = dictionary.value<std::string>(KeyEncoding);
+        if (encoding == EncodingFloat16) {
+            _encoding = OsflsFile::Encoding::Float16;
+        }
+        else if (encoding == EncodingQuantized16) {
+            _encoding = OsflsFile::Encoding::Quantized16;
+        }
+    }
+}
+
+std::string ConvertOsflsTask::description() {
+    return fmt::format(
+        "Convert the .osfls files in {} into version {} files in {}",
+        _inputPath, OsflsFile::Version, _outputPath
+    );
+}
+
+void ConvertOsflsTask::perform(const Task::ProgressCallback& progressCallback) {
+    std::vector<std::pair<std::string, std::string>> files;
+    if (std::filesystem::is_directory(_inputPath)) {
+        std::filesystem::create_directories(_outputPath);
+        for (const auto& entry : std::filesystem::directory_iterator(_inputPath)) {
+            const std::filesystem::path& path = entry.path();
+            if (entry.is_regular_file() && path.extension() == ".osfls") {
+                files.emplace_back(
+                    path.string(),
+                    (std::filesystem::path(_outputPath) / path.filename()).string()
+                );
+            }
+        }
+        std::sort(files.begin(), files.end());
+    }
+    else {
+        files.emplace_back(_inputPath, _outputPath);
+    }
+
+    size_t nConverted = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        try {
+            OsflsFile::convert(files[i].first, files[i].second, _encoding);
+            ++nConverted;
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.message);
+        }
+        progressCallback(static_cast<float>(i + 1) / files.size());
+    }
+
+    LINFO(fmt::format("Converted {} of {} .osfls files", nConverted, files.size()));
+}
+
+documentation::Documentation ConvertOsflsTask::documentation() {
+    using namespace documentation;
+    return {
+        "ConvertOsflsTask",
+        "fieldlinessequence_convert_osfls_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("ConvertOsflsTask"),
+                Optional::No,
+                "The type of this task"
+            },
+            {
+                KeyInput,
+                new StringAnnotationVerifier("A path to an .osfls file or a folder"),
+                Optional::No,
+                "The .osfls file that is converted or the folder whose .osfls files are "
+                "converted. The files can have any version"
+            },
+            {
+                KeyOutput,
+                new StringAnnotationVerifier("A valid file or folder path"),
+                Optional::No,
+                "The file into which a single file is converted or the folder into "
+                "which the files of a folder are converted. Existing files are "
+                "overwritten"
+            },
+            {
+                KeyEncoding,
+                new StringInListVerifier({
+                    EncodingFloat32, EncodingFloat16, EncodingQuantized16
+                }),
+                Optional::Yes,
+                "The encoding of the extra quantities. 'Float32' stores them without "
+                "loss of precision, 'Float16' as half precision floating point numbers "
+                "and 'Quantized16' as 16 bit integers between the minimum and maximum "
+                "value of each quantity. Quantities that can not be represented by a 16 "
+                "bit encoding are stored as 'Float32'. The default is 'Float32'"
+            }
+        }
+    };
+}
+
+} // namespace openspace
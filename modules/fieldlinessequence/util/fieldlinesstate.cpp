@@ -24,10 +24,12 @@
 
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
 
+#include <modules/fieldlinessequence/util/osflsfile.h>
 #include <openspace/json.h>
 #include <openspace/util/time.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <fstream>
 #include <iomanip>
 
@@ -35,6 +37,20 @@ namespace {
     constexpr const char* _loggerCat = "FieldlinesState";
     constexpr const int CurrentVersion = 0;
     using json = nlohmann::json;
+
+    // The smallest page size of the supported operating systems
+    constexpr const size_t PageSize = 4096;
+
+    // Reads one byte of every page of the \p count values at \p data, which makes the
+    // operating system read the pages of a memory mapped file from disk on this thread
+    template <typename T>
+    void touchPages(const T* data, size_t count) {
+        const volatile char* bytes = reinterpret_cast<const volatile char*>(data);
+        const size_t size = count * sizeof(T);
+        for (size_t offset = 0; offset < size; offset += PageSize) {
+            static_cast<void>(bytes[offset]);
+        }
+    }
 } // namespace
 
 namespace openspace {
@@ -45,6 +61,7 @@ namespace openspace {
  * expected to be in degrees. scale is an optional scaling factor.
  */
 void FieldlinesState::convertLatLonToCartesian(float scale) {
+    copyArraysFromOsflsFile();
     for (glm::vec3& p : _vertexPositions) {
         const float r = p.x * scale;
         const float lat = glm::radians(p.y);
@@ -56,6 +73,7 @@ void FieldlinesState::convertLatLonToCartesian(float scale) {
 }
 
 void FieldlinesState::scalePositions(float scale) {
+    copyArraysFromOsflsFile();
     for (glm::vec3& p : _vertexPositions) {
         p *= scale;
     }
@@ -68,13 +86,17 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
         return false;
     }
 
-    int binFileVersion;
+    int binFileVersion = -1;
     ifs.read(reinterpret_cast<char*>(&binFileVersion), sizeof(int));
 
     switch (binFileVersion) {
         case 0:
-            // No need to put everything in this scope now, as only version 0 exists!
+            _osflsFile = nullptr;
             break;
+        case OsflsFile::Version:
+            // Version 1 files are read through a memory map instead of the stream
+            ifs.close();
+            return loadStateFromMappedOsfls(pathToOsflsFile);
         default:
             LERROR("VERSION OF BINARY FILE WAS NOT RECOGNIZED!");
             return false;
@@ -133,6 +155,50 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
     return true;
 }
 
+bool FieldlinesState::loadStateFromMappedOsfls(const std::string& pathToOsflsFile) {
+    try {
+        auto file = std::make_shared<const OsflsFile>(pathToOsflsFile);
+
+        _triggerTime = file->triggerTime();
+        _model = file->model();
+        _isMorphable = file->isMorphable();
+
+        // The arrays are used directly from the file. Clearing the vectors keeps their
+        // memory for the next file that has to be copied into the state
+        _lineStart.clear();
+        _lineCount.clear();
+        _vertexPositions.clear();
+
+        // Only the 16 bit quantities have to be decoded, which is done here so that it
+        // happens on the thread that loads the state
+        _extraQuantities.resize(file->nExtraQuantities());
+        _extraQuantityNames.resize(file->nExtraQuantities());
+        for (size_t i = 0; i < file->nExtraQuantities(); ++i) {
+            const float* values = file->extraQuantity(i);
+            if (values) {
+                _extraQuantities[i].clear();
+                touchPages(values, file->nPoints());
+            }
+            else {
+                _extraQuantities[i].resize(file->nPoints());
+                file->decodeExtraQuantity(i, _extraQuantities[i].data());
+            }
+            _extraQuantityNames[i] = file->extraQuantityName(i);
+        }
+
+        touchPages(file->lineStart(), file->nLines());
+        touchPages(file->lineCount(), file->nLines());
+        touchPages(file->vertexPositions(), file->nPoints());
+
+        _osflsFile = std::move(file);
+        return true;
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(e.component, e.message);
+        return false;
+    }
+}
+
 bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
                                         fls::Model Model, float coordToMeters)
 {
@@ -149,6 +215,7 @@ bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
     ifs >> jFile;
     // -------------------------------------------------------------------------------- //
 
+    _osflsFile = nullptr;
     _model = Model;
 
     const char* sData  = "data";
@@ -220,6 +287,9 @@ bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
 /**
  * \param absPath must be the path to the file (incl. filename but excl. extension!)
  * Directory must exist! File is created (or overwritten if already existing).
+ * The file is written in version 0 of the binary format, which every reader of .osfls
+ * files understands. A file can be converted into the memory-mappable version 1 (see
+ * OsflsFile) with OsflsFile::convert, which also supports the 16-bit encodings.
  * File is structured like this: (for version 0)
  *  0. int                    - version number of binary state file! (in case something
  *                              needs to be altered in the future, then increase
@@ -244,6 +314,8 @@ bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
  *                              _extraQuantityNames). Each string ends with null char '\0'
  */
 void FieldlinesState::saveStateToOsfls(const std::string& absPath) {
+    copyArraysFromOsflsFile();
+
     // ------------------------------- Create the file ------------------------------- //
     std::string pathSafeTimeString = std::string(Time(_triggerTime).ISO8601());
     pathSafeTimeString.replace(13, 1, "-");
@@ -323,6 +395,8 @@ void FieldlinesState::saveStateToOsfls(const std::string& absPath) {
 //     }
 // }
 void FieldlinesState::saveStateToJson(const std::string& absPath) {
+    copyArraysFromOsflsFile();
+
     // Create the file
     const char* ext = ".json";
     std::ofstream ofs(absPath + ext, std::ofstream::trunc);
@@ -389,6 +463,10 @@ std::vector<float> FieldlinesState::extraQuantity(size_t index, bool& isSuccessf
 {
     if (index < _extraQuantities.size()) {
         isSuccessful = true;
+        const float* values = _osflsFile ? _osflsFile->extraQuantity(index) : nullptr;
+        if (values) {
+            return std::vector<float>(values, values + _osflsFile->nPoints());
+        }
         return _extraQuantities[index];
     }
     else {
@@ -402,6 +480,7 @@ std::vector<float> FieldlinesState::extraQuantity(size_t index, bool& isSuccessf
 // _lineStart & _lineCount accordingly.
 
 void FieldlinesState::addLine(std::vector<glm::vec3>& line) {
+    copyArraysFromOsflsFile();
     const size_t nNewPoints = line.size();
     const size_t nOldPoints = _vertexPositions.size();
     _lineStart.push_back(static_cast<GLint>(nOldPoints));
@@ -416,10 +495,12 @@ void FieldlinesState::addLine(std::vector<glm::vec3>& line) {
 }
 
 void FieldlinesState::appendToExtra(size_t idx, float val) {
+    copyArraysFromOsflsFile();
     _extraQuantities[idx].push_back(val);
 }
 
 void FieldlinesState::setExtraQuantityNames(std::vector<std::string> names) {
+    copyArraysFromOsflsFile();
     _extraQuantityNames = std::move(names);
     _extraQuantities.resize(_extraQuantityNames.size());
 }
@@ -440,6 +521,10 @@ const std::vector<GLint>& FieldlinesState::lineStart() const {
     return _lineStart;
 }
 
+bool FieldlinesState::isMorphable() const {
+    return _isMorphable;
+}
+
 fls::Model FieldlinesState::FieldlinesState::model() const {
     return _model;
 }
@@ -456,4 +541,30 @@ const std::vector<glm::vec3>& FieldlinesState::vertexPositions() const {
     return _vertexPositions;
 }
 
+const OsflsFile* FieldlinesState::osflsFile() const {
+    return _osflsFile.get();
+}
+
+void FieldlinesState::copyArraysFromOsflsFile() {
+    if (!_osflsFile) {
+        return;
+    }
+
+    const OsflsFile& file = *_osflsFile;
+    _lineStart.assign(file.lineStart(), file.lineStart() + file.nLines());
+    _lineCount.assign(file.lineCount(), file.lineCount() + file.nLines());
+    _vertexPositions.assign(
+        file.vertexPositions(),
+        file.vertexPositions() + file.nPoints()
+    );
+    for (size_t i = 0; i < file.nExtraQuantities(); ++i) {
+        // The other quantities have already been decoded when the file was loaded
+        const float* values = file.extraQuantity(i);
+        if (values) {
+            _extraQuantities[i].assign(values, values + file.nPoints());
+        }
+    }
+    _osflsFile = nullptr;
+}
+
 } // namespace openspace
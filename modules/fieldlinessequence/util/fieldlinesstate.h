@@ -28,16 +28,24 @@
 #include <modules/fieldlinessequence/util/commons.h>
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace openspace {
 
+class OsflsFile;
+
 class FieldlinesState {
 public:
     void convertLatLonToCartesian(float scale = 1.f);
     void scalePositions(float scale);
 
+    /**
+     * Loads the .osfls file at \p pathToOsflsFile. Version 1 files are not copied into
+     * the state, but stay memory mapped (see #osflsFile) until another file is loaded
+     * into the state or the state is modified.
+     */
     bool loadStateFromOsfls(const std::string& pathToOsflsFile);
     void saveStateToOsfls(const std::string& pathToOsflsFile);
 
@@ -50,11 +58,29 @@ public:
     const std::vector<GLsizei>& lineCount() const;
     const std::vector<GLint>& lineStart() const;
 
+    bool isMorphable() const;
     fls::Model model() const;
     size_t nExtraQuantities() const;
     double triggerTime() const;
     const std::vector<glm::vec3>& vertexPositions() const;
 
+    /**
+     * Returns the memory mapped version 1 file that contains the arrays of this state,
+     * or <code>nullptr</code> if they are stored in the vectors of the state. While the
+     * state is backed by a file, #lineStart, #lineCount and #vertexPositions are empty
+     * and the #extraQuantities only contain the quantities that are not stored as
+     * OsflsFile::Encoding::Float32 in the file, which are decoded when the file is
+     * loaded. All other arrays have to be read from the file instead.
+     */
+    const OsflsFile* osflsFile() const;
+
+    /**
+     * Copies the arrays of the memory mapped file (see #osflsFile) into the vectors of
+     * this state and releases the file. Functions that modify or save the state call this
+     * function before they access the vectors.
+     */
+    void copyArraysFromOsflsFile();
+
     // Special getter. Returns extraQuantities[index].
     std::vector<float> extraQuantity(size_t index, bool& isSuccesful) const;
 
@@ -66,6 +92,8 @@ public:
     void appendToExtra(size_t idx, float val);
 
 private:
+    bool loadStateFromMappedOsfls(const std::string& pathToOsflsFile);
+
     bool _isMorphable = false;
     double _triggerTime = -1.0;
     fls::Model _model;
@@ -75,6 +103,9 @@ private:
     std::vector<GLsizei> _lineCount;
     std::vector<GLint> _lineStart;
     std::vector<glm::vec3> _vertexPositions;
+
+    // Shared between copies of the state, as the file is never modified
+    std::shared_ptr<const OsflsFile> _osflsFile;
 };
 
 } // namespace openspace
@@ -0,0 +1,305 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/fieldlinessequence/util/fieldlinesstatestreamer.h>
+
+#include <openspace/engine/globals.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace {
+    // Besides the prefetched states, one slot is needed for the state that is requested
+    // for the current time and one for the previously displayed state
+    constexpr const size_t NAdditionalSlots = 2;
+
+    // The weight of a new measurement in the average load duration
+    constexpr const double LoadDurationWeight = 0.2;
+} // namespace
+
+namespace openspace {
+
+FieldlinesStateStreamer::FieldlinesStateStreamer(std::vector<std::string> sourceFiles,
+                                                 std::vector<double> triggerTimes,
+                                                 size_t nPrefetchStates,
+                                                 LoadFunction loadFunction)
+    : _sourceFiles(std::move(sourceFiles))
+    , _triggerTimes(std::move(triggerTimes))
+    , _nPrefetchStates(nPrefetchStates)
+    , _loadFunction(std::move(loadFunction))
+    , _slots(nPrefetchStates + NAdditionalSlots)
+{
+    ghoul_precondition(
+        _sourceFiles.size() == _triggerTimes.size(),
+        "Each source file must have a trigger time"
+    );
+    ghoul_precondition(
+        std::is_sorted(_triggerTimes.begin(), _triggerTimes.end()),
+        "Trigger times must be sorted"
+    );
+
+    _predictedIndices.reserve(nPrefetchStates + 1);
+}
+
+FieldlinesStateStreamer::~FieldlinesStateStreamer() {
+    for (Slot& slot : _slots) {
+        if (slot.status == Slot::Status::Loading) {
+            // If the job is removed before it starts, its promise is destroyed, which
+            // makes the future ready as well
+            global::jobSystem.cancel(slot.key);
+            slot.result.wait();
+        }
+    }
+}
+
+void FieldlinesStateStreamer::update(int activeIndex, double currentTime,
+                                     double deltaTime)
+{
+    ZoneScoped
+
+    collectFinishedLoads();
+
+    if (activeIndex < 0 || activeIndex >= static_cast<int>(_sourceFiles.size())) {
+        return;
+    }
+
+    if (activeIndex != _requestedIndex) {
+        _requestedIndex = activeIndex;
+        if (activeIndex != _displayedIndex) {
+            ++_nRequests;
+            const Slot* slot = findSlot(activeIndex);
+            if (slot && slot->status == Slot::Status::Ready) {
+                ++_nHits;
+            }
+        }
+    }
+
+    predictIndices(activeIndex, currentTime, deltaTime);
+
+    // Loads of states that are no longer needed would occupy their slots and the
+    // workers, so they are cancelled if they have not started yet
+    for (Slot& slot : _slots) {
+        const bool isPredicted = std::find(
+            _predictedIndices.begin(),
+            _predictedIndices.end(),
+            slot.index
+        ) != _predictedIndices.end();
+
+        if (slot.status == Slot::Status::Loading && !isPredicted &&
+            global::jobSystem.cancel(slot.key) > 0)
+        {
+            slot.result = std::future<bool>();
+            slot.status = Slot::Status::Empty;
+            slot.index = -1;
+        }
+    }
+
+    requestState(activeIndex, JobSystem::Priority::FrameCritical);
+    for (size_t i = 1; i < _predictedIndices.size(); ++i) {
+        requestState(_predictedIndices[i], JobSystem::Priority::Prefetch);
+    }
+}
+
+bool FieldlinesStateStreamer::takeState(int index, FieldlinesState& state) {
+    if (index == _displayedIndex) {
+        return true;
+    }
+
+    collectFinishedLoads();
+    Slot* slot = findSlot(index);
+    if (!slot || slot->status != Slot::Status::Ready) {
+        return false;
+    }
+
+    std::swap(slot->state, state);
+
+    // The slot now contains the state that was displayed before
+    slot->index = _displayedIndex;
+    slot->status = _displayedIndex == -1 ? Slot::Status::Empty : Slot::Status::Ready;
+    _displayedIndex = index;
+    return true;
+}
+
+size_t FieldlinesStateStreamer::nRequests() const {
+    return _nRequests;
+}
+
+size_t FieldlinesStateStreamer::nHits() const {
+    return _nHits;
+}
+
+float FieldlinesStateStreamer::hitRate() const {
+    return _nRequests > 0 ? static_cast<float>(_nHits) / _nRequests : 0.f;
+}
+
+bool FieldlinesStateStreamer::loadOsflsFile(const std::string& path,
+                                            FieldlinesState& state)
+{
+    return state.loadStateFromOsfls(path);
+}
+
+void FieldlinesStateStreamer::collectFinishedLoads() {
+    for (Slot& slot : _slots) {
+        if (slot.status != Slot::Status::Loading ||
+            slot.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            continue;
+        }
+
+        try {
+            slot.status = slot.result.get() ? Slot::Status::Ready : Slot::Status::Failed;
+        }
+        catch (const std::future_error&) {
+            // The job was destroyed without being executed
+            slot.status = Slot::Status::Failed;
+        }
+        slot.key = JobSystem::NoKey;
+    }
+}
+
+void FieldlinesStateStreamer::predictIndices(int activeIndex, double currentTime,
+                                             double deltaTime)
+{
+    _predictedIndices.clear();
+    _predictedIndices.push_back(activeIndex);
+
+    const int direction = deltaTime < 0.0 ? -1 : 1;
+    // The simulation time that passes while a single state is loaded
+    const double loadStep = std::abs(deltaTime) * _averageLoadDuration;
+
+    int index = activeIndex;
+    for (size_t i = 1; i <= _nPrefetchStates; ++i) {
+        int next = index + direction;
+
+        // States that would already be outdated when their load has finished are skipped
+        const int predicted = indexAtTime(currentTime + direction * loadStep * i);
+        if ((predicted - next) * direction > 0) {
+            next = predicted;
+        }
+
+        if (next < 0 || next >= static_cast<int>(_sourceFiles.size())) {
+            break;
+        }
+        _predictedIndices.push_back(next);
+        index = next;
+    }
+}
+
+void FieldlinesStateStreamer::requestState(int index, JobSystem::Priority priority) {
+    if (index == _displayedIndex) {
+        return;
+    }
+
+    Slot* slot = findSlot(index);
+    if (slot) {
+        // A prefetch of a state that is needed now is restarted with a higher priority
+        // if it has not started yet
+        if (slot->status == Slot::Status::Loading && priority < slot->priority &&
+            global::jobSystem.cancel(slot->key) > 0)
+        {
+            startLoading(*slot, index, priority);
+        }
+        return;
+    }
+
+    // Empty slots are used first, then the slot whose state is the farthest away from
+    // the active state among the ones that are not predicted to be needed
+    int bestDistance = -1;
+    for (Slot& s : _slots) {
+        if (s.status == Slot::Status::Empty) {
+            slot = &s;
+            break;
+        }
+        if (s.status == Slot::Status::Loading) {
+            continue;
+        }
+        const bool isPredicted = std::find(
+            _predictedIndices.begin(),
+            _predictedIndices.end(),
+            s.index
+        ) != _predictedIndices.end();
+        const int distance = std::abs(s.index - _predictedIndices.front());
+        if (!isPredicted && distance > bestDistance) {
+            slot = &s;
+            bestDistance = distance;
+        }
+    }
+
+    if (slot) {
+        startLoading(*slot, index, priority);
+    }
+}
+
+void FieldlinesStateStreamer::startLoading(Slot& slot, int index,
+                                           JobSystem::Priority priority)
+{
+    slot.index = index;
+    slot.status = Slot::Status::Loading;
+    slot.priority = priority;
+    slot.key = global::jobSystem.createKey();
+
+    // If the job is cancelled before it starts, the promise is destroyed together with
+    // the job, which makes the future ready as well
+    auto promise = std::make_shared<std::promise<bool>>();
+    slot.result = promise->get_future();
+    global::jobSystem.enqueue(
+        [this, &slot, path = _sourceFiles[index], promise]() {
+            ZoneScopedN("Load Fieldlines State")
+
+            const auto begin = std::chrono::steady_clock::now();
+            const bool success = _loadFunction(path, slot.state);
+            const std::chrono::duration<double> duration =
+                std::chrono::steady_clock::now() - begin;
+
+            // Concurrent updates might lose a measurement, which is fine for an estimate
+            _averageLoadDuration = (1.0 - LoadDurationWeight) * _averageLoadDuration +
+                LoadDurationWeight * duration.count();
+
+            promise->set_value(success);
+        },
+        priority,
+        slot.key
+    );
+}
+
+FieldlinesStateStreamer::Slot* FieldlinesStateStreamer::findSlot(int index) {
+    auto it = std::find_if(
+        _slots.begin(),
+        _slots.end(),
+        [index](const Slot& slot) {
+            return slot.index == index && slot.status != Slot::Status::Empty;
+        }
+    );
+    return it != _slots.end() ? &*it : nullptr;
+}
+
+int FieldlinesStateStreamer::indexAtTime(double time) const {
+    const auto it = std::upper_bound(_triggerTimes.begin(), _triggerTimes.end(), time);
+    const int index = static_cast<int>(std::distance(_triggerTimes.begin(), it)) - 1;
+    return std::clamp(index, 0, static_cast<int>(_triggerTimes.size()) - 1);
+}
+
+} // namespace openspace
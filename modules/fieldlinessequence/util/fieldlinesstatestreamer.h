@@ -0,0 +1,164 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATESTREAMER___H__
+#define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATESTREAMER___H__
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <openspace/util/jobsystem.h>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Loads the states of a fieldline sequence from disk while the sequence is played. The
+ * streamer keeps a fixed number of states in memory. Besides the state that is needed
+ * for the current time, it predicts which states will be needed next from the current
+ * delta time and prefetches them on the JobSystem. If the simulation time passes through
+ * the sequence faster than the states can be loaded, the prediction skips the states
+ * that would be outdated before they are loaded.
+ *
+ * States that are no longer needed are reused for the next loads, so that the memory of
+ * their vectors does not have to be allocated again. The streamer exchanges the contents
+ * of a loaded state with the state that is currently displayed (see #takeState) instead
+ * of copying it, and the previously displayed state stays in the cache. States that are
+ * loaded from version 1 .osfls files keep their memory mapped OsflsFile instead of
+ * copying its arrays, so that they can be uploaded to the GPU directly from the mapping.
+ *
+ * All functions have to be called from the same thread.
+ */
+class FieldlinesStateStreamer {
+public:
+    /// Loads the file at the path into the state and returns whether that succeeded
+    using LoadFunction = std::function<bool(const std::string&, FieldlinesState&)>;
+
+    /**
+     * Creates a streamer for the states in the \p sourceFiles, which start at the
+     * respective \p triggerTimes. Besides the state that is needed for the current
+     * time, up to \p nPrefetchStates states are prefetched.
+     *
+     * \pre \p sourceFiles and \p triggerTimes must have the same size
+     * \pre \p triggerTimes must be sorted
+     */
+    FieldlinesStateStreamer(std::vector<std::string> sourceFiles,
+        std::vector<double> triggerTimes, size_t nPrefetchStates,
+        LoadFunction loadFunction = &loadOsflsFile);
+
+    /// Cancels all loads that have not started yet and waits for the other ones
+    ~FieldlinesStateStreamer();
+
+    FieldlinesStateStreamer(const FieldlinesStateStreamer&) = delete;
+    FieldlinesStateStreamer& operator=(const FieldlinesStateStreamer&) = delete;
+
+    /**
+     * Requests the state with the \p activeIndex, if it is not the displayed state, and
+     * prefetches the states that are predicted to be needed after it. The prediction is
+     * based on the \p currentTime and the \p deltaTime of the simulation time. Loads of
+     * states that are no longer predicted are cancelled if they have not started yet.
+     * This function should be called once per frame.
+     */
+    void update(int activeIndex, double currentTime, double deltaTime);
+
+    /**
+     * Exchanges the contents of the \p state with the loaded state with the provided
+     * \p index. The previous contents of the \p state are kept as the state that was
+     * displayed before.
+     *
+     * \return <code>true</code> if the state has been loaded and was exchanged or if
+     *         \p index is the displayed state, <code>false</code> otherwise
+     */
+    bool takeState(int index, FieldlinesState& state);
+
+    /// Returns the number of times that a new state was requested by #update
+    size_t nRequests() const;
+
+    /// Returns the number of requested states that were already loaded
+    size_t nHits() const;
+
+    /// Returns the ratio of #nHits to #nRequests
+    float hitRate() const;
+
+    /// The default LoadFunction, which calls FieldlinesState::loadStateFromOsfls
+    static bool loadOsflsFile(const std::string& path, FieldlinesState& state);
+
+private:
+    struct Slot {
+        enum class Status {
+            Empty = 0,
+            Loading,
+            Ready,
+            Failed
+        };
+
+        int index = -1;
+        Status status = Status::Empty;
+        JobSystem::Key key = JobSystem::NoKey;
+        JobSystem::Priority priority = JobSystem::Priority::Prefetch;
+        std::future<bool> result;
+        FieldlinesState state;
+    };
+
+    /// Updates the status of all slots whose load has finished
+    void collectFinishedLoads();
+
+    /// Fills _predictedIndices with the indices of the states that are needed next
+    void predictIndices(int activeIndex, double currentTime, double deltaTime);
+
+    /// Starts loading the state with the \p index into a free slot, if there is one
+    void requestState(int index, JobSystem::Priority priority);
+
+    /// Starts loading the state with the \p index into the \p slot
+    void startLoading(Slot& slot, int index, JobSystem::Priority priority);
+
+    /// Returns the slot that contains or loads the state with the \p index, or nullptr
+    Slot* findSlot(int index);
+
+    /// Returns the index of the state that is active at the \p time
+    int indexAtTime(double time) const;
+
+    const std::vector<std::string> _sourceFiles;
+    const std::vector<double> _triggerTimes;
+    const size_t _nPrefetchStates;
+    const LoadFunction _loadFunction;
+
+    std::vector<Slot> _slots;
+    std::vector<int> _predictedIndices;
+    int _displayedIndex = -1;
+    int _requestedIndex = -1;
+
+    // The exponential moving average of the time it takes to load a state in seconds,
+    // which is updated by the workers
+    std::atomic<double> _averageLoadDuration = 0.0;
+
+    size_t _nRequests = 0;
+    size_t _nHits = 0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATESTREAMER___H__
@@ -0,0 +1,457 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/fieldlinessequence/util/osflsfile.h>
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace {
+    constexpr const char* _loggerCat = "OsflsFile";
+
+    using Header = openspace::OsflsFile::Header;
+    using QuantityEntry = openspace::OsflsFile::QuantityEntry;
+    using Encoding = openspace::OsflsFile::Encoding;
+
+    static_assert(std::is_trivially_copyable_v<Header>);
+    static_assert(std::is_trivially_copyable_v<QuantityEntry>);
+    static_assert(sizeof(Header) == 80, "The size of the header is part of the format");
+    static_assert(
+        sizeof(QuantityEntry) == 32,
+        "The size of a quantity entry is part of the format"
+    );
+    static_assert(sizeof(glm::vec3) == 3 * sizeof(float));
+
+    constexpr const float QuantizationSteps = 65535.f;
+
+    // The largest half precision value and the smallest subnormal one (2^-24). Smaller
+    // magnitudes are flushed to zero and larger ones overflow to infinity
+    constexpr const float HalfMaximum = 65504.f;
+    constexpr const float HalfMinimum = 5.9604645e-8f;
+
+    bool isHalfRepresentable(float v) {
+        const float magnitude = std::abs(v);
+        return std::isfinite(v) && magnitude <= HalfMaximum &&
+            (magnitude == 0.f || magnitude >= HalfMinimum);
+    }
+
+    uint64_t alignedOffset(uint64_t offset) {
+        constexpr const uint64_t Alignment = openspace::OsflsFile::Alignment;
+        return (offset + Alignment - 1) / Alignment * Alignment;
+    }
+
+    // Converting a half precision value is a lot slower than looking it up in a table
+    // that contains all 65536 possible values
+    const std::array<float, 65536>& halfFloatTable() {
+        static const std::array<float, 65536> Table = []() {
+            std::array<float, 65536> table;
+            for (size_t i = 0; i < table.size(); ++i) {
+                table[i] = glm::unpackHalf1x16(static_cast<uint16_t>(i));
+            }
+            return table;
+        }();
+        return Table;
+    }
+
+    size_t valueSize(Encoding encoding) {
+        return encoding == Encoding::Float32 ? sizeof(float) : sizeof(uint16_t);
+    }
+
+    // Returns whether the array of \p count elements of \p elementSize bytes that starts
+    // at \p offset is aligned and lies within a file of \p fileSize bytes
+    bool isValidArray(uint64_t offset, uint64_t count, size_t elementSize,
+                      size_t fileSize)
+    {
+        return offset % openspace::OsflsFile::Alignment == 0 && offset <= fileSize &&
+            count <= (fileSize - offset) / elementSize;
+    }
+
+    // Writes zeros into the \p stream until it has reached the \p offset
+    void writePadding(std::ofstream& stream, uint64_t offset) {
+        const uint64_t position = static_cast<uint64_t>(stream.tellp());
+        ghoul_assert(position <= offset, "The stream is already past the offset");
+        constexpr const char Zeros[openspace::OsflsFile::Alignment] = {};
+        stream.write(Zeros, offset - position);
+    }
+
+    template <typename T>
+    void writeArray(std::ofstream& stream, uint64_t offset, const T* data, size_t count) {
+        writePadding(stream, offset);
+        stream.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+    }
+} // namespace
+
+namespace openspace {
+
+void OsflsFile::write(const FieldlinesState& state, const std::string& path,
+                      const std::vector<Encoding>& encodings)
+{
+    ghoul_precondition(
+        state.osflsFile() == nullptr,
+        "The arrays of the state must not be stored in a memory mapped file"
+    );
+
+    const std::vector<GLint>& lineStart = state.lineStart();
+    const std::vector<GLsizei>& lineCount = state.lineCount();
+    const std::vector<glm::vec3>& positions = state.vertexPositions();
+    const std::vector<std::vector<float>>& quantities = state.extraQuantities();
+    const std::vector<std::string>& names = state.extraQuantityNames();
+
+    if (lineStart.size() != lineCount.size()) {
+        throw ghoul::RuntimeError(
+            "Different number of line starts and line counts", "OsflsFile"
+        );
+    }
+    if (quantities.size() != names.size()) {
+        throw ghoul::RuntimeError(
+            "Different number of extra quantities and names", "OsflsFile"
+        );
+    }
+
+    Header header;
+    header.model = static_cast<int32_t>(state.model());
+    header.triggerTime = state.triggerTime();
+    header.isMorphable = state.isMorphable() ? 1 : 0;
+    header.nLines = lineStart.size();
+    header.nPoints = positions.size();
+    header.nExtraQuantities = quantities.size();
+
+    header.lineStartOffset = alignedOffset(sizeof(Header));
+    header.lineCountOffset = alignedOffset(
+        header.lineStartOffset + header.nLines * sizeof(GLint)
+    );
+    header.positionOffset = alignedOffset(
+        header.lineCountOffset + header.nLines * sizeof(GLsizei)
+    );
+    header.quantityTableOffset = alignedOffset(
+        header.positionOffset + header.nPoints * sizeof(glm::vec3)
+    );
+
+    std::vector<QuantityEntry> entries(quantities.size());
+    uint64_t offset = header.quantityTableOffset + entries.size() * sizeof(QuantityEntry);
+    for (size_t i = 0; i < quantities.size(); ++i) {
+        const std::vector<float>& values = quantities[i];
+        if (values.size() != positions.size()) {
+            throw ghoul::RuntimeError(
+                fmt::format("Extra quantity '{}' has a wrong number of values", names[i]),
+                "OsflsFile"
+            );
+        }
+
+        QuantityEntry& entry = entries[i];
+        entry.encoding = i < encodings.size() ? encodings[i] : Encoding::Float32;
+        if (entry.encoding == Encoding::Quantized16) {
+            const bool isFinite = std::all_of(
+                values.begin(),
+                values.end(),
+                [](float v) { return std::isfinite(v); }
+            );
+            if (isFinite && !values.empty()) {
+                const auto [min, max] = std::minmax_element(values.begin(), values.end());
+                entry.minimum = *min;
+                entry.maximum = *max;
+            }
+            else if (!isFinite) {
+                LWARNING(fmt::format(
+                    "Extra quantity '{}' contains values that can not be quantized and "
+                    "is stored without loss of precision instead", names[i]
+                ));
+                entry.encoding = Encoding::Float32;
+            }
+        }
+        else if (entry.encoding == Encoding::Float16) {
+            const bool isRepresentable = std::all_of(
+                values.begin(),
+                values.end(),
+                isHalfRepresentable
+            );
+            if (!isRepresentable) {
+                LWARNING(fmt::format(
+                    "Extra quantity '{}' contains values outside of the half precision "
+                    "range and is stored without loss of precision instead", names[i]
+                ));
+                entry.encoding = Encoding::Float32;
+            }
+        }
+
+        entry.dataOffset = alignedOffset(offset);
+        offset = entry.dataOffset + values.size() * valueSize(entry.encoding);
+    }
+    for (size_t i = 0; i < names.size(); ++i) {
+        entries[i].nameOffset = offset;
+        entries[i].nameLength = static_cast<uint32_t>(names[i].size());
+        offset += names[i].size();
+    }
+
+    std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Unable to open file {} for writing", path),
+            "OsflsFile"
+        );
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    writeArray(file, header.lineStartOffset, lineStart.data(), lineStart.size());
+    writeArray(file, header.lineCountOffset, lineCount.data(), lineCount.size());
+    writeArray(file, header.positionOffset, positions.data(), positions.size());
+    writeArray(file, header.quantityTableOffset, entries.data(), entries.size());
+
+    std::vector<uint16_t> encoded;
+    for (size_t i = 0; i < quantities.size(); ++i) {
+        const std::vector<float>& values = quantities[i];
+        const QuantityEntry& entry = entries[i];
+        switch (entry.encoding) {
+            case Encoding::Float32:
+                writeArray(file, entry.dataOffset, values.data(), values.size());
+                continue;
+            case Encoding::Float16:
+                encoded.resize(values.size());
+                std::transform(
+                    values.begin(),
+                    values.end(),
+                    encoded.begin(),
+                    [](float v) { return glm::packHalf1x16(v); }
+                );
+                break;
+            case Encoding::Quantized16:
+            {
+                const float range = entry.maximum - entry.minimum;
+                const float scale = range > 0.f ? QuantizationSteps / range : 0.f;
+                encoded.resize(values.size());
+                std::transform(
+                    values.begin(),
+                    values.end(),
+                    encoded.begin(),
+                    [min = entry.minimum, scale](float v) {
+                        const float q = std::round((v - min) * scale);
+                        return static_cast<uint16_t>(
+                            std::clamp(q, 0.f, QuantizationSteps)
+                        );
+                    }
+                );
+                break;
+            }
+            default:
+                throw ghoul::MissingCaseException();
+        }
+        writeArray(file, entry.dataOffset, encoded.data(), encoded.size());
+    }
+
+    for (const std::string& name : names) {
+        file.write(name.data(), name.size());
+    }
+
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Error writing file {}", path),
+            "OsflsFile"
+        );
+    }
+}
+
+void OsflsFile::convert(const std::string& source, const std::string& destination,
+                        Encoding encoding)
+{
+    FieldlinesState state;
+    if (!state.loadStateFromOsfls(source)) {
+        throw ghoul::RuntimeError(
+            fmt::format("Unable to read fieldlines state {}", source),
+            "OsflsFile"
+        );
+    }
+    state.copyArraysFromOsflsFile();
+
+    write(
+        state,
+        destination,
+        std::vector<Encoding>(state.nExtraQuantities(), encoding)
+    );
+}
+
+OsflsFile::OsflsFile(const std::string& path)
+    : _file(path)
+{
+    if (!_file.isOpen()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Unable to open file {}", path),
+            "OsflsFile"
+        );
+    }
+
+    if (_file.size() >= sizeof(Header)) {
+        std::memcpy(&_header, _file.data(), sizeof(Header));
+    }
+    if (_file.size() < sizeof(Header) || _header.version != Version) {
+        throw ghoul::RuntimeError(
+            fmt::format("File {} is not a version {} .osfls file", path, Version),
+            "OsflsFile"
+        );
+    }
+
+    const size_t size = _file.size();
+    const bool isValid =
+        isValidArray(_header.lineStartOffset, _header.nLines, sizeof(GLint), size) &&
+        isValidArray(_header.lineCountOffset, _header.nLines, sizeof(GLsizei), size) &&
+        isValidArray(_header.positionOffset, _header.nPoints, sizeof(glm::vec3), size) &&
+        isValidArray(
+            _header.quantityTableOffset,
+            _header.nExtraQuantities,
+            sizeof(QuantityEntry),
+            size
+        );
+    if (!isValid) {
+        throw ghoul::RuntimeError(
+            fmt::format("The header of .osfls file {} is corrupted", path),
+            "OsflsFile"
+        );
+    }
+
+    for (size_t i = 0; i < _header.nExtraQuantities; ++i) {
+        const QuantityEntry& entry = quantityEntry(i);
+        const bool isValidEntry =
+            entry.encoding <= Encoding::Quantized16 &&
+            isValidArray(
+                entry.dataOffset,
+                _header.nPoints,
+                valueSize(entry.encoding),
+                size
+            ) &&
+            entry.nameOffset <= size && entry.nameLength <= size - entry.nameOffset;
+        if (!isValidEntry) {
+            throw ghoul::RuntimeError(
+                fmt::format("Extra quantity {} of .osfls file {} is corrupted", i, path),
+                "OsflsFile"
+            );
+        }
+    }
+}
+
+double OsflsFile::triggerTime() const {
+    return _header.triggerTime;
+}
+
+fls::Model OsflsFile::model() const {
+    return static_cast<fls::Model>(_header.model);
+}
+
+bool OsflsFile::isMorphable() const {
+    return _header.isMorphable != 0;
+}
+
+size_t OsflsFile::nLines() const {
+    return _header.nLines;
+}
+
+size_t OsflsFile::nPoints() const {
+    return _header.nPoints;
+}
+
+size_t OsflsFile::nExtraQuantities() const {
+    return _header.nExtraQuantities;
+}
+
+const GLint* OsflsFile::lineStart() const {
+    return reinterpret_cast<const GLint*>(_file.data() + _header.lineStartOffset);
+}
+
+const GLsizei* OsflsFile::lineCount() const {
+    return reinterpret_cast<const GLsizei*>(_file.data() + _header.lineCountOffset);
+}
+
+const glm::vec3* OsflsFile::vertexPositions() const {
+    return reinterpret_cast<const glm::vec3*>(_file.data() + _header.positionOffset);
+}
+
+std::string_view OsflsFile::extraQuantityName(size_t index) const {
+    const QuantityEntry& entry = quantityEntry(index);
+    return std::string_view(_file.data() + entry.nameOffset, entry.nameLength);
+}
+
+OsflsFile::Encoding OsflsFile::extraQuantityEncoding(size_t index) const {
+    return quantityEntry(index).encoding;
+}
+
+const float* OsflsFile::extraQuantity(size_t index) const {
+    const QuantityEntry& entry = quantityEntry(index);
+    if (entry.encoding != Encoding::Float32) {
+        return nullptr;
+    }
+    return reinterpret_cast<const float*>(_file.data() + entry.dataOffset);
+}
+
+void OsflsFile::decodeExtraQuantity(size_t index, float* values) const {
+    const QuantityEntry& entry = quantityEntry(index);
+    const char* data = _file.data() + entry.dataOffset;
+    const uint16_t* encoded = reinterpret_cast<const uint16_t*>(data);
+
+    switch (entry.encoding) {
+        case Encoding::Float32:
+            std::memcpy(values, data, _header.nPoints * sizeof(float));
+            break;
+        case Encoding::Float16:
+        {
+            const std::array<float, 65536>& table = halfFloatTable();
+            std::transform(
+                encoded,
+                encoded + _header.nPoints,
+                values,
+                [&table](uint16_t v) { return table[v]; }
+            );
+            break;
+        }
+        case Encoding::Quantized16:
+        {
+            const float step = (entry.maximum - entry.minimum) / QuantizationSteps;
+            std::transform(
+                encoded,
+                encoded + _header.nPoints,
+                values,
+                [min = entry.minimum, step](uint16_t v) { return min + v * step; }
+            );
+            break;
+        }
+        default:
+            throw ghoul::MissingCaseException();
+    }
+}
+
+const OsflsFile::QuantityEntry& OsflsFile::quantityEntry(size_t index) const {
+    ghoul_assert(index < _header.nExtraQuantities, "Index out of range");
+
+    const char* table = _file.data() + _header.quantityTableOffset;
+    return reinterpret_cast<const QuantityEntry*>(table)[index];
+}
+
+} // namespace openspace
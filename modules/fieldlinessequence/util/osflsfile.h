@@ -0,0 +1,181 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_FIELDLINESSEQUENCE___OSFLSFILE___H__
+#define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___OSFLSFILE___H__
+
+#include <modules/fieldlinessequence/util/commons.h>
+#include <openspace/util/memorymappedfile.h>
+#include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openspace {
+
+class FieldlinesState;
+
+/**
+ * Reads and writes version 1 of the binary .osfls format for fieldlines states. Version
+ * 0 files store the arrays of a state directly after each other, so they have to be read
+ * one by one into newly allocated memory. Opposed to that, every array of a version 1
+ * file starts at a multiple of #Alignment bytes and its location is stored in the header,
+ * so that the file can be memory mapped and the arrays can be used directly from the
+ * mapping. The extra quantities can optionally be stored with 16 bits per value (see
+ * Encoding), which halves their size. The layout of the file is:
+ *
+ *  - The Header, which starts with the version number just as a version 0 file
+ *  - <code>nLines</code> line starts of type <code>GLint</code>
+ *  - <code>nLines</code> line counts of type <code>GLsizei</code>
+ *  - <code>nPoints</code> vertex positions of type <code>glm::vec3</code>
+ *  - The quantity table, which contains <code>nExtraQuantities</code> values of type
+ *    QuantityEntry
+ *  - The <code>nPoints</code> values of every extra quantity in its Encoding
+ *  - The names of the extra quantities, which are not null-terminated
+ *
+ * Just as for version 0 files, all values are stored in the byte order of the machine
+ * that wrote the file.
+ */
+class OsflsFile {
+public:
+    static constexpr const int32_t Version = 1;
+
+    /// Every array in the file starts at a multiple of this number of bytes
+    static constexpr const size_t Alignment = 64;
+
+    enum class Encoding : uint8_t {
+        /// The values are stored without loss of precision
+        Float32 = 0,
+        /// The values are stored as half precision floating point numbers, which keep a
+        /// relative precision of about 1e-3 for magnitudes between 6e-5 and 65504
+        Float16,
+        /// The values are stored as 16 bit integers that are distributed linearly
+        /// between the minimum and maximum value of the quantity
+        Quantized16
+    };
+
+    struct Header {
+        int32_t version = Version;
+        int32_t model = 0;
+        double triggerTime = 0.0;
+        uint64_t nLines = 0;
+        uint64_t nPoints = 0;
+        uint64_t nExtraQuantities = 0;
+        uint64_t lineStartOffset = 0;
+        uint64_t lineCountOffset = 0;
+        uint64_t positionOffset = 0;
+        uint64_t quantityTableOffset = 0;
+        uint8_t isMorphable = 0;
+        uint8_t padding[7] = { 0, 0, 0, 0, 0, 0, 0 };
+    };
+
+    struct QuantityEntry {
+        uint64_t dataOffset = 0;
+        uint64_t nameOffset = 0;
+        uint32_t nameLength = 0;
+        // Only used for Encoding::Quantized16
+        float minimum = 0.f;
+        float maximum = 0.f;
+        Encoding encoding = Encoding::Float32;
+        uint8_t padding[3] = { 0, 0, 0 };
+    };
+
+    /**
+     * Writes the \p state into a version 1 file at \p path. The extra quantities are
+     * stored with the respective \p encodings. Quantities without an encoding are stored
+     * as Encoding::Float32, as are quantities whose values can not be represented by the
+     * requested 16 bit encoding, such as non-finite values or, for Encoding::Float16,
+     * magnitudes outside of the half precision range.
+     *
+     * \pre The arrays of the \p state must not be stored in a memory mapped file (see
+     *      FieldlinesState::copyArraysFromOsflsFile)
+     * \throw ghoul::RuntimeError If the \p state is inconsistent or the file could not
+     *        be written
+     */
+    static void write(const FieldlinesState& state, const std::string& path,
+        const std::vector<Encoding>& encodings = {});
+
+    /**
+     * Converts the .osfls file at \p source, which can have any version, into a version
+     * 1 file at \p destination in which all extra quantities use the \p encoding.
+     *
+     * \throw ghoul::RuntimeError If \p source could not be read or \p destination could
+     *        not be written
+     */
+    static void convert(const std::string& source, const std::string& destination,
+        Encoding encoding = Encoding::Float32);
+
+    /**
+     * Maps the version 1 file at \p path into memory.
+     *
+     * \throw ghoul::RuntimeError If the file could not be opened or is not a valid
+     *        version 1 file
+     */
+    explicit OsflsFile(const std::string& path);
+
+    double triggerTime() const;
+    fls::Model model() const;
+    bool isMorphable() const;
+
+    size_t nLines() const;
+    size_t nPoints() const;
+    size_t nExtraQuantities() const;
+
+    /// Returns the #nLines line starts inside the mapped file
+    const GLint* lineStart() const;
+
+    /// Returns the #nLines line counts inside the mapped file
+    const GLsizei* lineCount() const;
+
+    /// Returns the #nPoints vertex positions inside the mapped file
+    const glm::vec3* vertexPositions() const;
+
+    std::string_view extraQuantityName(size_t index) const;
+    Encoding extraQuantityEncoding(size_t index) const;
+
+    /**
+     * Returns the #nPoints values of the extra quantity with the provided \p index
+     * inside the mapped file if they are stored as Encoding::Float32, or
+     * <code>nullptr</code> if they have to be decoded with #decodeExtraQuantity.
+     */
+    const float* extraQuantity(size_t index) const;
+
+    /**
+     * Decodes the values of the extra quantity with the provided \p index into
+     * \p values, which must have space for #nPoints values.
+     */
+    void decodeExtraQuantity(size_t index, float* values) const;
+
+private:
+    const QuantityEntry& quantityEntry(size_t index) const;
+
+    MemoryMappedFile _file;
+    Header _header;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_FIELDLINESSEQUENCE___OSFLSFILE___H__
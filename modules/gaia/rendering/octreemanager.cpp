@@ -25,10 +25,12 @@
 #include <modules/gaia/rendering/octreemanager.h>
 
 #include <modules/gaia/rendering/octreeculler.h>
+#include <openspace/engine/globals.h>
 #include <openspace/util/distanceconstants.h>
 #include <ghoul/fmt.h>
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
+#include <filesystem>
 #include <fstream>
 #include <thread>
 
@@ -38,6 +40,10 @@ namespace {
 
 namespace openspace {
 
+OctreeManager::OctreeManager()
+    : _fetchPool(global::jobSystem, JobSystem::Priority::Prefetch)
+{}
+
 void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStarsPerNode) {
     if (_root) {
         LDEBUG("Clear existing Octree");
@@ -117,9 +123,15 @@ void OctreeManager::initBufferIndexStack(long long maxNodes, bool useVBO,
 }
 
 void OctreeManager::insert(const std::vector<float>& starValues) {
-    size_t index = getChildIndex(starValues[0], starValues[1], starValues[2]);
+    insert(starValues.data());
+}
+
+void OctreeManager::insert(const float* starValues) {
+    insertInNode(*_root->Children[branchIndex(starValues)], starValues);
+}
 
-    insertInNode(*_root->Children[index], starValues);
+size_t OctreeManager::branchIndex(const float* starValues) const {
+    return getChildIndex(starValues[0], starValues[1], starValues[2]);
 }
 
 void OctreeManager::sliceLodData(size_t branchIndex) {
@@ -127,7 +139,7 @@ void OctreeManager::sliceLodData(size_t branchIndex) {
         sliceNodeLodCache(*_root->Children[branchIndex]);
     }
     else {
-        for (int i = 0; i < 7; ++i) {
+        for (int i = 0; i < 8; ++i) {
             sliceNodeLodCache(*_root->Children[i]);
         }
     }
@@ -165,12 +177,10 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
                     continue;
                 }
 
-                // Use multithreading to load files and detach thread from main execution
-                // so it can execute independently. Thread will be destroyed when
-                // finished!
-                std::thread([this, n = _root->Children[i]]() {
+                // Load the branches asynchronously on the worker threads
+                _fetchPool.enqueue([this, n = _root->Children[i]]() {
                     fetchChildrenNodes(*n, -1);
-                }).detach();
+                });
             }
             _parentNodeOfCamera = 0;
         }
@@ -288,7 +298,9 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
         }
         // Use asynchronous removal.
         if (!nodesToRemove.empty()) {
-            std::thread(&OctreeManager::removeNodesFromRam, this, nodesToRemove).detach();
+            _fetchPool.enqueue([this, nodesToRemove]() {
+                removeNodesFromRam(nodesToRemove);
+            });
         }
     }
 }
@@ -384,12 +396,10 @@ void OctreeManager::findAndFetchNeighborNode(unsigned long long firstParentId, i
         indexStack.pop();
     }
 
-    // Fetch all children nodes from found parent. Use multithreading to load files
-    // asynchronously! Detach thread from main execution so it can execute independently.
-    // Thread will then be destroyed when it has finished!
-    std::thread([this, node, additionalLevelsToFetch]() {
+    // Fetch all children nodes from found parent asynchronously on the worker threads
+    _fetchPool.enqueue([this, node, additionalLevelsToFetch]() {
         fetchChildrenNodes(*node, additionalLevelsToFetch);
-    }).detach();
+    });
 }
 
 std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4& mvp,
@@ -596,8 +606,19 @@ int OctreeManager::readFromFile(std::ifstream& inFileStream, bool readData,
 
     // If we're not reading data then we need to stream from files later on.
     _streamOctree = !readData;
+    _nodeArchive = nullptr;
     if (_streamOctree) {
         _streamFolderPath = folderPath;
+
+        // Octrees that were constructed before the node archive was introduced store
+        // each node in its own file instead
+        const std::string archivePath = folderPath + OctreeNodeArchive::FileName;
+        if (std::filesystem::is_regular_file(archivePath)) {
+            _nodeArchive = std::make_unique<OctreeNodeArchive>(archivePath);
+            if (!_nodeArchive->isOpen()) {
+                _nodeArchive = nullptr;
+            }
+        }
     }
 
     _valuesPerStar = 0;
@@ -605,6 +626,15 @@ int OctreeManager::readFromFile(std::ifstream& inFileStream, bool readData,
     inFileStream.read(reinterpret_cast<char*>(&MAX_STARS_PER_NODE), sizeof(int32_t));
     inFileStream.read(reinterpret_cast<char*>(&MAX_DIST), sizeof(int32_t));
 
+    if (_nodeArchive &&
+        _nodeArchive->valuesPerStar() != static_cast<int32_t>(_valuesPerStar))
+    {
+        LERROR(fmt::format(
+            "Node archive in {} does not match the Octree structure", folderPath
+        ));
+        _nodeArchive = nullptr;
+    }
+
     LDEBUG(fmt::format(
         "Max stars per node in read Octree: {} - Radius of root layer: {}",
         MAX_STARS_PER_NODE, MAX_DIST
@@ -697,6 +727,28 @@ void OctreeManager::writeToMultipleFiles(const std::string& outFolderPath,
     clearNodeData(*_root->Children[branchIndex]);
 }
 
+void OctreeManager::writeToArchive(OctreeNodeArchive::Writer& archive,
+                                   size_t branchIndex)
+{
+    writeNodeToArchive(archive, *_root->Children[branchIndex]);
+
+    // Clear all data in branch.
+    LINFO(fmt::format("Clear all data from branch {} in octree", branchIndex));
+    clearNodeData(*_root->Children[branchIndex]);
+}
+
+void OctreeManager::writeNodeToArchive(OctreeNodeArchive::Writer& archive,
+                                       const OctreeNode& node)
+{
+    archive.addNode(node.octreePositionIndex, node.posData, node.colData, node.velData);
+
+    if (!node.isLeaf) {
+        for (size_t i = 0; i < 8; ++i) {
+            writeNodeToArchive(archive, *node.Children[i]);
+        }
+    }
+}
+
 void OctreeManager::writeNodeToMultipleFiles(const std::string& outFilePrefix,
                                              OctreeNode& node, bool threadWrites)
 {
@@ -779,6 +831,40 @@ void OctreeManager::fetchChildrenNodes(OctreeNode& parentNode,
 }
 
 void OctreeManager::fetchNodeDataFromFile(OctreeNode& node) {
+    if (_nodeArchive) {
+        const OctreeNodeArchive::NodeData data = _nodeArchive->nodeData(
+            node.octreePositionIndex
+        );
+        if (!data.data) {
+            LERROR(fmt::format(
+                "Node {} is missing in node archive", node.octreePositionIndex
+            ));
+            return;
+        }
+
+        // Copy straight from the mapping into the node, the only read from the disk
+        // happens when the pages are touched for the first time
+        const size_t starsInNode = data.nValues / _valuesPerStar;
+        const float* posEnd = data.data + starsInNode * POS_SIZE;
+        const float* colEnd = posEnd + starsInNode * COL_SIZE;
+        const float* velEnd = colEnd + starsInNode * VEL_SIZE;
+        node.posData.assign(data.data, posEnd);
+        node.colData.assign(posEnd, colEnd);
+        node.velData.assign(colEnd, velEnd);
+
+        // The copy is all that is accounted for in the RAM budget, so the mapped pages
+        // should not linger in the working set of the process
+        _nodeArchive->releaseNode(node.octreePositionIndex);
+
+        node.isLoaded = true;
+        if (!_datasetFitInMemory) {
+            std::lock_guard g(_leastRecentlyFetchedNodesMutex);
+            _leastRecentlyFetchedNodes.push(node.octreePositionIndex);
+        }
+        _cpuRamBudget -= static_cast<long long>(data.nValues * sizeof(float));
+        return;
+    }
+
     // Remove root ID ("8") from index before loading file.
     std::string posId = std::to_string(node.octreePositionIndex);
     posId.erase(posId.begin());
@@ -941,7 +1027,7 @@ bool OctreeManager::isRebuildOngoing() const {
 }
 
 size_t OctreeManager::getChildIndex(float posX, float posY, float posZ, float origX,
-                                    float origY, float origZ)
+                                    float origY, float origZ) const
 {
     size_t index = 0;
     if (posX < origX) {
@@ -956,16 +1042,14 @@ size_t OctreeManager::getChildIndex(float posX, float posY, float posZ, float or
     return index;
 }
 
-bool OctreeManager::insertInNode(OctreeNode& node, const std::vector<float>& starValues,
-                                 int depth)
-{
+bool OctreeManager::insertInNode(OctreeNode& node, const float* starValues, int depth) {
     if (node.isLeaf && node.numStars < MAX_STARS_PER_NODE) {
         // Node is a leaf and it's not yet full -> insert star.
         storeStarData(node, starValues);
 
-        if (depth > _totalDepth) {
-            _totalDepth = depth;
-        }
+        const size_t d = static_cast<size_t>(depth);
+        size_t totalDepth = _totalDepth;
+        while (d > totalDepth && !_totalDepth.compare_exchange_weak(totalDepth, d)) {}
         return true;
     }
     else if (node.isLeaf) {
@@ -973,20 +1057,19 @@ bool OctreeManager::insertInNode(OctreeNode& node, const std::vector<float>& sta
         // Create children and clean up parent.
         createNodeChildren(node);
 
-        // Distribute stars from parent node into children.
+        // Distribute stars from parent node into children. The buffer is reused for all
+        // stars to avoid an allocation per star.
+        std::vector<float> tmpValues(POS_SIZE + COL_SIZE + VEL_SIZE);
         for (size_t n = 0; n < MAX_STARS_PER_NODE; ++n) {
             // Position data.
             auto posBegin = node.posData.begin() + n * POS_SIZE;
-            auto posEnd = posBegin + POS_SIZE;
-            std::vector<float> tmpValues(posBegin, posEnd);
+            auto it = std::copy(posBegin, posBegin + POS_SIZE, tmpValues.begin());
             // Color data.
             auto colBegin = node.colData.begin() + n * COL_SIZE;
-            auto colEnd = colBegin + COL_SIZE;
-            tmpValues.insert(tmpValues.end(), colBegin, colEnd);
+            it = std::copy(colBegin, colBegin + COL_SIZE, it);
             // Velocity data.
             auto velBegin = node.velData.begin() + n * VEL_SIZE;
-            auto velEnd = velBegin + VEL_SIZE;
-            tmpValues.insert(tmpValues.end(), velBegin, velEnd);
+            std::copy(velBegin, velBegin + VEL_SIZE, it);
 
             // Find out which child that will inherit the data and store it.
             size_t index = getChildIndex(
@@ -997,7 +1080,7 @@ bool OctreeManager::insertInNode(OctreeNode& node, const std::vector<float>& sta
                 node.originY,
                 node.originZ
             );
-            insertInNode(*node.Children[index], tmpValues, depth);
+            insertInNode(*node.Children[index], tmpValues.data(), depth);
         }
 
         // Sort magnitudes in inner node.
@@ -1056,8 +1139,7 @@ void OctreeManager::sliceNodeLodCache(OctreeNode& node) {
     }
 }
 
-void OctreeManager::storeStarData(OctreeNode& node, const std::vector<float>& starValues)
-{
+void OctreeManager::storeStarData(OctreeNode& node, const float* starValues) {
     // Insert star data at the back of vectors and store a vector with pairs consisting of
     // star magnitude and insert index for later sorting and slicing of LOD cache.
     float mag = starValues[POS_SIZE];
@@ -1071,11 +1153,12 @@ void OctreeManager::storeStarData(OctreeNode& node, const std::vector<float>& st
         node.magOrder.resize(MAX_STARS_PER_NODE);
     }
 
-    auto posEnd = starValues.begin() + POS_SIZE;
-    auto colEnd = posEnd + COL_SIZE;
-    node.posData.insert(node.posData.end(), starValues.begin(), posEnd);
+    const float* posEnd = starValues + POS_SIZE;
+    const float* colEnd = posEnd + COL_SIZE;
+    const float* velEnd = colEnd + VEL_SIZE;
+    node.posData.insert(node.posData.end(), starValues, posEnd);
     node.colData.insert(node.colData.end(), posEnd, colEnd);
-    node.velData.insert(node.velData.end(), colEnd, starValues.end());
+    node.velData.insert(node.velData.end(), colEnd, velEnd);
 }
 
 std::string OctreeManager::printStarsPerNode(const OctreeNode& node,
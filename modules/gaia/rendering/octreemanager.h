@@ -26,9 +26,13 @@
 #define __OPENSPACE_MODULE_GAIA___OCTREEMANAGER___H__
 
 #include <modules/gaia/rendering/gaiaoptions.h>
+#include <modules/gaia/rendering/octreenodearchive.h>
+#include <openspace/util/threadpool.h>
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <stack>
@@ -59,7 +63,7 @@ public:
         unsigned long long octreePositionIndex;
     };
 
-    OctreeManager() = default;
+    OctreeManager();
     ~OctreeManager() = default;
 
     /**
@@ -85,6 +89,19 @@ public:
      */
     void insert(const std::vector<float>& starValues);
 
+    /**
+     * Inserts the star whose render values start at \param starValues. Stars that belong
+     * to different branches (see <code>branchIndex()</code>) can be inserted
+     * concurrently, but stars in the same branch have to be inserted sequentially.
+     */
+    void insert(const float* starValues);
+
+    /**
+     * \returns the index of the branch of the root node that the star whose render
+     * values start at \param starValues belongs to.
+     */
+    size_t branchIndex(const float* starValues) const;
+
     /**
      * Slices LOD data so only the MAX_STARS_PER_NODE brightest stars are stored in inner
      * nodes. If \p branchIndex is defined then only that branch will be sliced.
@@ -150,6 +167,14 @@ public:
     int readFromFile(std::ifstream& inFileStream, bool readData,
         const std::string& folderPath = std::string());
 
+    /**
+     * Write specified part of Octree to the \param archive, including all data.
+     * \param branchIndex defines which branch to write.
+     * Clears specified branch after writing is done.
+     * Calls <code>writeNodeToArchive()</code> for the specified branch.
+     */
+    void writeToArchive(OctreeNodeArchive::Writer& archive, size_t branchIndex);
+
     /**
      * Write specified part of Octree to multiple files, including all data.
      * \param branchIndex defines which branch to write.
@@ -203,7 +228,7 @@ private:
      * \returns the correct index of child node. Maps [1,1,1] to 0 and [-1,-1,-1] to 7.
      */
     size_t getChildIndex(float posX, float posY, float posZ, float origX = 0.f,
-        float origY = 0.f, float origZ = 0.f);
+        float origY = 0.f, float origZ = 0.f) const;
 
     /**
      * Private help function for <code>insert()</code>. Inserts star into node if leaf and
@@ -212,8 +237,7 @@ private:
      * If node is an inner node, then star is stores in LOD cache if it is among the
      * brightest stars in all children.
      */
-    bool insertInNode(OctreeNode& node, const std::vector<float>& starValues,
-        int depth = 1);
+    bool insertInNode(OctreeNode& node, const float* starValues, int depth = 1);
 
     /**
      * Slices LOD cache data in node to the MAX_STARS_PER_NODE brightest stars. This needs
@@ -226,7 +250,7 @@ private:
      * Private help function for <code>insertInNode()</code>. Stores star data in node and
      * keeps track of the brightest stars all children.
      */
-    void storeStarData(OctreeNode& node, const std::vector<float>& starValues);
+    void storeStarData(OctreeNode& node, const float* starValues);
 
     /**
      * Private help function for <code>printStarsPerNode()</code>. \returns an accumulated
@@ -309,6 +333,12 @@ private:
     void writeNodeToMultipleFiles(const std::string& outFilePrefix, OctreeNode& node,
         bool threadWrites);
 
+    /**
+     * Recursively appends the data of \param node and all of its descendants to the
+     * \param archive.
+     */
+    void writeNodeToArchive(OctreeNodeArchive::Writer& archive, const OctreeNode& node);
+
     /**
      * Finds the neighboring node on the same level (or a higher level if there is no
      * corresponding level) in the specified direction. Also fetches data from found node
@@ -329,7 +359,8 @@ private:
     void fetchChildrenNodes(OctreeNode& parentNode, int additionalLevelsToFetch);
 
     /**
-     * Fetches data for specified node from file.
+     * Fetches data for specified node from the node archive if the streamed Octree has
+     * one, or from the node's own file otherwise.
      * OBS! Only call if node file exists (i.e. node has any data, node->numStars > 0)
      * and is not already loaded.
      */
@@ -362,9 +393,10 @@ private:
     std::queue<unsigned long long> _leastRecentlyFetchedNodes;
     std::mutex _leastRecentlyFetchedNodesMutex;
 
-    size_t _totalDepth = 0;
-    size_t _numLeafNodes = 0;
-    size_t _numInnerNodes = 0;
+    // Atomic as the branches of the Octree can be constructed concurrently
+    std::atomic<size_t> _totalDepth = 0;
+    std::atomic<size_t> _numLeafNodes = 0;
+    std::atomic<size_t> _numInnerNodes = 0;
     size_t _biggestChunkIndexInUse = 0;
     size_t _valuesPerStar = 0;
     float _minTotalPixelsLod = 0.f;
@@ -378,8 +410,13 @@ private:
     long long _maxCpuRamBudget = 0;
     unsigned long long _parentNodeOfCamera = 8;
     std::string _streamFolderPath;
+    std::unique_ptr<OctreeNodeArchive> _nodeArchive;
     size_t _traversedBranchesInRenderCall = 0;
 
+    // Loads and unloads nodes asynchronously. Must be the last member so that all jobs
+    // are finished before any of the data they access is destroyed
+    ThreadPool _fetchPool;
+
 }; // class OctreeManager
 
 }  // namespace openspace
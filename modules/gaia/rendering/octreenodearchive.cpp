@@ -0,0 +1,220 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/gaia/rendering/octreenodearchive.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+    constexpr const char* _loggerCat = "OctreeNodeArchive";
+
+    constexpr const std::array<char, 4> Magic = { 'G', 'O', 'N', 'A' };
+    constexpr const uint32_t CurrentVersion = 1;
+
+    struct Header {
+        std::array<char, 4> magic;
+        uint32_t version;
+        int32_t valuesPerStar;
+        uint32_t reserved;
+        uint64_t indexOffset;
+        uint64_t nNodes;
+    };
+    static_assert(sizeof(Header) == 32, "Header size must not depend on the platform");
+
+    // The index entries are read directly from the mapping, so they have to be aligned
+    constexpr const uint64_t IndexAlignment = 8;
+} // namespace
+
+namespace openspace {
+
+OctreeNodeArchive::Writer::Writer(const std::string& filePath, int32_t valuesPerStar)
+    : _file(filePath, std::ofstream::binary)
+    , _offset(sizeof(Header))
+    , _valuesPerStar(valuesPerStar)
+{
+    if (!_file.good()) {
+        LERROR(fmt::format("Error opening file: {} as node archive", filePath));
+        return;
+    }
+
+    // The header is only valid after the index has been written, so we store an empty
+    // header here and replace it in the finish function
+    Header header = {};
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+}
+
+OctreeNodeArchive::Writer::~Writer() {
+    finish();
+}
+
+void OctreeNodeArchive::Writer::addNode(uint64_t octreePositionIndex,
+                                        const std::vector<float>& posData,
+                                        const std::vector<float>& colData,
+                                        const std::vector<float>& velData)
+{
+    const uint64_t nValues = posData.size() + colData.size() + velData.size();
+    if (nValues == 0) {
+        return;
+    }
+
+    std::lock_guard lock(_mutex);
+    if (_isFinished || !_file.good()) {
+        return;
+    }
+
+    _file.write(
+        reinterpret_cast<const char*>(posData.data()),
+        posData.size() * sizeof(float)
+    );
+    _file.write(
+        reinterpret_cast<const char*>(colData.data()),
+        colData.size() * sizeof(float)
+    );
+    _file.write(
+        reinterpret_cast<const char*>(velData.data()),
+        velData.size() * sizeof(float)
+    );
+    _index.push_back({ octreePositionIndex, _offset, nValues });
+    _offset += nValues * sizeof(float);
+}
+
+void OctreeNodeArchive::Writer::finish() {
+    std::lock_guard lock(_mutex);
+    if (_isFinished || !_file.good()) {
+        return;
+    }
+    _isFinished = true;
+
+    std::sort(
+        _index.begin(),
+        _index.end(),
+        [](const Entry& lhs, const Entry& rhs) {
+            return lhs.octreePositionIndex < rhs.octreePositionIndex;
+        }
+    );
+
+    const uint64_t padding = (IndexAlignment - _offset % IndexAlignment) % IndexAlignment;
+    const std::array<char, IndexAlignment> zeros = {};
+    _file.write(zeros.data(), padding);
+
+    Header header = {
+        Magic,
+        CurrentVersion,
+        _valuesPerStar,
+        0,
+        _offset + padding,
+        static_cast<uint64_t>(_index.size())
+    };
+    _file.write(
+        reinterpret_cast<const char*>(_index.data()),
+        _index.size() * sizeof(Entry)
+    );
+    _file.seekp(0);
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    _file.close();
+
+    LINFO(fmt::format("Wrote {} nodes to node archive", _index.size()));
+}
+
+OctreeNodeArchive::OctreeNodeArchive(const std::string& filePath)
+    // Nodes are loaded in the order in which the camera moves through the Octree, which
+    // has nothing to do with their location in the file
+    : _file(filePath, MemoryMappedFile::AccessPattern::Random)
+{
+    if (!_file.isOpen()) {
+        LERROR(fmt::format("Error opening node archive: {}", filePath));
+        return;
+    }
+    if (_file.size() < sizeof(Header)) {
+        LERROR(fmt::format("Node archive {} is too small", filePath));
+        return;
+    }
+
+    Header header;
+    std::memcpy(&header, _file.data(), sizeof(Header));
+    const uint64_t size = _file.size();
+    const bool isValid = header.magic == Magic && header.version == CurrentVersion &&
+        header.indexOffset % IndexAlignment == 0 && header.indexOffset <= size &&
+        header.nNodes <= (size - header.indexOffset) / sizeof(Entry);
+    if (!isValid) {
+        LERROR(fmt::format("File {} is not a valid node archive", filePath));
+        return;
+    }
+
+    _valuesPerStar = header.valuesPerStar;
+    _nNodes = header.nNodes;
+    _index = reinterpret_cast<const Entry*>(_file.data() + header.indexOffset);
+}
+
+bool OctreeNodeArchive::isOpen() const {
+    return _index != nullptr;
+}
+
+int32_t OctreeNodeArchive::valuesPerStar() const {
+    return _valuesPerStar;
+}
+
+OctreeNodeArchive::NodeData OctreeNodeArchive::nodeData(
+                                                    uint64_t octreePositionIndex) const
+{
+    const Entry* entry = findEntry(octreePositionIndex);
+    if (!entry || entry->offset + entry->nValues * sizeof(float) > _file.size()) {
+        return NodeData();
+    }
+
+    return {
+        reinterpret_cast<const float*>(_file.data() + entry->offset),
+        static_cast<size_t>(entry->nValues)
+    };
+}
+
+void OctreeNodeArchive::releaseNode(uint64_t octreePositionIndex) const {
+    const Entry* entry = findEntry(octreePositionIndex);
+    if (entry) {
+        _file.release(entry->offset, entry->nValues * sizeof(float));
+    }
+}
+
+const OctreeNodeArchive::Entry* OctreeNodeArchive::findEntry(
+                                                    uint64_t octreePositionIndex) const
+{
+    if (!_index) {
+        return nullptr;
+    }
+
+    const Entry* end = _index + _nNodes;
+    const Entry* it = std::lower_bound(
+        _index,
+        end,
+        octreePositionIndex,
+        [](const Entry& e, uint64_t index) { return e.octreePositionIndex < index; }
+    );
+    return (it != end && it->octreePositionIndex == octreePositionIndex) ? it : nullptr;
+}
+
+} // namespace openspace
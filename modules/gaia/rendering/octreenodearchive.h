@@ -0,0 +1,139 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GAIA___OCTREENODEARCHIVE___H__
+#define __OPENSPACE_MODULE_GAIA___OCTREENODEARCHIVE___H__
+
+#include <openspace/util/memorymappedfile.h>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A single packed file that contains the star data of all nodes in a streamed Octree.
+ * The file starts with a fixed-size header, followed by the data of each node (all
+ * position values, then all color values, then all velocity values) and ends with an
+ * index that maps from the octree position index of a node to the location of its data.
+ * The index is sorted so that a node can be found with a binary search.
+ *
+ * The archive is memory mapped when it is opened, which means that loading a node does
+ * not require any file to be opened and that the operating system is responsible for
+ * reading the pages from disk. The data of a node is returned as a view into the
+ * mapping, which stays valid for as long as the archive exists. This is not a zero-copy
+ * path, as the OctreeManager copies the values of a node into the vectors of the
+ * OctreeNode and releases the pages of the mapping afterwards.
+ */
+class OctreeNodeArchive {
+    /// An element of the index at the end of the archive
+    struct Entry {
+        uint64_t octreePositionIndex;
+        uint64_t offset;
+        uint64_t nValues;
+    };
+
+public:
+    /// The name of the archive file in the folder of a streamed Octree
+    static constexpr const char* FileName = "nodes.bin";
+
+    struct NodeData {
+        const float* data = nullptr;
+        size_t nValues = 0;
+    };
+
+    /**
+     * Writes an OctreeNodeArchive. The #addNode function may be called concurrently, for
+     * example when multiple branches of an Octree are written at the same time.
+     */
+    class Writer {
+    public:
+        /**
+         * Creates the archive file \p filePath, overwriting any existing file. The
+         * \p valuesPerStar are stored in the header to validate the archive on load.
+         */
+        Writer(const std::string& filePath, int32_t valuesPerStar);
+        ~Writer();
+
+        /**
+         * Appends the data of the node with the \p octreePositionIndex to the archive.
+         * Nodes without any data are not stored.
+         */
+        void addNode(uint64_t octreePositionIndex, const std::vector<float>& posData,
+            const std::vector<float>& colData, const std::vector<float>& velData);
+
+        /**
+         * Writes the index and the header. No further nodes can be added afterwards. This
+         * function is called by the destructor if it has not been called before.
+         */
+        void finish();
+
+    private:
+        std::mutex _mutex;
+        std::ofstream _file;
+        std::vector<Entry> _index;
+        uint64_t _offset;
+        const int32_t _valuesPerStar;
+        bool _isFinished = false;
+    };
+
+    /**
+     * Opens and memory maps the archive at \p filePath. If the file does not exist or is
+     * not a valid archive, an error is logged and #isOpen will return
+     * <code>false</code>.
+     */
+    explicit OctreeNodeArchive(const std::string& filePath);
+
+    bool isOpen() const;
+    int32_t valuesPerStar() const;
+
+    /**
+     * Returns the data of the node with the \p octreePositionIndex. If the archive does
+     * not contain the node, the returned NodeData is empty. This function can be called
+     * concurrently from any thread.
+     */
+    NodeData nodeData(uint64_t octreePositionIndex) const;
+
+    /**
+     * Informs the operating system that the data of the node with the
+     * \p octreePositionIndex is not accessed through the mapping anymore. The pages are
+     * removed from the working set of the process, but the file contents stay in the
+     * file system cache, so that the node can be loaded again cheaply.
+     */
+    void releaseNode(uint64_t octreePositionIndex) const;
+
+private:
+    const Entry* findEntry(uint64_t octreePositionIndex) const;
+
+    MemoryMappedFile _file;
+    const Entry* _index = nullptr;
+    uint64_t _nNodes = 0;
+    int32_t _valuesPerStar = 0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_GAIA___OCTREENODEARCHIVE___H__
@@ -26,13 +26,21 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
+#include <openspace/util/jobsystem.h>
 #include <ghoul/fmt.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/directory.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
-#include <thread>
+#include <functional>
+#include <mutex>
 
 namespace {
     constexpr const char* KeyInFileOrFolderPath = "InFileOrFolderPath";
@@ -67,6 +75,109 @@ namespace {
     constexpr const char* KeyFilterRvError = "FilterRvError";
 
     constexpr const char* _loggerCat = "ConstructOctreeTask";
+
+    // The number of stars that are read from a file and filtered at once
+    constexpr const size_t StarsPerChunk = 1 << 20;
+
+    // Fewer stars than this are not worth the overhead of an additional job
+    constexpr const size_t MinimumStarBatch = 1 << 14;
+
+    // How often the progress is reported while the jobs are running
+    constexpr const std::chrono::milliseconds ProgressInterval(250);
+
+    // Calls the report function at most once per ProgressInterval. The jobs call this
+    // whenever they made progress, so the calls are serialized as the progress callback
+    // of the task is not thread-safe. A job that finds another one reporting just skips
+    // the report instead of waiting for it
+    class ProgressReporter {
+    public:
+        explicit ProgressReporter(std::function<void()> report)
+            : _report(std::move(report))
+        {}
+
+        void operator()() {
+            std::unique_lock lock(_mutex, std::try_to_lock);
+            if (!lock) {
+                return;
+            }
+            const auto now = std::chrono::steady_clock::now();
+            if (now - _lastReport >= ProgressInterval) {
+                _lastReport = now;
+                _report();
+            }
+        }
+
+    private:
+        std::function<void()> _report;
+        std::mutex _mutex;
+        std::chrono::steady_clock::time_point _lastReport;
+    };
+
+    // Returns the number of stars per job when nStars stars are processed in parallel.
+    // Two batches per thread give the work stealing some room for balancing
+    size_t starBatchSize(size_t nStars) {
+        const size_t nThreads = openspace::global::jobSystem.numThreads();
+        return std::max((nStars + 2 * nThreads - 1) / (2 * nThreads), MinimumStarBatch);
+    }
+
+    // Copies the first nRenderValues values of all stars that were not filtered into the
+    // branch of the Octree that they belong to. This is a stable counting sort on the
+    // branch index, so the stars keep their relative order within each branch and the
+    // constructed Octree does not depend on the number of threads
+    std::array<std::vector<float>, 8> binStars(const openspace::OctreeManager& octree,
+                                               const float* values, size_t nStars,
+                                               int32_t nValuesPerStar,
+                                               int32_t nRenderValues,
+                                               const uint8_t* isFiltered)
+    {
+        const size_t batchSize = starBatchSize(nStars);
+        const size_t nBatches = (nStars + batchSize - 1) / batchSize;
+
+        // Count the stars per branch in every batch
+        std::vector<std::array<size_t, 8>> offsets(nBatches);
+        openspace::global::jobSystem.parallelFor(nBatches, [&](size_t batch) {
+            offsets[batch].fill(0);
+            const size_t end = std::min((batch + 1) * batchSize, nStars);
+            for (size_t i = batch * batchSize; i < end; ++i) {
+                if (!isFiltered[i]) {
+                    ++offsets[batch][octree.branchIndex(values + i * nValuesPerStar)];
+                }
+            }
+        });
+
+        // Turn the counts into the index of the first star of each batch in the branch
+        std::array<size_t, 8> nBranchStars = {};
+        for (std::array<size_t, 8>& batchOffsets : offsets) {
+            for (size_t b = 0; b < 8; ++b) {
+                const size_t count = batchOffsets[b];
+                batchOffsets[b] = nBranchStars[b];
+                nBranchStars[b] += count;
+            }
+        }
+
+        std::array<std::vector<float>, 8> branches;
+        for (size_t b = 0; b < 8; ++b) {
+            branches[b].resize(nBranchStars[b] * nRenderValues);
+        }
+        openspace::global::jobSystem.parallelFor(nBatches, [&](size_t batch) {
+            std::array<size_t, 8> next = offsets[batch];
+            const size_t end = std::min((batch + 1) * batchSize, nStars);
+            for (size_t i = batch * batchSize; i < end; ++i) {
+                if (isFiltered[i]) {
+                    continue;
+                }
+                const float* star = values + i * nValuesPerStar;
+                const size_t b = octree.branchIndex(star);
+                std::copy(
+                    star,
+                    star + nRenderValues,
+                    branches[b].begin() + next[b] * nRenderValues
+                );
+                ++next[b];
+            }
+        });
+        return branches;
+    }
 } // namespace
 
 namespace openspace {
@@ -281,27 +392,73 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
             nValues * sizeof(fullData[0])
         );
         nTotalStars = nValues / nValuesPerStar;
+        inFileStream.close();
 
         progressCallback(0.3f);
+        LINFO("Filtering stars.");
+
+        // Filter data by parameters, one batch of stars per job.
+        const size_t nStars = static_cast<size_t>(nTotalStars);
+        const std::vector<StarFilter> filters = activeFilters();
+        std::vector<uint8_t> isFiltered(nStars);
+        const size_t batchSize = starBatchSize(nStars);
+        const size_t nBatches = (nStars + batchSize - 1) / batchSize;
+        global::jobSystem.parallelFor(nBatches, [&](size_t batch) {
+            const size_t begin = batch * batchSize;
+            const size_t end = std::min(begin + batchSize, nStars);
+            filterStars(
+                fullData.data() + begin * nValuesPerStar,
+                end - begin,
+                nValuesPerStar,
+                filters,
+                isFiltered.data() + begin
+            );
+        });
+        nFilteredStars = static_cast<size_t>(
+            std::count(isFiltered.begin(), isFiltered.end(), uint8_t(1))
+        );
+
+        // Sort the render values of all stars that passed the filters into the branches
+        // of the Octree. The filter values are not needed after this.
+        std::array<std::vector<float>, 8> branches = binStars(
+            *_octreeManager,
+            fullData.data(),
+            nStars,
+            nValuesPerStar,
+            RENDER_VALUES,
+            isFiltered.data()
+        );
+        fullData.clear();
+        fullData.shrink_to_fit();
+
+        progressCallback(0.4f);
         LINFO("Constructing Octree.");
 
-        // Insert star into octree. We assume the data already is in correct order.
-        for (size_t i = 0; i < fullData.size(); i += nValuesPerStar) {
-            auto first = fullData.begin() + i;
-            auto last = fullData.begin() + i + nValuesPerStar;
-            std::vector<float> filterValues(first, last);
-            std::vector<float> renderValues(first, first + RENDER_VALUES);
-
-            // Filter data by parameters.
-            if (checkAllFilters(filterValues)) {
-                nFilteredStars++;
-                continue;
+        // Insert stars into octree. We assume the data already is in correct order. The
+        // branches are independent of each other and are constructed concurrently.
+        const size_t nStarsToInsert = nStars - nFilteredStars;
+        std::atomic<size_t> nInsertedStars = 0;
+        ProgressReporter reportProgress([&]() {
+            const float fraction = nStarsToInsert > 0 ?
+                static_cast<float>(nInsertedStars) / nStarsToInsert :
+                1.f;
+            progressCallback(0.4f + 0.5f * fraction);
+        });
+        global::jobSystem.parallelFor(
+            branches.size(),
+            [&](size_t branch) {
+                const std::vector<float>& data = branches[branch];
+                const size_t nBranchStars = data.size() / RENDER_VALUES;
+                for (size_t first = 0; first < nBranchStars; first += MinimumStarBatch) {
+                    const size_t end = std::min(first + MinimumStarBatch, nBranchStars);
+                    for (size_t i = first; i < end; ++i) {
+                        _octreeManager->insert(data.data() + i * RENDER_VALUES);
+                    }
+                    nInsertedStars += end - first;
+                    reportProgress();
+                }
             }
-
-            // If all filters passed then insert render values into Octree.
-            _octreeManager->insert(renderValues);
-        }
-        inFileStream.close();
+        );
     }
     else {
         LERROR(fmt::format(
@@ -312,7 +469,11 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
     LINFO(fmt::format("{} of {} read stars were filtered", nFilteredStars, nTotalStars));
 
     // Slice LOD data before writing to files.
-    _octreeManager->sliceLodData();
+    global::jobSystem.parallelFor(
+        8,
+        [this](size_t branch) { _octreeManager->sliceLodData(branch); }
+    );
+    progressCallback(0.95f);
 
     LINFO("Writing octree to: " + _outFileOrFolderPath);
     std::ofstream outFileStream(_outFileOrFolderPath, std::ofstream::binary);
@@ -334,153 +495,158 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
 void ConstructOctreeTask::constructOctreeFromFolder(
                                            const Task::ProgressCallback& progressCallback)
 {
-    int32_t nStars = 0;
-    int32_t nValuesPerStar = 0;
-    size_t nFilteredStars = 0;
-    //float maxRadius = 0.0;
-    //int starsOutside10 = 0;
-    //int starsOutside25 = 0;
-    //int starsOutside50 = 0;
-    //int starsOutside75 = 0;
-    //int starsOutside100 = 0;
-    //int starsOutside200 = 0;
-    //int starsOutside300 = 0;
-    //int starsOutside400 = 0;
-    //int starsOutside500 = 0;
-    //int starsOutside750 = 0;
-    //int starsOutside1000 = 0;
-    //int starsOutside1500 = 0;
-    //int starsOutside2000 = 0;
-    //int starsOutside5000 = 0;
-
     ghoul::filesystem::Directory currentDir(_inFileOrFolderPath);
     std::vector<std::string> allInputFiles = currentDir.readFiles();
-    std::vector<float> filterValues;
-    auto writeThreads = std::vector<std::thread>(8);
+    if (allInputFiles.size() > 8) {
+        LERROR(fmt::format(
+            "Expected at most one file per branch in '{}' but found {}",
+            _inFileOrFolderPath, allInputFiles.size()
+        ));
+        return;
+    }
 
     _indexOctreeManager->initOctree(0, _maxDist, _maxStarsPerNode);
 
-    float processOneFile = 1.f / allInputFiles.size();
+    // All branches are written into a single node archive that is memory mapped when
+    // the Octree is streamed
+    OctreeNodeArchive::Writer archive(
+        _outFileOrFolderPath + OctreeNodeArchive::FileName,
+        RENDER_VALUES
+    );
 
     LINFO(fmt::format(
         "MAX DIST: {} - MAX STARS PER NODE: {}",
         _indexOctreeManager->maxDist(), _indexOctreeManager->maxStarsPerNode()
     ));
 
-    for (size_t idx = 0; idx < allInputFiles.size(); ++idx) {
-        std::string inFilePath = allInputFiles[idx];
-        int nStarsInfile = 0;
-
-        LINFO("Reading data file: " + inFilePath);
-
+    // The total number of stars is only needed to report the progress.
+    size_t nTotalStars = 0;
+    for (const std::string& inFilePath : allInputFiles) {
         std::ifstream inFileStream(inFilePath, std::ifstream::binary);
-        if (inFileStream.good()) {
-            inFileStream.read(reinterpret_cast<char*>(&nValuesPerStar), sizeof(int32_t));
-            filterValues.resize(nValuesPerStar, 0.f);
-
-            while (inFileStream.read(
-                reinterpret_cast<char*>(filterValues.data()),
-                nValuesPerStar * sizeof(filterValues[0])
-            ))
-            {
-                // Filter data by parameters.
-                if (checkAllFilters(filterValues)) {
-                    nFilteredStars++;
-                    continue;
-                }
-                // Generate a 50/12,5 dataset (gMag <=13/>13).
-                //if ((filterStar(glm::vec2(20.0), filterValues[3], 20.f)) ||
-                //    (filterStar(glm::vec2(0.0), filterValues[16])) ||
-                //    (filterValues[3] > 13.0 && filterValues[17] > 0.125) ||
-                //    (filterValues[3] <= 13.0 && filterValues[17] > 0.5)) {
-                //    nFilteredStars++;
-                //    continue;
-                //}
-
-                // If all filters passed then insert render values into Octree.
-                std::vector<float> renderValues(
-                    filterValues.begin(),
-                    filterValues.begin() + RENDER_VALUES
+        int32_t nValuesPerStar = 0;
+        inFileStream.read(reinterpret_cast<char*>(&nValuesPerStar), sizeof(int32_t));
+        if (inFileStream.good() && nValuesPerStar > 0) {
+            const size_t nBytes = std::filesystem::file_size(inFilePath);
+            nTotalStars += (nBytes - sizeof(int32_t)) / (nValuesPerStar * sizeof(float));
+        }
+    }
+
+    const std::vector<StarFilter> filters = activeFilters();
+    std::array<std::mutex, 8> branchMutexes;
+    std::atomic<size_t> nReadStars = 0;
+    std::atomic<size_t> nFilteredStars = 0;
+    std::atomic<int32_t> nStars = 0;
+    ProgressReporter reportProgress([&]() {
+        const float fraction = nTotalStars > 0 ?
+            static_cast<float>(nReadStars) / nTotalStars :
+            1.f;
+        progressCallback(std::min(fraction, 1.f));
+    });
+
+    // Every file is read, filtered and inserted by its own job. Usually, every file
+    // contains the stars of a single branch, so the jobs rarely have to wait for each
+    // other, but as any file can contain stars of any branch, every branch is protected
+    // by its own mutex. For the same reason, no branch can be sliced and written before
+    // all files have been read.
+    global::jobSystem.parallelFor(
+        allInputFiles.size(),
+        [&](size_t idx) {
+            const std::string& inFilePath = allInputFiles[idx];
+            int nStarsInfile = 0;
+
+            LINFO("Reading data file: " + inFilePath);
+
+            std::ifstream inFileStream(inFilePath, std::ifstream::binary);
+            if (inFileStream.good()) {
+                int32_t nValuesPerStar = 0;
+                inFileStream.read(
+                    reinterpret_cast<char*>(&nValuesPerStar),
+                    sizeof(int32_t)
                 );
 
-                _indexOctreeManager->insert(renderValues);
-                nStarsInfile++;
-
-                //float maxVal = fmax(fmax(fabs(renderValues[0]), fabs(renderValues[1])),
-                //    fabs(renderValues[2]));
-                //if (maxVal > maxRadius) maxRadius = maxVal;
-                //// Calculate how many stars are outside of different thresholds.
-                //if (maxVal > 10) starsOutside10++;
-                //if (maxVal > 25) starsOutside25++;
-                //if (maxVal > 50) starsOutside50++;
-                //if (maxVal > 75) starsOutside75++;
-                //if (maxVal > 100) starsOutside100++;
-                //if (maxVal > 200) starsOutside200++;
-                //if (maxVal > 300) starsOutside300++;
-                //if (maxVal > 400) starsOutside400++;
-                //if (maxVal > 500) starsOutside500++;
-                //if (maxVal > 750) starsOutside750++;
-                //if (maxVal > 1000) starsOutside1000++;
-                //if (maxVal > 1500) starsOutside1500++;
-                //if (maxVal > 2000) starsOutside2000++;
-                //if (maxVal > 5000) starsOutside5000++;
+                std::vector<float> chunk(StarsPerChunk * nValuesPerStar);
+                std::vector<uint8_t> isFiltered(StarsPerChunk);
+                std::array<std::vector<float>, 8> branches;
+                while (inFileStream) {
+                    inFileStream.read(
+                        reinterpret_cast<char*>(chunk.data()),
+                        chunk.size() * sizeof(chunk[0])
+                    );
+                    const size_t nChunkStars = inFileStream.gcount() /
+                        (nValuesPerStar * sizeof(chunk[0]));
+                    if (nChunkStars == 0) {
+                        break;
+                    }
+
+                    // Filter data by parameters.
+                    filterStars(
+                        chunk.data(),
+                        nChunkStars,
+                        nValuesPerStar,
+                        filters,
+                        isFiltered.data()
+                    );
+
+                    // If all filters passed then insert render values into Octree.
+                    for (size_t i = 0; i < nChunkStars; ++i) {
+                        if (isFiltered[i]) {
+                            nFilteredStars++;
+                            continue;
+                        }
+                        const float* star = chunk.data() + i * nValuesPerStar;
+                        std::vector<float>& branch =
+                            branches[_indexOctreeManager->branchIndex(star)];
+                        branch.insert(branch.end(), star, star + RENDER_VALUES);
+                        nStarsInfile++;
+                    }
+                    for (size_t b = 0; b < branches.size(); ++b) {
+                        if (branches[b].empty()) {
+                            continue;
+                        }
+                        std::lock_guard lock(branchMutexes[b]);
+                        for (size_t i = 0; i < branches[b].size(); i += RENDER_VALUES) {
+                            _indexOctreeManager->insert(branches[b].data() + i);
+                        }
+                        branches[b].clear();
+                    }
+                    nReadStars += nChunkStars;
+                    reportProgress();
+                }
+                inFileStream.close();
             }
-            inFileStream.close();
-        }
-        else {
-            LERROR(fmt::format(
-                "Error opening file '{}' for loading preprocessed file!", inFilePath
-            ));
+            else {
+                LERROR(fmt::format(
+                    "Error opening file '{}' for loading preprocessed file!", inFilePath
+                ));
+            }
+            nStars += nStarsInfile;
         }
+    );
 
-        // Slice LOD data.
-        LINFO("Slicing LOD data!");
-        _indexOctreeManager->sliceLodData(idx);
-
-        progressCallback((idx + 1) * processOneFile);
-        nStars += nStarsInfile;
-
-        LINFO(fmt::format("Writing {} stars to octree files!", nStarsInfile));
-        LINFO(fmt::format(
-            "Number leaf nodes: {}\n Number inner nodes: {}\n Total depth of tree: {}",
-            _indexOctreeManager->numLeafNodes(),
-            _indexOctreeManager->numInnerNodes(),
-            _indexOctreeManager->totalDepth()
-        ));
-
-        // Write to 8 separate files in a separate thread. Data will be cleared after it
-        // has been written. Store joinable thread for later sync.
-        std::thread t(
-            &OctreeManager::writeToMultipleFiles,
-            _indexOctreeManager,
-            _outFileOrFolderPath,
-            idx
-        );
-        writeThreads[idx] = std::move(t);
+    // Slice LOD data and write the branches to the node archive. Data will be cleared
+    // after it has been written.
+    LINFO("Slicing LOD data!");
+    global::jobSystem.parallelFor(
+        8,
+        [this](size_t branch) { _indexOctreeManager->sliceLodData(branch); }
+    );
+    LINFO(fmt::format("Writing {} stars to octree files!", nStars.load()));
+    for (size_t branch = 0; branch < 8; ++branch) {
+        _indexOctreeManager->writeToArchive(archive, branch);
     }
+    archive.finish();
 
+    LINFO(fmt::format(
+        "Number leaf nodes: {}\n Number inner nodes: {}\n Total depth of tree: {}",
+        _indexOctreeManager->numLeafNodes(),
+        _indexOctreeManager->numInnerNodes(),
+        _indexOctreeManager->totalDepth()
+    ));
     LINFO(fmt::format(
         "A total of {} stars were read from files and distributed into {} total nodes",
-        nStars, _indexOctreeManager->totalNodes()
+        nStars.load(), _indexOctreeManager->totalNodes()
     ));
-    LINFO(std::to_string(nFilteredStars) + " stars were filtered");
-
-    //LINFO("Max radius of dataset is: " + std::to_string(maxRadius) +
-    //    "\n Number of stars outside of:" +
-    //    " - 10kPc is " + std::to_string(starsOutside10) + "\n" +
-    //    " - 25kPc is " + std::to_string(starsOutside25) + "\n" +
-    //    " - 50kPc is " + std::to_string(starsOutside50) + "\n" +
-    //    " - 75kPc is " + std::to_string(starsOutside75) + "\n" +
-    //    " - 100kPc is " + std::to_string(starsOutside100) + "\n" +
-    //    " - 200kPc is " + std::to_string(starsOutside200) + "\n" +
-    //    " - 300kPc is " + std::to_string(starsOutside300) + "\n" +
-    //    " - 400kPc is " + std::to_string(starsOutside400) + "\n" +
-    //    " - 500kPc is " + std::to_string(starsOutside500) + "\n" +
-    //    " - 750kPc is " + std::to_string(starsOutside750) + "\n" +
-    //    " - 1000kPc is " + std::to_string(starsOutside1000) + "\n" +
-    //    " - 1500kPc is " + std::to_string(starsOutside1500) + "\n" +
-    //    " - 2000kPc is " + std::to_string(starsOutside2000) + "\n" +
-    //    " - 5000kPc is " + std::to_string(starsOutside5000));
+    LINFO(fmt::format("{} stars were filtered", nFilteredStars.load()));
 
     // Write index file of Octree structure.
     std::string indexFileOutPath = _outFileOrFolderPath + "index.bin";
@@ -496,50 +662,74 @@ void ConstructOctreeTask::constructOctreeFromFolder(
             "Error opening file: {} as index output file.", indexFileOutPath
         ));
     }
-
-    // Make sure all threads are done.
-    for (int i = 0; i < 8; ++i) {
-        writeThreads[i].join();
-    }
 }
 
-bool ConstructOctreeTask::checkAllFilters(const std::vector<float>& filterValues) {
-    // Return true if star is caught in any filter.
-    return (_filterPosX && filterStar(_posX, filterValues[0])) ||
-        (_filterPosY && filterStar(_posY, filterValues[1])) ||
-        (_filterPosZ && filterStar(_posZ, filterValues[2])) ||
-        (_filterGMag && filterStar(_gMag, filterValues[3], 20.f)) ||
-        (_filterBpRp && filterStar(_bpRp, filterValues[4])) ||
-        (_filterVelX && filterStar(_velX, filterValues[5])) ||
-        (_filterVelY && filterStar(_velY, filterValues[6])) ||
-        (_filterVelZ && filterStar(_velZ, filterValues[7])) ||
-        (_filterBpMag && filterStar(_bpMag, filterValues[8], 20.f)) ||
-        (_filterRpMag && filterStar(_rpMag, filterValues[9], 20.f)) ||
-        (_filterBpG && filterStar(_bpG, filterValues[10])) ||
-        (_filterGRp && filterStar(_gRp, filterValues[11])) ||
-        (_filterRa && filterStar(_ra, filterValues[12])) ||
-        (_filterRaError && filterStar(_raError, filterValues[13])) ||
-        (_filterDec && filterStar(_dec, filterValues[14])) ||
-        (_filterDecError && filterStar(_decError, filterValues[15])) ||
-        (_filterParallax && filterStar(_parallax, filterValues[16])) ||
-        (_filterParallaxError && filterStar(_parallaxError, filterValues[17])) ||
-        (_filterPmra && filterStar(_pmra, filterValues[18])) ||
-        (_filterPmraError && filterStar(_pmraError, filterValues[19])) ||
-        (_filterPmdec && filterStar(_pmdec, filterValues[20])) ||
-        (_filterPmdecError && filterStar(_pmdecError, filterValues[21])) ||
-        (_filterRv && filterStar(_rv, filterValues[22])) ||
-        (_filterRvError && filterStar(_rvError, filterValues[23]));
+std::vector<ConstructOctreeTask::StarFilter> ConstructOctreeTask::activeFilters() const {
+    std::vector<StarFilter> filters;
+    auto addFilter = [&filters](bool isActive, size_t column, const glm::vec2& range,
+                                float normValue = 0.f)
+    {
+        if (!isActive) {
+            return;
+        }
+        filters.push_back({
+            column,
+            range.x,
+            range.y,
+            std::fabs(range.x - range.y) < FLT_EPSILON,
+            std::fabs(range.x - normValue) > FLT_EPSILON,
+            std::fabs(range.y - normValue) > FLT_EPSILON
+        });
+    };
+
+    addFilter(_filterPosX, 0, _posX);
+    addFilter(_filterPosY, 1, _posY);
+    addFilter(_filterPosZ, 2, _posZ);
+    addFilter(_filterGMag, 3, _gMag, 20.f);
+    addFilter(_filterBpRp, 4, _bpRp);
+    addFilter(_filterVelX, 5, _velX);
+    addFilter(_filterVelY, 6, _velY);
+    addFilter(_filterVelZ, 7, _velZ);
+    addFilter(_filterBpMag, 8, _bpMag, 20.f);
+    addFilter(_filterRpMag, 9, _rpMag, 20.f);
+    addFilter(_filterBpG, 10, _bpG);
+    addFilter(_filterGRp, 11, _gRp);
+    addFilter(_filterRa, 12, _ra);
+    addFilter(_filterRaError, 13, _raError);
+    addFilter(_filterDec, 14, _dec);
+    addFilter(_filterDecError, 15, _decError);
+    addFilter(_filterParallax, 16, _parallax);
+    addFilter(_filterParallaxError, 17, _parallaxError);
+    addFilter(_filterPmra, 18, _pmra);
+    addFilter(_filterPmraError, 19, _pmraError);
+    addFilter(_filterPmdec, 20, _pmdec);
+    addFilter(_filterPmdecError, 21, _pmdecError);
+    addFilter(_filterRv, 22, _rv);
+    addFilter(_filterRvError, 23, _rvError);
+    return filters;
 }
 
-bool ConstructOctreeTask::filterStar(const glm::vec2& range, float filterValue,
-                                     float normValue)
+void ConstructOctreeTask::filterStars(const float* values, size_t nStars,
+                                      int32_t nValuesPerStar,
+                                      const std::vector<StarFilter>& filters,
+                                      uint8_t* isFiltered) const
 {
-    // Return true if star should be filtered away, i.e. if min = max = filterValue or
-    // if filterValue < min (when min != 0.0) or filterValue > max (when max != 0.0).
-    return (fabs(range.x - range.y) < FLT_EPSILON &&
-        fabs(range.x - filterValue) < FLT_EPSILON) ||
-        (fabs(range.x - normValue) > FLT_EPSILON && filterValue < range.x) ||
-        (fabs(range.y - normValue) > FLT_EPSILON && filterValue > range.y);
+    std::fill(isFiltered, isFiltered + nStars, uint8_t(0));
+
+    // Each filter is one branch-free pass over its column, which lets the compiler
+    // vectorize the comparisons.
+    for (const StarFilter& filter : filters) {
+        const float* column = values + filter.column;
+        for (size_t i = 0; i < nStars; ++i) {
+            const float value = column[i * nValuesPerStar];
+            const bool isEqual = std::fabs(filter.min - value) < FLT_EPSILON;
+            isFiltered[i] |= static_cast<uint8_t>(
+                (filter.filterEqual & isEqual) |
+                (filter.filterMin & (value < filter.min)) |
+                (filter.filterMax & (value > filter.max))
+            );
+        }
+    }
 }
 
 documentation::Documentation ConstructOctreeTask::Documentation() {
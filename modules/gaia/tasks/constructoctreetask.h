@@ -46,6 +46,20 @@ public:
 private:
     const int RENDER_VALUES = 8;
 
+    /**
+     * A filter on a single column of the star data. A star is filtered away if
+     * filterEqual is set and the value equals min, if filterMin is set and the value is
+     * smaller than min or if filterMax is set and the value is bigger than max.
+     */
+    struct StarFilter {
+        size_t column;
+        float min;
+        float max;
+        bool filterEqual;
+        bool filterMin;
+        bool filterMax;
+    };
+
     /**
      * Reads a single binary file with preprocessed star data and insert the render values
      * into an octree structure (if star data passed all defined filters).
@@ -56,27 +70,27 @@ private:
     /**
      *  Reads binary star data from 8 preprocessed files (one per branch) in specified
      * folder, prepared by ReadFitsTask, and inserts star render data into an octree
-     * (if star data passed all defined filters).
-     * Stores octree structure in a binary index file and stores all render data
-     * separate files, one file per node in the octree.
+     * (if star data passed all defined filters). The files are processed concurrently.
+     * Stores octree structure in a binary index file and stores all render data in a
+     * node archive.
      */
     void constructOctreeFromFolder(const Task::ProgressCallback& progressCallback);
 
     /**
-     * Checks all defined filter ranges and \returns true if any of the corresponding
-     * <code>filterValues</code> are outside of the defined range.
-     * \returns false if value should be inserted into Octree.
-     * \param filterValues are all read filter values in binary file.
+     * \returns all defined filters. Star is filtered either if min = max = filterValue
+     * or if filterValue < min (when min != normValue) or filterValue > max (when
+     * max != normValue). The normValue is 20 for magnitudes and 0 otherwise.
      */
-    bool checkAllFilters(const std::vector<float>& filterValues);
+    std::vector<StarFilter> activeFilters() const;
 
     /**
-     * \returns true if star should be filtered away and false if all filters passed.
-     * \param range contains ]min, max[ and \param filterValue corresponding value in
-     * star. Star is filtered either if min = max = filterValue or if filterValue < min
-     * (when min != 0.0) or filterValue > max (when max != 0.0).
+     * Applies the \param filters to \param nStars stars of which each has
+     * \param nValuesPerStar values starting at \param values. Every filter is applied
+     * as one pass over its column. \param isFiltered is set to 1 for every star that
+     * should be filtered away and to 0 for every star that passed all filters.
      */
-    bool filterStar(const glm::vec2& range, float filterValue, float normValue = 0.f);
+    void filterStars(const float* values, size_t nStars, int32_t nValuesPerStar,
+        const std::vector<StarFilter>& filters, uint8_t* isFiltered) const;
 
     std::string _inFileOrFolderPath;
     std::string _outFileOrFolderPath;
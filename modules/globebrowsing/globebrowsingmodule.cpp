@@ -26,6 +26,7 @@
 
 #include <modules/globebrowsing/src/basictypes.h>
 #include <modules/globebrowsing/src/dashboarditemglobelocation.h>
+#include <modules/globebrowsing/src/disktilecache.h>
 #include <modules/globebrowsing/src/gdalwrapper.h>
 #include <modules/globebrowsing/src/geodeticpatch.h>
 #include <modules/globebrowsing/src/globelabelscomponent.h>
@@ -47,6 +48,7 @@
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/misc/profiling.h>
 #include <ghoul/systemcapabilities/generalcapabilitiescomponent.h>
+#include <limits>
 #include <vector>
 
 #include <gdal.h>
@@ -106,6 +108,55 @@ namespace {
         "The maximum size of the MemoryAwareTileCache, on the CPU and GPU."
     };
 
+    constexpr openspace::properties::Property::PropertyInfo DiskTileCacheEnabledInfo = {
+        "DiskTileCacheEnabled",
+        "Disk Tile Cache Enabled",
+        "Determines whether decoded tiles are stored on disk so that they do not have to "
+        "be read and reprojected by GDAL again in later sessions. Changing the value of "
+        "this property will not take effect until the application is restarted."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo DiskTileCacheLocationInfo = {
+        "DiskTileCacheLocation",
+        "Disk Tile Cache Location",
+        "The location of the folder in which the disk tile cache stores its files. "
+        "Changing the value of this property will not take effect until the application "
+        "is restarted."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo DiskTileCacheSizeInfo = {
+        "DiskTileCacheSize",
+        "Disk Tile Cache Size",
+        "The maximum size (in MB) of the disk tile cache for all tile providers. If the "
+        "cache grows beyond this size, the least recently used tiles are removed."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchRequestsInfo = {
+        "PrefetchRequests",
+        "Prefetch Requests",
+        "The number of tiles that were enqueued for loading because a globe predicted "
+        "that they will be needed soon."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchHitsInfo = {
+        "PrefetchHits",
+        "Prefetch Hits",
+        "The number of prefetched tiles that were requested for rendering afterwards."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchWastedLoadsInfo = {
+        "PrefetchWastedLoads",
+        "Prefetch Wasted Loads",
+        "The number of prefetched tiles that were loaded but not requested for "
+        "rendering shortly afterwards."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchHitRateInfo = {
+        "PrefetchHitRate",
+        "Prefetch Hit Rate",
+        "The ratio of prefetch hits to prefetch requests."
+    };
+
 
     openspace::GlobeBrowsingModule::Capabilities
     parseSubDatasets(char** subDatasets, int nSubdatasets)
@@ -168,12 +219,43 @@ GlobeBrowsingModule::GlobeBrowsingModule()
     , _wmsCacheLocation(WMSCacheLocationInfo, "${BASE}/cache_gdal")
     , _wmsCacheSizeMB(WMSCacheSizeInfo, 1024)
     , _tileCacheSizeMB(TileCacheSizeInfo, 1024)
+    , _diskTileCacheEnabled(DiskTileCacheEnabledInfo, false)
+    , _diskTileCacheLocation(DiskTileCacheLocationInfo, "${BASE}/cache_tiles")
+    , _diskTileCacheSizeMB(DiskTileCacheSizeInfo, 4096)
+    , _prefetchStatistics({
+        properties::IntProperty(
+            PrefetchRequestsInfo, 0, 0, std::numeric_limits<int>::max()
+        ),
+        properties::IntProperty(PrefetchHitsInfo, 0, 0, std::numeric_limits<int>::max()),
+        properties::IntProperty(
+            PrefetchWastedLoadsInfo, 0, 0, std::numeric_limits<int>::max()
+        ),
+        properties::FloatProperty(PrefetchHitRateInfo, 0.f, 0.f, 1.f)
+    })
 {
     addProperty(_wmsCacheEnabled);
     addProperty(_offlineMode);
     addProperty(_wmsCacheLocation);
     addProperty(_wmsCacheSizeMB);
     addProperty(_tileCacheSizeMB);
+    addProperty(_diskTileCacheEnabled);
+    addProperty(_diskTileCacheLocation);
+
+    _diskTileCacheSizeMB.onChange([this]() {
+        if (_diskTileCache) {
+            _diskTileCache->setMaximumSize(uint64_t(_diskTileCacheSizeMB) * 1024 * 1024);
+        }
+    });
+    addProperty(_diskTileCacheSizeMB);
+
+    _prefetchStatistics.requests.setReadOnly(true);
+    addProperty(_prefetchStatistics.requests);
+    _prefetchStatistics.hits.setReadOnly(true);
+    addProperty(_prefetchStatistics.hits);
+    _prefetchStatistics.wastedLoads.setReadOnly(true);
+    addProperty(_prefetchStatistics.wastedLoads);
+    _prefetchStatistics.hitRate.setReadOnly(true);
+    addProperty(_prefetchStatistics.hitRate);
 }
 
 void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
@@ -198,6 +280,19 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
             dict.value<double>(TileCacheSizeInfo.identifier)
         );
     }
+    if (dict.hasKeyAndValue<bool>(DiskTileCacheEnabledInfo.identifier)) {
+        _diskTileCacheEnabled = dict.value<bool>(DiskTileCacheEnabledInfo.identifier);
+    }
+    if (dict.hasKeyAndValue<std::string>(DiskTileCacheLocationInfo.identifier)) {
+        _diskTileCacheLocation = dict.value<std::string>(
+            DiskTileCacheLocationInfo.identifier
+        );
+    }
+    if (dict.hasKeyAndValue<double>(DiskTileCacheSizeInfo.identifier)) {
+        _diskTileCacheSizeMB = static_cast<unsigned int>(
+            dict.value<double>(DiskTileCacheSizeInfo.identifier)
+        );
+    }
 
     // Sanity check
     const bool noWarning = dict.hasKeyAndValue<bool>("NoWarning") ?
@@ -215,6 +310,16 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
     }
 
 
+    if (_diskTileCacheEnabled) {
+        // The disk cache does not depend on OpenGL and has to exist before the first
+        // tile provider is created
+        _diskTileCache = std::make_unique<cache::DiskTileCache>(
+            absPath(_diskTileCacheLocation),
+            uint64_t(_diskTileCacheSizeMB) * 1024 * 1024
+        );
+        addPropertySubOwner(_diskTileCache.get());
+    }
+
     // Initialize
     global::callback::initializeGL.emplace_back([&]() {
         ZoneScopedN("GlobeBrowsingModule")
@@ -244,6 +349,16 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
         ZoneScopedN("GlobeBrowsingModule")
 
         _tileCache->update();
+        if (_diskTileCache) {
+            _diskTileCache->update();
+        }
+
+        _prefetchStatistics.requests = _nPrefetchRequests;
+        _prefetchStatistics.hits = _nPrefetchHits;
+        _prefetchStatistics.wastedLoads = _nPrefetchWastedLoads;
+        _prefetchStatistics.hitRate = _nPrefetchRequests > 0 ?
+            static_cast<float>(_nPrefetchHits) / _nPrefetchRequests :
+            0.f;
     });
 
     // Deinitialize
@@ -313,6 +428,10 @@ globebrowsing::cache::MemoryAwareTileCache* GlobeBrowsingModule::tileCache() {
     return _tileCache.get();
 }
 
+globebrowsing::cache::DiskTileCache* GlobeBrowsingModule::diskTileCache() {
+    return _diskTileCache.get();
+}
+
 scripting::LuaLibrary GlobeBrowsingModule::luaLibrary() const {
     std::string listLayerGroups = layerGroupNamesList();
 
@@ -394,6 +513,16 @@ scripting::LuaLibrary GlobeBrowsingModule::luaLibrary() const {
             "argument, as three floating point values - latitude, longitude and altitude "
             "(degrees and meters)."
         },
+        {
+            "getSurfaceHeights",
+            &globebrowsing::luascriptfunctions::getSurfaceHeights,
+            {},
+            "string, table",
+            "Returns the heights of the surface of the globe identified by the first "
+            "argument above its reference ellipsoid in meters. The second argument is a "
+            "list of positions, each of which is a table with the latitude and the "
+            "longitude in degrees. The heights are returned in the same order."
+        },
         {
             "getGeoPositionForCamera",
             &globebrowsing::luascriptfunctions::getGeoPositionForCamera,
@@ -777,4 +906,16 @@ uint64_t GlobeBrowsingModule::wmsCacheSize() const {
     return size * 1024 * 1024;
 }
 
+void GlobeBrowsingModule::addPrefetchRequest() {
+    ++_nPrefetchRequests;
+}
+
+void GlobeBrowsingModule::addPrefetchHit() {
+    ++_nPrefetchHits;
+}
+
+void GlobeBrowsingModule::addPrefetchWastedLoad() {
+    ++_nPrefetchWastedLoads;
+}
+
 } // namespace openspace
@@ -27,6 +27,8 @@
 
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/scalar/uintproperty.h>
 #include <openspace/util/openspacemodule.h>
 
@@ -40,7 +42,10 @@ namespace openspace::globebrowsing {
     struct Geodetic2;
     struct Geodetic3;
 
-    namespace cache { class MemoryAwareTileCache; }
+    namespace cache {
+        class DiskTileCache;
+        class MemoryAwareTileCache;
+    } // namespace cache
 } // namespace openspace::globebrowsing
 
 namespace openspace {
@@ -64,6 +69,12 @@ public:
         double latitude, double longitude, double altitude);
 
     globebrowsing::cache::MemoryAwareTileCache* tileCache();
+
+    /**
+     * Returns the persistent tile cache or <code>nullptr</code> if the disk tile cache
+     * is disabled.
+     */
+    globebrowsing::cache::DiskTileCache* diskTileCache();
     scripting::LuaLibrary luaLibrary() const override;
     std::vector<documentation::Documentation> documentations() const override;
 
@@ -95,6 +106,13 @@ public:
     std::string wmsCacheLocation() const;
     uint64_t wmsCacheSize() const; // bytes
 
+    /// Records that a tile was enqueued speculatively
+    void addPrefetchRequest();
+    /// Records that a speculatively loaded tile was requested for rendering
+    void addPrefetchHit();
+    /// Records that a speculatively loaded tile was not used in time
+    void addPrefetchWastedLoad();
+
 protected:
     void internalInitialize(const ghoul::Dictionary&) override;
 
@@ -127,8 +145,22 @@ private:
     properties::StringProperty _wmsCacheLocation;
     properties::UIntProperty _wmsCacheSizeMB;
     properties::UIntProperty _tileCacheSizeMB;
+    properties::BoolProperty _diskTileCacheEnabled;
+    properties::StringProperty _diskTileCacheLocation;
+    properties::UIntProperty _diskTileCacheSizeMB;
+
+    struct {
+        properties::IntProperty requests;
+        properties::IntProperty hits;
+        properties::IntProperty wastedLoads;
+        properties::FloatProperty hitRate;
+    } _prefetchStatistics;
+    int _nPrefetchRequests = 0;
+    int _nPrefetchHits = 0;
+    int _nPrefetchWastedLoads = 0;
 
     std::unique_ptr<globebrowsing::cache::MemoryAwareTileCache> _tileCache;
+    std::unique_ptr<globebrowsing::cache::DiskTileCache> _diskTileCache;
 
     // name -> capabilities
     std::map<std::string, std::future<Capabilities>> _inFlightCapabilitiesMap;
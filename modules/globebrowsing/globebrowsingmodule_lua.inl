@@ -319,6 +319,54 @@ int getGeoPosition(lua_State* L) {
     return 3;
 }
 
+int getSurfaceHeights(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 2, "lua::getSurfaceHeights");
+
+    const std::string& globeIdentifier = ghoul::lua::value<std::string>(L, 1);
+    SceneGraphNode* n = sceneGraphNode(globeIdentifier);
+    if (!n) {
+        return ghoul::lua::luaError(L, "Unknown globe identifier: " + globeIdentifier);
+    }
+    const RenderableGlobe* globe = dynamic_cast<const RenderableGlobe*>(n->renderable());
+    if (!globe) {
+        return ghoul::lua::luaError(L, "Identifier must be a RenderableGlobe");
+    }
+    if (!lua_istable(L, 2)) {
+        return ghoul::lua::luaError(L, "Expected a table of latitude/longitude pairs");
+    }
+
+    const size_t nPositions = lua_rawlen(L, 2);
+    std::vector<glm::dvec3> positions;
+    positions.reserve(nPositions);
+    for (size_t i = 0; i < nPositions; ++i) {
+        lua_rawgeti(L, 2, static_cast<lua_Integer>(i + 1));
+        if (!lua_istable(L, -1)) {
+            return ghoul::lua::luaError(L, "Each position must be a table");
+        }
+        lua_rawgeti(L, -1, 1);
+        lua_rawgeti(L, -2, 2);
+        const double latitude = lua_tonumber(L, -2);
+        const double longitude = lua_tonumber(L, -1);
+        lua_pop(L, 3);
+
+        positions.push_back(globe->ellipsoid().cartesianSurfacePosition(
+            Geodetic2{ glm::radians(latitude), glm::radians(longitude) }
+        ));
+    }
+    lua_settop(L, 0);
+
+    const std::vector<float> heights = globe->heights(positions);
+
+    lua_newtable(L);
+    for (size_t i = 0; i < heights.size(); ++i) {
+        ghoul::lua::push(L, heights[i]);
+        lua_rawseti(L, -2, static_cast<lua_Integer>(i + 1));
+    }
+
+    ghoul_assert(lua_gettop(L) == 1, "Incorrect number of items left on stack");
+    return 1;
+}
+
 int getGeoPositionForCamera(lua_State* L) {
     ghoul::lua::checkArgumentsAndThrow(L, 0, "lua::getGeoPositionForCamera");
 
@@ -30,6 +30,7 @@
 #include <modules/globebrowsing/src/tileloadjob.h>
 #include <openspace/engine/moduleengine.h>
 #include <openspace/engine/globals.h>
+#include <openspace/util/jobsystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/profiling.h>
 #include <ghoul/opengl/ghoul_gl.h>
@@ -38,13 +39,20 @@ namespace openspace::globebrowsing {
 
 namespace {
     constexpr const char* _loggerCat = "AsyncTileDataProvider";
+
+    // Prefetched tiles that are not used within this number of frames after they were
+    // loaded are counted as wasted loads
+    constexpr const uint64_t PrefetchExpirationFrames = 300;
 } // namespace
 
 AsyncTileDataProvider::AsyncTileDataProvider(std::string name,
                                     std::unique_ptr<RawTileDataReader> rawTileDataReader)
     : _name(std::move(name))
     , _rawTileDataReader(std::move(rawTileDataReader))
-    , _concurrentJobManager(LRUThreadPool<TileIndex::TileHashKey>(1, 10))
+    // GDAL datasets are not thread-safe, so only one tile per reader is loaded at a time
+    , _concurrentJobManager(
+        LRUThreadPool<TileIndex::TileHashKey>(global::jobSystem, 1, 10)
+    )
 {
     ZoneScoped
 
@@ -61,6 +69,15 @@ const RawTileDataReader& AsyncTileDataProvider::rawTileDataReader() const {
 bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex) {
     ZoneScoped
 
+    if (_resetMode == ResetMode::ShouldNotReset &&
+        _prefetchedTileRequests.erase(tileIndex.hashKey()) > 0)
+    {
+        // The tile was correctly predicted and is either waiting or already loading
+        _globeBrowsingModule->addPrefetchHit();
+        _concurrentJobManager.promote(tileIndex.hashKey());
+        return false;
+    }
+
     if (_resetMode == ResetMode::ShouldNotReset && satisfiesEnqueueCriteria(tileIndex)) {
         auto job = std::make_unique<TileLoadJob>(*_rawTileDataReader, tileIndex);
         _concurrentJobManager.enqueueJob(std::move(job), tileIndex.hashKey());
@@ -70,6 +87,35 @@ bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex) {
     return false;
 }
 
+bool AsyncTileDataProvider::prefetchTileIO(const TileIndex& tileIndex) {
+    ZoneScoped
+
+    const TileIndex::TileHashKey key = tileIndex.hashKey();
+    if (_resetMode != ResetMode::ShouldNotReset ||
+        _enqueuedTileRequests.find(key) != _enqueuedTileRequests.end() ||
+        _unusedPrefetchedTiles.find(key) != _unusedPrefetchedTiles.end())
+    {
+        return false;
+    }
+
+    auto job = std::make_unique<TileLoadJob>(*_rawTileDataReader, tileIndex);
+    _concurrentJobManager.enqueuePrefetchJob(std::move(job), key);
+    _enqueuedTileRequests.insert(key);
+    _prefetchedTileRequests.insert(key);
+    _globeBrowsingModule->addPrefetchRequest();
+    return true;
+}
+
+void AsyncTileDataProvider::notifyTileUsed(const TileIndex& tileIndex) {
+    if (_unusedPrefetchedTiles.empty()) {
+        return;
+    }
+
+    if (_unusedPrefetchedTiles.erase(tileIndex.hashKey()) > 0) {
+        _globeBrowsingModule->addPrefetchHit();
+    }
+}
+
 void AsyncTileDataProvider::clearTiles() {
     std::optional<RawTile> finishedJob = popFinishedRawTile();
     while (finishedJob) {
@@ -85,6 +131,11 @@ std::optional<RawTile> AsyncTileDataProvider::popFinishedRawTile() {
         const TileIndex::TileHashKey key = product.tileIndex.hashKey();
         // No longer enqueued. Remove from set of enqueued tiles
         _enqueuedTileRequests.erase(key);
+        if (_prefetchedTileRequests.erase(key) > 0 &&
+            product.error == RawTile::ReadError::None)
+        {
+            _unusedPrefetchedTiles[key] = _frame;
+        }
         // Pbo is still mapped. Set the id for the raw tile
         if (product.error != RawTile::ReadError::None) {
             product.imageData = nullptr;
@@ -122,6 +173,7 @@ void AsyncTileDataProvider::endUnfinishedJobs() {
     for (const TileIndex::TileHashKey& unfinishedJob : unfinishedJobs) {
         // When erasing the job before
         _enqueuedTileRequests.erase(unfinishedJob);
+        _prefetchedTileRequests.erase(unfinishedJob);
     }
 }
 
@@ -131,12 +183,24 @@ void AsyncTileDataProvider::endEnqueuedJobs() {
     for (const TileIndex::TileHashKey& enqueuedJob : enqueuedJobs) {
         // When erasing the job before
         _enqueuedTileRequests.erase(enqueuedJob);
+        _prefetchedTileRequests.erase(enqueuedJob);
     }
 }
 
 void AsyncTileDataProvider::update() {
     endUnfinishedJobs();
 
+    ++_frame;
+    for (auto it = _unusedPrefetchedTiles.begin(); it != _unusedPrefetchedTiles.end();) {
+        if (_frame - it->second > PrefetchExpirationFrames) {
+            _globeBrowsingModule->addPrefetchWastedLoad();
+            it = _unusedPrefetchedTiles.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
     // May reset
     switch (_resetMode) {
         case ResetMode::ShouldResetAll: {
@@ -198,6 +262,8 @@ void AsyncTileDataProvider::performReset(ResetRawTileDataReader resetRawTileData
 
     ghoul_assert(_enqueuedTileRequests.empty(), "No enqueued requests left");
 
+    _unusedPrefetchedTiles.clear();
+
     // Reset raw tile data reader
     if (resetRawTileDataReader == ResetRawTileDataReader::Yes) {
         _rawTileDataReader->reset();
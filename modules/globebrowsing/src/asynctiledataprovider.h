@@ -32,6 +32,7 @@
 #include <map>
 #include <optional>
 #include <set>
+#include <unordered_map>
 
 namespace openspace { class GlobeBrowsingModule; }
 
@@ -59,6 +60,20 @@ public:
      */
     bool enqueueTileIO(const TileIndex& tileIndex);
 
+    /**
+     * Creates a job which asynchronously loads a raw tile that is likely to be needed
+     * in the near future. This job is only executed if no job created by
+     * #enqueueTileIO is waiting and it is turned into a regular job if #enqueueTileIO
+     * is called for the same tile before the job has been started.
+     */
+    bool prefetchTileIO(const TileIndex& tileIndex);
+
+    /**
+     * Notifies the provider that the tile with the \p tileIndex was used for rendering.
+     * This is only used to determine whether prefetched tiles were useful.
+     */
+    void notifyTileUsed(const TileIndex& tileIndex);
+
     /**
      * Get one finished job.
      */
@@ -112,6 +127,15 @@ private:
 
     std::set<TileIndex::TileHashKey> _enqueuedTileRequests;
 
+    /// The subset of _enqueuedTileRequests that were created by prefetchTileIO and that
+    /// have not been requested through enqueueTileIO since
+    std::set<TileIndex::TileHashKey> _prefetchedTileRequests;
+
+    /// Prefetched tiles that finished loading but have not been used yet, mapped to the
+    /// frame in which they finished
+    std::unordered_map<TileIndex::TileHashKey, uint64_t> _unusedPrefetchedTiles;
+    uint64_t _frame = 0;
+
     ResetMode _resetMode = ResetMode::ShouldResetAllButRawTileDataReader;
     bool _shouldBeDeleted = false;
 };
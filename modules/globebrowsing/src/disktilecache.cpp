@@ -0,0 +1,725 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/disktilecache.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    constexpr const char* _loggerCat = "DiskTileCache";
+
+    constexpr const char* IndexFile = "index.bin";
+    constexpr const char* SegmentPrefix = "segment_";
+    constexpr const char* SegmentExtension = ".bin";
+
+    constexpr const uint32_t TileMagic = 0x454C4954; // 'TILE'
+    constexpr const uint32_t IndexMagic = 0x58444E49; // 'INDX'
+    constexpr const uint32_t CurrentVersion = 2;
+
+    // The image data of each record starts at this offset, which keeps it aligned and
+    // leaves room for additions to the header
+    constexpr const size_t HeaderSize = 128;
+
+    // Segments are never larger than this, and caches with a small budget use smaller
+    // segments so that the deletion of one segment only affects a small part of it
+    constexpr const uint64_t MaximumSegmentSize = 64 * 1024 * 1024;
+    constexpr const uint64_t SegmentsPerBudget = 16;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t provider;
+        uint64_t initDataKey;
+        uint32_t x;
+        uint32_t y;
+        uint8_t level;
+        uint8_t error;
+        uint8_t nValues;
+        std::array<uint8_t, 4> hasMissingData;
+        std::array<float, 4> maxValues;
+        std::array<float, 4> minValues;
+        uint64_t dataSize;
+    };
+    static_assert(sizeof(Header) <= HeaderSize, "Header does not fit");
+    static_assert(std::is_trivially_copyable_v<Header>, "Header must be a POD");
+
+    struct IndexEntry {
+        uint64_t hash;
+        uint64_t size;
+    };
+
+    uint64_t mix(uint64_t h, uint64_t v) {
+        // MurmurHash3 finalizer applied to the combination of both values
+        h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Records are padded so that the header of the following record stays aligned
+    uint64_t recordSize(uint64_t dataSize) {
+        return HeaderSize + (dataSize + HeaderSize - 1) / HeaderSize * HeaderSize;
+    }
+
+    std::optional<uint32_t> segmentFromFilename(const std::filesystem::path& path) {
+        if (path.extension() != SegmentExtension) {
+            return std::nullopt;
+        }
+        const std::string stem = path.stem().string();
+        const std::string prefix = SegmentPrefix;
+        if (stem.size() <= prefix.size() || stem.size() > prefix.size() + 9 ||
+            stem.compare(0, prefix.size(), prefix) != 0)
+        {
+            return std::nullopt;
+        }
+        uint32_t id = 0;
+        for (size_t i = prefix.size(); i < stem.size(); ++i) {
+            const char c = stem[i];
+            if (c < '0' || c > '9') {
+                return std::nullopt;
+            }
+            id = id * 10 + static_cast<uint32_t>(c - '0');
+        }
+        return id;
+    }
+
+    constexpr openspace::properties::Property::PropertyInfo HitsInfo = {
+        "Hits",
+        "Hits",
+        "The number of tiles that were loaded from the disk cache in this session."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo MissesInfo = {
+        "Misses",
+        "Misses",
+        "The number of tiles that were requested in this session but that were not "
+        "available in the disk cache and thus had to be read from their dataset."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo EvictionsInfo = {
+        "Evictions",
+        "Evictions",
+        "The number of tiles that were removed from the disk cache in this session to "
+        "stay within the maximum size."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo UsedSizeInfo = {
+        "UsedSize",
+        "Used size (MB)",
+        "The amount of disk space (in MB) that is currently used by the disk cache."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ClearInfo = {
+        "Clear",
+        "Clear disk cache",
+        "Removes all tiles that are stored in the disk cache."
+    };
+} // namespace
+
+namespace openspace::globebrowsing::cache {
+
+DiskTileCache::DiskTileCache(std::string directory, uint64_t maximumSize)
+    : PropertyOwner({ "DiskTileCache" })
+    , _directory(std::move(directory))
+    , _entries(std::numeric_limits<uint32_t>::max() - 1)
+    , _maximumSize(maximumSize)
+    , _hits(HitsInfo, 0, 0, std::numeric_limits<int>::max())
+    , _misses(MissesInfo, 0, 0, std::numeric_limits<int>::max())
+    , _evictions(EvictionsInfo, 0, 0, std::numeric_limits<int>::max())
+    , _usedSize(UsedSizeInfo, 0, 0, std::numeric_limits<int>::max())
+    , _clear(ClearInfo)
+{
+    ZoneScoped
+
+    _hits.setReadOnly(true);
+    addProperty(_hits);
+
+    _misses.setReadOnly(true);
+    addProperty(_misses);
+
+    _evictions.setReadOnly(true);
+    addProperty(_evictions);
+
+    _usedSize.setReadOnly(true);
+    addProperty(_usedSize);
+
+    _clear.onChange([this]() { clear(); });
+    addProperty(_clear);
+
+    std::error_code ec;
+    std::filesystem::create_directories(_directory, ec);
+    if (ec) {
+        LERROR(fmt::format(
+            "Could not create disk tile cache directory '{}': {}",
+            _directory, ec.message()
+        ));
+    }
+
+    loadIndex();
+
+    std::lock_guard lock(_mutex);
+    evict();
+}
+
+DiskTileCache::~DiskTileCache() {
+    saveIndex();
+}
+
+uint64_t DiskTileCache::providerHash(const std::string& identifier) {
+    // FNV-1a, as std::hash is not guaranteed to be stable between executions
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : identifier) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+DiskTileCache::Segment::Segment(uint32_t id_, std::string path_, uint64_t capacity_,
+                                uint64_t used_)
+    : id(id_)
+    , path(std::move(path_))
+    , file(std::make_unique<MemoryMappedFile>(
+        path, MemoryMappedFile::AccessPattern::Random
+    ))
+    , capacity(capacity_)
+    , used(used_)
+{}
+
+DiskTileCache::Segment::~Segment() {
+    // The mapping has to be closed before the file can be deleted on Windows
+    file = nullptr;
+    if (isRemoved) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+}
+
+uint64_t DiskTileCache::contentHash(const Key& key) {
+    uint64_t hash = mix(key.provider, key.initDataKey);
+    hash = mix(hash, (static_cast<uint64_t>(key.tileIndex.x) << 32) | key.tileIndex.y);
+    hash = mix(hash, key.tileIndex.level);
+    return hash;
+}
+
+std::string DiskTileCache::segmentPath(uint32_t id) const {
+    return fmt::format("{}/{}{:06}{}", _directory, SegmentPrefix, id, SegmentExtension);
+}
+
+std::optional<RawTile> DiskTileCache::get(const Key& key,
+                                          const TileTextureInitData& initData)
+{
+    ZoneScoped
+
+    const uint64_t hash = contentHash(key);
+    Location location;
+    std::shared_ptr<Segment> segment;
+    {
+        std::lock_guard lock(_mutex);
+        if (!_entries.exist(hash)) {
+            ++_nMisses;
+            return std::nullopt;
+        }
+        location = _entries.get(hash);
+        // Holding on to the segment keeps its mapping and its file alive while the tile
+        // is copied, even if a concurrent put evicts the segment in the meantime
+        segment = _segments.at(location.segment);
+    }
+
+    const MemoryMappedFile& file = *segment->file;
+    Header header = {};
+    const bool isInFile = location.size >= HeaderSize &&
+        location.offset + location.size <= file.size();
+    if (isInFile) {
+        std::memcpy(&header, file.data() + location.offset, sizeof(Header));
+    }
+
+    const bool isValid = isInFile &&
+        header.magic == TileMagic && header.version == CurrentVersion &&
+        header.provider == key.provider && header.initDataKey == key.initDataKey &&
+        header.x == key.tileIndex.x && header.y == key.tileIndex.y &&
+        header.level == key.tileIndex.level &&
+        header.dataSize == initData.totalNumBytes &&
+        recordSize(header.dataSize) == location.size;
+    if (!isValid) {
+        // Hash collisions and corrupted records are removed from the index, unless a
+        // concurrent put has already replaced the record
+        std::lock_guard lock(_mutex);
+        if (_entries.exist(hash)) {
+            const Location current = _entries.get(hash);
+            if (current.segment == location.segment && current.offset == location.offset)
+            {
+                _entries.remove(hash);
+                release(hash, current);
+            }
+        }
+        ++_nMisses;
+        return std::nullopt;
+    }
+
+    RawTile rawTile;
+    rawTile.imageData = std::unique_ptr<std::byte[]>(new std::byte[header.dataSize]);
+    std::memcpy(
+        rawTile.imageData.get(),
+        file.data() + location.offset + HeaderSize,
+        header.dataSize
+    );
+
+    rawTile.tileMetaData.nValues = header.nValues;
+    for (size_t i = 0; i < 4; ++i) {
+        rawTile.tileMetaData.maxValues[i] = header.maxValues[i];
+        rawTile.tileMetaData.minValues[i] = header.minValues[i];
+        rawTile.tileMetaData.hasMissingData[i] = header.hasMissingData[i] != 0;
+    }
+    rawTile.error = static_cast<RawTile::ReadError>(header.error);
+    rawTile.tileIndex = key.tileIndex;
+    rawTile.textureInitData = initData;
+
+    ++_nHits;
+
+    bool isFragmented = false;
+    {
+        std::lock_guard lock(_mutex);
+        isFragmented = segment != _currentSegment && !segment->isRemoved &&
+            segment->live * 2 < segment->used;
+    }
+    if (isFragmented) {
+        // Tiles that are still in use are moved out of segments that are about to be
+        // deleted
+        put(key, rawTile);
+    }
+    return rawTile;
+}
+
+void DiskTileCache::put(const Key& key, const RawTile& rawTile) {
+    ZoneScoped
+
+    if (rawTile.error > RawTile::ReadError::Debug || !rawTile.imageData ||
+        !rawTile.textureInitData.has_value())
+    {
+        return;
+    }
+
+    Header header = {};
+    header.magic = TileMagic;
+    header.version = CurrentVersion;
+    header.provider = key.provider;
+    header.initDataKey = key.initDataKey;
+    header.x = key.tileIndex.x;
+    header.y = key.tileIndex.y;
+    header.level = key.tileIndex.level;
+    header.error = static_cast<uint8_t>(rawTile.error);
+    header.nValues = rawTile.tileMetaData.nValues;
+    for (size_t i = 0; i < 4; ++i) {
+        header.maxValues[i] = rawTile.tileMetaData.maxValues[i];
+        header.minValues[i] = rawTile.tileMetaData.minValues[i];
+        header.hasMissingData[i] = rawTile.tileMetaData.hasMissingData[i] ? 1 : 0;
+    }
+    header.dataSize = rawTile.textureInitData->totalNumBytes;
+
+    std::array<char, HeaderSize> headerBuffer = {};
+    std::memcpy(headerBuffer.data(), &header, sizeof(Header));
+
+    const uint64_t hash = contentHash(key);
+    const uint64_t size = recordSize(header.dataSize);
+    uint64_t offset = 0;
+    std::shared_ptr<Segment> segment;
+    {
+        std::lock_guard lock(_mutex);
+        segment = allocate(size, offset);
+    }
+    if (!segment) {
+        return;
+    }
+
+    // The record is written without holding the lock and is only added to the index
+    // once it is complete, so a concurrent reader never sees a partially written tile
+    {
+        std::fstream file(
+            segment->path,
+            std::fstream::in | std::fstream::out | std::fstream::binary
+        );
+        file.seekp(offset);
+        file.write(headerBuffer.data(), HeaderSize);
+        file.write(
+            reinterpret_cast<const char*>(rawTile.imageData.get()),
+            header.dataSize
+        );
+        if (!file.good()) {
+            LERROR(fmt::format("Error writing tile to '{}'", segment->path));
+            return;
+        }
+    }
+
+    std::lock_guard lock(_mutex);
+    if (segment->isRemoved) {
+        // The segment was cleared or evicted while the tile was written
+        return;
+    }
+    insert(hash, { segment->id, offset, size });
+    evict();
+}
+
+std::shared_ptr<DiskTileCache::Segment> DiskTileCache::allocate(uint64_t size,
+                                                                uint64_t& offset)
+{
+    if (!_currentSegment || _currentSegment->used + size > _currentSegment->capacity) {
+        if (_currentSegment) {
+            const std::shared_ptr<Segment> full = std::move(_currentSegment);
+            if (full->live * 4 < full->used) {
+                removeSegment(full->id);
+            }
+        }
+
+        const uint64_t capacity = std::max(
+            size,
+            std::min(MaximumSegmentSize, _maximumSize / SegmentsPerBudget)
+        );
+        const uint32_t id = _nextSegment++;
+        const std::string path = segmentPath(id);
+
+        // The file is allocated with its final size up front, as a mapping can not grow
+        // together with its file
+        std::error_code ec;
+        {
+            std::ofstream file(path, std::ofstream::binary);
+        }
+        std::filesystem::resize_file(path, capacity, ec);
+        auto segment = std::make_shared<Segment>(id, path, capacity, 0);
+        if (ec || !segment->file->isOpen() || segment->file->size() != capacity) {
+            LERROR(fmt::format("Could not create disk tile cache segment '{}'", path));
+            segment->isRemoved = true;
+            return nullptr;
+        }
+        _segments[id] = segment;
+        _currentSegment = std::move(segment);
+    }
+
+    offset = _currentSegment->used;
+    _currentSegment->used += size;
+    return _currentSegment;
+}
+
+void DiskTileCache::insert(uint64_t hash, const Location& location) {
+    const std::optional<Location> previous = _entries.remove(hash);
+    if (previous.has_value()) {
+        release(hash, *previous);
+    }
+
+    // Releasing the previous record might have removed the segment of the new one
+    const auto it = _segments.find(location.segment);
+    if (it == _segments.end()) {
+        return;
+    }
+    _entries.put(hash, location);
+    it->second->live += location.size;
+    it->second->hashes.insert(hash);
+    _size += location.size;
+}
+
+void DiskTileCache::release(uint64_t hash, const Location& location) {
+    _size -= location.size;
+
+    const auto it = _segments.find(location.segment);
+    ghoul_assert(it != _segments.end(), "Segment of a record must exist");
+    Segment& segment = *it->second;
+    segment.live -= location.size;
+    segment.hashes.erase(hash);
+
+    // The remaining records of a mostly unused segment are the tiles that were not read
+    // since the segment became fragmented, so they are dropped together with it
+    if (it->second != _currentSegment && segment.live * 4 < segment.used) {
+        removeSegment(segment.id);
+    }
+}
+
+void DiskTileCache::removeSegment(uint32_t id) {
+    const auto it = _segments.find(id);
+    ghoul_assert(it != _segments.end(), "Segment must exist");
+    const std::shared_ptr<Segment> segment = std::move(it->second);
+    _segments.erase(it);
+    if (segment == _currentSegment) {
+        _currentSegment = nullptr;
+    }
+
+    for (uint64_t hash : segment->hashes) {
+        const std::optional<Location> location = _entries.remove(hash);
+        ghoul_assert(
+            location.has_value() && location->segment == id,
+            "Record must be stored in this segment"
+        );
+        _size -= location->size;
+        ++_nEvictions;
+    }
+    segment->hashes.clear();
+    segment->live = 0;
+
+    // The file is deleted once the last reader has finished copying from it
+    segment->isRemoved = true;
+}
+
+void DiskTileCache::evict() {
+    while (_size > _maximumSize && !_entries.isEmpty()) {
+        const std::pair<uint64_t, Location> entry = _entries.popLRU();
+        release(entry.first, entry.second);
+        ++_nEvictions;
+    }
+}
+
+void DiskTileCache::clear() {
+    ZoneScoped
+
+    LINFO("Clearing disk tile cache");
+    std::lock_guard lock(_mutex);
+    for (const std::pair<const uint32_t, std::shared_ptr<Segment>>& s : _segments) {
+        s.second->isRemoved = true;
+    }
+    _segments.clear();
+    _currentSegment = nullptr;
+    _entries.clear();
+    _size = 0;
+}
+
+void DiskTileCache::update() {
+    constexpr const uint64_t ByteToMegaByte = 1024 * 1024;
+
+    _hits = _nHits.load();
+    _misses = _nMisses.load();
+    _evictions = _nEvictions.load();
+    _usedSize = static_cast<int>(size() / ByteToMegaByte);
+}
+
+void DiskTileCache::setMaximumSize(uint64_t maximumSize) {
+    std::lock_guard lock(_mutex);
+    _maximumSize = maximumSize;
+    evict();
+}
+
+uint64_t DiskTileCache::maximumSize() const {
+    std::lock_guard lock(_mutex);
+    return _maximumSize;
+}
+
+uint64_t DiskTileCache::size() const {
+    std::lock_guard lock(_mutex);
+    return _size;
+}
+
+void DiskTileCache::loadIndex() {
+    ZoneScoped
+
+    namespace fs = std::filesystem;
+
+    std::vector<std::shared_ptr<Segment>> segments;
+    std::error_code ec;
+    for (const fs::directory_entry& e : fs::directory_iterator(_directory, ec)) {
+        if (!e.is_regular_file(ec)) {
+            continue;
+        }
+        const fs::path& path = e.path();
+        if (path.extension() == ".tile" || path.extension() == ".tmp") {
+            // Left over from the previous version of the cache that stored every tile in
+            // a separate file
+            fs::remove(path, ec);
+            continue;
+        }
+        const std::optional<uint32_t> id = segmentFromFilename(path);
+        if (!id.has_value()) {
+            continue;
+        }
+        const uint64_t size = e.file_size(ec);
+        auto segment = std::make_shared<Segment>(*id, path.string(), size, size);
+        if (ec || !segment->file->isOpen()) {
+            LWARNING(fmt::format(
+                "Could not open disk tile cache segment '{}'", path.string()
+            ));
+            continue;
+        }
+        _nextSegment = std::max(_nextSegment, *id + 1);
+        segments.push_back(std::move(segment));
+    }
+    std::sort(
+        segments.begin(), segments.end(),
+        [](const std::shared_ptr<Segment>& lhs, const std::shared_ptr<Segment>& rhs) {
+            return lhs->id < rhs->id;
+        }
+    );
+
+    // The segments are the authoritative source for which tiles exist, the index file
+    // only provides the recency order of the previous session. As records are only
+    // appended, a later record replaces an earlier record of the same tile
+    std::unordered_map<uint64_t, Location> records;
+    for (const std::shared_ptr<Segment>& segment : segments) {
+        const MemoryMappedFile& file = *segment->file;
+        uint64_t offset = 0;
+        while (file.size() - offset >= HeaderSize) {
+            Header header;
+            std::memcpy(&header, file.data() + offset, sizeof(Header));
+            if (header.magic != TileMagic || header.version != CurrentVersion ||
+                header.dataSize > file.size() - offset - HeaderSize)
+            {
+                // The remainder of the segment was never written
+                break;
+            }
+            const uint64_t size = std::min(
+                recordSize(header.dataSize),
+                file.size() - offset
+            );
+            const Key key = {
+                header.provider,
+                TileIndex(header.x, header.y, header.level),
+                header.initDataKey
+            };
+            records[contentHash(key)] = { segment->id, offset, size };
+            offset += size;
+        }
+    }
+
+    std::vector<IndexEntry> order;
+    const std::string indexPath = fmt::format("{}/{}", _directory, IndexFile);
+    std::ifstream index(indexPath, std::ifstream::binary);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t nEntries = 0;
+    index.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t));
+    index.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
+    index.read(reinterpret_cast<char*>(&nEntries), sizeof(uint64_t));
+    // The number of entries is bounded by the size of the file so that a corrupted
+    // index can not cause a huge allocation
+    std::error_code sizeError;
+    const uint64_t indexSize = fs::file_size(indexPath, sizeError);
+    const uint64_t headerSize = 2 * sizeof(uint32_t) + sizeof(uint64_t);
+    const bool hasValidSize = !sizeError && indexSize >= headerSize &&
+        nEntries <= (indexSize - headerSize) / sizeof(IndexEntry);
+    if (index.good() && magic == IndexMagic && version == CurrentVersion &&
+        hasValidSize)
+    {
+        order.resize(nEntries);
+        index.read(
+            reinterpret_cast<char*>(order.data()),
+            nEntries * sizeof(IndexEntry)
+        );
+        if (!index.good()) {
+            order.clear();
+        }
+    }
+
+    // The index is stored from least to most recently used
+    std::vector<std::pair<uint64_t, Location>> known;
+    known.reserve(order.size());
+    for (const IndexEntry& entry : order) {
+        const auto it = records.find(entry.hash);
+        if (it != records.end()) {
+            known.push_back(*it);
+            records.erase(it);
+        }
+    }
+
+    std::lock_guard lock(_mutex);
+    for (std::shared_ptr<Segment>& segment : segments) {
+        _segments[segment->id] = std::move(segment);
+    }
+    // Records that are not part of the index are inserted first so that they are the
+    // first ones to be evicted
+    for (const std::pair<const uint64_t, Location>& record : records) {
+        insert(record.first, record.second);
+    }
+    for (const std::pair<uint64_t, Location>& record : known) {
+        insert(record.first, record.second);
+    }
+
+    std::vector<uint32_t> fragmented;
+    for (const std::pair<const uint32_t, std::shared_ptr<Segment>>& s : _segments) {
+        if (s.second->live * 4 < s.second->used) {
+            fragmented.push_back(s.first);
+        }
+    }
+    for (uint32_t id : fragmented) {
+        removeSegment(id);
+    }
+
+    LINFO(fmt::format(
+        "Loaded {} tiles ({} MB) in {} segments from '{}'",
+        _entries.size(), _size / (1024 * 1024), _segments.size(), _directory
+    ));
+}
+
+void DiskTileCache::saveIndex() {
+    ZoneScoped
+
+    std::vector<IndexEntry> order;
+    std::vector<std::shared_ptr<Segment>> segments;
+    {
+        std::lock_guard lock(_mutex);
+        order.reserve(_entries.size());
+        while (!_entries.isEmpty()) {
+            const std::pair<uint64_t, Location> entry = _entries.popLRU();
+            order.push_back({ entry.first, entry.second.size });
+        }
+        _size = 0;
+
+        for (std::pair<const uint32_t, std::shared_ptr<Segment>>& s : _segments) {
+            segments.push_back(std::move(s.second));
+        }
+        _segments.clear();
+        _currentSegment = nullptr;
+    }
+
+    // The space at the end of a segment was only allocated for records that were never
+    // written, and it can only be released after the segment is no longer mapped
+    for (const std::shared_ptr<Segment>& segment : segments) {
+        segment->file = nullptr;
+        std::error_code ec;
+        std::filesystem::resize_file(segment->path, segment->used, ec);
+    }
+
+    const std::string path = fmt::format("{}/{}", _directory, IndexFile);
+    std::ofstream index(path, std::ofstream::binary);
+    const uint64_t nEntries = order.size();
+    index.write(reinterpret_cast<const char*>(&IndexMagic), sizeof(uint32_t));
+    index.write(reinterpret_cast<const char*>(&CurrentVersion), sizeof(uint32_t));
+    index.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
+    index.write(
+        reinterpret_cast<const char*>(order.data()),
+        nEntries * sizeof(IndexEntry)
+    );
+    if (!index.good()) {
+        LERROR(fmt::format("Error writing disk tile cache index '{}'", path));
+    }
+}
+
+} // namespace openspace::globebrowsing::cache
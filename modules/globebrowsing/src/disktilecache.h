@@ -0,0 +1,196 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
+
+#include <modules/globebrowsing/src/lrucache.h>
+#include <modules/globebrowsing/src/rawtile.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/scalar/intproperty.h>
+#include <openspace/properties/triggerproperty.h>
+#include <openspace/util/memorymappedfile.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_set>
+
+namespace openspace::globebrowsing::cache {
+
+/**
+ * A persistent cache of post-processed RawTile payloads that survives between sessions.
+ * Tiles are packed into a small number of segment files that are appended to. Every
+ * record in a segment consists of a fixed-size header, containing the full key for
+ * verification and the TileMetaData, followed by the image data, which starts at a 128
+ * byte aligned offset and is stored in exactly the layout in which it is uploaded to the
+ * GPU. The segments are memory mapped and an in-memory index maps the hash of each Key
+ * to the segment and offset of its record, so reading a tile is a single copy out of the
+ * mapping into the RawTile and does not require a conversion.
+ *
+ * The total size of all live records is limited by the maximum size, and the least
+ * recently used tiles are removed from the index when this budget is exceeded. A segment
+ * is deleted from the disk once most of its records are no longer live, and tiles that
+ * are read from a segment that is only half used are rewritten into the current segment
+ * first so that they survive the deletion. The recency order is stored in an index file
+ * when the cache is destroyed.
+ *
+ * The #get and #put functions can be called concurrently from any thread, all other
+ * functions have to be called from the main thread.
+ */
+class DiskTileCache : public properties::PropertyOwner {
+public:
+    struct Key {
+        /// Identifies the dataset, see #providerHash
+        uint64_t provider;
+        TileIndex tileIndex;
+        TileTextureInitData::HashKey initDataKey;
+    };
+
+    /**
+     * Creates a cache that stores its segments in \p directory, which is created if it
+     * does not exist, and that will use at most \p maximumSize bytes of disk space.
+     */
+    DiskTileCache(std::string directory, uint64_t maximumSize);
+    ~DiskTileCache();
+
+    /**
+     * Returns a hash of the \p identifier of a dataset that is stable between sessions
+     * and platforms and that can be used as the Key::provider.
+     */
+    static uint64_t providerHash(const std::string& identifier);
+
+    /**
+     * Returns the tile stored for the \p key or <code>std::nullopt</code> if no tile
+     * exists or if the stored tile does not match the \p initData.
+     */
+    std::optional<RawTile> get(const Key& key, const TileTextureInitData& initData);
+
+    /**
+     * Stores the \p rawTile for the \p key, replacing a previously stored tile. Tiles
+     * that were read with an error are not stored as they might be temporary failures.
+     */
+    void put(const Key& key, const RawTile& rawTile);
+
+    /// Removes all tiles from the disk
+    void clear();
+
+    /// Updates the property values with the current statistics
+    void update();
+
+    void setMaximumSize(uint64_t maximumSize);
+    uint64_t maximumSize() const;
+    uint64_t size() const;
+
+private:
+    struct IdentityHasher {
+        size_t operator()(uint64_t v) const { return static_cast<size_t>(v); }
+    };
+
+    /// The position of a record inside the segments
+    struct Location {
+        uint32_t segment = 0;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+
+    /**
+     * A segment file into which records are packed. A segment is kept alive by the
+     * readers that copy out of its mapping, and the file is only deleted from the disk
+     * when the last reference to a removed segment is released.
+     */
+    struct Segment {
+        Segment(uint32_t id, std::string path, uint64_t capacity, uint64_t used);
+        ~Segment();
+
+        const uint32_t id;
+        const std::string path;
+        std::unique_ptr<MemoryMappedFile> file;
+        /// The size of the file, which is allocated when the segment is created
+        const uint64_t capacity;
+        /// The number of bytes that were handed out to records
+        uint64_t used;
+        /// The number of bytes that belong to records that are part of the index
+        uint64_t live = 0;
+        /// The hashes of the records in this segment that are part of the index
+        std::unordered_set<uint64_t> hashes;
+        std::atomic_bool isRemoved = false;
+    };
+
+    static uint64_t contentHash(const Key& key);
+    std::string segmentPath(uint32_t id) const;
+
+    void loadIndex();
+    void saveIndex();
+
+    /// Adds the record at \p location to the index. The caller must hold the _mutex
+    void insert(uint64_t hash, const Location& location);
+
+    /// Removes the record of \p hash at \p location, which is no longer part of the
+    /// _entries, from its segment and deletes the segment if most of its records are no
+    /// longer in use. The caller must hold the _mutex
+    void release(uint64_t hash, const Location& location);
+
+    /// Removes the segment \p id and all of the records that are still stored in it from
+    /// the index. The caller must hold the _mutex
+    void removeSegment(uint32_t id);
+
+    /// Reserves \p size bytes in the current segment, creating a new segment if the
+    /// current one is full. The caller must hold the _mutex
+    std::shared_ptr<Segment> allocate(uint64_t size, uint64_t& offset);
+
+    /// Removes the least recently used tiles until the size is within the budget. The
+    /// caller must hold the _mutex
+    void evict();
+
+    const std::string _directory;
+
+    mutable std::mutex _mutex;
+    /// Maps from the content hash to the location of the record
+    LRUCache<uint64_t, Location, IdentityHasher> _entries;
+    std::map<uint32_t, std::shared_ptr<Segment>> _segments;
+    /// The segment to which new records are appended
+    std::shared_ptr<Segment> _currentSegment;
+    uint32_t _nextSegment = 0;
+    uint64_t _size = 0;
+    uint64_t _maximumSize;
+
+    std::atomic<int> _nHits = 0;
+    std::atomic<int> _nMisses = 0;
+    std::atomic<int> _nEvictions = 0;
+
+    properties::IntProperty _hits;
+    properties::IntProperty _misses;
+    properties::IntProperty _evictions;
+    properties::IntProperty _usedSize;
+    properties::TriggerProperty _clear;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
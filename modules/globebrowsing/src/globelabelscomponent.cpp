@@ -722,10 +722,11 @@ void GlobeLabelsComponent::renderLabels(const RenderData& data,
     }
     glm::dvec3 orthoUp = glm::normalize(glm::cross(orthoRight, cameraViewDirectionObj));
 
+    std::vector<const LabelEntry*> visibleLabels;
+    std::vector<glm::dvec3> labelPositions;
     for (const LabelEntry& lEntry : _labels.labelsArray) {
-        glm::vec3 position = lEntry.geoPosition;
         glm::dvec3 locationPositionWorld =
-            glm::dvec3(_globe->modelTransform() * glm::dvec4(position, 1.0));
+            glm::dvec3(_globe->modelTransform() * glm::dvec4(lEntry.geoPosition, 1.0));
         double distanceCameraToLabelWorld =
             glm::length(locationPositionWorld - data.camera.positionVec3());
 
@@ -733,59 +734,79 @@ void GlobeLabelsComponent::renderLabels(const RenderData& data,
             ((distToCamera > (distanceCameraToLabelWorld + _labelsDistaneEPS)) &&
             isLabelInFrustum(VP, locationPositionWorld)))
         {
-            if (_labelAlignmentOption == Circularly) {
-                glm::dvec3 labelNormalObj = glm::dvec3(
-                    invModelMatrix * glm::dvec4(data.camera.positionVec3(), 1.0)
-                ) - glm::dvec3(position);
+            visibleLabels.push_back(&lEntry);
+            labelPositions.push_back(glm::dvec3(lEntry.geoPosition));
+        }
+    }
 
-                glm::dvec3 labelUpDirectionObj = glm::dvec3(position);
+    // The labels are lifted onto the height mapped surface. The heights of all visible
+    // labels are sampled in a single batch, as most of them share the same few tiles
+    const std::vector<float> heights = _globe->heights(labelPositions);
 
-                orthoRight = glm::normalize(
-                    glm::cross(labelUpDirectionObj, labelNormalObj)
-                );
-                if (orthoRight == glm::dvec3(0.0)) {
-                    glm::dvec3 otherVector(
-                        labelUpDirectionObj.y,
-                        labelUpDirectionObj.x,
-                        labelUpDirectionObj.z
-                    );
-                    orthoRight = glm::normalize(glm::cross(otherVector, labelNormalObj));
-                }
-                orthoUp = glm::normalize(glm::cross(labelNormalObj, orthoRight));
+    for (size_t i = 0; i < visibleLabels.size(); ++i) {
+        const LabelEntry& lEntry = *visibleLabels[i];
+        const glm::dvec3 normal = _globe->ellipsoid().geodeticSurfaceNormal(
+            globebrowsing::Geodetic2{
+                glm::radians(static_cast<double>(lEntry.latitude)),
+                glm::radians(static_cast<double>(lEntry.longitude))
             }
+        );
+        glm::vec3 position = glm::vec3(
+            labelPositions[i] + normal * static_cast<double>(heights[i])
+        );
 
-            position += _labelsMinHeight;
-
-            ghoul::fontrendering::FontRenderer::ProjectedLabelsInformation labelInfo;
-            labelInfo.orthoRight = orthoRight;
-            labelInfo.orthoUp = orthoUp;
-            labelInfo.minSize = _labelsMinSize;
-            labelInfo.maxSize = _labelsMaxSize;
-            labelInfo.cameraPos = data.camera.positionVec3();
-            labelInfo.cameraLookUp = data.camera.lookUpVectorWorldSpace();
-            labelInfo.renderType = 0;
-            labelInfo.mvpMatrix = modelViewProjectionMatrix;
-            labelInfo.scale = powf(2.f, _labelsSize);
-            labelInfo.enableDepth = true;
-            labelInfo.enableFalseDepth = true;
-            labelInfo.disableTransmittance = true;
-
-            // Testing
-            glm::dmat4 modelviewTransform = glm::dmat4(data.camera.combinedViewMatrix()) *
-                                            _globe->modelTransform();
-            labelInfo.modelViewMatrix = modelviewTransform;
-            labelInfo.projectionMatrix = glm::dmat4(
-                data.camera.sgctInternal.projectionMatrix()
-            );
+        if (_labelAlignmentOption == Circularly) {
+            glm::dvec3 labelNormalObj = glm::dvec3(
+                invModelMatrix * glm::dvec4(data.camera.positionVec3(), 1.0)
+            ) - glm::dvec3(position);
 
-            ghoul::fontrendering::FontRenderer::defaultProjectionRenderer().render(
-                *_font,
-                position,
-                lEntry.feature,
-                textColor,
-                labelInfo
+            glm::dvec3 labelUpDirectionObj = glm::dvec3(position);
+
+            orthoRight = glm::normalize(
+                glm::cross(labelUpDirectionObj, labelNormalObj)
             );
+            if (orthoRight == glm::dvec3(0.0)) {
+                glm::dvec3 otherVector(
+                    labelUpDirectionObj.y,
+                    labelUpDirectionObj.x,
+                    labelUpDirectionObj.z
+                );
+                orthoRight = glm::normalize(glm::cross(otherVector, labelNormalObj));
+            }
+            orthoUp = glm::normalize(glm::cross(labelNormalObj, orthoRight));
         }
+
+        position += _labelsMinHeight;
+
+        ghoul::fontrendering::FontRenderer::ProjectedLabelsInformation labelInfo;
+        labelInfo.orthoRight = orthoRight;
+        labelInfo.orthoUp = orthoUp;
+        labelInfo.minSize = _labelsMinSize;
+        labelInfo.maxSize = _labelsMaxSize;
+        labelInfo.cameraPos = data.camera.positionVec3();
+        labelInfo.cameraLookUp = data.camera.lookUpVectorWorldSpace();
+        labelInfo.renderType = 0;
+        labelInfo.mvpMatrix = modelViewProjectionMatrix;
+        labelInfo.scale = powf(2.f, _labelsSize);
+        labelInfo.enableDepth = true;
+        labelInfo.enableFalseDepth = true;
+        labelInfo.disableTransmittance = true;
+
+        // Testing
+        glm::dmat4 modelviewTransform = glm::dmat4(data.camera.combinedViewMatrix()) *
+                                        _globe->modelTransform();
+        labelInfo.modelViewMatrix = modelviewTransform;
+        labelInfo.projectionMatrix = glm::dmat4(
+            data.camera.sgctInternal.projectionMatrix()
+        );
+
+        ghoul::fontrendering::FontRenderer::defaultProjectionRenderer().render(
+            *_font,
+            position,
+            lEntry.feature,
+            textColor,
+            labelInfo
+        );
     }
 }
 
@@ -238,4 +238,9 @@ glm::dvec3 GlobeTranslation::position(const UpdateData&) const {
     }
 }
 
+bool GlobeTranslation::requiresMainThreadUpdate() const {
+    // Sampling the height map reads the globe's chunk tree
+    return true;
+}
+
 } // namespace openspace::globebrowsing
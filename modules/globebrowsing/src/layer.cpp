@@ -411,6 +411,10 @@ Tile::Status Layer::tileStatus(const TileIndex& index) const {
         Tile::Status::Unavailable;
 }
 
+bool Layer::prefetchTile(const TileIndex& index) {
+    return _tileProvider ? tileprovider::prefetch(*_tileProvider, index) : false;
+}
+
 layergroupid::TypeID Layer::type() const {
     return _type;
 }
@@ -453,11 +457,11 @@ void Layer::onChange(std::function<void(Layer*)> callback) {
     _onChangeCallback = std::move(callback);
 }
 
-int Layer::update() {
+int Layer::update(std::vector<TileIndex>& updatedTiles) {
     ZoneScoped
 
     if (_tileProvider) {
-        return tileprovider::update(*_tileProvider);
+        return tileprovider::update(*_tileProvider, updatedTiles);
     }
     else {
         return 0;
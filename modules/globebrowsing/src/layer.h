@@ -54,6 +54,13 @@ public:
     ChunkTilePile chunkTilePile(const TileIndex& tileIndex, int pileSize) const;
     Tile::Status tileStatus(const TileIndex& index) const;
 
+    /**
+     * Requests the tile with the \p index to be loaded with a lower priority than the
+     * tiles that are currently needed for rendering. Returns whether a new request was
+     * enqueued, which is not the case if the tile is already cached or requested.
+     */
+    bool prefetchTile(const TileIndex& index);
+
     layergroupid::TypeID type() const;
     layergroupid::BlendModeID blendMode() const;
     TileDepthTransform depthTransform() const;
@@ -66,8 +73,9 @@ public:
 
     void onChange(std::function<void(Layer*)> callback);
 
-    // Return:  number of tiles that were updated
-    int update();
+    // Return:  number of tiles that were updated. The indices of uploaded tiles are
+    //          appended to updatedTiles
+    int update(std::vector<TileIndex>& updatedTiles);
 
     glm::ivec2 tilePixelStartOffset() const;
     glm::ivec2 tilePixelSizeDifference() const;
@@ -97,7 +97,7 @@ void LayerGroup::deinitialize() {
     }
 }
 
-int LayerGroup::update() {
+int LayerGroup::update(std::vector<TileIndex>& updatedTiles) {
     ZoneScoped
 
     int res = 0;
@@ -105,7 +105,7 @@ int LayerGroup::update() {
 
     for (const std::unique_ptr<Layer>& layer : _layers) {
         if (layer->enabled()) {
-            res += layer->update();
+            res += layer->update(updatedTiles);
             _activeLayers.push_back(layer.get());
         }
     }
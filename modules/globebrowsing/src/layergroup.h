@@ -29,10 +29,12 @@
 
 #include <modules/globebrowsing/src/layergroupid.h>
 #include <openspace/properties/scalar/boolproperty.h>
+#include <vector>
 
 namespace openspace::globebrowsing {
 
 class Layer;
+struct TileIndex;
 
 namespace tileprovider { struct TileProvider; }
 
@@ -48,8 +50,9 @@ struct LayerGroup : public properties::PropertyOwner {
     void deinitialize();
 
     /// Updates all layers tile providers within this group
-    /// Return:  Number of tiles that were updated
-    int update();
+    /// Return:  Number of tiles that were updated. The indices of uploaded tiles are
+    ///          appended to updatedTiles
+    int update(std::vector<TileIndex>& updatedTiles);
 
     Layer* addLayer(const ghoul::Dictionary& layerDict);
     void deleteLayer(const std::string& layerName);
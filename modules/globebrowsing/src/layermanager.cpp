@@ -143,12 +143,12 @@ std::array<LayerGroup*, LayerManager::NumLayerGroups> LayerManager::layerGroups(
     return res;
 }
 
-int LayerManager::update() {
+int LayerManager::update(std::vector<TileIndex>& updatedTiles) {
     ZoneScoped
 
     int res = 0;
     for (std::unique_ptr<LayerGroup>& layerGroup : _layerGroups) {
-        res += layerGroup->update();
+        res += layerGroup->update(updatedTiles);
     }
     return res;
 }
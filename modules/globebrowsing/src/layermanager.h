@@ -32,6 +32,7 @@
 #include <array>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace ghoul { class Dictionary; }
 
@@ -42,6 +43,7 @@ namespace openspace::globebrowsing {
 class Layer;
 struct LayerGroup;
 class TileTextureInitData;
+struct TileIndex;
 
 /**
  * Manages multiple LayerGroups.
@@ -66,8 +68,9 @@ public:
 
     std::array<LayerGroup*, NumLayerGroups> layerGroups() const;
 
-    // Return:  Number of tiles updated
-    int update();
+    // Return:  Number of tiles updated. The indices of uploaded tiles are appended to
+    //          updatedTiles
+    int update(std::vector<TileIndex>& updatedTiles);
     void reset(bool includeDisabled = false);
 
     void onChange(std::function<void(Layer* l)> callback);
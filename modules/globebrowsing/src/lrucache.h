@@ -25,8 +25,13 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 
-#include <list>
-#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
 #include <vector>
 
 namespace openspace::globebrowsing::cache {
@@ -34,12 +39,17 @@ namespace openspace::globebrowsing::cache {
 /**
  * Templated class implementing a Least-Recently-Used Cache.
  * <code>KeyType</code> needs to be an enumerable type.
+ *
+ * All items are stored densely in a single vector and are chained into the LRU order
+ * through indices, so bumping an item to the front does not allocate any memory. The
+ * items are found through an open-addressing hash table with linear probing that only
+ * stores the index into the item vector. Removing an item moves the last item of the
+ * vector into its place, which keeps the storage contiguous.
  */
 template <typename KeyType, typename ValueType, typename HasherType>
 class LRUCache {
 public:
     using Item = std::pair<KeyType, ValueType>;
-    using Items = std::list<Item>;
 
     /**
      * \param size is the maximum size of the cache given in number of cached items.
@@ -56,6 +66,12 @@ public:
      * \returns true if value of this key exists.
      */
     bool touch(const KeyType& key);
+
+    /**
+     * Removes the value with the provided \p key from the cache.
+     * \returns the removed value or <code>std::nullopt</code> if the key did not exist
+     */
+    std::optional<ValueType> remove(const KeyType& key);
     bool isEmpty() const;
     ValueType get(const KeyType& key);
 
@@ -72,15 +88,92 @@ public:
     size_t maximumCacheSize() const;
 
 private:
+    using Index = uint32_t;
+    static constexpr const Index Invalid = std::numeric_limits<Index>::max();
+
+    struct Entry {
+        Item item;
+        uint64_t hash;
+        Index previous;
+        Index next;
+    };
+
+    uint64_t hash(const KeyType& key) const;
+
+    /// Returns the slot in the hash table that points to the entry with the \p key or
+    /// the empty slot at which the key would have to be inserted
+    size_t findSlot(const KeyType& key, uint64_t hash) const;
+
+    /// Returns the slot in the hash table that points to the entry at \p index
+    size_t slotOfEntry(Index index) const;
+
+    /// Removes the slot from the hash table using backward shift deletion so that no
+    /// tombstones are necessary
+    void eraseSlot(size_t slot);
+    void growTable();
+
+    void unlink(Index index);
+    void linkFront(Index index);
+
+    /// Removes the entry at \p index from the LRU list, the hash table, and the entry
+    /// storage and returns its item
+    Item removeEntry(Index index);
+
     void putWithoutCleaning(KeyType key, ValueType value);
     void clean();
 
     std::vector<Item> cleanAndFetchPopped();
 
-    Items _itemList;
-    std::unordered_map<KeyType, typename Items::const_iterator, HasherType> _itemMap;
+    std::vector<Entry> _entries;
+    std::vector<Index> _table;
+    Index _head = Invalid;
+    Index _tail = Invalid;
+
+    size_t _maximumCacheSize;
+    HasherType _hasher;
+};
+
+/**
+ * A thread-safe cache that distributes its keys across <code>NShards</code> independent
+ * LRUCaches, each protected by its own mutex. Threads accessing different shards do not
+ * contend with each other. The eviction order is only least-recently-used within each
+ * shard, which is why this cache does not provide the <code>popMRU</code> and
+ * <code>popLRU</code> functions of the LRUCache.
+ */
+template <typename KeyType, typename ValueType, typename HasherType, size_t NShards = 8>
+class ShardedLRUCache {
+public:
+    using Item = std::pair<KeyType, ValueType>;
+
+    /**
+     * \param size is the maximum size of the cache given in number of cached items. Each
+     *        shard can hold an equal part of the items.
+     */
+    ShardedLRUCache(size_t size);
+
+    void put(KeyType key, ValueType value);
+    std::vector<Item> putAndFetchPopped(KeyType key, ValueType value);
+    void clear();
+    bool exist(const KeyType& key) const;
+    bool touch(const KeyType& key);
+    ValueType get(const KeyType& key);
+    size_t size() const;
+    size_t maximumCacheSize() const;
+
+private:
+    struct Shard {
+        Shard(size_t size) : cache(size) {}
+
+        mutable std::mutex mutex;
+        LRUCache<KeyType, ValueType, HasherType> cache;
+    };
+
+    Shard& shard(const KeyType& key);
+    const Shard& shard(const KeyType& key) const;
 
+    std::vector<std::unique_ptr<Shard>> _shards;
     size_t _maximumCacheSize;
+    HasherType _hasher;
 };
 
 } // namespace openspace::globebrowsing::cache
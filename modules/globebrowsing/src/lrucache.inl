@@ -29,13 +29,16 @@ namespace openspace::globebrowsing::cache {
 
 template<typename KeyType, typename ValueType, typename HasherType>
 LRUCache<KeyType, ValueType, HasherType>::LRUCache(size_t size)
-    : _maximumCacheSize(size)
+    : _table(16, Invalid)
+    , _maximumCacheSize(size)
 {}
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clear() {
-    _itemList.clear();
-    _itemMap.clear();
+    _entries.clear();
+    std::fill(_table.begin(), _table.end(), Invalid);
+    _head = Invalid;
+    _tail = Invalid;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
@@ -54,76 +57,67 @@ LRUCache<KeyType, ValueType, HasherType>::putAndFetchPopped(KeyType key, ValueTy
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::exist(const KeyType& key) const {
-    return (_itemMap.count(key) > 0);
+    return _table[findSlot(key, hash(key))] != Invalid;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::touch(const KeyType& key) {
     ZoneScoped
 
-    const auto it = _itemMap.find(key);
-    if (it != _itemMap.end()) {
-        // @TODO (abock, 2020-08-14) Instead of removing the iterator from the previous
-        // position and then readding it at the front, it might make more sense to move
-        // them around?  That would prevent the dynamic memoray allocation that is
-        // happening here
+    const Index index = _table[findSlot(key, hash(key))];
+    if (index == Invalid) {
+        return false;
+    }
 
-        // Found in cache
-        ValueType value = it->second->second;
-        // Remove from current position
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
-        // Bump to front
-        _itemList.emplace_front(key, value);
-        _itemMap.emplace(key, _itemList.begin());
+    // Bump to front
+    unlink(index);
+    linkFront(index);
+    return true;
+}
 
-        return true;
-    }
-    else {
-        return false;
+template<typename KeyType, typename ValueType, typename HasherType>
+std::optional<ValueType> LRUCache<KeyType, ValueType, HasherType>::remove(
+                                                                      const KeyType& key)
+{
+    const Index index = _table[findSlot(key, hash(key))];
+    if (index == Invalid) {
+        return std::nullopt;
     }
+    return removeEntry(index).second;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::isEmpty() const {
-    return (_itemMap.size() == 0);
+    return _entries.empty();
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 ValueType LRUCache<KeyType, ValueType, HasherType>::get(const KeyType& key) {
-    const auto it = _itemMap.find(key);
-    // Move list iterator pointing to value
-    _itemList.splice(_itemList.begin(), _itemList, it->second);
-    ValueType res = it->second->second;
-    return res;
+    const Index index = _table[findSlot(key, hash(key))];
+    ghoul_assert(index != Invalid, "Key must exist in the cache");
+
+    unlink(index);
+    linkFront(index);
+    return _entries[index].item.second;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popMRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
+    ghoul_assert(!_entries.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
 
-    auto first_it = _itemList.begin();
-    _itemMap.erase(first_it->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.front();
-    _itemList.pop_front();
-    return toReturn;
+    return removeEntry(_head);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popLRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
+    ghoul_assert(!_entries.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
 
-    auto lastIt = _itemList.end();
-    lastIt--;
-    _itemMap.erase(lastIt->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.back();
-    _itemList.pop_back();
-    return toReturn;
+    return removeEntry(_tail);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 size_t LRUCache<KeyType, ValueType, HasherType>::size() const {
-    return _itemMap.size();
+    return _entries.size();
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
@@ -131,26 +125,186 @@ size_t LRUCache<KeyType, ValueType, HasherType>::maximumCacheSize() const {
     return _maximumCacheSize;
 }
 
+template<typename KeyType, typename ValueType, typename HasherType>
+uint64_t LRUCache<KeyType, ValueType, HasherType>::hash(const KeyType& key) const {
+    // The hashers used for tiles and jobs pack the key into the bits with very little
+    // entropy in the lower bits, so the result is mixed (MurmurHash3 finalizer) before
+    // it is used for linear probing
+    uint64_t h = static_cast<uint64_t>(_hasher(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t LRUCache<KeyType, ValueType, HasherType>::findSlot(const KeyType& key,
+                                                         uint64_t hash) const
+{
+    const size_t mask = _table.size() - 1;
+    size_t slot = hash & mask;
+    while (true) {
+        const Index index = _table[slot];
+        if (index == Invalid) {
+            return slot;
+        }
+        const Entry& e = _entries[index];
+        if (e.hash == hash && e.item.first == key) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t LRUCache<KeyType, ValueType, HasherType>::slotOfEntry(Index index) const {
+    const size_t mask = _table.size() - 1;
+    size_t slot = _entries[index].hash & mask;
+    while (_table[slot] != index) {
+        ghoul_assert(_table[slot] != Invalid, "Entry must be in the hash table");
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::eraseSlot(size_t slot) {
+    const size_t mask = _table.size() - 1;
+    size_t hole = slot;
+    size_t i = slot;
+    while (true) {
+        i = (i + 1) & mask;
+        const Index index = _table[i];
+        if (index == Invalid) {
+            break;
+        }
+
+        // The entry can only be moved into the hole if its ideal slot does not lie
+        // cyclically in (hole, i], otherwise it would become unreachable
+        const size_t ideal = _entries[index].hash & mask;
+        const bool canMove = (hole <= i) ?
+            (ideal <= hole || ideal > i) :
+            (ideal <= hole && ideal > i);
+        if (canMove) {
+            _table[hole] = index;
+            hole = i;
+        }
+    }
+    _table[hole] = Invalid;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::growTable() {
+    std::vector<Index> table(_table.size() * 2, Invalid);
+    const size_t mask = table.size() - 1;
+    for (Index i = 0; i < static_cast<Index>(_entries.size()); ++i) {
+        size_t slot = _entries[i].hash & mask;
+        while (table[slot] != Invalid) {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = i;
+    }
+    _table = std::move(table);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::unlink(Index index) {
+    Entry& e = _entries[index];
+    if (e.previous != Invalid) {
+        _entries[e.previous].next = e.next;
+    }
+    else {
+        _head = e.next;
+    }
+    if (e.next != Invalid) {
+        _entries[e.next].previous = e.previous;
+    }
+    else {
+        _tail = e.previous;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::linkFront(Index index) {
+    Entry& e = _entries[index];
+    e.previous = Invalid;
+    e.next = _head;
+    if (_head != Invalid) {
+        _entries[_head].previous = index;
+    }
+    _head = index;
+    if (_tail == Invalid) {
+        _tail = index;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::removeEntry(
+                                                                              Index index)
+{
+    unlink(index);
+    eraseSlot(slotOfEntry(index));
+
+    Item item = std::move(_entries[index].item);
+
+    const Index last = static_cast<Index>(_entries.size() - 1);
+    if (index != last) {
+        // Move the last entry into the gap and redirect everything that pointed to it
+        const size_t lastSlot = slotOfEntry(last);
+        _entries[index] = std::move(_entries[last]);
+        _table[lastSlot] = index;
+
+        Entry& e = _entries[index];
+        if (e.previous != Invalid) {
+            _entries[e.previous].next = index;
+        }
+        else {
+            _head = index;
+        }
+        if (e.next != Invalid) {
+            _entries[e.next].previous = index;
+        }
+        else {
+            _tail = index;
+        }
+    }
+    _entries.pop_back();
+
+    return item;
+}
+
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::putWithoutCleaning(KeyType key,
                                                                   ValueType value)
 {
-    const auto it = _itemMap.find(key);
-    if (it != _itemMap.end()) {
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
+    const uint64_t h = hash(key);
+    size_t slot = findSlot(key, h);
+    if (_table[slot] != Invalid) {
+        const Index index = _table[slot];
+        _entries[index].item.second = std::move(value);
+        unlink(index);
+        linkFront(index);
+        return;
+    }
+
+    // Keep the load factor below 0.75
+    if ((_entries.size() + 1) * 4 > _table.size() * 3) {
+        growTable();
+        slot = findSlot(key, h);
     }
-    _itemList.emplace_front(key, std::move(value));
-    _itemMap.emplace(std::move(key), _itemList.begin());
+
+    const Index index = static_cast<Index>(_entries.size());
+    _entries.push_back({ { std::move(key), std::move(value) }, h, Invalid, Invalid });
+    _table[slot] = index;
+    linkFront(index);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clean() {
-    while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        _itemList.pop_back();
+    while (_entries.size() > _maximumCacheSize) {
+        removeEntry(_tail);
     }
 }
 
@@ -159,14 +313,111 @@ std::vector<std::pair<KeyType, ValueType>>
 LRUCache<KeyType, ValueType, HasherType>::cleanAndFetchPopped()
 {
     std::vector<std::pair<KeyType, ValueType>> toReturn;
-    while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        toReturn.push_back(_itemList.back());
-        _itemList.pop_back();
+    while (_entries.size() > _maximumCacheSize) {
+        toReturn.push_back(removeEntry(_tail));
     }
     return toReturn;
 }
 
+//
+// ShardedLRUCache
+//
+
+template<typename KeyType, typename ValueType, typename HasherType, size_t NShards>
+ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::ShardedLRUCache(size_t size)
+    : _maximumCacheSize(size)
+{
+    static_assert(NShards > 0, "There has to be at least one shard");
+
+    const size_t shardSize = std::max<size_t>(size / NShards, 1);
+    for (size_t i = 0; i < NShards; ++i) {
+        _shards.push_back(std::make_unique<Shard>(shardSize));
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType, size_t NShards>
+typename ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::Shard&
+ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::shard(const KeyType& key) {
+    // Use the upper bits for the shard selection as the lower bits are used within the
+    // individual caches
+    const uint64_t h = static_cast<uint64_t>(_hasher(key)) * 0x9e3779b97f4a7c15ULL;
+    return *_shards[(h >> 32) % NShards];
+}
+
+template<typename KeyType, typename ValueType, typename HasherType, size_t NShards>
+const typename ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::Shard&
+ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::shard(const KeyType& key) const
+{
+    const uint64_t h = static_cast<uint64_t>(_hasher(key)) * 0x9e3779b97f4a7c15ULL;
+    return *_shards[(h >> 32) % NShards];
+}
+
+template<typename KeyType, typename ValueType, typename HasherType, size_t NShards>
+void ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::put(KeyType key,
+                                                                   ValueType value)
+{
+    Shard& s = shard(key);
+    std::lock_guard lock(s.mutex);
+    s.cache.put(std::move(key), std::move(value));
+}
+
+template<typename KeyType, typename ValueType, typename HasherType, size_t NShards>
+std::vector<std::pair<KeyType, ValueType>>
+ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::putAndFetchPopped(KeyType key,
+                                                                          ValueType value)
+{
+    Shard& s = shard(key);
+    std::lock_guard lock(s.mutex);
+    return s.cache.putAndFetchPopped(std::move(key), std::move(value));
+}
+
+template<typename KeyType, typename ValueType, typename HasherType, size_t NShards>
+void ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::clear() {
+    for (const std::unique_ptr<Shard>& s : _shards) {
+        std::lock_guard lock(s->mutex);
+        s->cache.clear();
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType, size_t NShards>
+bool ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::exist(
+                                                                const KeyType& key) const
+{
+    const Shard& s = shard(key);
+    std::lock_guard lock(s.mutex);
+    return s.cache.exist(key);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType, size_t NShards>
+bool ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::touch(const KeyType& key) {
+    Shard& s = shard(key);
+    std::lock_guard lock(s.mutex);
+    return s.cache.touch(key);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType, size_t NShards>
+ValueType ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::get(
+                                                                      const KeyType& key)
+{
+    Shard& s = shard(key);
+    std::lock_guard lock(s.mutex);
+    return s.cache.get(key);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType, size_t NShards>
+size_t ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::size() const {
+    size_t result = 0;
+    for (const std::unique_ptr<Shard>& s : _shards) {
+        std::lock_guard lock(s->mutex);
+        result += s->cache.size();
+    }
+    return result;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType, size_t NShards>
+size_t ShardedLRUCache<KeyType, ValueType, HasherType, NShards>::maximumCacheSize() const
+{
+    return _maximumCacheSize;
+}
+
 } // namespace openspace::globebrowsing::cache
@@ -26,28 +26,15 @@
 #define __OPENSPACE_MODULE_GLOBEBROWSING___LRU_THREAD_POOL___H__
 
 #include <modules/globebrowsing/src/lrucache.h>
+#include <openspace/util/jobsystem.h>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <thread>
 #include <vector>
 
-// Implementation based on http://progsch.net/wordpress/?p=81
-
 namespace openspace::globebrowsing {
 
-template<typename KeyType> class LRUThreadPool;
-
-template<typename KeyType>
-class LRUThreadPoolWorker {
-public:
-    LRUThreadPoolWorker(LRUThreadPool<KeyType>& pool);
-    void operator()();
-
-private:
-    LRUThreadPool<KeyType>& _pool;
-};
-
 /**
  * The <code>LRUThreadPool</code> will only enqueue a certain number of tasks. The most
  * recently enqueued task is the one that will be executed first. This class is templated
@@ -57,15 +44,40 @@ private:
  * outcome to a second enqueued task with the same key. This is because a second enqueued
  * task with the same key will simply be bumped and prioritised before other enqueued
  * tasks. The given task will be ignored.
+ *
+ * The tasks are executed on a JobSystem, which is either created privately for this pool
+ * or shared with the rest of the engine. At most <code>maxConcurrency</code> jobs of the
+ * JobSystem will be working on the tasks of this pool at the same time.
+ *
+ * In addition to the regular tasks, speculative tasks can be added with #enqueuePrefetch.
+ * These are kept in a separate queue and are only executed when no regular task is
+ * waiting. Jobs that only work on prefetch tasks are submitted with the Prefetch priority
+ * and yield back to the JobSystem after every task, so that a regular task never has to
+ * wait for more than a single prefetch task to finish.
  */
 template<typename KeyType>
 class LRUThreadPool {
 public:
     LRUThreadPool(size_t numThreads, size_t queueSize);
+    LRUThreadPool(JobSystem& jobSystem, size_t maxConcurrency, size_t queueSize,
+        JobSystem::Priority priority = JobSystem::Priority::FrameCritical);
     LRUThreadPool(const LRUThreadPool& toCopy);
     ~LRUThreadPool();
 
     void enqueue(std::function<void()> f, KeyType key);
+
+    /**
+     * Enqueues a speculative task. The task is ignored if a regular task with the same
+     * key is already enqueued.
+     */
+    void enqueuePrefetch(std::function<void()> f, KeyType key);
+
+    /**
+     * Moves the prefetch task with the \p key to the regular queue.
+     * \returns true if a prefetch task with the \p key was enqueued
+     */
+    bool promote(KeyType key);
+
     bool touch(KeyType key);
     std::vector<KeyType> getQueuedTasksKeys();
     std::vector<KeyType> getUnqueuedTasksKeys();
@@ -77,11 +89,34 @@ private:
             return static_cast<unsigned long long>(key);
         }
     };
-    friend class LRUThreadPoolWorker<KeyType>;
 
-    std::vector<std::thread> _workers;
+    /// Executes queued tasks in MRU order until the queue is empty. This is the only
+    /// function that is ever submitted to the JobSystem. \p isPrefetchJob is true if
+    /// this job was submitted with the Prefetch priority
+    void processTasks(bool isPrefetchJob);
+
+    /// Submits a job to the JobSystem. The caller must hold the _queueMutex
+    void submitJob(bool isPrefetchJob);
+
+    /// Resubmits all jobs that are waiting in the JobSystem with the Prefetch priority
+    /// with the regular priority instead. The caller must hold the _queueMutex
+    void upgradePrefetchJobs();
+
+    std::unique_ptr<JobSystem> _ownedJobSystem;
+    JobSystem& _jobSystem;
+    const JobSystem::Priority _priority;
+    const JobSystem::Key _key;
+    const JobSystem::Key _prefetchKey;
+    const size_t _maxConcurrency;
+
     cache::LRUCache<KeyType, std::function<void()>, DefaultHasher> _queuedTasks;
+    cache::LRUCache<KeyType, std::function<void()>, DefaultHasher> _prefetchTasks;
     std::vector<KeyType> _unqueuedTasks;
+    /// The number of jobs that are currently enqueued or running processTasks
+    size_t _nActiveJobs = 0;
+    /// The number of jobs that were submitted with the Prefetch priority but that have
+    /// not been started yet
+    size_t _nPendingPrefetchJobs = 0;
     std::mutex _queueMutex;
     std::condition_variable _condition;
 
@@ -25,101 +25,215 @@
 namespace openspace::globebrowsing {
 
 template<typename KeyType>
-LRUThreadPoolWorker<KeyType>::LRUThreadPoolWorker(LRUThreadPool<KeyType>& pool)
-    : _pool(pool)
+LRUThreadPool<KeyType>::LRUThreadPool(size_t numThreads, size_t queueSize)
+    : _ownedJobSystem(std::make_unique<JobSystem>(numThreads))
+    , _jobSystem(*_ownedJobSystem)
+    , _priority(JobSystem::Priority::FrameCritical)
+    , _key(_jobSystem.createKey())
+    , _prefetchKey(_jobSystem.createKey())
+    , _maxConcurrency(numThreads)
+    , _queuedTasks(queueSize)
+    , _prefetchTasks(queueSize)
 {}
 
 template<typename KeyType>
-void LRUThreadPoolWorker<KeyType>::operator()() {
-    std::function<void()> task;
+LRUThreadPool<KeyType>::LRUThreadPool(JobSystem& jobSystem, size_t maxConcurrency,
+                                      size_t queueSize, JobSystem::Priority priority)
+    : _jobSystem(jobSystem)
+    , _priority(priority)
+    , _key(_jobSystem.createKey())
+    , _prefetchKey(_jobSystem.createKey())
+    , _maxConcurrency(maxConcurrency)
+    , _queuedTasks(queueSize)
+    , _prefetchTasks(queueSize)
+{}
+
+template<typename KeyType>
+LRUThreadPool<KeyType>::LRUThreadPool(const LRUThreadPool& toCopy)
+    : _ownedJobSystem(
+        toCopy._ownedJobSystem ?
+            std::make_unique<JobSystem>(toCopy._ownedJobSystem->numThreads()) :
+            nullptr
+    )
+    , _jobSystem(_ownedJobSystem ? *_ownedJobSystem : toCopy._jobSystem)
+    , _priority(toCopy._priority)
+    , _key(_jobSystem.createKey())
+    , _prefetchKey(_jobSystem.createKey())
+    , _maxConcurrency(toCopy._maxConcurrency)
+    , _queuedTasks(toCopy._queuedTasks.maximumCacheSize())
+    , _prefetchTasks(toCopy._prefetchTasks.maximumCacheSize())
+{}
+
+template<typename KeyType>
+LRUThreadPool<KeyType>::~LRUThreadPool() {
+    {
+        std::unique_lock lock(_queueMutex);
+        _stop = true;
+        _queuedTasks.clear();
+        _prefetchTasks.clear();
+
+        // Jobs that have not been picked up yet will never run, the others will notice
+        // the stop flag after finishing their current task
+        const size_t nCancelled = _jobSystem.cancel(_key);
+        const size_t nCancelledPrefetch = _jobSystem.cancel(_prefetchKey);
+        _nActiveJobs -= nCancelled + nCancelledPrefetch;
+        _nPendingPrefetchJobs -= nCancelledPrefetch;
+    }
+
+    std::unique_lock lock(_queueMutex);
+    _condition.wait(lock, [this]() { return _nActiveJobs == 0; });
+}
+
+template<typename KeyType>
+void LRUThreadPool<KeyType>::submitJob(bool isPrefetchJob) {
+    if (isPrefetchJob) {
+        ++_nPendingPrefetchJobs;
+        _jobSystem.enqueue(
+            [this]() { processTasks(true); },
+            JobSystem::Priority::Prefetch,
+            _prefetchKey
+        );
+    }
+    else {
+        _jobSystem.enqueue([this]() { processTasks(false); }, _priority, _key);
+    }
+}
+
+template<typename KeyType>
+void LRUThreadPool<KeyType>::upgradePrefetchJobs() {
+    if (_nPendingPrefetchJobs == 0) {
+        return;
+    }
+
+    // Jobs that have already been started are not cancelled and will pick up the regular
+    // tasks after finishing their current prefetch task
+    const size_t nCancelled = _jobSystem.cancel(_prefetchKey);
+    _nPendingPrefetchJobs -= nCancelled;
+    for (size_t i = 0; i < nCancelled; ++i) {
+        submitJob(false);
+    }
+}
+
+template<typename KeyType>
+void LRUThreadPool<KeyType>::processTasks(bool isPrefetchJob) {
+    if (isPrefetchJob) {
+        std::unique_lock lock(_queueMutex);
+        --_nPendingPrefetchJobs;
+    }
+
     while (true) {
-        // acquire lock
+        std::function<void()> task;
+        bool isPrefetchTask = false;
         {
-            std::unique_lock lock(_pool._queueMutex);
+            std::unique_lock lock(_queueMutex);
+            if (_stop || (_queuedTasks.isEmpty() && _prefetchTasks.isEmpty())) {
+                --_nActiveJobs;
+                _condition.notify_all();
+                return;
+            }
 
-            // look for a work item
-            while (!_pool._stop && _pool._queuedTasks.isEmpty()) {
-                // if there are none wait for notification
-                _pool._condition.wait(lock);
+            if (!_queuedTasks.isEmpty()) {
+                task = _queuedTasks.popMRU().second;
             }
+            else {
+                task = _prefetchTasks.popMRU().second;
+                isPrefetchTask = true;
+            }
+        }
 
-            if (_pool._stop) { // exit if the pool is stopped
+        task();
+
+        if (isPrefetchTask) {
+            std::unique_lock lock(_queueMutex);
+            if (!_stop && _queuedTasks.isEmpty() && !_prefetchTasks.isEmpty()) {
+                // Give the JobSystem the chance to run more important jobs before the
+                // next prefetch task. This job stays active, it is only moved to the end
+                // of the line
+                submitJob(true);
                 return;
             }
+        }
+    }
+}
 
-            // get the task from the queue
-            task = _pool._queuedTasks.popMRU().second;
+template<typename KeyType>
+void LRUThreadPool<KeyType>::enqueue(std::function<void()> f, KeyType key) {
+    std::unique_lock lock(_queueMutex);
 
-        }// release lock
+    // A regular request supersedes a prefetch request for the same key
+    _prefetchTasks.remove(key);
 
-        // execute the task
-        task();
+    const std::vector<std::pair<KeyType, std::function<void()>>>& unfinishedTasks =
+        _queuedTasks.putAndFetchPopped(key, std::move(f));
+    for (const std::pair<KeyType, std::function<void()>>& unfinishedTask :
+         unfinishedTasks)
+    {
+        _unqueuedTasks.push_back(unfinishedTask.first);
     }
-}
 
-template<typename KeyType>
-LRUThreadPool<KeyType>::LRUThreadPool(size_t numThreads, size_t queueSize)
-    : _queuedTasks(queueSize)
-{
-    for (size_t i = 0; i < numThreads; ++i) {
-        _workers.push_back(std::thread(LRUThreadPoolWorker<KeyType>(*this)));
+    if (_nActiveJobs < _maxConcurrency) {
+        ++_nActiveJobs;
+        submitJob(false);
+    }
+    else {
+        upgradePrefetchJobs();
     }
 }
 
 template<typename KeyType>
-LRUThreadPool<KeyType>::LRUThreadPool(const LRUThreadPool& toCopy)
-    : LRUThreadPool(toCopy._workers.size(), toCopy._queuedTasks.maximumCacheSize())
-{}
+void LRUThreadPool<KeyType>::enqueuePrefetch(std::function<void()> f, KeyType key) {
+    std::unique_lock lock(_queueMutex);
 
-// the destructor joins all threads
-template<typename KeyType>
-LRUThreadPool<KeyType>::~LRUThreadPool() {
+    if (_queuedTasks.exist(key)) {
+        return;
+    }
+
+    const std::vector<std::pair<KeyType, std::function<void()>>>& unfinishedTasks =
+        _prefetchTasks.putAndFetchPopped(key, std::move(f));
+    for (const std::pair<KeyType, std::function<void()>>& unfinishedTask :
+         unfinishedTasks)
     {
-        std::unique_lock lock(_queueMutex);
-        _stop = true;
+        _unqueuedTasks.push_back(unfinishedTask.first);
     }
-    _condition.notify_all();
 
-    // join them
-    for (size_t i = 0; i < _workers.size(); ++i) {
-        _workers[i].join();
+    if (_nActiveJobs < _maxConcurrency) {
+        ++_nActiveJobs;
+        submitJob(true);
     }
 }
 
-// add new work item to the pool
 template<typename KeyType>
-void LRUThreadPool<KeyType>::enqueue(std::function<void()> f, KeyType key) {
+bool LRUThreadPool<KeyType>::promote(KeyType key) {
+    std::unique_lock lock(_queueMutex);
+
+    std::optional<std::function<void()>> task = _prefetchTasks.remove(key);
+    if (!task.has_value()) {
+        return false;
+    }
+
+    const std::vector<std::pair<KeyType, std::function<void()>>>& unfinishedTasks =
+        _queuedTasks.putAndFetchPopped(key, std::move(*task));
+    for (const std::pair<KeyType, std::function<void()>>& unfinishedTask :
+         unfinishedTasks)
     {
-        std::unique_lock<std::mutex> lock(_queueMutex);
-
-        // add the task
-        //_queuedTasks.put(key, f);
-        const std::vector<std::pair<KeyType, std::function<void()>>>& unfinishedTasks =
-            _queuedTasks.putAndFetchPopped(key, f);
-        for (const std::pair<KeyType, std::function<void()>>& unfinishedTask :
-             unfinishedTasks)
-        {
-            _unqueuedTasks.push_back(unfinishedTask.first);
-        }
+        _unqueuedTasks.push_back(unfinishedTask.first);
     }
 
-    // wake up one thread
-    _condition.notify_one();
+    upgradePrefetchJobs();
+    return true;
 }
 
 template<typename KeyType>
 bool LRUThreadPool<KeyType>::touch(KeyType key) {
-    std::unique_lock<std::mutex> lock(_queueMutex);
+    std::unique_lock lock(_queueMutex);
     return _queuedTasks.touch(key);
 }
 
 template<typename KeyType>
 std::vector<KeyType> LRUThreadPool<KeyType>::getUnqueuedTasksKeys() {
-    std::vector<KeyType> toReturn = _unqueuedTasks;
-    {
-        std::unique_lock<std::mutex> lock(_queueMutex);
-        _unqueuedTasks.clear();
-    }
+    std::unique_lock lock(_queueMutex);
+    std::vector<KeyType> toReturn = std::move(_unqueuedTasks);
+    _unqueuedTasks.clear();
     return toReturn;
 }
 
@@ -127,18 +241,22 @@ template<typename KeyType>
 std::vector<KeyType> LRUThreadPool<KeyType>::getQueuedTasksKeys() {
     std::vector<KeyType> queuedTasks;
     {
-        std::unique_lock<std::mutex> lock(_queueMutex);
+        std::unique_lock lock(_queueMutex);
         while (!_queuedTasks.isEmpty()) {
             queuedTasks.push_back(_queuedTasks.popMRU().first);
         }
+        while (!_prefetchTasks.isEmpty()) {
+            queuedTasks.push_back(_prefetchTasks.popMRU().first);
+        }
     }
     return queuedTasks;
 }
 
 template<typename KeyType>
 void LRUThreadPool<KeyType>::clearEnqueuedTasks() {
-    std::unique_lock<std::mutex> lock(_queueMutex);
+    std::unique_lock lock(_queueMutex);
     _queuedTasks.clear();
+    _prefetchTasks.clear();
 }
 
 } // namespace openspace::globebrowsing
@@ -301,6 +301,7 @@ MemoryAwareTileCache::MemoryAwareTileCache(int tileCacheSize)
 
 void MemoryAwareTileCache::clear() {
     LINFO("Clearing tile cache");
+    ++_generation;
     _numTextureBytesAllocatedOnCPU = 0;
     using K = TileTextureInitData::HashKey;
     using V = TextureContainerTileCache;
@@ -370,6 +371,7 @@ void MemoryAwareTileCache::setSizeEstimated(size_t estimatedSize) {
 void MemoryAwareTileCache::resetTextureContainerSize(size_t numTexturesPerTextureType) {
     ZoneScoped
 
+    ++_generation;
     _numTextureBytesAllocatedOnCPU = 0;
     for (std::pair<const TileTextureInitData::HashKey,
         TextureContainerTileCache>& p : _textureContainerMap)
@@ -424,6 +426,7 @@ ghoul::opengl::Texture* MemoryAwareTileCache::texture(const TileTextureInitData&
         _textureContainerMap[initDataKey].first->getTextureIfFree();
     // Second option. No more textures available. Pop from the LRU cache
     if (!texture) {
+        ++_generation;
         Tile oldTile = _textureContainerMap[initDataKey].second->popLRU().second;
         // Use the old tile's texture
         texture = oldTile.texture;
@@ -473,6 +476,7 @@ void MemoryAwareTileCache::createTileAndPut(ProviderTileKey key, RawTile rawTile
         Tile tile{ tex, std::move(rawTile.tileMetaData), Tile::Status::OK };
         TileTextureInitData::HashKey initDataKey = initData.hashKey;
         _textureContainerMap[initDataKey].second->put(std::move(key), std::move(tile));
+        ++_generation;
     }
 }
 
@@ -481,6 +485,11 @@ void MemoryAwareTileCache::put(const ProviderTileKey& key,
                                Tile tile)
 {
     _textureContainerMap[initDataKey].second->put(key, std::move(tile));
+    ++_generation;
+}
+
+uint64_t MemoryAwareTileCache::generation() const {
+    return _generation;
 }
 
 void MemoryAwareTileCache::update() {
@@ -96,6 +96,13 @@ public:
         const TileTextureInitData::HashKey& initDataKey, Tile tile);
     void update();
 
+    /**
+     * Returns a number that changes whenever a tile is added to or removed from the
+     * cache. As long as it does not change, the textures of the tiles that were returned
+     * by #get are not reused for other tiles.
+     */
+    uint64_t generation() const;
+
     size_t gpuAllocatedDataSize() const;
     size_t cpuAllocatedDataSize() const;
 
@@ -156,6 +163,7 @@ private:
 
     TextureContainerMap _textureContainerMap;
     size_t _numTextureBytesAllocatedOnCPU;
+    uint64_t _generation = 0;
 
     // Properties
     properties::IntProperty _cpuAllocatedTileData;
@@ -49,6 +49,18 @@ public:
      */
     void enqueueJob(std::shared_ptr<Job<P>> job, KeyType key);
 
+    /**
+     * Enqueues a speculative job which is only executed if there are no regular jobs
+     * waiting. The job is ignored if a regular job with the same key is enqueued.
+     */
+    void enqueuePrefetchJob(std::shared_ptr<Job<P>> job, KeyType key);
+
+    /**
+     * Turns the prefetch job identified with <code>key</code> into a regular job.
+     * \returns true if the prefetch job was found and has not been started yet
+     */
+    bool promote(KeyType key);
+
     /**
      * The keys returned by this function have been popped from the queue and corresponds
      * to jobs that will not be executed and therefore marked as unfinished. Calling this
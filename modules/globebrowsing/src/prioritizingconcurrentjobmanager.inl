@@ -43,6 +43,23 @@ void PrioritizingConcurrentJobManager<P, KeyType>::enqueueJob(std::shared_ptr<Jo
     }, key);
 }
 
+template <typename P, typename KeyType>
+void PrioritizingConcurrentJobManager<P, KeyType>::enqueuePrefetchJob(
+                                                             std::shared_ptr<Job<P>> job,
+                                                             KeyType key)
+{
+    _threadPool.enqueuePrefetch([this, job]() {
+        job->execute();
+        std::lock_guard lock(_finishedJobsMutex);
+        _finishedJobs.push(job);
+    }, key);
+}
+
+template <typename P, typename KeyType>
+bool PrioritizingConcurrentJobManager<P, KeyType>::promote(KeyType key) {
+    return _threadPool.promote(key);
+}
+
 template <typename P, typename KeyType>
 std::vector<KeyType>
 PrioritizingConcurrentJobManager<P, KeyType>::keysToUnfinishedJobs() {
@@ -25,6 +25,7 @@
 #include <modules/globebrowsing/src/rawtiledatareader.h>
 
 #include <modules/globebrowsing/globebrowsingmodule.h>
+#include <modules/globebrowsing/src/disktilecache.h>
 #include <modules/globebrowsing/src/geodeticpatch.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/moduleengine.h>
@@ -52,6 +53,7 @@
 #endif // _MSC_VER
 
 #include <algorithm>
+#include <filesystem>
 #include <fstream>
 
 namespace openspace::globebrowsing {
@@ -446,6 +448,21 @@ void RawTileDataReader::initialize() {
 
     GlobeBrowsingModule& module = *global::moduleEngine.module<GlobeBrowsingModule>();
 
+    _diskCache = module.diskTileCache();
+    if (_diskCache) {
+        // Local files are identified by their modification time as well so that stale
+        // tiles are not used after a dataset was changed
+        std::string identifier = fmt::format(
+            "{}|{}", _datasetFilePath, _preprocess ? "preprocessed" : "raw"
+        );
+        std::error_code ec;
+        const auto writeTime = std::filesystem::last_write_time(_datasetFilePath, ec);
+        if (!ec) {
+            identifier += fmt::format("|{}", writeTime.time_since_epoch().count());
+        }
+        _diskCacheProvider = cache::DiskTileCache::providerHash(identifier);
+    }
+
     std::string content = _datasetFilePath;
     if (module.isWMSCachingEnabled()) {
         ZoneScopedN("WMS Caching")
@@ -638,6 +655,18 @@ RawTile::ReadError RawTileDataReader::rasterRead(int rasterBand,
 }
 
 RawTile RawTileDataReader::readTileData(TileIndex tileIndex) const {
+    const cache::DiskTileCache::Key diskCacheKey = {
+        _diskCacheProvider,
+        tileIndex,
+        _initData.hashKey
+    };
+    if (_diskCache) {
+        std::optional<RawTile> cached = _diskCache->get(diskCacheKey, _initData);
+        if (cached.has_value()) {
+            return std::move(*cached);
+        }
+    }
+
     size_t numBytes = _initData.totalNumBytes;
 
     RawTile rawTile;
@@ -671,6 +700,10 @@ RawTile RawTileDataReader::readTileData(TileIndex tileIndex) const {
         );
     }
 
+    if (_diskCache) {
+        _diskCache->put(diskCacheKey, rawTile);
+    }
+
     return rawTile;
 }
 
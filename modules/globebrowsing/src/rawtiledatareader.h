@@ -39,6 +39,7 @@ class GDALRasterBand;
 namespace openspace::globebrowsing {
 
 class GeodeticPatch;
+namespace cache { class DiskTileCache; }
 
 class RawTileDataReader {
 public:
@@ -100,6 +101,11 @@ private:
     const PerformPreprocessing _preprocess;
     TileDepthTransform _depthTransform = { 0.f, 0.f };
 
+    /// Persistent cache that is consulted before reading from the dataset, or
+    /// <code>nullptr</code> if the disk cache is disabled
+    cache::DiskTileCache* _diskCache = nullptr;
+    uint64_t _diskCacheProvider = 0;
+
     mutable std::mutex _datasetLock;
 };
 
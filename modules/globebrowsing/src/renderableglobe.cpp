@@ -25,18 +25,22 @@
 #include <modules/globebrowsing/src/renderableglobe.h>
 
 #include <modules/debugging/rendering/debugrenderer.h>
+#include <modules/globebrowsing/globebrowsingmodule.h>
 #include <modules/globebrowsing/src/basictypes.h>
 #include <modules/globebrowsing/src/gpulayergroup.h>
 #include <modules/globebrowsing/src/layer.h>
 #include <modules/globebrowsing/src/layergroup.h>
+#include <modules/globebrowsing/src/memoryawaretilecache.h>
 #include <modules/globebrowsing/src/renderableglobe.h>
 #include <modules/globebrowsing/src/tileprovider.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/scene/scene.h>
+#include <openspace/util/jobsystem.h>
 #include <openspace/util/memorymanager.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/time.h>
@@ -49,9 +53,11 @@
 #include <ghoul/opengl/textureunit.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
+#include <algorithm>
 #include <numeric>
 #include <queue>
 #include <memory_resource>
+#include <unordered_map>
 
 namespace {
     // Global flags to modify the RenderableGlobe
@@ -93,6 +99,20 @@ namespace {
     constexpr const int DefaultSkirtedGridSegments = 64;
     constexpr const int UnknownDesiredLevel = -1;
 
+    // The maximum number of chunks whose tiles are prefetched in a single frame and the
+    // number of levels below the current leaf chunks that are considered
+    constexpr const int MaxPrefetchedChunksPerFrame = 32;
+    constexpr const int PrefetchDepth = 2;
+
+    // The fraction of the distance between the camera and a chunk that the camera has to
+    // move before the desired level of the chunk is recomputed. The level depends on the
+    // logarithm of the distance, so this causes an error of less than 0.015 levels
+    constexpr const double LevelCameraThresholdFraction = 0.01;
+    constexpr const int MinCachedLevel = 3;
+
+    // Batches of height queries that are smaller than this are evaluated serially
+    constexpr const size_t MinimumParallelHeightBatch = 1024;
+
     const openspace::globebrowsing::GeodeticPatch Coverage =
         openspace::globebrowsing::GeodeticPatch(0, 0, 90, 180);
 
@@ -231,6 +251,24 @@ namespace {
         "This is the number of currently active layers, if this value reaches the "
         "maximum, bad things will happen."
     };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchLookaheadInfo = {
+        "PrefetchLookahead",
+        "Prefetch Lookahead (frames)",
+        "The number of frames that the camera movement is extrapolated into the future "
+        "to determine which chunks will be split soon. The tiles of these chunks are "
+        "loaded with a lower priority than the tiles that are currently needed. A value "
+        "of 0 disables the prefetching."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ChunkUpdateTimeBudgetInfo = {
+        "ChunkUpdateTimeBudget",
+        "Chunk Update Time Budget (ms)",
+        "The time in milliseconds that can be spent on updating the chunk tree in each "
+        "frame before splits and merges that do not affect the visible quality, which "
+        "are merges and splits of chunks outside the view, are deferred to the next "
+        "frame. Splits of visible chunks are always performed immediately."
+    };
 } // namespace
 
 using namespace openspace::properties;
@@ -261,6 +299,213 @@ const Chunk& findChunkNode(const Chunk& node, const Geodetic2& location) {
     return *n;
 }
 
+// The tile and the position within that tile at which the height for a position is
+// sampled
+struct HeightSamplePosition {
+    TileIndex tileIndex;
+    glm::vec2 uv;
+};
+
+HeightSamplePosition heightSamplePosition(const Chunk& leftRoot, const Chunk& rightRoot,
+                                          const Ellipsoid& ellipsoid,
+                                          const glm::dvec3& position)
+{
+    const Geodetic2 geodeticPosition = ellipsoid.cartesianToGeodetic2(position);
+    const Chunk& node = geodeticPosition.lon < Coverage.center().lon ?
+        findChunkNode(leftRoot, geodeticPosition) :
+        findChunkNode(rightRoot, geodeticPosition);
+    const int chunkLevel = node.tileIndex.level;
+
+    const int numIndicesAtLevel = 1 << chunkLevel;
+    const double u = 0.5 + geodeticPosition.lon / glm::two_pi<double>();
+    const double v = 0.25 - geodeticPosition.lat / glm::two_pi<double>();
+    const double xIndexSpace = u * numIndicesAtLevel;
+    const double yIndexSpace = v * numIndicesAtLevel;
+
+    const int x = static_cast<int>(floor(xIndexSpace));
+    const int y = static_cast<int>(floor(yIndexSpace));
+
+    const TileIndex tileIndex(x, y, chunkLevel);
+    const GeodeticPatch patch = GeodeticPatch(tileIndex);
+
+    const Geodetic2 northEast = patch.corner(Quad::NORTH_EAST);
+    const Geodetic2 southWest = patch.corner(Quad::SOUTH_WEST);
+
+    const Geodetic2 geoDiffPatch = {
+        northEast.lat - southWest.lat,
+        northEast.lon - southWest.lon
+    };
+
+    const Geodetic2 geoDiffPoint = {
+        geodeticPosition.lat - southWest.lat,
+        geodeticPosition.lon - southWest.lon
+    };
+    const glm::vec2 patchUV = glm::vec2(
+        geoDiffPoint.lon / geoDiffPatch.lon,
+        geoDiffPoint.lat / geoDiffPatch.lat
+    );
+    return { tileIndex, patchUV };
+}
+
+HeightTile heightTile(const LayerManager& lm, const TileIndex& tileIndex) {
+    ZoneScoped
+
+    HeightTile result;
+
+    const std::vector<Layer*>& heightMapLayers =
+        lm.layerGroup(layergroupid::GroupID::HeightLayers).activeLayers();
+    for (Layer* layer : heightMapLayers) {
+        tileprovider::TileProvider* tileProvider = layer->tileProvider();
+        if (!tileProvider) {
+            continue;
+        }
+        const ChunkTile chunkTile = tileprovider::chunkTile(*tileProvider, tileIndex);
+        const Tile& tile = chunkTile.tile;
+        if (tile.status != Tile::Status::OK || !tile.texture) {
+            result.isAvailable = false;
+            result.layers.clear();
+            return result;
+        }
+
+        ghoul::opengl::Texture* texture = tile.texture;
+        const bool isSingleFloat = texture->dataType() == GL_FLOAT &&
+            texture->format() == ghoul::opengl::Texture::Format::Red &&
+            texture->pixelData();
+
+        HeightLayerSampler sampler;
+        sampler.layer = layer;
+        sampler.texture = texture;
+        sampler.texels = isSingleFloat ?
+            reinterpret_cast<const float*>(texture->pixelData()) :
+            nullptr;
+        sampler.dimensions = glm::uvec2(texture->dimensions());
+        sampler.uvTransform = chunkTile.uvTransform;
+        sampler.depthTransform = tileprovider::depthTransform(*tileProvider);
+        sampler.noDataValue = tileprovider::noDataValueAsFloat(*tileProvider);
+        result.layers.push_back(sampler);
+    }
+    return result;
+}
+
+// Samples the heights at the \p n positions \p uvs within the \p tile using bilinear
+// interpolation and stores them in \p heights. The positions are processed in blocks
+// and the interpolation is written branch-free over each block so that it is vectorized
+void sampleHeights(const HeightTile& tile, const glm::vec2* uvs, size_t n,
+                   float* heights)
+{
+    std::fill(heights, heights + n, 0.f);
+    if (!tile.isAvailable) {
+        return;
+    }
+
+    constexpr const size_t BlockSize = 16;
+    std::array<float, BlockSize> s00;
+    std::array<float, BlockSize> s10;
+    std::array<float, BlockSize> s01;
+    std::array<float, BlockSize> s11;
+    std::array<float, BlockSize> fx;
+    std::array<float, BlockSize> fy;
+    std::array<float, BlockSize> sample;
+
+    for (const HeightLayerSampler& s : tile.layers) {
+        const glm::uvec2 max = s.dimensions - glm::uvec2(1);
+        for (size_t block = 0; block < n; block += BlockSize) {
+            const size_t count = std::min(BlockSize, n - block);
+
+            // Gather the four texels around each sample position
+            for (size_t i = 0; i < count; ++i) {
+                const glm::vec2 samplePos = s.layer->tileUvToTextureSamplePosition(
+                    s.uvTransform,
+                    uvs[block + i],
+                    s.dimensions
+                ) * glm::vec2(s.dimensions);
+
+                const glm::uvec2 p00 = glm::clamp(
+                    glm::uvec2(glm::max(samplePos, glm::vec2(0.f))),
+                    glm::uvec2(0),
+                    max
+                );
+                const glm::uvec2 p11 = glm::min(p00 + glm::uvec2(1), max);
+                fx[i] = samplePos.x - static_cast<float>(p00.x);
+                fy[i] = samplePos.y - static_cast<float>(p00.y);
+
+                if (s.texels) {
+                    const float* row0 = s.texels + p00.y * s.dimensions.x;
+                    const float* row1 = s.texels + p11.y * s.dimensions.x;
+                    s00[i] = row0[p00.x];
+                    s10[i] = row0[p11.x];
+                    s01[i] = row1[p00.x];
+                    s11[i] = row1[p11.x];
+                }
+                else {
+                    s00[i] = s.texture->texelAsFloat(p00).x;
+                    s10[i] = s.texture->texelAsFloat(glm::uvec2(p11.x, p00.y)).x;
+                    s01[i] = s.texture->texelAsFloat(glm::uvec2(p00.x, p11.y)).x;
+                    s11[i] = s.texture->texelAsFloat(p11).x;
+                }
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                const float sample0 = s00[i] * (1.f - fx[i]) + s10[i] * fx[i];
+                const float sample1 = s01[i] * (1.f - fx[i]) + s11[i] * fx[i];
+                sample[i] = sample0 * (1.f - fy[i]) + sample1 * fy[i];
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                // In case the texture has NaN or no data values don't use this height map
+                const bool anySampleIsNaN = std::isnan(s00[i]) || std::isnan(s01[i]) ||
+                    std::isnan(s10[i]) || std::isnan(s11[i]);
+                const bool anySampleIsNoData = s00[i] == s.noDataValue ||
+                    s01[i] == s.noDataValue || s10[i] == s.noDataValue ||
+                    s11[i] == s.noDataValue;
+
+                // Same as is used in the shader. This is not a perfect solution but
+                // if the sample is actually a no-data-value (min_float) the interpolated
+                // value might not be. Therefore we have a cut-off. Assuming no data value
+                // is smaller than -100000
+                if (anySampleIsNaN || anySampleIsNoData || !(sample[i] > -100000)) {
+                    continue;
+                }
+
+                // Perform depth transform to get the value in meters and make sure that
+                // the height value follows the layer settings. For example if the
+                // multiplier is set to a value bigger than one, the sampled height
+                // should be modified as well
+                const float height = s.depthTransform.offset +
+                    s.depthTransform.scale * sample[i];
+                heights[block + i] = s.layer->renderSettings().performLayerSettings(
+                    height
+                );
+            }
+        }
+    }
+}
+
+// Calls \p f with consecutive ranges that cover [0, n). Large ranges are split into
+// batches that are executed on the JobSystem, in which the calling thread takes part
+template <typename Func>
+void runInParallel(size_t n, Func f) {
+    if (n < MinimumParallelHeightBatch) {
+        f(0, n);
+        return;
+    }
+
+    const size_t nThreads = global::jobSystem.numThreads();
+    // Two batches per thread give the work stealing some room for balancing
+    const size_t batchSize = std::max(
+        (n + 2 * nThreads - 1) / (2 * nThreads),
+        MinimumParallelHeightBatch / 2
+    );
+    global::jobSystem.parallelFor(
+        (n + batchSize - 1) / batchSize,
+        [&f, batchSize, n](size_t batch) {
+            const size_t begin = batch * batchSize;
+            f(begin, std::min(begin + batchSize, n));
+        },
+        JobSystem::Priority::FrameCritical
+    );
+}
+
 std::pmr::vector<std::pair<ChunkTile, const LayerRenderSettings*>>
 tilesAndSettingsUnsorted(const LayerGroup& layerGroup, const TileIndex& tileIndex)
 {
@@ -429,6 +674,19 @@ std::array<glm::dvec4, 8> boundingCornersForChunk(const Chunk& chunk,
     return corners;
 }
 
+// Returns the distance from the point \p p to the axis-aligned box around the \p corners,
+// which is 0 if the point is inside the box
+double distanceToCorners(const std::array<glm::dvec4, 8>& corners, const glm::dvec3& p) {
+    glm::dvec3 min = glm::dvec3(corners[0]);
+    glm::dvec3 max = glm::dvec3(corners[0]);
+    for (const glm::dvec4& c : corners) {
+        min = glm::min(min, glm::dvec3(c));
+        max = glm::max(max, glm::dvec3(c));
+    }
+    const glm::dvec3 d = glm::max(glm::max(min - p, p - max), glm::dvec3(0.0));
+    return glm::length(d);
+}
+
 void expand(AABB3& bb, const glm::vec3& p) {
     bb.min = glm::min(bb.min, p);
     bb.max = glm::max(bb.max, p);
@@ -524,7 +782,9 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
         FloatProperty(CurrentLodScaleFactorInfo, 15.f, 1.f, 50.f),
         FloatProperty(CameraMinHeightInfo, 100.f, 0.f, 1000.f),
         FloatProperty(OrenNayarRoughnessInfo, 0.f, 0.f, 1.f),
-        IntProperty(NActiveLayersInfo, 0, 0, OpenGLCap.maxTextureUnits() / 3)
+        IntProperty(NActiveLayersInfo, 0, 0, OpenGLCap.maxTextureUnits() / 3),
+        IntProperty(PrefetchLookaheadInfo, 20, 0, 300),
+        FloatProperty(ChunkUpdateTimeBudgetInfo, 1.f, 0.f, 16.f)
     })
     , _debugPropertyOwner({ "Debug" })
     , _shadowMappingPropertyOwner({ "ShadowMapping" })
@@ -577,12 +837,17 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
         _generalProperties.currentLodScaleFactor = sf;
         _lodScaleFactorDirty = true;
     });
+    _generalProperties.currentLodScaleFactor.onChange([this]() {
+        ++_chunkDataGeneration;
+    });
     addProperty(_generalProperties.targetLodScaleFactor);
     addProperty(_generalProperties.currentLodScaleFactor);
     addProperty(_generalProperties.cameraMinHeight);
     addProperty(_generalProperties.orenNayarRoughness);
     _generalProperties.nActiveLayers.setReadOnly(true);
     addProperty(_generalProperties.nActiveLayers);
+    addProperty(_generalProperties.prefetchLookahead);
+    addProperty(_generalProperties.chunkUpdateTimeBudget);
 
     _debugPropertyOwner.addProperty(_debugProperties.showChunkEdges);
     //_debugPropertyOwner.addProperty(_debugProperties.showChunkBounds);
@@ -604,10 +869,13 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
     _debugProperties.showChunkEdges.onChange(notifyShaderRecompilation);
     _debugProperties.showHeightResolution.onChange(notifyShaderRecompilation);
     _debugProperties.showHeightIntensities.onChange(notifyShaderRecompilation);
+    _debugProperties.levelByProjectedAreaElseDistance.onChange([this]() {
+        ++_chunkDataGeneration;
+    });
 
     _layerManager.onChange([&](Layer* l) {
         _shadersNeedRecompilation = true;
-        _chunkCornersDirty = true;
+        ++_chunkDataGeneration;
         _nLayersIsDirty = true;
         _lastChangedLayer = l;
     });
@@ -722,7 +990,8 @@ void RenderableGlobe::initializeGL() {
         addPropertySubOwner(_globeLabelsComponent);
     }
 
-    _layerManager.update();
+    std::vector<TileIndex> updatedTiles;
+    _layerManager.update(updatedTiles);
 
     _grid.initializeGL();
 
@@ -971,7 +1240,25 @@ void RenderableGlobe::renderChunks(const RenderData& data, RendererTasks&,
 
 
     if (_layerManagerDirty) {
-        _layerManager.update();
+        std::vector<TileIndex> updatedTiles;
+        const int nUpdatedTiles = _layerManager.update(updatedTiles);
+        if (nUpdatedTiles > static_cast<int>(updatedTiles.size())) {
+            // A tile provider has replaced all of its tiles at once
+            ++_chunkDataGeneration;
+        }
+        else {
+            // A new tile might change the bounding heights and the availability of its
+            // chunk and of all descendants that are currently using it instead of a tile
+            // of a higher level. All other chunks keep their cached data
+            for (const TileIndex& tileIndex : updatedTiles) {
+                invalidateChunkData(_leftRoot, tileIndex);
+                invalidateChunkData(_rightRoot, tileIndex);
+            }
+            if (!updatedTiles.empty()) {
+                _chunkTreeUpdate.hasPendingUpdates = true;
+            }
+        }
+        checkHeightLayerSettings();
         _layerManagerDirty = false;
     }
 
@@ -1082,10 +1369,13 @@ void RenderableGlobe::renderChunks(const RenderData& data, RendererTasks&,
         viewTransform;
     const glm::dmat4 mvp = vp * _cachedModelTransform;
 
-    _allChunksAvailable = true;
-    updateChunkTree(_leftRoot, data, mvp);
-    updateChunkTree(_rightRoot, data, mvp);
-    _chunkCornersDirty = false;
+    updateChunkTrees(data, mvp);
+    // The shadow pass renders the globe from the light source, whose position must not
+    // be mistaken for a movement of the camera
+    if (!renderGeomOnly && _prefetchFrameNumber != global::renderEngine.frameNumber()) {
+        _prefetchFrameNumber = global::renderEngine.frameNumber();
+        prefetchTiles(data);
+    }
     _iterationsOfAvailableData =
         (_allChunksAvailable ? _iterationsOfAvailableData + 1 : 0);
     _iterationsOfUnavailableData =
@@ -1859,6 +2149,13 @@ SurfacePositionHandle RenderableGlobe::calculateSurfacePositionHandle(
 {
     ZoneScoped
 
+    return surfacePositionHandle(targetModelSpace, getHeight(targetModelSpace));
+}
+
+SurfacePositionHandle RenderableGlobe::surfacePositionHandle(
+                                                      const glm::dvec3& targetModelSpace,
+                                                      double heightToSurface) const
+{
     glm::dvec3 centerToEllipsoidSurface =
         _ellipsoid.geodeticSurfaceProjection(targetModelSpace);
     glm::dvec3 ellipsoidSurfaceToTarget = targetModelSpace - centerToEllipsoidSurface;
@@ -1870,7 +2167,6 @@ SurfacePositionHandle RenderableGlobe::calculateSurfacePositionHandle(
         ellipsoidSurfaceOutDirection *= -1.0;
     }
 
-    double heightToSurface = getHeight(targetModelSpace);
     heightToSurface = glm::isnan(heightToSurface) ? 0.0 : heightToSurface;
     centerToEllipsoidSurface = glm::isnan(glm::length(centerToEllipsoidSurface)) ?
         (glm::dvec3(0.0, 1.0, 0.0) * static_cast<double>(boundingSphere())) :
@@ -1896,14 +2192,14 @@ bool RenderableGlobe::testIfCullable(const Chunk& chunk,
            (PerformFrustumCulling && isCullableByFrustum(chunk, renderData, mvp));
 }
 
-int RenderableGlobe::desiredLevel(const Chunk& chunk, const RenderData& renderData,
+int RenderableGlobe::desiredLevel(const Chunk& chunk, const glm::dvec3& cameraPosition,
                                   const BoundingHeights& heights) const
 {
     ZoneScoped
 
     const int desiredLevel = _debugProperties.levelByProjectedAreaElseDistance ?
-        desiredLevelByProjectedArea(chunk, renderData, heights) :
-        desiredLevelByDistance(chunk, renderData, heights);
+        desiredLevelByProjectedArea(chunk, cameraPosition, heights) :
+        desiredLevelByDistance(chunk, cameraPosition, heights);
     const int levelByAvailableData = desiredLevelByAvailableTileData(chunk);
 
     if (LimitLevelByAvailableData && (levelByAvailableData != UnknownDesiredLevel)) {
@@ -1918,152 +2214,129 @@ int RenderableGlobe::desiredLevel(const Chunk& chunk, const RenderData& renderDa
 float RenderableGlobe::getHeight(const glm::dvec3& position) const {
     ZoneScoped
 
-    float height = 0;
-
-    // Get the uv coordinates to sample from
-    const Geodetic2 geodeticPosition = _ellipsoid.cartesianToGeodetic2(position);
-    const Chunk& node = geodeticPosition.lon < Coverage.center().lon ?
-        findChunkNode(_leftRoot, geodeticPosition) :
-        findChunkNode(_rightRoot, geodeticPosition);
-    const int chunkLevel = node.tileIndex.level;
-
-
-    //TileIndex::TileIndex(const Geodetic2& point, int level_)
-    //    : level(level_)
-    //{
-    const int numIndicesAtLevel = 1 << chunkLevel;
-    const double u = 0.5 + geodeticPosition.lon / glm::two_pi<double>();
-    const double v = 0.25 - geodeticPosition.lat / glm::two_pi<double>();
-    const double xIndexSpace = u * numIndicesAtLevel;
-    const double yIndexSpace = v * numIndicesAtLevel;
-
-    const int x = static_cast<int>(floor(xIndexSpace));
-    const int y = static_cast<int>(floor(yIndexSpace));
+    const HeightSamplePosition p = heightSamplePosition(
+        _leftRoot,
+        _rightRoot,
+        _ellipsoid,
+        position
+    );
+    float height = 0.f;
+    sampleHeights(cachedHeightTile(p.tileIndex), &p.uv, 1, &height);
+    return height;
+}
 
-    const TileIndex tileIndex(x, y, chunkLevel);
-    const GeodeticPatch patch = GeodeticPatch(tileIndex);
+const HeightTile& RenderableGlobe::cachedHeightTile(const TileIndex& tileIndex) const {
+    const uint64_t tileCacheGeneration =
+        global::moduleEngine.module<GlobeBrowsingModule>()->tileCache()->generation();
+    if (_heightTileCache.tileCacheGeneration != tileCacheGeneration ||
+        _heightTileCache.chunkDataGeneration != _chunkDataGeneration)
+    {
+        _heightTileCache.tiles.clear();
+        _heightTileCache.tileCacheGeneration = tileCacheGeneration;
+        _heightTileCache.chunkDataGeneration = _chunkDataGeneration;
+    }
 
-    const Geodetic2 northEast = patch.corner(Quad::NORTH_EAST);
-    const Geodetic2 southWest = patch.corner(Quad::SOUTH_WEST);
+    const auto it = _heightTileCache.tiles.find(tileIndex.hashKey());
+    if (it != _heightTileCache.tiles.end()) {
+        return it->second;
+    }
+    return _heightTileCache.tiles.emplace(
+        tileIndex.hashKey(),
+        heightTile(_layerManager, tileIndex)
+    ).first->second;
+}
 
-    const Geodetic2 geoDiffPatch = {
-        northEast.lat - southWest.lat,
-        northEast.lon - southWest.lon
-    };
+std::vector<float> RenderableGlobe::heights(
+                                          const std::vector<glm::dvec3>& positions) const
+{
+    ZoneScoped
 
-    const Geodetic2 geoDiffPoint = {
-        geodeticPosition.lat - southWest.lat,
-        geodeticPosition.lon - southWest.lon
-    };
-    const glm::vec2 patchUV = glm::vec2(
-        geoDiffPoint.lon / geoDiffPatch.lon,
-        geoDiffPoint.lat / geoDiffPatch.lat
+    std::vector<HeightSamplePosition> samplePositions(
+        positions.size(),
+        HeightSamplePosition{ TileIndex(0, 0, 0), glm::vec2(0.f) }
     );
-
-    // Get the tile providers for the height maps
-    const std::vector<Layer*>& heightMapLayers =
-        _layerManager.layerGroup(layergroupid::GroupID::HeightLayers).activeLayers();
-
-    for (Layer* layer : heightMapLayers) {
-        tileprovider::TileProvider* tileProvider = layer->tileProvider();
-        if (!tileProvider) {
-            continue;
-        }
-        // Transform the uv coordinates to the current tile texture
-        const ChunkTile chunkTile = tileprovider::chunkTile(*tileProvider, tileIndex);
-        const Tile& tile = chunkTile.tile;
-        const TileUvTransform& uvTransform = chunkTile.uvTransform;
-        const TileDepthTransform& depthTransform =
-            tileprovider::depthTransform(*tileProvider);
-        if (tile.status != Tile::Status::OK) {
-            return 0;
+    runInParallel(positions.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            samplePositions[i] = heightSamplePosition(
+                _leftRoot,
+                _rightRoot,
+                _ellipsoid,
+                positions[i]
+            );
         }
+    });
 
-        ghoul::opengl::Texture* tileTexture = tile.texture;
-        if (!tileTexture) {
-            return 0;
+    // Looking up the tiles is not thread-safe and many positions usually share the same
+    // tile, so each tile is only looked up once here on the calling thread
+    std::vector<const HeightTile*> tiles;
+    std::vector<uint32_t> tileOfPosition(positions.size());
+    {
+        ZoneScopedN("Tile lookup")
+        std::unordered_map<TileIndex::TileHashKey, uint32_t> tileIds;
+        for (size_t i = 0; i < samplePositions.size(); ++i) {
+            const TileIndex& ti = samplePositions[i].tileIndex;
+            const auto [it, isNew] = tileIds.try_emplace(
+                ti.hashKey(),
+                static_cast<uint32_t>(tiles.size())
+            );
+            if (isNew) {
+                tiles.push_back(&cachedHeightTile(ti));
+            }
+            tileOfPosition[i] = it->second;
         }
+    }
 
-        glm::vec2 transformedUv = layer->tileUvToTextureSamplePosition(
-            uvTransform,
-            patchUV,
-            glm::uvec2(tileTexture->dimensions())
-        );
-
-        // Sample and do linear interpolation
-        // (could possibly be moved as a function in ghoul texture)
-        // Suggestion: a function in ghoul::opengl::Texture that takes uv coordinates
-        // in range [0,1] and uses the set interpolation method and clamping.
+    // Sort the positions by their tile so that all positions of a tile can be sampled
+    // together, which keeps the tile in the cache and allows for vectorization
+    std::vector<uint32_t> tileBegin(tiles.size() + 1, 0);
+    for (uint32_t t : tileOfPosition) {
+        ++tileBegin[t + 1];
+    }
+    std::partial_sum(tileBegin.begin(), tileBegin.end(), tileBegin.begin());
+    std::vector<uint32_t> order(positions.size());
+    std::vector<glm::vec2> uvs(positions.size());
+    {
+        std::vector<uint32_t> next(tileBegin.begin(), tileBegin.end() - 1);
+        for (size_t i = 0; i < positions.size(); ++i) {
+            const uint32_t slot = next[tileOfPosition[i]]++;
+            order[slot] = static_cast<uint32_t>(i);
+            uvs[slot] = samplePositions[i].uv;
+        }
+    }
 
-        const glm::uvec3 dimensions = tileTexture->dimensions();
+    std::vector<float> sortedHeights(positions.size());
+    runInParallel(positions.size(), [&](size_t begin, size_t end) {
+        // Find the tile that contains the first position of this range
+        const auto first = std::upper_bound(tileBegin.begin(), tileBegin.end(), begin);
+        size_t t = static_cast<size_t>(std::distance(tileBegin.begin(), first)) - 1;
+        for (size_t i = begin; i < end; ++t) {
+            const size_t tileEnd = std::min<size_t>(tileBegin[t + 1], end);
+            sampleHeights(*tiles[t], &uvs[i], tileEnd - i, &sortedHeights[i]);
+            i = tileEnd;
+        }
+    });
 
-        const glm::vec2 samplePos = transformedUv * glm::vec2(dimensions);
-        glm::uvec2 samplePos00 = samplePos;
-        samplePos00 = glm::clamp(
-            samplePos00,
-            glm::uvec2(0, 0),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::vec2 samplePosFract = samplePos - glm::vec2(samplePos00);
+    std::vector<float> result(positions.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        result[order[i]] = sortedHeights[i];
+    }
+    return result;
+}
 
-        const glm::uvec2 samplePos10 = glm::min(
-            samplePos00 + glm::uvec2(1, 0),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::uvec2 samplePos01 = glm::min(
-            samplePos00 + glm::uvec2(0, 1),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::uvec2 samplePos11 = glm::min(
-            samplePos00 + glm::uvec2(1, 1),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
+std::vector<SurfacePositionHandle> RenderableGlobe::calculateSurfacePositionHandles(
+                                  const std::vector<glm::dvec3>& targetsModelSpace) const
+{
+    ZoneScoped
 
-        const float sample00 = tileTexture->texelAsFloat(samplePos00).x;
-        const float sample10 = tileTexture->texelAsFloat(samplePos10).x;
-        const float sample01 = tileTexture->texelAsFloat(samplePos01).x;
-        const float sample11 = tileTexture->texelAsFloat(samplePos11).x;
-
-        // In case the texture has NaN or no data values don't use this height map.
-        const bool anySampleIsNaN =
-            std::isnan(sample00) ||
-            std::isnan(sample01) ||
-            std::isnan(sample10) ||
-            std::isnan(sample11);
-
-        const bool anySampleIsNoData =
-            sample00 == tileprovider::noDataValueAsFloat(*tileProvider) ||
-            sample01 == tileprovider::noDataValueAsFloat(*tileProvider) ||
-            sample10 == tileprovider::noDataValueAsFloat(*tileProvider) ||
-            sample11 == tileprovider::noDataValueAsFloat(*tileProvider);
-
-        if (anySampleIsNaN || anySampleIsNoData) {
-            continue;
-        }
+    const std::vector<float> h = heights(targetsModelSpace);
 
-        const float sample0 = sample00 * (1.f - samplePosFract.x) +
-            sample10 * samplePosFract.x;
-        const float sample1 = sample01 * (1.f - samplePosFract.x) +
-            sample11 * samplePosFract.x;
-
-        const float sample = sample0 * (1.f - samplePosFract.y) +
-            sample1 * samplePosFract.y;
-
-        // Same as is used in the shader. This is not a perfect solution but
-        // if the sample is actually a no-data-value (min_float) the interpolated
-        // value might not be. Therefore we have a cut-off. Assuming no data value
-        // is smaller than -100000
-        if (sample > -100000) {
-            // Perform depth transform to get the value in meters
-            height = depthTransform.offset + depthTransform.scale * sample;
-            // Make sure that the height value follows the layer settings.
-            // For example if the multiplier is set to a value bigger than one,
-            // the sampled height should be modified as well.
-            height = layer->renderSettings().performLayerSettings(height);
+    std::vector<SurfacePositionHandle> result(targetsModelSpace.size());
+    runInParallel(targetsModelSpace.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result[i] = surfacePositionHandle(targetsModelSpace[i], h[i]);
         }
-    }
-    // Return the result
-    return height;
+    });
+    return result;
 }
 
 void RenderableGlobe::calculateEclipseShadows(ghoul::opengl::ProgramObject& programObject,
@@ -2229,17 +2502,11 @@ void RenderableGlobe::calculateEclipseShadows(ghoul::opengl::ProgramObject& prog
 //////////////////////////////////////////////////////////////////////////////////////////
 
 int RenderableGlobe::desiredLevelByDistance(const Chunk& chunk,
-                                            const RenderData& data,
+                                            const glm::dvec3& cameraPosition,
                                             const BoundingHeights& heights) const
 {
     ZoneScoped
 
-    // Calculations are done in the reference frame of the globe
-    // (model space). Hence, the camera position needs to be transformed
-    // with the inverse model matrix
-    const glm::dvec3 cameraPosition = glm::dvec3(_cachedInverseModelTransform *
-        glm::dvec4(data.camera.positionVec3(), 1.0));
-
     const Geodetic2 pointOnPatch = chunk.surfacePatch.closestPoint(
         _ellipsoid.cartesianToGeodetic2(cameraPosition)
     );
@@ -2265,18 +2532,11 @@ int RenderableGlobe::desiredLevelByDistance(const Chunk& chunk,
 }
 
 int RenderableGlobe::desiredLevelByProjectedArea(const Chunk& chunk,
-                                                 const RenderData& data,
+                                                 const glm::dvec3& cameraPosition,
                                                  const BoundingHeights& heights) const
 {
     ZoneScoped
 
-    // Calculations are done in the reference frame of the globe
-    // (model space). Hence, the camera position needs to be transformed
-    // with the inverse model matrix
-    const glm::dvec3 cameraPosition = glm::dvec3(
-        _cachedInverseModelTransform * glm::dvec4(data.camera.positionVec3(), 1.0)
-    );
-
     // Approach:
     // The projected area of the chunk will be calculated based on a small area that
     // is close to the camera, and the scaled up to represent the full area.
@@ -2521,8 +2781,41 @@ void RenderableGlobe::mergeChunkNode(Chunk& cn) {
     cn.children.fill(nullptr);
 }
 
+void RenderableGlobe::updateChunkTrees(const RenderData& data, const glm::dmat4& mvp) {
+    ZoneScoped
+
+    // Calculations are done in the reference frame of the globe (model space). Hence,
+    // the camera position needs to be transformed with the inverse model matrix
+    const glm::dvec3 cameraPosition = glm::dvec3(
+        _cachedInverseModelTransform * glm::dvec4(data.camera.positionVec3(), 1.0)
+    );
+
+    // If nothing has changed since the last update, every chunk would end up with the
+    // same status, so we can skip the traversal altogether. Chunks that were created in
+    // the last update or operations that were deferred make another traversal necessary
+    const bool isUnchanged = !_chunkTreeUpdate.hasPendingUpdates &&
+        _chunkTreeUpdate.dataGeneration == _chunkDataGeneration &&
+        _chunkTreeUpdate.cameraPosition == cameraPosition &&
+        _chunkTreeUpdate.mvp == mvp;
+    if (isUnchanged) {
+        return;
+    }
+
+    _chunkTreeUpdate.mvp = mvp;
+    _chunkTreeUpdate.cameraPosition = cameraPosition;
+    _chunkTreeUpdate.dataGeneration = _chunkDataGeneration;
+    _chunkTreeUpdate.hasPendingUpdates = false;
+    _chunkTreeUpdate.start = std::chrono::steady_clock::now();
+    _chunkTreeUpdate.nDeferrableUpdates = 0;
+
+    _allChunksAvailable = true;
+    updateChunkTree(_leftRoot, data, mvp, cameraPosition);
+    updateChunkTree(_rightRoot, data, mvp, cameraPosition);
+}
+
 bool RenderableGlobe::updateChunkTree(Chunk& cn, const RenderData& data,
-                                      const glm::dmat4& mvp)
+                                      const glm::dmat4& mvp,
+                                      const glm::dvec3& cameraPosition)
 {
     ZoneScoped
 
@@ -2533,10 +2826,14 @@ bool RenderableGlobe::updateChunkTree(Chunk& cn, const RenderData& data,
     //         In addition, this didn't even improve performance ---  2018-10-04
     if (isLeaf(cn)) {
         ZoneScopedN("leaf")
-        updateChunk(cn, data, mvp);
+        updateChunk(cn, data, mvp, cameraPosition);
 
         if (cn.status == Chunk::Status::WantSplit) {
-            splitChunkNode(cn, 1);
+            if (cn.isVisible || canPerformDeferrableUpdate()) {
+                splitChunkNode(cn, 1);
+                // The new children have not been evaluated yet
+                _chunkTreeUpdate.hasPendingUpdates = true;
+            }
         }
         else if (cn.status == Chunk::Status::DoNothing && (!cn.colorTileOK)) {
             // Checking cn.heightTileOK caused always not avaiable for certain HiRISE data
@@ -2549,19 +2846,24 @@ bool RenderableGlobe::updateChunkTree(Chunk& cn, const RenderData& data,
         ZoneScopedN("!leaf")
         char requestedMergeMask = 0;
         for (int i = 0; i < 4; ++i) {
-            if (updateChunkTree(*cn.children[i], data, mvp)) {
+            if (updateChunkTree(*cn.children[i], data, mvp, cameraPosition)) {
                 requestedMergeMask |= (1 << i);
             }
         }
 
         const bool allChildrenWantsMerge = requestedMergeMask == 0xf;
-        updateChunk(cn, data, mvp);
+        updateChunk(cn, data, mvp, cameraPosition);
 
         if (allChildrenWantsMerge && (cn.status != Chunk::Status::WantSplit)) {
-            mergeChunkNode(cn);
+            // Merging only reduces the number of rendered chunks, which were rendered
+            // with a higher level of detail than necessary
+            if (canPerformDeferrableUpdate()) {
+                mergeChunkNode(cn);
+            }
         }
         else if (cn.status == Chunk::Status::WantSplit) {
             splitChunkNode(cn, 1);
+            _chunkTreeUpdate.hasPendingUpdates = true;
         }
         else if (cn.status == Chunk::Status::DoNothing && (!cn.colorTileOK)) {
             _allChunksAvailable = false;
@@ -2571,22 +2873,181 @@ bool RenderableGlobe::updateChunkTree(Chunk& cn, const RenderData& data,
     }
 }
 
-void RenderableGlobe::updateChunk(Chunk& chunk, const RenderData& data,
-                                  const glm::dmat4& mvp) const
-{
+bool RenderableGlobe::canPerformDeferrableUpdate() {
+    // At least one operation is performed per frame so that the tree converges even if
+    // the time budget is smaller than the time of the traversal itself
+    if (_chunkTreeUpdate.nDeferrableUpdates > 0) {
+        using namespace std::chrono;
+        const double elapsed = duration<double, std::milli>(
+            steady_clock::now() - _chunkTreeUpdate.start
+        ).count();
+        if (elapsed > _generalProperties.chunkUpdateTimeBudget) {
+            _chunkTreeUpdate.hasPendingUpdates = true;
+            return false;
+        }
+    }
+    ++_chunkTreeUpdate.nDeferrableUpdates;
+    return true;
+}
+
+void RenderableGlobe::checkHeightLayerSettings() {
+    ZoneScoped
+
+    const std::vector<Layer*>& layers =
+        _layerManager.layerGroup(layergroupid::GroupID::HeightLayers).activeLayers();
+
+    auto settings = [](const Layer* layer) {
+        const LayerRenderSettings& rs = layer->renderSettings();
+        return glm::vec4(
+            rs.opacity.value(),
+            rs.gamma.value(),
+            rs.multiplier.value(),
+            rs.offset.value()
+        );
+    };
+
+    bool hasChanged = layers.size() != _heightLayerSettings.size();
+    for (size_t i = 0; i < layers.size() && !hasChanged; ++i) {
+        hasChanged = settings(layers[i]) != _heightLayerSettings[i];
+    }
+
+    if (hasChanged) {
+        _heightLayerSettings.clear();
+        for (const Layer* layer : layers) {
+            _heightLayerSettings.push_back(settings(layer));
+        }
+        ++_chunkDataGeneration;
+    }
+}
+
+void RenderableGlobe::prefetchTiles(const RenderData& data) {
     ZoneScoped
 
-    const BoundingHeights& heights = boundingHeightsForChunk(chunk, _layerManager);
-    chunk.heightTileOK = heights.tileOK;
-    chunk.colorTileOK = colorAvailableForChunk(chunk, _layerManager);
+    const glm::dvec3 cameraPosition = glm::dvec3(
+        _cachedInverseModelTransform * glm::dvec4(data.camera.positionVec3(), 1.0)
+    );
+    const std::optional<glm::dvec3> previousPosition = _previousCameraPosition;
+    _previousCameraPosition = cameraPosition;
+
+    const int lookahead = _generalProperties.prefetchLookahead;
+    if (lookahead == 0 || !previousPosition.has_value()) {
+        return;
+    }
+
+    // The level of detail depends on the distance to the surface, so a movement that is
+    // small compared to the altitude will not cause any chunk to split
+    const glm::dvec3 predictedMovement = (cameraPosition - *previousPosition) *
+        static_cast<double>(lookahead);
+    const double altitude = glm::length(cameraPosition) - _ellipsoid.minimumRadius();
+    if (glm::length(predictedMovement) < 0.01 * std::abs(altitude)) {
+        return;
+    }
+
+    const glm::dvec3 predictedPosition = cameraPosition + predictedMovement;
+    int budget = MaxPrefetchedChunksPerFrame;
+    prefetchChunkTree(_leftRoot, predictedPosition, budget);
+    prefetchChunkTree(_rightRoot, predictedPosition, budget);
+}
+
+void RenderableGlobe::prefetchChunkTree(const Chunk& cn,
+                                        const glm::dvec3& cameraPosition, int& budget)
+{
+    if (budget <= 0) {
+        return;
+    }
+
+    if (isLeaf(cn)) {
+        if (cn.isVisible) {
+            prefetchChunk(cn, cameraPosition, cn.heights, PrefetchDepth, budget);
+        }
+    }
+    else {
+        for (const Chunk* child : cn.children) {
+            prefetchChunkTree(*child, cameraPosition, budget);
+        }
+    }
+}
+
+void RenderableGlobe::prefetchChunk(const Chunk& chunk, const glm::dvec3& cameraPosition,
+                                    const BoundingHeights& heights, int depth,
+                                    int& budget)
+{
+    // Requesting the bounding heights of chunks that do not exist yet would enqueue
+    // their height tiles as regular requests, so the heights of the leaf are used
+    const int level = _debugProperties.levelByProjectedAreaElseDistance ?
+        desiredLevelByProjectedArea(chunk, cameraPosition, heights) :
+        desiredLevelByDistance(chunk, cameraPosition, heights);
+    if (glm::min(level, MaxSplitDepth) <= chunk.tileIndex.level) {
+        return;
+    }
+
+    for (size_t i = 0; i < chunk.children.size() && budget > 0; ++i) {
+        const Chunk child(chunk.tileIndex.child(static_cast<Quad>(i)));
+        bool hasRequested = false;
+        for (size_t g = 0; g < layergroupid::NUM_LAYER_GROUPS; ++g) {
+            const LayerGroup& group = _layerManager.layerGroup(layergroupid::GroupID(g));
+            for (Layer* layer : group.activeLayers()) {
+                hasRequested |= layer->prefetchTile(child.tileIndex);
+            }
+        }
+        // Chunks whose tiles are already cached or requested do not cost anything, so
+        // they must not use up the budget for the chunks further along the way
+        if (hasRequested) {
+            --budget;
+        }
+
+        if (depth > 1) {
+            prefetchChunk(child, cameraPosition, heights, depth - 1, budget);
+        }
+    }
+}
+
+void RenderableGlobe::invalidateChunkData(Chunk& cn, const TileIndex& tileIndex) {
+    // A chunk uses the tiles of itself and of its ancestors, so the tile affects the
+    // chunks in its own subtree, which are reached along the path of its ancestors
+    const TileIndex& chunkIndex = cn.tileIndex;
+    if (chunkIndex.level >= tileIndex.level) {
+        const int shift = chunkIndex.level - tileIndex.level;
+        if ((chunkIndex.x >> shift) != tileIndex.x ||
+            (chunkIndex.y >> shift) != tileIndex.y)
+        {
+            return;
+        }
+        cn.dataGeneration = 0;
+    }
+    else {
+        const int shift = tileIndex.level - chunkIndex.level;
+        if ((tileIndex.x >> shift) != chunkIndex.x ||
+            (tileIndex.y >> shift) != chunkIndex.y)
+        {
+            return;
+        }
+    }
+
+    if (!isLeaf(cn)) {
+        for (Chunk* child : cn.children) {
+            invalidateChunkData(*child, tileIndex);
+        }
+    }
+}
 
-    if (_chunkCornersDirty) {
-        chunk.corners = boundingCornersForChunk(chunk, _ellipsoid, heights);
+void RenderableGlobe::updateChunk(Chunk& chunk, const RenderData& data,
+                                  const glm::dmat4& mvp, const glm::dvec3& cameraPosition)
+{
+    ZoneScoped
 
-        // The flag gets set to false globally after the updateChunkTree calls
+    // Querying the tiles of all layers is the most expensive part of the update, so it
+    // is only done after new tiles have arrived or the layers have changed
+    const bool isDataDirty = chunk.dataGeneration != _chunkDataGeneration;
+    if (isDataDirty) {
+        chunk.heights = boundingHeightsForChunk(chunk, _layerManager);
+        chunk.heightTileOK = chunk.heights.tileOK;
+        chunk.colorTileOK = colorAvailableForChunk(chunk, _layerManager);
+        chunk.corners = boundingCornersForChunk(chunk, _ellipsoid, chunk.heights);
+        chunk.dataGeneration = _chunkDataGeneration;
     }
 
-    if (testIfCullable(chunk, data, heights, mvp)) {
+    if (testIfCullable(chunk, data, chunk.heights, mvp)) {
         chunk.isVisible = false;
         chunk.status = Chunk::Status::WantMerge;
     }
@@ -2594,7 +3055,22 @@ void RenderableGlobe::updateChunk(Chunk& chunk, const RenderData& data,
         chunk.isVisible = true;
     }
 
-    const int dl = desiredLevel(chunk, data, heights);
+    const glm::dvec3 cameraMovement = cameraPosition - chunk.levelCameraPosition;
+    const double cameraMovementSquared = glm::dot(cameraMovement, cameraMovement);
+    if (isDataDirty || cameraMovementSquared > chunk.levelCameraThreshold) {
+        chunk.desiredLevel = desiredLevel(chunk, cameraPosition, chunk.heights);
+        chunk.levelCameraPosition = cameraPosition;
+
+        // The box around the corners only contains the curved surface of small chunks,
+        // so the few chunks on the lowest levels are evaluated whenever the camera moves
+        const double distance = chunk.tileIndex.level < MinCachedLevel ?
+            0.0 :
+            distanceToCorners(chunk.corners, cameraPosition);
+        const double threshold = LevelCameraThresholdFraction * distance;
+        chunk.levelCameraThreshold = threshold * threshold;
+    }
+
+    const int dl = chunk.desiredLevel;
 
     if (dl < chunk.tileIndex.level) {
         chunk.status = Chunk::Status::WantMerge;
@@ -27,6 +27,7 @@
 
 #include <openspace/rendering/renderable.h>
 
+#include <modules/globebrowsing/src/basictypes.h>
 #include <modules/globebrowsing/src/ellipsoid.h>
 #include <modules/globebrowsing/src/geodeticpatch.h>
 #include <modules/globebrowsing/src/globelabelscomponent.h>
@@ -41,8 +42,13 @@
 #include <openspace/properties/scalar/boolproperty.h>
 #include <ghoul/misc/memorypool.h>
 #include <ghoul/opengl/uniformcache.h>
+#include <chrono>
 #include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
+namespace ghoul::opengl { class Texture; }
 namespace openspace::documentation { struct Documentation; }
 
 namespace openspace::globebrowsing {
@@ -58,6 +64,25 @@ struct BoundingHeights {
     bool tileOK;
 };
 
+// Everything that is needed to sample the heights of one height layer within one tile
+struct HeightLayerSampler {
+    Layer* layer;
+    ghoul::opengl::Texture* texture;
+    // Points to the texels if the texture contains single channel floats, which is the
+    // case for all height layers, and is nullptr otherwise
+    const float* texels;
+    glm::uvec2 dimensions;
+    TileUvTransform uvTransform;
+    TileDepthTransform depthTransform;
+    float noDataValue;
+};
+
+struct HeightTile {
+    // If any of the height layers has not loaded the tile yet, the height is 0
+    bool isAvailable = true;
+    std::vector<HeightLayerSampler> layers;
+};
+
 namespace chunklevelevaluator { class Evaluator; }
 namespace culling { class ChunkCuller; }
 
@@ -79,6 +104,18 @@ struct Chunk {
     bool colorTileOK = false;
     bool heightTileOK = false;
 
+    /// The bounding heights, availability, and corners are cached and only recomputed
+    /// when this generation differs from the RenderableGlobe's chunk data generation.
+    /// A generation of 0 marks a chunk whose tiles have changed
+    uint64_t dataGeneration = 0;
+    BoundingHeights heights = { 0.f, 0.f, false, true };
+
+    /// The desired level is cached until the camera has moved further away from the
+    /// position it was computed for than the (squared) threshold distance
+    int desiredLevel = 0;
+    glm::dvec3 levelCameraPosition = glm::dvec3(0.0);
+    double levelCameraThreshold = -1.0;
+
     std::array<glm::dvec4, 8> corners;
     std::array<Chunk*, 4> children = { { nullptr, nullptr, nullptr, nullptr } };
 };
@@ -108,6 +145,25 @@ public:
     SurfacePositionHandle calculateSurfacePositionHandle(
         const glm::dvec3& targetModelSpace) const override;
 
+    /**
+     * Calculates the SurfacePositionHandle for each of the \p targetsModelSpace. The
+     * result is the same as calling #calculateSurfacePositionHandle for every position,
+     * but see #heights for why this is faster for a large number of positions.
+     */
+    std::vector<SurfacePositionHandle> calculateSurfacePositionHandles(
+        const std::vector<glm::dvec3>& targetsModelSpace) const;
+
+    /**
+     * Calculates the heights from the surface of the reference ellipsoid to the height
+     * mapped surface for all \p positions, which have to be in cartesian model space.
+     * The positions are grouped by the chunk they fall into, so that all positions of a
+     * chunk are sampled together, and large batches are sampled in parallel. The height
+     * layer tiles of a chunk are kept between calls until the tile cache or the layers
+     * change, which also benefits #calculateSurfacePositionHandle. This function must be
+     * called from the main thread.
+     */
+    std::vector<float> heights(const std::vector<glm::dvec3>& positions) const;
+
     bool renderedWithDesiredData() const override;
 
     const Ellipsoid& ellipsoid() const;
@@ -146,6 +202,8 @@ private:
         properties::FloatProperty cameraMinHeight;
         properties::FloatProperty orenNayarRoughness;
         properties::IntProperty   nActiveLayers;
+        properties::IntProperty   prefetchLookahead;
+        properties::FloatProperty chunkUpdateTimeBudget;
     } _generalProperties;
 
     properties::PropertyOwner _debugPropertyOwner;
@@ -172,7 +230,7 @@ private:
      * <code>Chunk</code>, it wants to split. If it is lower, it wants to merge with
      * its siblings.
      */
-    int desiredLevel(const Chunk& chunk, const RenderData& renderData,
+    int desiredLevel(const Chunk& chunk, const glm::dvec3& cameraPosition,
         const BoundingHeights& heights) const;
 
     /**
@@ -188,6 +246,16 @@ private:
      */
     float getHeight(const glm::dvec3& position) const;
 
+    SurfacePositionHandle surfacePositionHandle(const glm::dvec3& targetModelSpace,
+        double heightToSurface) const;
+
+    /**
+     * Returns the height layer tiles that are used for the chunk with the \p tileIndex.
+     * The tiles are only looked up again after the tile cache or the layers have
+     * changed, as the textures might have been reused for other tiles in that case.
+     */
+    const HeightTile& cachedHeightTile(const TileIndex& tileIndex) const;
+
     void renderChunks(const RenderData& data, RendererTasks& rendererTask,
         const ShadowComponent::ShadowMapData& shadowData = {}, bool renderGeomOnly = false
     );
@@ -226,9 +294,11 @@ private:
     bool isCullableByHorizon(const Chunk& chunk, const RenderData& renderData,
         const BoundingHeights& heights) const;
 
-    int desiredLevelByDistance(const Chunk& chunk, const RenderData& data,
+    /// The \p cameraPosition has to be provided in the model space of the globe
+    int desiredLevelByDistance(const Chunk& chunk, const glm::dvec3& cameraPosition,
         const BoundingHeights& heights) const;
-    int desiredLevelByProjectedArea(const Chunk& chunk, const RenderData& data,
+    /// The \p cameraPosition has to be provided in the model space of the globe
+    int desiredLevelByProjectedArea(const Chunk& chunk, const glm::dvec3& cameraPosition,
         const BoundingHeights& heights) const;
     int desiredLevelByAvailableTileData(const Chunk& chunk) const;
 
@@ -245,8 +315,47 @@ private:
 
     void splitChunkNode(Chunk& cn, int depth);
     void mergeChunkNode(Chunk& cn);
-    bool updateChunkTree(Chunk& cn, const RenderData& data, const glm::dmat4& mvp);
-    void updateChunk(Chunk& chunk, const RenderData& data, const glm::dmat4& mvp) const;
+
+    /**
+     * Updates the chunk trees unless neither the view nor the chunk data generation has
+     * changed since the last call and the last call did not split or defer any chunks.
+     */
+    void updateChunkTrees(const RenderData& data, const glm::dmat4& mvp);
+    bool updateChunkTree(Chunk& cn, const RenderData& data, const glm::dmat4& mvp,
+        const glm::dvec3& cameraPosition);
+    void updateChunk(Chunk& chunk, const RenderData& data, const glm::dmat4& mvp,
+        const glm::dvec3& cameraPosition);
+
+    /**
+     * Returns whether a split or merge that does not change the visible quality, that is
+     * a merge or a split of a chunk that is not visible, can be performed in this frame
+     * or whether it has to be deferred as the update time budget has been used up.
+     */
+    bool canPerformDeferrableUpdate();
+
+    /**
+     * Increments the chunk data generation if the render settings of the height layers,
+     * which are used for the bounding heights, have changed since the last call.
+     */
+    void checkHeightLayerSettings();
+
+    /**
+     * Invalidates the cached data of all chunks in the tree below \p cn that use the
+     * tile with the provided \p tileIndex, which are the chunk of the tile itself and
+     * its descendants.
+     */
+    void invalidateChunkData(Chunk& cn, const TileIndex& tileIndex);
+
+    /**
+     * Extrapolates the camera movement of the last frame by the prefetch lookahead and
+     * enqueues the tiles of the chunks that would be split at the predicted camera
+     * position as prefetch requests.
+     */
+    void prefetchTiles(const RenderData& data);
+    void prefetchChunkTree(const Chunk& cn, const glm::dvec3& cameraPosition,
+        int& budget);
+    void prefetchChunk(const Chunk& chunk, const glm::dvec3& cameraPosition,
+        const BoundingHeights& heights, int depth, int& budget);
     void freeChunkNode(Chunk* n);
 
     Ellipsoid _ellipsoid;
@@ -255,6 +364,11 @@ private:
 
     glm::dmat4 _cachedModelTransform = glm::dmat4(1.0);
     glm::dmat4 _cachedInverseModelTransform = glm::dmat4(1.0);
+    /// The camera position in model space of the last frame, used for the prefetching
+    std::optional<glm::dvec3> _previousCameraPosition;
+    /// The frame in which the tiles were last prefetched, as #renderChunks is called
+    /// more than once per frame if shadows are enabled
+    uint64_t _prefetchFrameNumber = 0;
 
     ghoul::ReusableTypedMemoryPool<Chunk, 256> _chunkPool;
 
@@ -286,7 +400,6 @@ private:
 
     bool _shadersNeedRecompilation = true;
     bool _lodScaleFactorDirty = true;
-    bool _chunkCornersDirty = true;
     bool _nLayersIsDirty = true;
     bool _allChunksAvailable = true;
     bool _layerManagerDirty = true;
@@ -294,6 +407,33 @@ private:
     size_t _iterationsOfUnavailableData = 0;
     Layer* _lastChangedLayer = nullptr;
 
+    /// Incremented whenever the cached data of all chunks becomes invalid, for example
+    /// when the layers or the level of detail have changed. Chunks affected by newly
+    /// arrived tiles are invalidated individually by #invalidateChunkData
+    uint64_t _chunkDataGeneration = 1;
+    /// The opacity, gamma, multiplier, and offset of the active height layers
+    std::vector<glm::vec4> _heightLayerSettings;
+
+    /// The height layer tiles that were used by #getHeight and #heights, together with
+    /// the generations of the tile cache and of the chunk data they are valid for
+    mutable struct {
+        std::unordered_map<TileIndex::TileHashKey, HeightTile> tiles;
+        uint64_t tileCacheGeneration = 0;
+        uint64_t chunkDataGeneration = 0;
+    } _heightTileCache;
+
+    /// The state of the last chunk tree update, which is used to skip the next update if
+    /// it would not change anything
+    struct {
+        glm::dmat4 mvp = glm::dmat4(0.0);
+        glm::dvec3 cameraPosition = glm::dvec3(0.0);
+        uint64_t dataGeneration = 0;
+        bool hasPendingUpdates = false;
+
+        std::chrono::steady_clock::time_point start;
+        int nDeferrableUpdates = 0;
+    } _chunkTreeUpdate;
+
     // Components
     RingsComponent _ringsComponent;
     ShadowComponent _shadowComponent;
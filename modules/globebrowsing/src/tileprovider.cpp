@@ -168,19 +168,20 @@ void initAsyncTileDataReader(DefaultTileProvider& t, TileTextureInitData initDat
     );
 }
 
-bool initTexturesFromLoadedData(DefaultTileProvider& t) {
+std::optional<TileIndex> initTexturesFromLoadedData(DefaultTileProvider& t) {
     ZoneScoped
 
     if (t.asyncTextureDataProvider) {
         std::optional<RawTile> tile = t.asyncTextureDataProvider->popFinishedRawTile();
         if (tile) {
-            const cache::ProviderTileKey key = { tile->tileIndex, t.uniqueIdentifier };
+            const TileIndex tileIndex = tile->tileIndex;
+            const cache::ProviderTileKey key = { tileIndex, t.uniqueIdentifier };
             ghoul_assert(!t.tileCache->exist(key), "Tile must not be existing in cache");
             t.tileCache->createTileAndPut(key, std::move(*tile));
-            return true;
+            return tileIndex;
         }
     }
-    return false;
+    return std::nullopt;
 }
 
 
@@ -954,6 +955,9 @@ Tile tile(TileProvider& tp, const TileIndex& tileIndex) {
                     //TracyMessage("Enqueuing tile", 32);
                     t.asyncTextureDataProvider->enqueueTileIO(tileIndex);
                 }
+                else {
+                    t.asyncTextureDataProvider->notifyTileUsed(tileIndex);
+                }
 
                 return tile;
             }
@@ -1059,6 +1063,44 @@ Tile tile(TileProvider& tp, const TileIndex& tileIndex) {
 
 
 
+bool prefetch(TileProvider& tp, const TileIndex& tileIndex) {
+    ZoneScoped
+
+    switch (tp.type) {
+        case Type::DefaultTileProvider: {
+            DefaultTileProvider& t = static_cast<DefaultTileProvider&>(tp);
+            if (!t.asyncTextureDataProvider || tileIndex.level > maxLevel(t)) {
+                return false;
+            }
+            const cache::ProviderTileKey key = { tileIndex, t.uniqueIdentifier };
+            return !t.tileCache->exist(key) &&
+                t.asyncTextureDataProvider->prefetchTileIO(tileIndex);
+        }
+        case Type::ByIndexTileProvider: {
+            TileProviderByIndex& t = static_cast<TileProviderByIndex&>(tp);
+            const auto it = t.tileProviderMap.find(tileIndex.hashKey());
+            return it != t.tileProviderMap.end() && prefetch(*it->second, tileIndex);
+        }
+        case Type::ByLevelTileProvider: {
+            TileProviderByLevel& t = static_cast<TileProviderByLevel&>(tp);
+            TileProvider* provider = levelProvider(t, tileIndex.level);
+            return provider && prefetch(*provider, tileIndex);
+        }
+        case Type::TemporalTileProvider: {
+            TemporalTileProvider& t = static_cast<TemporalTileProvider&>(tp);
+            return t.successfulInitialization && t.currentTileProvider &&
+                prefetch(*t.currentTileProvider, tileIndex);
+        }
+        case Type::SingleImageTileProvider:
+        case Type::SizeReferenceTileProvider:
+        case Type::TileIndexTileProvider:
+            // These providers do not load their tiles asynchronously
+            return false;
+        default:
+            throw ghoul::MissingCaseException();
+    }
+}
+
 Tile::Status tileStatus(TileProvider& tp, const TileIndex& index) {
     ZoneScoped
 
@@ -1166,7 +1208,7 @@ TileDepthTransform depthTransform(TileProvider& tp) {
 
 
 
-int update(TileProvider& tp) {
+int update(TileProvider& tp, std::vector<TileIndex>& updatedTiles) {
     ZoneScoped
 
     switch (tp.type) {
@@ -1177,7 +1219,7 @@ int update(TileProvider& tp) {
             }
 
             t.asyncTextureDataProvider->update();
-            bool hasUploaded = initTexturesFromLoadedData(t);
+            std::optional<TileIndex> uploadedTile = initTexturesFromLoadedData(t);
 
             if (t.asyncTextureDataProvider->shouldBeDeleted()) {
                 t.asyncTextureDataProvider = nullptr;
@@ -1186,7 +1228,8 @@ int update(TileProvider& tp) {
                     tileTextureInitData(t.layerGroupID, t.padTiles, t.tilePixelSize)
                 );
             }
-            if (hasUploaded) {
+            if (uploadedTile.has_value()) {
+                updatedTiles.push_back(*uploadedTile);
                 return 1;
             }
             break;
@@ -1201,31 +1244,36 @@ int update(TileProvider& tp) {
             TileProviderByIndex& t = static_cast<TileProviderByIndex&>(tp);
             using K = TileIndex::TileHashKey;
             using V = std::unique_ptr<TileProvider>;
+            int res = 0;
             for (std::pair<const K, V>& it : t.tileProviderMap) {
-                update(*it.second);
+                res += update(*it.second, updatedTiles);
             }
-            update(*t.defaultTileProvider);
-            break;
+            res += update(*t.defaultTileProvider, updatedTiles);
+            return res;
         }
         case Type::ByLevelTileProvider: {
             TileProviderByLevel& t = static_cast<TileProviderByLevel&>(tp);
+            int res = 0;
             for (const std::unique_ptr<TileProvider>& provider : t.levelTileProviders) {
-                update(*provider);
+                res += update(*provider, updatedTiles);
             }
-            break;
+            return res;
         }
         case Type::TemporalTileProvider: {
             TemporalTileProvider& t = static_cast<TemporalTileProvider&>(tp);
+            int res = 0;
             if (t.successfulInitialization) {
                 TileProvider* newCurrent = getTileProvider(t, global::timeManager.time());
-                if (newCurrent) {
+                if (newCurrent && newCurrent != t.currentTileProvider) {
                     t.currentTileProvider = newCurrent;
+                    // All tiles have changed, even if they were already loaded before
+                    res += 1;
                 }
                 if (t.currentTileProvider) {
-                    update(*t.currentTileProvider);
+                    res += update(*t.currentTileProvider, updatedTiles);
                 }
             }
-            break;
+            return res;
         }
         default:
             throw ghoul::MissingCaseException();
@@ -36,6 +36,7 @@
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <unordered_map>
+#include <vector>
 
 struct CPLXMLNode;
 
@@ -199,6 +200,15 @@ bool deinitialize(TileProvider& tp);
 
 Tile tile(TileProvider& tp, const TileIndex& tileIndex);
 
+/**
+ * Speculatively loads the <code>Tile</code> with the provided <code>TileIndex</code> in
+ * the background, so that it is available once the <code>tile</code> function is called
+ * for it. Prefetch requests have a lower priority than the requests made through the
+ * <code>tile</code> function. Returns <code>true</code> if a new request was enqueued and
+ * <code>false</code> if the tile is already cached or requested.
+ */
+bool prefetch(TileProvider& tp, const TileIndex& tileIndex);
+
 ChunkTile chunkTile(TileProvider& tp, TileIndex tileIndex, int parents = 0,
     int maxParents = 1337);
 
@@ -221,11 +231,14 @@ TileDepthTransform depthTransform(TileProvider& tp);
 
 /**
  * This method should be called once per frame. Here, TileProviders
- * are given the opportunity to update their internal state.
+ * are given the opportunity to update their internal state. The indices of the tiles
+ * that have been uploaded in this call are appended to \p updatedTiles.
  *
- * \return The number of tiles that have been updated in this call
+ * \return The number of tiles that have been updated in this call. This number is larger
+ *         than the number of appended indices if all tiles of a provider have changed,
+ *         for example when a TemporalTileProvider switches to a different time step
  */
-int update(TileProvider& tp);
+int update(TileProvider& tp, std::vector<TileIndex>& updatedTiles);
 
 /**
  * Provides a uniform way of all TileProviders to reload or
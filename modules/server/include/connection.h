@@ -25,9 +25,16 @@
 #ifndef __OPENSPACE_MODULE_SERVER___CONNECTION___H__
 #define __OPENSPACE_MODULE_SERVER___CONNECTION___H__
 
-#include <ghoul/misc/templatefactory.h>
 #include <openspace/json.h>
+#include <openspace/util/jobsystem.h>
+#include <ghoul/misc/templatefactory.h>
+#include <atomic>
+#include <deque>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <string>
 #include <thread>
 
@@ -47,13 +54,47 @@ public:
         bool authorized = false,
         const std::string& password = ""
     );
+    ~Connection();
+
+    /**
+     * Handles the parts of the \p message that do not have to be executed on the main
+     * thread. This function must only be called by the thread that receives the messages
+     * of this connection. The message is parsed, unauthorized messages are rejected, and
+     * messages for topics that only depend on the state of this connection, such as the
+     * authorization, are handled immediately.
+     *
+     * \return The parsed message if it has to be passed to #handleJson on the main
+     *         thread, or <code>std::nullopt</code> if it has already been handled
+     */
+    std::optional<nlohmann::json> preprocessMessage(const std::string& message);
 
-    void handleMessage(const std::string& message);
+    /**
+     * Sends the \p message to the client. If another thread is currently sending on this
+     * connection, the \p message is queued and sent by that thread, so this function can
+     * be called from any thread without waiting for the socket.
+     */
     void sendMessage(const std::string& message);
     void handleJson(const nlohmann::json& json);
     void sendJson(const nlohmann::json& json);
     void setAuthorized(bool status);
 
+    /**
+     * Schedules the value of the SubscriptionTopic with the \p topicId to be sent with
+     * the next call to #flushSubscriptions. Any number of changes until then result in a
+     * single update for that topic. This function can be called from any thread.
+     */
+    void scheduleSubscriptionUpdate(TopicId topicId);
+
+    /**
+     * Sends the current values of all subscriptions that were scheduled since the last
+     * flush. The values are read on the calling thread, but the conversion to JSON and
+     * the sending of the messages is performed by the JobSystem. If the messages of the
+     * previous flush have not been sent yet, for example because the client is slow to
+     * receive them, nothing is sent and the scheduled subscriptions are coalesced with
+     * the changes that happen until the next flush.
+     */
+    void flushSubscriptions();
+
     bool isAuthorized() const;
 
     ghoul::io::Socket* socket();
@@ -61,15 +102,37 @@ public:
     void setThread(std::thread&& thread);
 
 private:
+    std::optional<nlohmann::json> parseMessage(const std::string& message);
+
+    /**
+     * Sends the messages in the outgoing queue unless another thread is currently sending
+     * messages on this connection, in which case that thread sends them instead. This
+     * function never waits for the socket.
+     */
+    void sendOutgoingMessages();
+
     ghoul::TemplateFactory<Topic> _topicFactory;
     std::map<TopicId, std::unique_ptr<Topic>> _topics;
+    // The topics that are handled by the thread that receives the messages
+    std::map<TopicId, std::unique_ptr<Topic>> _threadSafeTopics;
     std::unique_ptr<ghoul::io::Socket> _socket;
     std::thread _thread;
 
     std::string _address;
-    bool _isAuthorized = false;
+    std::atomic_bool _isAuthorized = false;
     std::map<TopicId, std::string> _messageQueue;
     std::map<TopicId, std::chrono::system_clock::time_point> _sentMessages;
+
+    std::mutex _subscriptionMutex;
+    std::set<TopicId> _scheduledSubscriptions;
+
+    // Prevents messages from being sent by the main thread and the JobSystem at the same
+    // time. Messages that are sent while the socket is busy wait in the outgoing queue
+    std::mutex _sendMutex;
+    std::mutex _outgoingMutex;
+    std::deque<std::string> _outgoingMessages;
+    std::future<void> _subscriptionSend;
+    JobSystem::Key _subscriptionSendKey;
 };
 
 } // namespace openspace
@@ -27,23 +27,59 @@
 
 #include <modules/server/include/topics/topic.h>
 
+#include <string>
+
 namespace openspace::properties { class Property; }
 
 namespace openspace {
 
+/**
+ * A topic that sends the value of a property whenever it changes. Changes are not sent
+ * immediately but are coalesced by the Connection, which sends the latest value of all
+ * changed subscriptions at most once per update interval of the ServerModule. If the
+ * subscription was started with <code>batch</code> set to <code>true</code>, the update
+ * is sent as part of a single JSON array that contains the updates of all batched
+ * subscriptions of the connection.
+ */
 class SubscriptionTopic : public Topic {
 public:
+    /**
+     * The state of the subscribed property at the time of a flush. Only the values that
+     * have to be read from the property on the main thread are stored, the conversion to
+     * JSON can be performed on any thread.
+     */
+    struct Snapshot {
+        /// Creates the same message that the wrapped payload of the property would be
+        nlohmann::json toJson() const;
+
+        size_t topicId = 0;
+        std::string jsonDescription;
+        std::string description;
+        std::string jsonValue;
+    };
+
     SubscriptionTopic() = default;
     ~SubscriptionTopic();
 
     void handleJson(const nlohmann::json& json) override;
     bool isDone() const override;
 
+    /**
+     * Returns the current state of the subscribed property.
+     *
+     * \pre This topic must not be done
+     */
+    Snapshot snapshot() const;
+
+    /// Returns whether updates should be sent as part of the batched message
+    bool isBatched() const;
+
 private:
     void resetCallbacks();
 
     const int UnsetCallbackHandle = -1;
 
+    bool _isBatched = false;
     bool _requestedResourceIsSubscribable = false;
     bool _isSubscribedTo = false;
     int _onChangeHandle = UnsetCallbackHandle;
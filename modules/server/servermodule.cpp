@@ -40,7 +40,18 @@
 #include <ghoul/misc/templatefactory.h>
 
 namespace {
+    constexpr const char* _loggerCat = "ServerModule";
+
     constexpr const char* KeyInterfaces = "Interfaces";
+
+    constexpr openspace::properties::Property::PropertyInfo SubscriptionIntervalInfo = {
+        "SubscriptionInterval",
+        "Subscription Interval",
+        "The minimum time in seconds between two updates of property subscriptions. All "
+        "changes to a subscribed property that happen within this interval are sent to "
+        "the client as a single update. If this value is 0, the updates are sent at most "
+        "once per frame."
+    };
 } // namespace
 
 namespace openspace {
@@ -48,8 +59,10 @@ namespace openspace {
 ServerModule::ServerModule()
     : OpenSpaceModule(ServerModule::Name)
     , _interfaceOwner({"Interfaces", "Interfaces", "Server Interfaces"})
+    , _subscriptionInterval(SubscriptionIntervalInfo, 0.f, 0.f, 10.f)
 {
     addPropertySubOwner(_interfaceOwner);
+    addProperty(_subscriptionInterval);
 }
 
 ServerModule::~ServerModule() {
@@ -156,6 +169,9 @@ void ServerModule::preSync() {
     // Consume all messages put into the message queue by the socket threads.
     consumeMessages();
 
+    // Send the subscription updates that have been collected since the last flush
+    flushSubscriptions();
+
     // Join threads for sockets that disconnected.
     cleanUpFinishedThreads();
 }
@@ -181,6 +197,21 @@ void ServerModule::cleanUpFinishedThreads() {
     ), _connections.end());
 }
 
+void ServerModule::flushSubscriptions() {
+    ZoneScoped
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const std::chrono::duration<float> interval(_subscriptionInterval);
+    if (now - _lastSubscriptionFlush < interval) {
+        return;
+    }
+    _lastSubscriptionFlush = now;
+
+    for (ConnectionData& connectionData : _connections) {
+        connectionData.connection->flushSubscriptions();
+    }
+}
+
 void ServerModule::disconnectAll() {
     ZoneScoped
 
@@ -203,24 +234,32 @@ void ServerModule::disconnectAll() {
 void ServerModule::handleConnection(std::shared_ptr<Connection> connection) {
     ZoneScoped
 
+    // Parsing the messages and handling the topics that don't need to access the state of
+    // the engine is done on this thread, so only the remaining messages are passed to the
+    // main thread
     std::string messageString;
     messageString.reserve(256);
     while (connection->socket()->getMessage(messageString)) {
-        std::lock_guard lock(_messageQueueMutex);
-        _messageQueue.push_back({ connection, std::move(messageString) });
+        std::optional<nlohmann::json> json = connection->preprocessMessage(messageString);
+        if (json) {
+            _messageQueue.push({ connection, std::move(*json) });
+        }
     }
 }
 
 void ServerModule::consumeMessages() {
     ZoneScoped
 
-    std::lock_guard lock(_messageQueueMutex);
-    while (!_messageQueue.empty()) {
-        const Message& m = _messageQueue.front();
+    Message m;
+    while (_messageQueue.pop(m)) {
         if (std::shared_ptr<Connection> c = m.connection.lock()) {
-            c->handleMessage(m.messageString);
+            try {
+                c->handleJson(m.json);
+            }
+            catch (const std::exception& e) {
+                LERROR(fmt::format("JSON handling error: {}", e.what()));
+            }
         }
-        _messageQueue.pop_front();
     }
 }
 
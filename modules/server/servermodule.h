@@ -29,9 +29,11 @@
 
 #include <modules/server/include/serverinterface.h>
 
-#include <deque>
+#include <openspace/json.h>
+#include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/util/mpscqueue.h>
+#include <chrono>
 #include <memory>
-#include <mutex>
 
 namespace openspace {
 
@@ -43,7 +45,7 @@ class Connection;
 
 struct Message {
     std::weak_ptr<Connection> connection;
-    std::string messageString;
+    nlohmann::json json;
 };
 
 class ServerModule : public OpenSpaceModule {
@@ -68,14 +70,19 @@ private:
     void cleanUpFinishedThreads();
     void consumeMessages();
     void disconnectAll();
+    void flushSubscriptions();
     void preSync();
 
-    std::mutex _messageQueueMutex;
-    std::deque<Message> _messageQueue;
+    /// Messages that have been received and preprocessed by the connection threads and
+    /// that have to be handled on the main thread
+    MpscQueue<Message> _messageQueue;
 
     std::vector<ConnectionData> _connections;
     std::vector<std::unique_ptr<ServerInterface>> _interfaces;
     properties::PropertyOwner _interfaceOwner;
+
+    properties::FloatProperty _subscriptionInterval;
+    std::chrono::steady_clock::time_point _lastSubscriptionFlush;
 };
 
 } // namespace openspace
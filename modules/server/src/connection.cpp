@@ -40,12 +40,14 @@
 #include <modules/server/include/topics/versiontopic.h>
 #include <openspace/engine/configuration.h>
 #include <openspace/engine/globals.h>
+#include <openspace/util/jobsystem.h>
 #include <ghoul/io/socket/socket.h>
 #include <ghoul/io/socket/tcpsocketserver.h>
 #include <ghoul/io/socket/websocketserver.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/profiling.h>
 #include <fmt/format.h>
+#include <algorithm>
 
 namespace {
     constexpr const char* _loggerCat = "ServerModule: Connection";
@@ -67,6 +69,13 @@ namespace {
     constexpr const char* TriggerPropertyTopicKey = "trigger";
     constexpr const char* BounceTopicKey = "bounce";
     constexpr const char* FlightControllerTopicKey = "flightcontroller";
+
+    // These topics only depend on the state of their connection and are therefore handled
+    // directly on the thread that receives the messages instead of the main thread
+    constexpr const char* ThreadSafeTopicKeys[] = {
+        AuthenticationTopicKey,
+        BounceTopicKey
+    };
 } // namespace
 
 namespace openspace {
@@ -78,6 +87,7 @@ Connection::Connection(std::unique_ptr<ghoul::io::Socket> s,
     : _socket(std::move(s))
     , _address(std::move(address))
     , _isAuthorized(authorized)
+    , _subscriptionSendKey(global::jobSystem.createKey())
 {
     ghoul_assert(_socket, "Socket must not be nullptr");
 
@@ -108,29 +118,93 @@ Connection::Connection(std::unique_ptr<ghoul::io::Socket> s,
     _topicFactory.registerClass<VersionTopic>(VersionTopicKey);
 }
 
-void Connection::handleMessage(const std::string& message) {
+Connection::~Connection() {
+    // If the job has not started yet, cancelling it destroys the promise, which makes the
+    // future ready. Otherwise we have to wait for it as it accesses the socket
+    if (_subscriptionSend.valid()) {
+        global::jobSystem.cancel(_subscriptionSendKey);
+        _subscriptionSend.wait();
+    }
+}
+
+std::optional<nlohmann::json> Connection::preprocessMessage(const std::string& message)
+{
+    ZoneScoped
+
+    std::optional<nlohmann::json> json = parseMessage(message);
+    if (!json) {
+        return std::nullopt;
+    }
+
+    auto topicJson = json->find(MessageKeyTopic);
+    auto payloadJson = json->find(MessageKeyPayload);
+    if (topicJson == json->end() || !topicJson->is_number_integer() ||
+        payloadJson == json->end() || !payloadJson->is_object())
+    {
+        // Malformed messages are reported by handleJson
+        return json;
+    }
+
+    const TopicId topicId = *topicJson;
+    auto topicIt = _threadSafeTopics.find(topicId);
+    if (topicIt == _threadSafeTopics.end()) {
+        auto typeJson = json->find(MessageKeyType);
+        if (typeJson == json->end() || !typeJson->is_string()) {
+            return json;
+        }
+
+        const std::string& type = typeJson->get_ref<const std::string&>();
+        if (!isAuthorized() && type != AuthenticationTopicKey) {
+            // Messages are checked for authorization in the order in which they arrive,
+            // which is no longer the order in which they are handled
+            LERROR("Connection isn't authorized.");
+            return std::nullopt;
+        }
+
+        const bool isThreadSafe = std::find(
+            std::begin(ThreadSafeTopicKeys),
+            std::end(ThreadSafeTopicKeys),
+            type
+        ) != std::end(ThreadSafeTopicKeys);
+        if (!isThreadSafe) {
+            return json;
+        }
+
+        std::unique_ptr<Topic> topic = std::unique_ptr<Topic>(_topicFactory.create(type));
+        topic->initialize(this, topicId);
+        topicIt = _threadSafeTopics.emplace(topicId, std::move(topic)).first;
+    }
+    else if (!isAuthorized()) {
+        LERROR("Connection isn't authorized.");
+        return std::nullopt;
+    }
+
+    try {
+        Topic& topic = *topicIt->second;
+        topic.handleJson(*payloadJson);
+        if (topic.isDone()) {
+            _threadSafeTopics.erase(topicIt);
+        }
+    }
+    catch (const std::exception& e) {
+        LERROR(fmt::format("JSON handling error from: {}. {}", message, e.what()));
+    }
+    return std::nullopt;
+}
+
+std::optional<nlohmann::json> Connection::parseMessage(const std::string& message) {
     ZoneScoped
 
     try {
-        nlohmann::json j = nlohmann::json::parse(message.c_str());
-        try {
-            handleJson(j);
-        } catch (const std::domain_error& e) {
-            LERROR(fmt::format("JSON handling error from: {}. {}", message, e.what()));
-        }
-        } catch (const std::out_of_range& e) {
-            LERROR(fmt::format("JSON handling error from: {}. {}", message, e.what()));
-        }
-        catch (const std::exception& e) {
-            LERROR(e.what());
-    } catch (...) {
+        return nlohmann::json::parse(message.c_str());
+    }
+    catch (...) {
         if (!isAuthorized()) {
             _socket->disconnect();
             LERROR(fmt::format(
                 "Could not parse JSON: '{}'. Connection is unauthorized. Disconnecting.",
                 message
             ));
-            return;
         }
         else {
             std::string sanitizedString = message;
@@ -144,6 +218,7 @@ void Connection::handleMessage(const std::string& message) {
             );
             LERROR(fmt::format("Could not parse JSON: '{}'", sanitizedString));
         }
+        return std::nullopt;
     }
 }
 
@@ -209,7 +284,35 @@ void Connection::handleJson(const nlohmann::json& json) {
 void Connection::sendMessage(const std::string& message) {
     ZoneScoped
 
-    _socket->putMessage(message);
+    {
+        std::lock_guard lock(_outgoingMutex);
+        _outgoingMessages.push_back(message);
+    }
+    sendOutgoingMessages();
+}
+
+void Connection::sendOutgoingMessages() {
+    // Only one thread at a time writes to the socket. A thread that finds the socket busy
+    // leaves its message in the queue, where it is picked up by the thread that is
+    // currently sending. This way, the main thread never has to wait for the JobSystem
+    // to send the subscriptions to a slow client
+    std::unique_lock sendLock(_sendMutex, std::try_to_lock);
+    while (sendLock) {
+        std::deque<std::string> messages;
+        {
+            std::lock_guard lock(_outgoingMutex);
+            if (_outgoingMessages.empty()) {
+                // The send lock is released while the queue is locked, so any message
+                // that is added afterwards is sent by the thread that added it
+                sendLock.unlock();
+                return;
+            }
+            messages.swap(_outgoingMessages);
+        }
+        for (const std::string& m : messages) {
+            _socket->putMessage(m);
+        }
+    }
 }
 
 void Connection::sendJson(const nlohmann::json& json) {
@@ -218,6 +321,86 @@ void Connection::sendJson(const nlohmann::json& json) {
     sendMessage(json.dump());
 }
 
+void Connection::scheduleSubscriptionUpdate(TopicId topicId) {
+    std::lock_guard lock(_subscriptionMutex);
+    _scheduledSubscriptions.insert(topicId);
+}
+
+void Connection::flushSubscriptions() {
+    ZoneScoped
+
+    // Locking the socket can fail spuriously, in which case messages might be left in the
+    // queue without a thread sending them
+    sendOutgoingMessages();
+
+    if (_subscriptionSend.valid()) {
+        const std::future_status status =
+            _subscriptionSend.wait_for(std::chrono::seconds(0));
+        if (status != std::future_status::ready) {
+            // The previous updates are still being sent, so we keep collecting changes
+            return;
+        }
+    }
+
+    std::set<TopicId> scheduled;
+    {
+        std::lock_guard lock(_subscriptionMutex);
+        scheduled.swap(_scheduledSubscriptions);
+    }
+
+    std::vector<SubscriptionTopic::Snapshot> singles;
+    std::vector<SubscriptionTopic::Snapshot> batched;
+    for (TopicId topicId : scheduled) {
+        auto it = _topics.find(topicId);
+        if (it == _topics.end()) {
+            // The subscription has been stopped since it was scheduled
+            continue;
+        }
+        SubscriptionTopic* topic = dynamic_cast<SubscriptionTopic*>(it->second.get());
+        if (!topic || topic->isDone()) {
+            continue;
+        }
+
+        if (topic->isBatched()) {
+            batched.push_back(topic->snapshot());
+        }
+        else {
+            singles.push_back(topic->snapshot());
+        }
+    }
+
+    if (singles.empty() && batched.empty()) {
+        return;
+    }
+
+    auto promise = std::make_shared<std::promise<void>>();
+    _subscriptionSend = promise->get_future();
+    global::jobSystem.enqueue(
+        [this, singles = std::move(singles), batched = std::move(batched), promise]() {
+            ZoneScopedN("Send Subscriptions")
+
+            try {
+                for (const SubscriptionTopic::Snapshot& snapshot : singles) {
+                    sendMessage(snapshot.toJson().dump());
+                }
+                if (!batched.empty()) {
+                    nlohmann::json batch = nlohmann::json::array();
+                    for (const SubscriptionTopic::Snapshot& snapshot : batched) {
+                        batch.push_back(snapshot.toJson());
+                    }
+                    sendMessage(batch.dump());
+                }
+            }
+            catch (const std::exception& e) {
+                LERROR(fmt::format("Error sending subscriptions: {}", e.what()));
+            }
+            promise->set_value();
+        },
+        JobSystem::Priority::Background,
+        _subscriptionSendKey
+    );
+}
+
 bool Connection::isAuthorized() const {
     return _isAuthorized;
 }
@@ -31,11 +31,14 @@
 #include <openspace/util/timemanager.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
 
 namespace {
     constexpr const char* _loggerCat = "SubscriptionTopic";
     constexpr const char* PropertyKey = "property";
     constexpr const char* EventKey = "event";
+    constexpr const char* BatchKey = "batch";
 
     constexpr const char* StartSubscription = "start_subscription";
     constexpr const char* StopSubscription = "stop_subscription";
@@ -53,6 +56,39 @@ bool SubscriptionTopic::isDone() const {
     return !_requestedResourceIsSubscribable || !_isSubscribedTo;
 }
 
+nlohmann::json SubscriptionTopic::Snapshot::toJson() const {
+    ZoneScoped
+
+    // This is the same structure as the to_json function for properties produces
+    json value = {
+        { "Description", json::parse(jsonDescription) },
+        { "Value", json::parse(jsonValue) }
+    };
+    value["Description"]["description"] = description;
+
+    return {
+        { "topic", topicId },
+        { "payload", std::move(value) }
+    };
+}
+
+SubscriptionTopic::Snapshot SubscriptionTopic::snapshot() const {
+    ZoneScoped
+
+    ghoul_precondition(!isDone(), "Subscription must not be done");
+
+    Snapshot snapshot;
+    snapshot.topicId = _topicId;
+    snapshot.jsonDescription = _prop->generateBaseJsonDescription();
+    snapshot.description = _prop->description();
+    snapshot.jsonValue = _prop->jsonValue();
+    return snapshot;
+}
+
+bool SubscriptionTopic::isBatched() const {
+    return _isBatched;
+}
+
 void SubscriptionTopic::resetCallbacks() {
     if (!_prop) {
         return;
@@ -79,8 +115,13 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
         if (_prop) {
             _requestedResourceIsSubscribable = true;
             _isSubscribedTo = true;
-            auto onChange = [this, k = std::move(key)]() {
-                _connection->sendJson(wrappedPayload(_prop));
+            auto batch = json.find(BatchKey);
+            _isBatched = batch != json.end() && batch->is_boolean() && batch->get<bool>();
+
+            // The value is sent by the connection during its next flush, which coalesces
+            // all changes that happen until then
+            auto onChange = [this]() {
+                _connection->scheduleSubscriptionUpdate(_topicId);
             };
 
             _onChangeHandle = _prop->onChange(onChange);
@@ -90,7 +131,7 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
                 _isSubscribedTo = false;
             });
 
-            // immediately send the value
+            // Send the initial value with the next flush
             onChange();
         }
         else {
@@ -136,6 +136,8 @@ RenderableConstellationBounds::RenderableConstellationBounds(
         "RenderableConstellationBounds"
     );
 
+    _requiresMainThreadUpdate = false;
+
     _vertexFilename.onChange([&](){ loadVertexFile(); });
     addProperty(_vertexFilename);
     _vertexFilename = dictionary.value<std::string>(VertexInfo.identifier);
@@ -26,6 +26,7 @@
 
 #include <modules/space/translation/keplertranslation.h>
 #include <modules/space/translation/tletranslation.h>
+#include <modules/space/util/keplerpropagator.h>
 #include <modules/space/spacemodule.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/rendering/renderengine.h>
@@ -34,6 +35,7 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
+#include <ghoul/fmt.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/misc/csvreader.h>
@@ -372,6 +374,8 @@ RenderableOrbitalKepler::RenderableOrbitalKepler(const ghoul::Dictionary& dict)
         "RenderableOrbitalKepler"
     );
 
+    _requiresMainThreadUpdate = false;
+
     _path = dict.value<std::string>(PathInfo.identifier);
     _segmentQuality = static_cast<int>(dict.value<double>(SegmentQualityInfo.identifier));
 
@@ -516,6 +520,28 @@ void RenderableOrbitalKepler::render(const RenderData& data, RendererTasks&) {
 void RenderableOrbitalKepler::updateBuffers() {
     readDataFile(_path);
 
+    // The propagator only handles closed orbits, so rows with an eccentricity outside of
+    // [0, 1) or a period that is not positive are skipped instead of discarding the file
+    size_t nValidOrbits = 0;
+    for (size_t i = 0; i < _data.size(); ++i) {
+        const KeplerParameters& orbit = _data[i];
+        const bool isValid = orbit.eccentricity >= 0.0 && orbit.eccentricity < 1.0 &&
+                             orbit.period > 0.0;
+        if (isValid) {
+            _data[nValidOrbits] = _data[i];
+            _segmentSize[nValidOrbits] = _segmentSize[i];
+            ++nValidOrbits;
+        }
+    }
+    if (nValidOrbits < _data.size()) {
+        LWARNING(fmt::format(
+            "Skipped {} orbits in '{}' that are not closed or have no positive period",
+            _data.size() - nValidOrbits, _path.value()
+        ));
+        _data.erase(_data.begin() + nValidOrbits, _data.end());
+        _segmentSize.erase(_segmentSize.begin() + nValidOrbits, _segmentSize.end());
+    }
+
     size_t nVerticesTotal = 0;
 
     int numOrbits = static_cast<int>(_data.size());
@@ -524,11 +550,12 @@ void RenderableOrbitalKepler::updateBuffers() {
     }
     _vertexBufferData.resize(nVerticesTotal);
 
-    size_t vertexBufIdx = 0;
-    for (size_t orbitIdx = 0; orbitIdx < numOrbits; ++orbitIdx) {
-        const KeplerParameters& orbit = _data[orbitIdx];
-
-        _keplerTranslator.setKeplerElements(
+    // All orbits are propagated at once, which is much faster than updating a single
+    // KeplerTranslation for each of them
+    KeplerPropagator propagator;
+    propagator.reserve(_data.size());
+    for (const KeplerParameters& orbit : _data) {
+        propagator.addOrbit({
             orbit.eccentricity,
             orbit.semiMajorAxis,
             orbit.inclination,
@@ -537,18 +564,19 @@ void RenderableOrbitalKepler::updateBuffers() {
             orbit.meanAnomaly,
             orbit.period,
             orbit.epoch
-        );
+        });
+    }
+    const std::vector<glm::dvec3> positions = propagator.sampleOrbits(_segmentSize);
+
+    size_t vertexBufIdx = 0;
+    for (size_t orbitIdx = 0; orbitIdx < numOrbits; ++orbitIdx) {
+        const KeplerParameters& orbit = _data[orbitIdx];
 
         for (size_t j = 0 ; j < (_segmentSize[orbitIdx] + 1); ++j) {
             double timeOffset = orbit.period *
                 static_cast<double>(j)/ static_cast<double>(_segmentSize[orbitIdx]);
 
-            glm::dvec3 position = _keplerTranslator.position({
-                {},
-                Time(timeOffset + orbit.epoch),
-                Time(0.0)
-            });
-
+            const glm::dvec3& position = positions[vertexBufIdx];
             _vertexBufferData[vertexBufIdx].x = static_cast<float>(position.x);
             _vertexBufferData[vertexBufIdx].y = static_cast<float>(position.y);
             _vertexBufferData[vertexBufIdx].z = static_cast<float>(position.z);
@@ -112,8 +112,6 @@ private:
         double period = 0.0;
     };
 
-    KeplerTranslation _keplerTranslator;
-
     /// The backend storage for the vertex buffer object containing all points for this
     /// trail.
     std::vector<TrailVBOLayout> _vertexBufferData;
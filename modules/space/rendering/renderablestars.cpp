@@ -28,6 +28,7 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/util/distanceconstants.h>
+#include <openspace/util/speckfile.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
@@ -40,6 +41,7 @@
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <fstream>
@@ -1368,107 +1370,64 @@ void RenderableStars::loadData() {
 
 void RenderableStars::readSpeckFile() {
     std::string _file = _speckFile;
-    std::ifstream file(_file);
-    if (!file.good()) {
+    SpeckFile file(_file);
+    if (!file.isOpen()) {
         LERROR(fmt::format("Failed to open Speck file '{}'", _file));
         return;
     }
 
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line, '\n');
+    for (const SpeckFile::Variable& variable : file.variables()) {
+        _dataNames.push_back(variable.name);
 
-        if (line[0] == '#' || line.empty()) {
-            continue;
+        // +3 because the position x, y, z
+        const int position = variable.index + 3;
+        if (variable.name == "lum") {
+            _lumArrayPos = position;
         }
-
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture")
-        {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            if (_enableTestGrid) {
-                file.seekg(position - std::streamoff(8));
-            }
-            break;
+        else if (variable.name == "absmag") {
+            _absMagArrayPos = position;
         }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy;
-            str >> _nValuesPerStar;
-
-            std::string name;
-            str >> name;
-            _dataNames.push_back(name);
-
-            // +3 because the position x, y, z
-            if (name == "lum") {
-                _lumArrayPos = _nValuesPerStar + 3;
-            }
-            else if (name == "absmag") {
-                _absMagArrayPos = _nValuesPerStar + 3;
-            }
-            else if (name == "appmag") {
-                _appMagArrayPos = _nValuesPerStar + 3;
-            }
-            else if (name == "colorb_v") {
-                _bvColorArrayPos = _nValuesPerStar + 3;
-            }
-            else if (name == "vx") {
-                _velocityArrayPos = _nValuesPerStar + 3;
-            }
-            else if (name == "speed") {
-                _speedArrayPos = _nValuesPerStar + 3;
-            }
-            _nValuesPerStar += 1; // We want the number, but the index is 0 based
+        else if (variable.name == "appmag") {
+            _appMagArrayPos = position;
+        }
+        else if (variable.name == "colorb_v") {
+            _bvColorArrayPos = position;
+        }
+        else if (variable.name == "vx") {
+            _velocityArrayPos = position;
+        }
+        else if (variable.name == "speed") {
+            _speedArrayPos = position;
         }
     }
 
-    _nValuesPerStar += 3; // X Y Z are not counted in the Speck file indices
+    _nValuesPerStar = file.nValuesPerObject();
     _otherDataOption.addOptions(_dataNames);
 
+    _fullData = file.readData(_nValuesPerStar);
+
     float minLumValue = std::numeric_limits<float>::max();
     float maxLumValue = std::numeric_limits<float>::min();
 
-    do {
-        std::vector<float> values(_nValuesPerStar);
-        std::stringstream str(line);
-
-        for (int i = 0; i < _nValuesPerStar; ++i) {
-            str >> values[i];
-        }
-
-        bool nullArray = true;
-        for (float v : values) {
-            if (v != 0.0) {
-                nullArray = false;
-                break;
-            }
-        }
-        minLumValue = values[_lumArrayPos] < minLumValue ?
-            values[_lumArrayPos] : minLumValue;
-        maxLumValue = values[_lumArrayPos] > maxLumValue ?
-            values[_lumArrayPos] : maxLumValue;
+    // Remove all stars without any values in place while computing the luminosity range
+    // over all stars, including the removed ones
+    size_t nStarValues = 0;
+    for (size_t i = 0; i < _fullData.size(); i += _nValuesPerStar) {
+        const float* values = _fullData.data() + i;
+        minLumValue = std::min(values[_lumArrayPos], minLumValue);
+        maxLumValue = std::max(values[_lumArrayPos], maxLumValue);
+
+        const bool nullArray = std::all_of(
+            values,
+            values + _nValuesPerStar,
+            [](float v) { return v == 0.f; }
+        );
         if (!nullArray) {
-            _fullData.insert(_fullData.end(), values.begin(), values.end());
+            std::copy(values, values + _nValuesPerStar, _fullData.begin() + nStarValues);
+            nStarValues += _nValuesPerStar;
         }
-
-        std::getline(file, line, '\n');
-
-    } while (!file.eof());
+    }
+    _fullData.resize(nStarValues);
 
     // Normalize Luminosity:
     for (size_t i = 0; i < _fullData.size(); i += _nValuesPerStar) {
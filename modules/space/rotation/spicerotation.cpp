@@ -52,6 +52,14 @@ namespace {
         "Time Frame",
         "The time frame in which the spice kernels are valid."
     };
+
+    constexpr openspace::properties::Property::PropertyInfo InterpolationToleranceInfo = {
+        "InterpolationTolerance",
+        "Interpolation Tolerance",
+        "If this value is larger than 0, the rotation is interpolated from previously "
+        "sampled rotations instead of being computed by SPICE every time. The value is "
+        "the maximum allowed error of the interpolation in radians."
+    };
 } // namespace
 
 namespace openspace {
@@ -93,6 +101,12 @@ documentation::Documentation SpiceRotation::Documentation() {
                 Optional::Yes,
                 TimeFrameInfo.description
             },
+            {
+                InterpolationToleranceInfo.identifier,
+                new DoubleGreaterEqualVerifier(0.0),
+                Optional::Yes,
+                InterpolationToleranceInfo.description
+            }
         }
     };
 }
@@ -100,6 +114,7 @@ documentation::Documentation SpiceRotation::Documentation() {
 SpiceRotation::SpiceRotation(const ghoul::Dictionary& dictionary)
     : _sourceFrame(SourceInfo)
     , _destinationFrame(DestinationInfo)
+    , _interpolationTolerance(InterpolationToleranceInfo, 0.0, 0.0, 1.0)
 {
     documentation::testSpecificationAndThrow(
         Documentation(),
@@ -138,18 +153,37 @@ SpiceRotation::SpiceRotation(const ghoul::Dictionary& dictionary)
     addProperty(_sourceFrame);
     addProperty(_destinationFrame);
 
-    _sourceFrame.onChange([this]() { requireUpdate(); });
-    _destinationFrame.onChange([this]() { requireUpdate(); });
+    if (dictionary.hasKey(InterpolationToleranceInfo.identifier)) {
+        _interpolationTolerance = dictionary.value<double>(
+            InterpolationToleranceInfo.identifier
+        );
+    }
+    addProperty(_interpolationTolerance);
+
+    _sourceFrame.onChange([this]() {
+        _cachedSourceFrame = SpiceManager::ref().frame(_sourceFrame);
+        requireUpdate();
+    });
+    _destinationFrame.onChange([this]() {
+        _cachedDestinationFrame = SpiceManager::ref().frame(_destinationFrame);
+        requireUpdate();
+    });
+    _interpolationTolerance.onChange([this]() { requireUpdate(); });
+
+    // The frames were set before the kernels were loaded and the callbacks were added
+    _cachedSourceFrame = SpiceManager::ref().frame(_sourceFrame);
+    _cachedDestinationFrame = SpiceManager::ref().frame(_destinationFrame);
 }
 
 glm::dmat3 SpiceRotation::matrix(const UpdateData& data) const {
     if (_timeFrame && !_timeFrame->isActive(data.time)) {
         return glm::dmat3(1.0);
     }
-    return SpiceManager::ref().positionTransformMatrix(
-        _sourceFrame,
-        _destinationFrame,
-        data.time.j2000Seconds()
+    return SpiceManager::ref().interpolatedPositionTransformMatrix(
+        _cachedSourceFrame,
+        _cachedDestinationFrame,
+        data.time.j2000Seconds(),
+        _interpolationTolerance
     );
 }
 
@@ -27,8 +27,10 @@
 
 #include <openspace/scene/rotation.h>
 
+#include <openspace/properties/scalar/doubleproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/scene/timeframe.h>
+#include <openspace/util/spicemanager.h>
 
 namespace openspace {
 
@@ -46,7 +48,13 @@ public:
 private:
     properties::StringProperty _sourceFrame;
     properties::StringProperty _destinationFrame;
+    properties::DoubleProperty _interpolationTolerance;
     ghoul::mm_unique_ptr<TimeFrame> _timeFrame;
+
+    // The frames are resolved whenever the properties change, so that neither the
+    // strings have to be retrieved nor their NAIF IDs have to be looked up every frame
+    SpiceManager::NaifObject _cachedSourceFrame;
+    SpiceManager::NaifObject _cachedDestinationFrame;
 };
 
 } // namespace openspace
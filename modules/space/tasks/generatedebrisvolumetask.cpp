@@ -23,6 +23,7 @@
  ****************************************************************************************/
 #include <modules/space/tasks/generatedebrisvolumetask.h>
 
+#include <modules/space/util/keplerpropagator.h>
 #include <modules/volume/rawvolume.h>
 #include <modules/volume/rawvolumemetadata.h>
 #include <modules/volume/rawvolumewriter.h>
@@ -394,10 +395,31 @@ std::vector<glm::dvec3> getPositionBuffer(std::vector<KeplerParameters> tleData,
     float maxTheta = 0.0;
     float maxPhi = 0.0;
 
-    std::vector<glm::dvec3> positionBuffer;
+    // The propagator only handles closed orbits, so rows with an eccentricity outside of
+    // [0, 1) or a period that is not positive are skipped instead of aborting the task
+    size_t nValidOrbits = 0;
+    for (size_t i = 0; i < tleData.size(); ++i) {
+        const KeplerParameters& orbit = tleData[i];
+        const bool isValid = orbit.eccentricity >= 0.0 && orbit.eccentricity < 1.0 &&
+                             orbit.period > 0.0;
+        if (isValid) {
+            tleData[nValidOrbits] = tleData[i];
+            ++nValidOrbits;
+        }
+    }
+    if (nValidOrbits < tleData.size()) {
+        LWARNING(fmt::format(
+            "Skipped {} orbits that are not closed or have no positive period",
+            tleData.size() - nValidOrbits
+        ));
+        tleData.erase(tleData.begin() + nValidOrbits, tleData.end());
+    }
+
+    // All orbits are propagated to the time at once
+    KeplerPropagator propagator;
+    propagator.reserve(tleData.size());
     for(const auto& orbit : tleData) {
-        KeplerTranslation keplerTranslator;
-        keplerTranslator.setKeplerElements(
+        propagator.addOrbit({
             orbit.eccentricity,
             orbit.semiMajorAxis,
             orbit.inclination,
@@ -406,13 +428,12 @@ std::vector<glm::dvec3> getPositionBuffer(std::vector<KeplerParameters> tleData,
             orbit.meanAnomaly,
             orbit.period,
             orbit.epoch
-        );
-        glm::dvec3 position = keplerTranslator.position({
-            {},
-            Time(timeInSeconds),
-            Time(0.0),
-            false
         });
+    }
+    const std::vector<glm::dvec3> positions = propagator.positions(timeInSeconds);
+
+    std::vector<glm::dvec3> positionBuffer;
+    for(const glm::dvec3& position : positions) {
         // LINFO(fmt::format("cart: {} ", position));
         glm::dvec3 sphPos;
         if( gridType == "Spherical"){
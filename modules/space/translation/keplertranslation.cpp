@@ -24,11 +24,13 @@
 
 #include <modules/space/translation/keplertranslation.h>
 
+#include <modules/space/util/keplerpropagator.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/spicemanager.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/logging/logmanager.h>
 #include <glm/gtx/transform.hpp>
+#include <memory>
 
 namespace {
 
@@ -188,8 +190,11 @@ KeplerTranslation::KeplerTranslation()
     , _epoch(EpochInfo, 0.0, 0.0, 1e9)
     , _period(PeriodInfo, 0.0, 0.0, 1e6)
 {
+    // Trails are sampled in the background through a positionSampler, which copies the
+    // elements, so the properties and the orbit plane are only ever accessed from the
+    // main thread and the orbit plane can be recomputed right away
     auto update = [this]() {
-        _orbitPlaneDirty = true;
+        computeOrbitPlane();
         requireUpdate();
     };
 
@@ -285,11 +290,6 @@ double KeplerTranslation::eccentricAnomaly(double meanAnomaly) const {
 }
 
 glm::dvec3 KeplerTranslation::position(const UpdateData& data) const {
-    if (_orbitPlaneDirty) {
-        computeOrbitPlane();
-        _orbitPlaneDirty = false;
-    }
-
     const double t = data.time.j2000Seconds() -_epoch;
     const double meanMotion = glm::two_pi<double>() / _period;
     const double meanAnomaly = glm::radians(_meanAnomalyAtEpoch.value()) + t * meanMotion;
@@ -304,6 +304,42 @@ glm::dvec3 KeplerTranslation::position(const UpdateData& data) const {
     return _orbitPlaneRotation * p;
 }
 
+std::vector<glm::dvec3> KeplerTranslation::positions(
+                                                   const std::vector<double>& times) const
+{
+    return positionSampler()(times);
+}
+
+Translation::PositionSampler KeplerTranslation::positionSampler() const {
+    if (_eccentricity >= 1.0 || _period <= 0.0) {
+        // The propagator does not accept open orbits or orbits without a period, which
+        // do not have a meaningful trail
+        return [](const std::vector<double>& times) {
+            return std::vector<glm::dvec3>(times.size(), glm::dvec3(0.0));
+        };
+    }
+
+    // The returned function only uses this copy of the elements, so the properties can
+    // be changed on the main thread while it is called from a background job
+    auto propagator = std::make_shared<KeplerPropagator>();
+    propagator->addOrbit({
+        _eccentricity,
+        _semiMajorAxis,
+        _inclination,
+        _ascendingNode,
+        _argumentOfPeriapsis,
+        _meanAnomalyAtEpoch,
+        _period,
+        _epoch
+    });
+
+    return [propagator](const std::vector<double>& times) {
+        std::vector<glm::dvec3> result(times.size());
+        propagator->positions(0, times.data(), times.size(), result.data());
+        return result;
+    };
+}
+
 void KeplerTranslation::computeOrbitPlane() const {
     // We assume the following coordinate system:
     // z = axis of rotation
@@ -329,7 +365,6 @@ void KeplerTranslation::computeOrbitPlane() const {
                           glm::rotate(per, glm::dvec3(argPeriapsisAxisRot));
 
     notifyObservers();
-    _orbitPlaneDirty = false;
 }
 
 void KeplerTranslation::setKeplerElements(double eccentricity, double semiMajorAxis,
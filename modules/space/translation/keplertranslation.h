@@ -70,6 +70,20 @@ public:
     */
     glm::dvec3 position(const UpdateData& data) const override;
 
+    /**
+     * Returns the positions at all provided \p times, which are computed in a single
+     * batch by the KeplerPropagator.
+     *
+     * \param times The times in seconds past the J2000 epoch
+     */
+    std::vector<glm::dvec3> positions(const std::vector<double>& times) const override;
+
+    /**
+     * Returns a function that computes the positions with a KeplerPropagator that holds
+     * a copy of the current Keplerian elements.
+     */
+    PositionSampler positionSampler() const override;
+
     /**
      * Method returning the openspace::Documentation that describes the ghoul::Dictinoary
      * that can be passed to the constructor.
@@ -157,8 +171,6 @@ private:
     /// The period of the orbit in seconds
     properties::DoubleProperty _period;
 
-    /// Dirty flag for the _orbitPlaneRotation parameters
-    mutable bool _orbitPlaneDirty = true;
     /// The rotation matrix that defines the plane of the orbit
     mutable glm::dmat3 _orbitPlaneRotation = glm::dmat3(1.0);
 
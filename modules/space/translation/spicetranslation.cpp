@@ -61,6 +61,14 @@ namespace {
         "This is the SPICE NAIF name for the reference frame in which the position "
         "should be retrieved. The default value is GALACTIC."
     };
+
+    constexpr openspace::properties::Property::PropertyInfo InterpolationToleranceInfo = {
+        "InterpolationTolerance",
+        "Interpolation Tolerance",
+        "If this value is larger than 0, the position is interpolated from previously "
+        "sampled positions instead of being computed by SPICE every time. The value is "
+        "the maximum allowed error of the interpolation in meters."
+    };
 } // namespace
 
 namespace openspace {
@@ -99,6 +107,12 @@ documentation::Documentation SpiceTranslation::Documentation() {
                 Optional::Yes,
                 FrameInfo.description
             },
+            {
+                InterpolationToleranceInfo.identifier,
+                new DoubleGreaterEqualVerifier(0.0),
+                Optional::Yes,
+                InterpolationToleranceInfo.description
+            },
             {
                 KeyKernels,
                 new OrVerifier({ new StringListVerifier, new StringVerifier }),
@@ -115,7 +129,7 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
     : _target(TargetInfo)
     , _observer(ObserverInfo)
     , _frame(FrameInfo, DefaultReferenceFrame)
-    , _cachedFrame(DefaultReferenceFrame)
+    , _interpolationTolerance(InterpolationToleranceInfo, 0.0, 0.0, 1e6)
 {
     documentation::testSpecificationAndThrow(
         Documentation(),
@@ -152,25 +166,29 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
     }
 
     _target.onChange([this]() {
-        _cachedTarget = _target;
+        _cachedTarget = SpiceManager::ref().body(_target);
         requireUpdate();
         notifyObservers();
     });
     addProperty(_target);
 
     _observer.onChange([this]() {
-        _cachedObserver = _observer;
+        _cachedObserver = SpiceManager::ref().body(_observer);
         requireUpdate();
         notifyObservers();
     });
     addProperty(_observer);
 
     _frame.onChange([this]() {
-        _cachedFrame = _frame;
+        _cachedFrame = SpiceManager::ref().frame(_frame);
         requireUpdate();
         notifyObservers();
     });
     addProperty(_frame);
+    _cachedFrame = SpiceManager::ref().frame(_frame);
+
+    _interpolationTolerance.onChange([this]() { requireUpdate(); });
+    addProperty(_interpolationTolerance);
 
     _target = dictionary.value<std::string>(TargetInfo.identifier);
     _observer = dictionary.value<std::string>(ObserverInfo.identifier);
@@ -178,18 +196,56 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
     if (dictionary.hasKey(FrameInfo.identifier)) {
         _frame = dictionary.value<std::string>(FrameInfo.identifier);
     }
+
+    if (dictionary.hasKey(InterpolationToleranceInfo.identifier)) {
+        _interpolationTolerance = dictionary.value<double>(
+            InterpolationToleranceInfo.identifier
+        );
+    }
 }
 
 glm::dvec3 SpiceTranslation::position(const UpdateData& data) const {
     double lightTime = 0.0;
-    return SpiceManager::ref().targetPosition(
+    // SPICE works in kilometers, but we use meters
+    return SpiceManager::ref().interpolatedTargetPosition(
         _cachedTarget,
         _cachedObserver,
         _cachedFrame,
         {},
         data.time.j2000Seconds(),
+        _interpolationTolerance / 1000.0,
         lightTime
     ) * 1000.0;
 }
 
+std::vector<glm::dvec3> SpiceTranslation::positions(
+                                                   const std::vector<double>& times) const
+{
+    return positionSampler()(times);
+}
+
+Translation::PositionSampler SpiceTranslation::positionSampler() const {
+    // The target, observer, and frame are copied so that the returned function is not
+    // affected by changes to the properties while it is called from a background job
+    SpiceManager::PositionBatch batch;
+    batch.target = _cachedTarget;
+    batch.observer = _cachedObserver;
+    batch.referenceFrame = _cachedFrame;
+    batch.tolerance = _interpolationTolerance / 1000.0;
+
+    return [batch](const std::vector<double>& times) {
+        // All positions are computed in a single batch, which only acquires the lock of
+        // the SpiceManager once
+        SpiceManager::PositionBatch b = batch;
+        b.times = times;
+
+        std::vector<glm::dvec3> result = SpiceManager::ref().targetPositions(b);
+        // SPICE works in kilometers, but we use meters
+        for (glm::dvec3& p : result) {
+            p *= 1000.0;
+        }
+        return result;
+    };
+}
+
 } // namespace openspace
@@ -27,7 +27,9 @@
 
 #include <openspace/scene/translation.h>
 
+#include <openspace/properties/scalar/doubleproperty.h>
 #include <openspace/properties/stringproperty.h>
+#include <openspace/util/spicemanager.h>
 
 namespace openspace {
 
@@ -36,6 +38,8 @@ public:
     SpiceTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    std::vector<glm::dvec3> positions(const std::vector<double>& times) const override;
+    PositionSampler positionSampler() const override;
 
     static documentation::Documentation Documentation();
 
@@ -43,14 +47,15 @@ private:
     properties::StringProperty _target;
     properties::StringProperty _observer;
     properties::StringProperty _frame;
+    properties::DoubleProperty _interpolationTolerance;
 
     // We are accessing these values every frame and when retrieving a string from the
-    // StringProperty, it allocates some new memory, which we want to prevent. Until the
-    // property can return a const ref of the string, we keep a local copy as the target,
-    // observer, and frame are not likely to change very often
-    std::string _cachedTarget;
-    std::string _cachedObserver;
-    std::string _cachedFrame;
+    // StringProperty, it allocates some new memory, which we want to prevent. As the
+    // target, observer, and frame are not likely to change very often, we resolve their
+    // NAIF IDs once whenever they change instead of looking up the names every frame
+    SpiceManager::NaifObject _cachedTarget;
+    SpiceManager::NaifObject _cachedObserver;
+    SpiceManager::NaifObject _cachedFrame;
 
     glm::dvec3 _position = glm::dvec3(0.0);
 };
@@ -0,0 +1,256 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/space/util/keplerpropagator.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/util/jobsystem.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+    // The number of positions that are computed together. The intermediate values of a
+    // block are kept in fixed-size arrays on the stack
+    constexpr const size_t BlockSize = 64;
+
+    // The number of positions that are computed by a single job of the JobSystem
+    constexpr const size_t PositionsPerJob = 8192;
+
+    // The Laguerre-Conway iteration converges cubically from Danby's starting value, so
+    // that this number of iterations reaches double precision for all eccentricities
+    constexpr const int SolverIterations = 8;
+} // namespace
+
+namespace openspace {
+
+size_t KeplerPropagator::addOrbit(const Elements& elements) {
+    if (elements.eccentricity < 0.0 || elements.eccentricity >= 1.0) {
+        throw ghoul::RuntimeError(
+            fmt::format("Eccentricity {} is not in [0, 1)", elements.eccentricity),
+            "KeplerPropagator"
+        );
+    }
+    if (elements.period <= 0.0) {
+        throw ghoul::RuntimeError(
+            fmt::format("Period {} is not positive", elements.period),
+            "KeplerPropagator"
+        );
+    }
+
+    _eccentricity.push_back(elements.eccentricity);
+    _semiMajorAxis.push_back(elements.semiMajorAxis * 1000.0);
+    _meanAnomalyAtEpoch.push_back(glm::radians(elements.meanAnomalyAtEpoch));
+    _meanMotion.push_back(glm::two_pi<double>() / elements.period);
+    _epoch.push_back(elements.epoch);
+
+    // These are the first two columns of the rotation matrix that rotates around the z
+    // axis by the ascending node, around the new x axis by the inclination, and around
+    // the new z axis by the argument of periapsis (see KeplerTranslation)
+    const double asc = glm::radians(elements.ascendingNode);
+    const double inc = glm::radians(elements.inclination);
+    const double per = glm::radians(elements.argumentOfPeriapsis);
+    const double cosAsc = std::cos(asc);
+    const double sinAsc = std::sin(asc);
+    const double cosInc = std::cos(inc);
+    const double sinInc = std::sin(inc);
+    const double cosPer = std::cos(per);
+    const double sinPer = std::sin(per);
+
+    _px.push_back(cosAsc * cosPer - sinAsc * cosInc * sinPer);
+    _py.push_back(sinAsc * cosPer + cosAsc * cosInc * sinPer);
+    _pz.push_back(sinInc * sinPer);
+    _qx.push_back(-cosAsc * sinPer - sinAsc * cosInc * cosPer);
+    _qy.push_back(-sinAsc * sinPer + cosAsc * cosInc * cosPer);
+    _qz.push_back(sinInc * cosPer);
+
+    return _eccentricity.size() - 1;
+}
+
+void KeplerPropagator::reserve(size_t nOrbits) {
+    _eccentricity.reserve(nOrbits);
+    _semiMajorAxis.reserve(nOrbits);
+    _meanAnomalyAtEpoch.reserve(nOrbits);
+    _meanMotion.reserve(nOrbits);
+    _epoch.reserve(nOrbits);
+    _px.reserve(nOrbits);
+    _py.reserve(nOrbits);
+    _pz.reserve(nOrbits);
+    _qx.reserve(nOrbits);
+    _qy.reserve(nOrbits);
+    _qz.reserve(nOrbits);
+}
+
+void KeplerPropagator::clear() {
+    _eccentricity.clear();
+    _semiMajorAxis.clear();
+    _meanAnomalyAtEpoch.clear();
+    _meanMotion.clear();
+    _epoch.clear();
+    _px.clear();
+    _py.clear();
+    _pz.clear();
+    _qx.clear();
+    _qy.clear();
+    _qz.clear();
+}
+
+size_t KeplerPropagator::nOrbits() const {
+    return _eccentricity.size();
+}
+
+std::vector<glm::dvec3> KeplerPropagator::positions(double time) const {
+    const size_t n = nOrbits();
+    std::vector<glm::dvec3> result(n);
+
+    const size_t nJobs = (n + PositionsPerJob - 1) / PositionsPerJob;
+    global::jobSystem.parallelFor(
+        nJobs,
+        [this, n, time, &result](size_t job) {
+            const size_t begin = job * PositionsPerJob;
+            const size_t count = std::min(PositionsPerJob, n - begin);
+            computePositions(begin, 1, &time, 0, count, result.data() + begin);
+        }
+    );
+    return result;
+}
+
+void KeplerPropagator::positions(size_t orbit, const double* times, size_t nTimes,
+                                 glm::dvec3* result) const
+{
+    ghoul_precondition(orbit < nOrbits(), "Orbit index out of range");
+    computePositions(orbit, 0, times, 1, nTimes, result);
+}
+
+std::vector<glm::dvec3> KeplerPropagator::sampleOrbits(
+                                             const std::vector<size_t>& nSegments) const
+{
+    ghoul_precondition(nSegments.size() == nOrbits(), "One value per orbit required");
+
+    const size_t n = nOrbits();
+    std::vector<size_t> offsets(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        offsets[i + 1] = offsets[i] + nSegments[i] + 1;
+    }
+    std::vector<glm::dvec3> result(offsets.back());
+
+    // Orbits are distributed between the jobs such that each job computes roughly the
+    // same number of positions
+    std::vector<size_t> jobBegins = { 0 };
+    for (size_t i = 0; i < n; ++i) {
+        if (offsets[i + 1] - offsets[jobBegins.back()] >= PositionsPerJob) {
+            jobBegins.push_back(i + 1);
+        }
+    }
+    if (jobBegins.back() != n) {
+        jobBegins.push_back(n);
+    }
+
+    global::jobSystem.parallelFor(
+        jobBegins.size() - 1,
+        [this, &nSegments, &offsets, &jobBegins, &result](size_t job) {
+            std::vector<double> times;
+            for (size_t i = jobBegins[job]; i < jobBegins[job + 1]; ++i) {
+                const size_t nSamples = nSegments[i] + 1;
+                const double period = glm::two_pi<double>() / _meanMotion[i];
+                const double step = nSegments[i] > 0 ? period / nSegments[i] : 0.0;
+                times.resize(nSamples);
+                for (size_t j = 0; j < nSamples; ++j) {
+                    times[j] = _epoch[i] + step * j;
+                }
+                computePositions(i, 0, times.data(), 1, nSamples, &result[offsets[i]]);
+            }
+        }
+    );
+    return result;
+}
+
+void KeplerPropagator::eccentricAnomalies(const double* meanAnomalies,
+                                          const double* eccentricities, double* result,
+                                          size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        // The position is periodic in the mean anomaly, but the starting value is only
+        // close to the solution for mean anomalies in [-pi, pi]
+        const double m = std::remainder(meanAnomalies[i], glm::two_pi<double>());
+        const double e = eccentricities[i];
+
+        double x = m + 0.85 * e * std::copysign(1.0, std::sin(m));
+        for (int j = 0; j < SolverIterations; ++j) {
+            const double s = e * std::sin(x);
+            const double c = e * std::cos(x);
+            const double f = x - s - m;
+            const double f1 = 1.0 - c;
+            // f1 is positive for all eccentricities < 1, which is why the sign of the
+            // square root does not have to be chosen depending on the sign of f1
+            x -= 5.0 * f / (f1 + std::sqrt(std::abs(16.0 * f1 * f1 - 20.0 * f * s)));
+        }
+        result[i] = x;
+    }
+}
+
+void KeplerPropagator::computePositions(size_t firstOrbit, size_t orbitStride,
+                                        const double* times, size_t timeStride,
+                                        size_t n, glm::dvec3* result) const
+{
+    std::array<double, BlockSize> meanAnomaly;
+    std::array<double, BlockSize> eccentricity;
+    std::array<double, BlockSize> eccentricAnomaly;
+
+    for (size_t begin = 0; begin < n; begin += BlockSize) {
+        const size_t count = std::min(BlockSize, n - begin);
+
+        for (size_t i = 0; i < count; ++i) {
+            const size_t o = firstOrbit + (begin + i) * orbitStride;
+            const double t = times[(begin + i) * timeStride] - _epoch[o];
+            meanAnomaly[i] = _meanAnomalyAtEpoch[o] + t * _meanMotion[o];
+            eccentricity[i] = _eccentricity[o];
+        }
+
+        eccentricAnomalies(
+            meanAnomaly.data(),
+            eccentricity.data(),
+            eccentricAnomaly.data(),
+            count
+        );
+
+        for (size_t i = 0; i < count; ++i) {
+            const size_t o = firstOrbit + (begin + i) * orbitStride;
+            const double e = eccentricity[i];
+            const double a = _semiMajorAxis[o];
+            const double x = a * (std::cos(eccentricAnomaly[i]) - e);
+            const double y = a * std::sin(eccentricAnomaly[i]) * std::sqrt(1.0 - e * e);
+            result[begin + i] = glm::dvec3(
+                _px[o] * x + _qx[o] * y,
+                _py[o] * x + _qy[o] * y,
+                _pz[o] * x + _qz[o] * y
+            );
+        }
+    }
+}
+
+} // namespace openspace
@@ -0,0 +1,148 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
+#define __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
+
+#include <ghoul/glm.h>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The KeplerPropagator computes the positions of a large number of objects that are
+ * described by Keplerian elements, such as the objects of a TLE catalog. Opposed to the
+ * KeplerTranslation, which describes a single orbit through properties, the elements of
+ * all orbits are stored as a structure of arrays and the positions of many orbits (or of
+ * many times on the same orbit) are computed in blocks with a fixed number of iterations
+ * of the eccentric anomaly solver. This avoids data-dependent branches in the inner
+ * loops, which makes them suitable for vectorization by the compiler. Large batches are
+ * split between the threads of the JobSystem.
+ *
+ * All positions are returned in meters in the reference frame in which the elements are
+ * defined, which is the same convention as for the KeplerTranslation.
+ */
+class KeplerPropagator {
+public:
+    struct Elements {
+        /// The eccentricity of the orbit in [0, 1)
+        double eccentricity = 0.0;
+        /// The semi-major axis in km
+        double semiMajorAxis = 0.0;
+        /// The inclination of the orbit in degrees
+        double inclination = 0.0;
+        /// The right ascension of the ascending node in degrees
+        double ascendingNode = 0.0;
+        /// The argument of periapsis in degrees
+        double argumentOfPeriapsis = 0.0;
+        /// The mean anomaly at the epoch in degrees
+        double meanAnomalyAtEpoch = 0.0;
+        /// The period of the orbit in seconds
+        double period = 0.0;
+        /// The epoch in seconds relative to the J2000 epoch
+        double epoch = 0.0;
+    };
+
+    /**
+     * Adds the orbit described by the \p elements and returns its index.
+     *
+     * \throw ghoul::RuntimeError If the eccentricity is not in [0, 1) or the period is
+     *        not positive
+     */
+    size_t addOrbit(const Elements& elements);
+
+    /// Reserves the memory for \p nOrbits orbits
+    void reserve(size_t nOrbits);
+
+    /// Removes all orbits
+    void clear();
+
+    size_t nOrbits() const;
+
+    /**
+     * Returns the positions of all orbits at the provided \p time, which is given in
+     * seconds relative to the J2000 epoch. The result contains one position per orbit in
+     * the order in which the orbits were added.
+     */
+    std::vector<glm::dvec3> positions(double time) const;
+
+    /**
+     * Computes the positions of the \p orbit at the \p nTimes \p times, which are given
+     * in seconds relative to the J2000 epoch, and stores them in \p result.
+     *
+     * \pre \p orbit must be smaller than #nOrbits
+     * \pre \p result must have space for at least \p nTimes positions
+     */
+    void positions(size_t orbit, const double* times, size_t nTimes,
+        glm::dvec3* result) const;
+
+    /**
+     * Samples each orbit over one full period, starting at its epoch. For the orbit
+     * <code>i</code>, <code>nSegments[i] + 1</code> positions are computed, so that the
+     * first and the last position coincide. The positions of all orbits are returned in
+     * a single vector in the order in which the orbits were added.
+     *
+     * \pre \p nSegments must contain one value for every orbit
+     */
+    std::vector<glm::dvec3> sampleOrbits(const std::vector<size_t>& nSegments) const;
+
+    /**
+     * Solves Kepler's equation <code>M = E - e sin(E)</code> for the eccentric anomalies
+     * <code>E</code> of \p n pairs of \p meanAnomalies and \p eccentricities. Every value
+     * is refined with the same, fixed number of Laguerre-Conway iterations, which
+     * converge for all eccentricities in [0, 1).
+     */
+    static void eccentricAnomalies(const double* meanAnomalies,
+        const double* eccentricities, double* result, size_t n);
+
+private:
+    /**
+     * Computes \p n positions and stores them in \p result. The <code>i</code>-th
+     * position belongs to the orbit <code>firstOrbit + i * orbitStride</code> at the time
+     * <code>times[i * timeStride]</code>.
+     */
+    void computePositions(size_t firstOrbit, size_t orbitStride, const double* times,
+        size_t timeStride, size_t n, glm::dvec3* result) const;
+
+    // The elements of all orbits as a structure of arrays. The angles are stored in
+    // radians and the semi-major axis in meters
+    std::vector<double> _eccentricity;
+    std::vector<double> _semiMajorAxis;
+    std::vector<double> _meanAnomalyAtEpoch;
+    std::vector<double> _meanMotion;
+    std::vector<double> _epoch;
+
+    // The unit vectors pointing towards the periapsis (P) and 90 degrees ahead of it in
+    // the direction of motion (Q), which span the plane of the orbit
+    std::vector<double> _px;
+    std::vector<double> _py;
+    std::vector<double> _pz;
+    std::vector<double> _qx;
+    std::vector<double> _qy;
+    std::vector<double> _qz;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
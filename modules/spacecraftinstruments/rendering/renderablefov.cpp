@@ -691,7 +691,10 @@ void RenderableFov::computeIntercepts(const UpdateData& data, const std::string&
         }
     }
     else {
-        // At least one point will intersect
+        // At least one point will intersect. The probes between all boundaries are
+        // collected first, so that the SpiceManager can compute them as one batch
+        std::vector<glm::dvec3> probes;
+        probes.reserve(_instrument.bounds.size() * InterpolationSteps);
         for (size_t i = 0; i < _instrument.bounds.size(); ++i) {
             // Wrap around the array index to 0
             const size_t j = (i == _instrument.bounds.size() - 1) ? 0 : i + 1;
@@ -699,74 +702,63 @@ void RenderableFov::computeIntercepts(const UpdateData& data, const std::string&
             const glm::dvec3& iBound = _instrument.bounds[i];
             const glm::dvec3& jBound = _instrument.bounds[j];
 
-            auto intercepts = [&](const glm::dvec3& probe) -> bool {
-                return SpiceManager::ref().surfaceIntercept(
-                    target,
-                    _instrument.spacecraft,
-                    _instrument.name,
-                    makeBodyFixedReferenceFrame(_instrument.referenceFrame).first,
-                    _instrument.aberrationCorrection,
-                    data.time.j2000Seconds(),
-                    probe
-                ).interceptFound;
-            };
-
-            // Computes the intercept vector between the 'probe' and the target
-            // the intercept vector is in meter and contains a standoff distance offset
-            auto interceptVector = [&](const glm::dvec3& probe) -> glm::dvec3 {
-                auto ref = makeBodyFixedReferenceFrame(_instrument.referenceFrame);
-                SpiceManager::SurfaceInterceptResult r =
-                    SpiceManager::ref().surfaceIntercept(
-                        target,
-                        _instrument.spacecraft,
-                        _instrument.name,
-                        ref.first,
-                        _instrument.aberrationCorrection,
-                        data.time.j2000Seconds(),
-                        probe
-                    );
+            for (size_t m = 0; m < InterpolationSteps; ++m) {
+                const double t = static_cast<double>(m) / (InterpolationSteps);
+                probes.push_back(glm::mix(iBound, jBound, t));
+            }
+        }
 
-                if (ref.second) {
-                    r.surfaceVector = SpiceManager::ref().frameTransformationMatrix(
-                        ref.first,
-                        _instrument.referenceFrame,
-                        data.time.j2000Seconds()
-                    ) * r.surfaceVector;
-                }
+        const std::pair<std::string, bool> ref = makeBodyFixedReferenceFrame(
+            _instrument.referenceFrame
+        );
+        const std::vector<SpiceManager::SurfaceInterceptResult> intercepts =
+            SpiceManager::ref().surfaceIntercepts(
+                target,
+                _instrument.spacecraft,
+                _instrument.name,
+                ref.first,
+                _instrument.aberrationCorrection,
+                data.time.j2000Seconds(),
+                probes
+            );
 
+        // If we had to convert the reference frame into a body-fixed frame, we need to
+        // apply this change to all intercept vectors
+        const glm::dmat3 refTransform = ref.second ?
+            SpiceManager::ref().frameTransformationMatrix(
+                ref.first,
+                _instrument.referenceFrame,
+                data.time.j2000Seconds()
+            ) :
+            glm::dmat3(1.0);
+
+        // The probes are in the same order as the vertices of the orthogonal plane
+        for (size_t k = 0; k < probes.size(); ++k) {
+            if (intercepts[k].interceptFound) {
                 // Convert the KM scale that SPICE uses to meter
                 // Standoff distance, we would otherwise end up *exactly* on the surface
-                return r.surfaceVector * 1000.0 * _standOffDistance.value();
-            };
+                const glm::vec3 icpt = refTransform * intercepts[k].surfaceVector *
+                    1000.0 * _standOffDistance.value();
+                _orthogonalPlane.data[k] = {
+                    { icpt.x, icpt.y, icpt.z },
+                    RenderInformation::VertexColorTypeSquare
+                };
+            }
+            else {
+                const glm::vec3 o = orthogonalProjection(
+                    probes[k],
+                    data.time.j2000Seconds(),
+                    target
+                );
 
-            for (size_t m = 0; m < InterpolationSteps; ++m) {
-                const double t = static_cast<double>(m) / (InterpolationSteps);
-                const glm::dvec3 tBound = glm::mix(iBound, jBound, t);
-
-                if (intercepts(tBound)) {
-                    const glm::vec3 icpt = interceptVector(tBound);
-                    _orthogonalPlane.data[indexForBounds(i) + m] = {
-                        { icpt.x, icpt.y, icpt.z },
-                        RenderInformation::VertexColorTypeSquare
-                    };
-                }
-                else {
-                    const glm::vec3 o = orthogonalProjection(
-                        tBound,
-                        data.time.j2000Seconds(),
-                        target
-                    );
-
-                    _orthogonalPlane.data[indexForBounds(i) + m] = {
-                        { o.x, o.y, o.z },
-                        RenderInformation::VertexColorTypeSquare
-                    };
-                }
+                _orthogonalPlane.data[k] = {
+                    { o.x, o.y, o.z },
+                    RenderInformation::VertexColorTypeSquare
+                };
             }
         }
     }
 
-
 #ifdef DEBUG_THIS
         // At least one point will intersect
         for (size_t i = 0; i < _instrument.bounds.size(); ++i) {
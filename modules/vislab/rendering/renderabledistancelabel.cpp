@@ -100,6 +100,9 @@ RenderableDistanceLabel::RenderableDistanceLabel(const ghoul::Dictionary& dictio
         "RenderableDistanceLabel"
     );
 
+    // Opposed to RenderableLabels, the update reads the state of another renderable
+    _requiresMainThreadUpdate = true;
+
     if (dictionary.hasKey(NodeLineInfo.identifier)) {
         _nodelineId = dictionary.value<std::string>(NodeLineInfo.identifier);
         addProperty(_nodelineId);
@@ -84,6 +84,7 @@ namespace {
     constexpr const char* KeyVersionCheckUrl = "VersionCheckUrl";
     constexpr const char* KeyUseMultithreadedInitialization =
                                                          "UseMultithreadedInitialization";
+    constexpr const char* KeyUseParallelSceneUpdate = "UseParallelSceneUpdate";
     constexpr const char* KeyLoadingScreen = "LoadingScreen";
     constexpr const char* KeyShowMessage = "ShowMessage";
     constexpr const char* KeyShowNodeNames = "ShowNodeNames";
@@ -285,6 +286,7 @@ void parseLuaState(Configuration& configuration) {
     getValue(s, KeyScriptLog, c.scriptLog);
     getValue(s, KeyVersionCheckUrl, c.versionCheckUrl);
     getValue(s, KeyUseMultithreadedInitialization, c.useMultithreadedInitialization);
+    getValue(s, KeyUseParallelSceneUpdate, c.useParallelSceneUpdate);
     getValue(s, KeyCheckOpenGLState, c.isCheckingOpenGLState);
     getValue(s, KeyLogEachOpenGLCall, c.isLoggingOpenGLCalls);
     getValue(s, KeyShutdownCountdown, c.shutdownCountdown);
@@ -393,6 +393,16 @@ documentation::Documentation Configuration::Documentation = {
             "initialize in parallel. The only use for this value is to disable it for "
             "debugging support."
         },
+        {
+            KeyUseParallelSceneUpdate,
+            new BoolVerifier,
+            Optional::Yes,
+            "If this value is enabled, the scene graph nodes are grouped into levels "
+            "based on their parents and dependencies, and the nodes within each level "
+            "are updated in parallel. Translations, rotations, scales, and renderables "
+            "that are not thread-safe are still updated on the main thread. This "
+            "defaults to 'false'."
+        },
         {
             KeyLoadingScreen,
             new TableVerifier({
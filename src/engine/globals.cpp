@@ -50,6 +50,7 @@
 #include <openspace/scene/profile.h>
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/scripting/scriptscheduler.h>
+#include <openspace/util/jobsystem.h>
 #include <openspace/util/memorymanager.h>
 #include <openspace/util/timemanager.h>
 #include <openspace/util/versionchecker.h>
@@ -83,6 +84,12 @@ DownloadManager& gDownloadManager() {
     return g;
 }
 
+JobSystem& gJobSystem() {
+    // The worker threads are only started when the first job is enqueued
+    static JobSystem g;
+    return g;
+}
+
 LuaConsole& gLuaConsole() {
     static LuaConsole g;
     return g;
@@ -719,6 +719,7 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
     }
 
     _scene = std::make_unique<Scene>(std::move(sceneInitializer));
+    _scene->setParallelUpdate(global::configuration.useParallelSceneUpdate);
     global::renderEngine.setScene(_scene.get());
 
     global::rootPropertyOwner.addPropertySubOwner(_scene.get());
@@ -1077,7 +1078,7 @@ void OpenSpaceEngine::preSynchronization() {
         global::profile.setIgnoreUpdates(true);
         loadSingleAsset(_scheduledAssetPathToLoad);
         global::profile.setIgnoreUpdates(false);
-        resetPropertyChangeFlagsOfSubowners(&global::rootPropertyOwner);
+        properties::Property::resetChangedProperties(&global::rootPropertyOwner);
         _hasScheduledAssetLoading = false;
         _scheduledAssetPathToLoad.clear();
     }
@@ -1287,20 +1288,8 @@ void OpenSpaceEngine::postDraw() {
 void OpenSpaceEngine::resetPropertyChangeFlags() {
     ZoneScoped
 
-    std::vector<SceneGraphNode*> nodes =
-            global::renderEngine.scene()->allSceneGraphNodes();
-    for (SceneGraphNode* n : nodes) {
-        resetPropertyChangeFlagsOfSubowners(n);
-    }
-}
-
-void OpenSpaceEngine::resetPropertyChangeFlagsOfSubowners(properties::PropertyOwner* po) {
-    for (properties::PropertyOwner* subOwner : po->propertySubOwners()) {
-        resetPropertyChangeFlagsOfSubowners(subOwner);
-    }
-    for (properties::Property* p : po->properties()) {
-        p->resetToUnchanged();
-    }
+    // Only the properties that have actually changed are visited here
+    properties::Property::resetChangedProperties(global::renderEngine.scene());
 }
 
 void OpenSpaceEngine::keyboardCallback(Key key, KeyModifier mod, KeyAction action) {
@@ -1456,10 +1445,10 @@ std::vector<std::byte> OpenSpaceEngine::encode() {
     return buffer;
 }
 
-void OpenSpaceEngine::decode(std::vector<std::byte> data) {
+void OpenSpaceEngine::decode(const std::vector<std::byte>& data) {
     ZoneScoped
 
-    global::syncEngine.decodeSyncables(std::move(data));
+    global::syncEngine.decodeSyncables(data);
 }
 
 void OpenSpaceEngine::toggleShutdownMode() {
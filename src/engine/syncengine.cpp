@@ -25,9 +25,106 @@
 #include <openspace/engine/syncengine.h>
 
 #include <openspace/util/syncdata.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/profiling.h>
 #include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr const char* _loggerCat = "SyncEngine";
+
+    // Every Syncable in a frame starts with a varint whose lowest two bits contain the
+    // type of the entry and whose remaining bits contain the size of the Syncable's data
+    enum class EntryType {
+        // The data is identical to the previous frame and the Syncable is not decoded
+        Unchanged = 0,
+        // The entry contains the full data
+        Full = 1,
+        // The entry contains a list of pairs of varints, the number of bytes that are
+        // identical to the previous frame followed by the number of bytes that are
+        // different and these bytes
+        Delta = 2
+    };
+
+    // The number of identical bytes after which a range of changed bytes is ended. A
+    // shorter range of identical bytes is cheaper to send as part of the changed bytes
+    constexpr const size_t MinimumUnchangedBytes = 3;
+
+    void appendVarint(std::vector<std::byte>& data, uint64_t value) {
+        while (value >= 0x80) {
+            data.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<std::byte>(value));
+    }
+
+    bool readVarint(const std::byte*& data, const std::byte* end, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && data < end; shift += 7) {
+            const uint64_t byte = static_cast<uint64_t>(*data++);
+            value |= (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Encodes the changes between the `size` bytes of `data` and `previous` as a Delta
+    // entry
+    void encodeDelta(const std::byte* data, const std::byte* previous, size_t size,
+                     std::vector<std::byte>& result)
+    {
+        size_t i = 0;
+        while (i < size) {
+            const size_t unchangedBegin = i;
+            while (i < size && data[i] == previous[i]) {
+                ++i;
+            }
+
+            const size_t changedBegin = i;
+            size_t nUnchanged = 0;
+            while (i < size && nUnchanged < MinimumUnchangedBytes) {
+                nUnchanged = (data[i] == previous[i]) ? nUnchanged + 1 : 0;
+                ++i;
+            }
+            if (nUnchanged == MinimumUnchangedBytes) {
+                // These bytes are the beginning of the next range of unchanged bytes
+                i -= nUnchanged;
+            }
+
+            appendVarint(result, changedBegin - unchangedBegin);
+            appendVarint(result, i - changedBegin);
+            result.insert(result.end(), data + changedBegin, data + i);
+        }
+    }
+
+    // Applies the changes of a Delta entry to the `size` bytes of `previous`
+    bool decodeDelta(const std::byte*& data, const std::byte* end, std::byte* previous,
+                     size_t size)
+    {
+        size_t i = 0;
+        while (i < size) {
+            uint64_t nUnchanged = 0;
+            uint64_t nChanged = 0;
+            if (!readVarint(data, end, nUnchanged) || !readVarint(data, end, nChanged)) {
+                return false;
+            }
+            if (nUnchanged + nChanged > size - i ||
+                nChanged > static_cast<uint64_t>(end - data))
+            {
+                return false;
+            }
+            i += nUnchanged;
+            std::memcpy(previous + i, data, nChanged);
+            data += nChanged;
+            i += nChanged;
+        }
+        return true;
+    }
+} // namespace
 
 namespace openspace {
 
@@ -39,20 +136,109 @@ SyncEngine::SyncEngine(unsigned int syncBufferSize)
 
 // Should be called on sgct master
 std::vector<std::byte> SyncEngine::encodeSyncables() {
-    for (Syncable* syncable : _syncables) {
+    ZoneScoped
+
+    const bool isKeyframe = (_nFramesSinceKeyframe == 0);
+    _nFramesSinceKeyframe = (_nFramesSinceKeyframe + 1) % KeyframeInterval;
+    _previousData.resize(_syncables.size());
+
+    // The frame is moved to the caller, so it is not copied on its way to the network
+    std::vector<std::byte> frame;
+    frame.reserve(_previousFrameSize);
+    appendVarint(frame, _syncables.size());
+
+    for (size_t i = 0; i < _syncables.size(); ++i) {
+        Syncable* syncable = _syncables[i];
         syncable->encode(&_syncBuffer);
+        const std::byte* data = _syncBuffer.encodedData();
+        const size_t size = _syncBuffer.encodedSize();
+        std::vector<std::byte>& previous = _previousData[i];
+
+        const bool hasPrevious = !isKeyframe && previous.size() == size;
+        if (hasPrevious && syncable->canSkipUnchangedData() &&
+            std::equal(data, data + size, previous.begin()))
+        {
+            appendVarint(frame, static_cast<uint64_t>(EntryType::Unchanged));
+            _syncBuffer.reset();
+            continue;
+        }
+
+        _delta.clear();
+        if (hasPrevious) {
+            encodeDelta(data, previous.data(), size, _delta);
+        }
+
+        if (hasPrevious && _delta.size() < size) {
+            appendVarint(frame, (size << 2) | static_cast<uint64_t>(EntryType::Delta));
+            frame.insert(frame.end(), _delta.begin(), _delta.end());
+        }
+        else {
+            appendVarint(frame, (size << 2) | static_cast<uint64_t>(EntryType::Full));
+            frame.insert(frame.end(), data, data + size);
+        }
+        previous.assign(data, data + size);
+        _syncBuffer.reset();
     }
 
-    std::vector<std::byte> data = _syncBuffer.data();
-    _syncBuffer.reset();
-    return data;
+    _previousFrameSize = frame.size();
+    return frame;
 }
 
 // Should be called on sgct slaves
-void SyncEngine::decodeSyncables(std::vector<std::byte> data) {
-    _syncBuffer.setData(std::move(data));
-    for (Syncable* syncable : _syncables) {
-        syncable->decode(&_syncBuffer);
+void SyncEngine::decodeSyncables(const std::vector<std::byte>& data) {
+    ZoneScoped
+
+    const std::byte* it = data.data();
+    const std::byte* end = data.data() + data.size();
+
+    uint64_t nSyncables = 0;
+    if (!readVarint(it, end, nSyncables) || nSyncables != _syncables.size()) {
+        LERROR(fmt::format(
+            "Received data for {} Syncables, but {} are registered",
+            nSyncables, _syncables.size()
+        ));
+        return;
+    }
+    _previousData.resize(_syncables.size());
+
+    for (size_t i = 0; i < _syncables.size(); ++i) {
+        uint64_t header = 0;
+        if (!readVarint(it, end, header)) {
+            LERROR("Received incomplete synchronization data");
+            _previousData.clear();
+            break;
+        }
+        const EntryType type = static_cast<EntryType>(header & 0b11);
+        const size_t size = static_cast<size_t>(header >> 2);
+        std::vector<std::byte>& previous = _previousData[i];
+
+        if (type == EntryType::Unchanged) {
+            continue;
+        }
+        else if (type == EntryType::Full && size <= static_cast<size_t>(end - it)) {
+            // The Syncable decodes directly from the received data. The copy is only
+            // kept as the reference for the changes in the next frames
+            _syncBuffer.setData(it, size);
+            previous.assign(it, it + size);
+            it += size;
+        }
+        else if (type == EntryType::Delta && previous.size() == size &&
+                 decodeDelta(it, end, previous.data(), size))
+        {
+            _syncBuffer.setData(previous.data(), previous.size());
+        }
+        else {
+            // Without the correct data of the previous frame, none of the following
+            // changes can be applied until the next keyframe
+            LERROR(fmt::format(
+                "Could not decode the data of Syncable {}. Waiting for the next keyframe",
+                i
+            ));
+            _previousData.clear();
+            break;
+        }
+
+        _syncables[i]->decode(&_syncBuffer);
     }
 
     _syncBuffer.reset();
@@ -78,6 +264,11 @@ void SyncEngine::addSyncable(Syncable* syncable) {
     ghoul_assert(syncable, "Syncable must not be nullptr");
 
     _syncables.push_back(syncable);
+
+    // The next frame is a keyframe, as the data of the previous frame no longer matches
+    // the order of the Syncables
+    _previousData.clear();
+    _nFramesSinceKeyframe = 0;
 }
 
 void SyncEngine::addSyncables(const std::vector<Syncable*>& syncables) {
@@ -92,6 +283,9 @@ void SyncEngine::removeSyncable(Syncable* syncable) {
         std::remove(_syncables.begin(), _syncables.end(), syncable),
         _syncables.end()
     );
+
+    _previousData.clear();
+    _nFramesSinceKeyframe = 0;
 }
 
 void SyncEngine::removeSyncables(const std::vector<Syncable*>& syncables) {
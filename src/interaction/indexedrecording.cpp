@@ -0,0 +1,528 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/interaction/indexedrecording.h>
+
+#include <openspace/network/messagestructures.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+
+namespace {
+    using Entry = openspace::interaction::IndexedRecording::Entry;
+    using Footer = openspace::interaction::IndexedRecording::Footer;
+
+    // The header that is shared with the version 1 formats consists of the title, the
+    // version, the data format tag and a newline
+    const std::string FileHeaderTitle = "OpenSpace_record/playback";
+    constexpr const size_t FileHeaderVersionLength = 5;
+    constexpr const char FileHeaderVersion[FileHeaderVersionLength] = {
+        '0', '2', '.', '0', '0'
+    };
+    constexpr const char DataFormatAsciiTag = 'A';
+    constexpr const char DataFormatBinaryTag = 'B';
+
+    static_assert(std::is_trivially_copyable_v<Entry>);
+    static_assert(sizeof(Entry) == 104, "The size of an entry is part of the format");
+    static_assert(sizeof(Footer) == 56, "The size of the footer is part of the format");
+
+    template <typename T>
+    T readValue(std::istream& stream) {
+        T value;
+        stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void writeValue(std::ostream& stream, const T& value) {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeStringTable(std::ostream& stream, const std::vector<std::string>& table) {
+        for (const std::string& s : table) {
+            writeValue(stream, static_cast<uint32_t>(s.size()));
+            stream.write(s.data(), s.size());
+        }
+    }
+
+    void convertBinaryEntries(std::istream& file,
+                              openspace::interaction::IndexedRecording::Builder& builder)
+    {
+        using namespace openspace::datamessagestructures;
+
+        while (true) {
+            const unsigned char type = readValue<unsigned char>(file);
+            if (!file) {
+                // We have reached the end of the file
+                return;
+            }
+            const double timeOs = readValue<double>(file);
+            const double timeRec = readValue<double>(file);
+            const double timeSim = readValue<double>(file);
+
+            if (type == 'c') {
+                CameraKeyframe kf;
+                kf.read(&file);
+                builder.addCamera(
+                    kf._timestamp,
+                    timeRec,
+                    timeSim,
+                    kf._position,
+                    kf._rotation,
+                    kf._scale,
+                    kf._followNodeRotation,
+                    kf._focusNode
+                );
+            }
+            else if (type == 't') {
+                const double dt = readValue<double>(file);
+                const bool paused = readValue<unsigned char>(file) != 0;
+                const bool jump = readValue<unsigned char>(file) != 0;
+                builder.addTime(timeOs, timeRec, timeSim, dt, paused, jump);
+            }
+            else if (type == 's') {
+                const size_t length = readValue<size_t>(file);
+                std::string script(length, '\0');
+                file.read(script.data(), length);
+                builder.addScript(timeOs, timeRec, timeSim, std::move(script));
+            }
+            else {
+                throw ghoul::RuntimeError(
+                    fmt::format("Unknown frame type {}", type),
+                    "IndexedRecording"
+                );
+            }
+
+            if (!file) {
+                throw ghoul::RuntimeError("Truncated keyframe entry", "IndexedRecording");
+            }
+        }
+    }
+
+    void convertAsciiEntries(std::istream& file,
+                             openspace::interaction::IndexedRecording::Builder& builder)
+    {
+        std::string line;
+        int lineNumber = 1;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            // The version 1 ASCII files were written in text mode
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+
+            std::istringstream iss(line);
+            std::string type;
+            double timeOs;
+            double timeRec;
+            double timeSim;
+            if (!(iss >> type >> timeOs >> timeRec >> timeSim)) {
+                throw ghoul::RuntimeError(
+                    fmt::format("Error parsing line {}", lineNumber),
+                    "IndexedRecording"
+                );
+            }
+
+            if (type == "camera") {
+                glm::dvec3 position;
+                glm::dquat rotation;
+                float scale;
+                std::string rotationFollowing;
+                std::string focusNode;
+                iss >> position.x >> position.y >> position.z
+                    >> rotation.x >> rotation.y >> rotation.z >> rotation.w
+                    >> scale >> rotationFollowing >> focusNode;
+                if (iss.fail() || !iss.eof()) {
+                    throw ghoul::RuntimeError(
+                        fmt::format("Error parsing camera line {}", lineNumber),
+                        "IndexedRecording"
+                    );
+                }
+                builder.addCamera(
+                    timeOs,
+                    timeRec,
+                    timeSim,
+                    position,
+                    rotation,
+                    scale,
+                    rotationFollowing == "F",
+                    focusNode
+                );
+            }
+            else if (type == "time") {
+                double dt;
+                std::string paused;
+                std::string jump;
+                iss >> dt >> paused >> jump;
+                if (iss.fail() || !iss.eof()) {
+                    throw ghoul::RuntimeError(
+                        fmt::format("Error parsing time line {}", lineNumber),
+                        "IndexedRecording"
+                    );
+                }
+                builder.addTime(timeOs, timeRec, timeSim, dt, paused == "P", jump == "J");
+            }
+            else if (type == "script") {
+                unsigned int nLines;
+                std::string script;
+                iss >> nLines;
+                std::getline(iss, script);
+                if (iss.fail()) {
+                    throw ghoul::RuntimeError(
+                        fmt::format("Error parsing script line {}", lineNumber),
+                        "IndexedRecording"
+                    );
+                }
+                // The version 1 ASCII format separates the number of lines and the
+                // script with a space that is not part of the script itself
+                if (!script.empty() && script.front() == ' ') {
+                    script.erase(0, 1);
+                }
+                for (unsigned int i = 1; i < nLines; ++i) {
+                    std::string scriptLine;
+                    std::getline(file, scriptLine);
+                    if (!scriptLine.empty() && scriptLine.back() == '\r') {
+                        scriptLine.pop_back();
+                    }
+                    script += '\n' + scriptLine;
+                    lineNumber++;
+                }
+                builder.addScript(timeOs, timeRec, timeSim, std::move(script));
+            }
+            else {
+                throw ghoul::RuntimeError(
+                    fmt::format("Unknown frame type {} in line {}", type, lineNumber),
+                    "IndexedRecording"
+                );
+            }
+        }
+    }
+} // namespace
+
+namespace openspace::interaction {
+
+void IndexedRecording::Builder::addCamera(double timeOs, double timeRec, double timeSim,
+                                          const glm::dvec3& position,
+                                          const glm::dquat& rotation, float scale,
+                                          bool followNodeRotation,
+                                          const std::string& focusNode)
+{
+    auto it = _nodeNameIndices.find(focusNode);
+    if (it == _nodeNameIndices.end()) {
+        const uint32_t index = static_cast<uint32_t>(_nodeNames.size());
+        _nodeNames.push_back(focusNode);
+        it = _nodeNameIndices.emplace(focusNode, index).first;
+    }
+
+    Entry e;
+    e.type = EntryType::Camera;
+    e.timeOs = timeOs;
+    e.timeRec = timeRec;
+    e.timeSim = timeSim;
+    e.position[0] = position.x;
+    e.position[1] = position.y;
+    e.position[2] = position.z;
+    e.rotation[0] = rotation.x;
+    e.rotation[1] = rotation.y;
+    e.rotation[2] = rotation.z;
+    e.rotation[3] = rotation.w;
+    e.scale = scale;
+    e.followNodeRotation = followNodeRotation;
+    e.index = it->second;
+    _entries.push_back(e);
+}
+
+void IndexedRecording::Builder::addTime(double timeOs, double timeRec, double timeSim,
+                                        double deltaTime, bool paused,
+                                        bool requiresTimeJump)
+{
+    Entry e;
+    e.type = EntryType::Time;
+    e.timeOs = timeOs;
+    e.timeRec = timeRec;
+    e.timeSim = timeSim;
+    e.deltaTime = deltaTime;
+    e.paused = paused;
+    e.requiresTimeJump = requiresTimeJump;
+    _entries.push_back(e);
+}
+
+void IndexedRecording::Builder::addScript(double timeOs, double timeRec, double timeSim,
+                                          std::string script)
+{
+    Entry e;
+    e.type = EntryType::Script;
+    e.timeOs = timeOs;
+    e.timeRec = timeRec;
+    e.timeSim = timeSim;
+    e.index = static_cast<uint32_t>(_scripts.size());
+    _scripts.push_back(std::move(script));
+    _entries.push_back(e);
+}
+
+void IndexedRecording::Builder::save(const std::string& path) {
+    // The stable sort keeps the order of keyframes that were recorded at the same time
+    std::stable_sort(
+        _entries.begin(),
+        _entries.end(),
+        [](const Entry& lhs, const Entry& rhs) { return lhs.timeRec < rhs.timeRec; }
+    );
+
+    std::ofstream file(path, std::ofstream::binary);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Unable to open file {} for writing", path),
+            "IndexedRecording"
+        );
+    }
+
+    file << FileHeaderTitle;
+    file.write(FileHeaderVersion, FileHeaderVersionLength);
+    file << DataFormatTag << '\n';
+
+    Footer footer;
+    footer.entryTableOffset = static_cast<uint64_t>(file.tellp());
+    footer.nEntries = _entries.size();
+    file.write(
+        reinterpret_cast<const char*>(_entries.data()),
+        _entries.size() * sizeof(Entry)
+    );
+
+    footer.nodeNameTableOffset = static_cast<uint64_t>(file.tellp());
+    footer.nNodeNames = _nodeNames.size();
+    writeStringTable(file, _nodeNames);
+
+    footer.scriptTableOffset = static_cast<uint64_t>(file.tellp());
+    footer.nScripts = _scripts.size();
+    writeStringTable(file, _scripts);
+
+    writeValue(file, footer);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Error writing file {}", path),
+            "IndexedRecording"
+        );
+    }
+}
+
+IndexedRecording::IndexedRecording(const std::string& path)
+    : _file(path, MemoryMappedFile::AccessPattern::Random)
+{
+    if (!_file.isOpen()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Unable to open file {}", path),
+            "IndexedRecording"
+        );
+    }
+
+    const size_t headerSize = FileHeaderTitle.size() + FileHeaderVersionLength + 2;
+    if (_file.size() < headerSize + sizeof(Footer) ||
+        std::string_view(_file.data(), FileHeaderTitle.size()) != FileHeaderTitle ||
+        _file.data()[headerSize - 2] != DataFormatTag)
+    {
+        throw ghoul::RuntimeError(
+            fmt::format("File {} is not a version 2 session recording", path),
+            "IndexedRecording"
+        );
+    }
+
+    std::memcpy(&_footer, _file.data() + _file.size() - sizeof(Footer), sizeof(Footer));
+    const uint64_t tablesEnd = _file.size() - sizeof(Footer);
+    const bool isValid =
+        std::memcmp(_footer.magic, Footer().magic, sizeof(Footer::magic)) == 0 &&
+        _footer.entryTableOffset >= headerSize &&
+        _footer.entryTableOffset <= tablesEnd &&
+        _footer.nEntries <= (tablesEnd - _footer.entryTableOffset) / sizeof(Entry) &&
+        _footer.nodeNameTableOffset ==
+            _footer.entryTableOffset + _footer.nEntries * sizeof(Entry) &&
+        _footer.scriptTableOffset >= _footer.nodeNameTableOffset &&
+        _footer.scriptTableOffset <= tablesEnd &&
+        // Every node name and every script is referenced by at least one entry
+        _footer.nNodeNames <= _footer.nEntries &&
+        _footer.nScripts <= _footer.nEntries;
+    if (!isValid) {
+        throw ghoul::RuntimeError(
+            fmt::format("The index of session recording {} is corrupted", path),
+            "IndexedRecording"
+        );
+    }
+
+    _nodeNames = readStringTable(_footer.nodeNameTableOffset, _footer.nNodeNames);
+    _scripts = readStringTable(_footer.scriptTableOffset, _footer.nScripts);
+}
+
+std::vector<std::string_view> IndexedRecording::readStringTable(uint64_t offset,
+                                                                uint64_t count) const
+{
+    const uint64_t tablesEnd = _file.size() - sizeof(Footer);
+
+    // Every string takes up at least the bytes of its length, which bounds the number of
+    // strings before any memory is reserved for them
+    if (offset > tablesEnd || count > (tablesEnd - offset) / sizeof(uint32_t)) {
+        throw ghoul::RuntimeError("Truncated string table", "IndexedRecording");
+    }
+
+    std::vector<std::string_view> result;
+    result.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        uint32_t length;
+        if (offset + sizeof(length) > tablesEnd) {
+            throw ghoul::RuntimeError("Truncated string table", "IndexedRecording");
+        }
+        std::memcpy(&length, _file.data() + offset, sizeof(length));
+        offset += sizeof(length);
+        if (offset + length > tablesEnd) {
+            throw ghoul::RuntimeError("Truncated string table", "IndexedRecording");
+        }
+        result.emplace_back(_file.data() + offset, length);
+        offset += length;
+    }
+    return result;
+}
+
+size_t IndexedRecording::nEntries() const {
+    return static_cast<size_t>(_footer.nEntries);
+}
+
+size_t IndexedRecording::nNodeNames() const {
+    return _nodeNames.size();
+}
+
+size_t IndexedRecording::nScripts() const {
+    return _scripts.size();
+}
+
+IndexedRecording::Entry IndexedRecording::entry(size_t index) const {
+    ghoul_assert(index < nEntries(), "Index out of range");
+
+    // The entries are copied as the mapped file does not guarantee their alignment
+    Entry e;
+    std::memcpy(
+        &e,
+        _file.data() + _footer.entryTableOffset + index * sizeof(Entry),
+        sizeof(Entry)
+    );
+
+    const bool hasValidIndex =
+        (e.type == EntryType::Camera && e.index < _nodeNames.size()) ||
+        (e.type == EntryType::Script && e.index < _scripts.size()) ||
+        e.type == EntryType::Time;
+    if (!hasValidIndex) {
+        throw ghoul::RuntimeError(
+            fmt::format("Invalid session recording entry {}", index),
+            "IndexedRecording"
+        );
+    }
+    return e;
+}
+
+double IndexedRecording::recordedTime(size_t index) const {
+    ghoul_assert(index < nEntries(), "Index out of range");
+
+    double time;
+    std::memcpy(
+        &time,
+        _file.data() + _footer.entryTableOffset + index * sizeof(Entry) +
+            offsetof(Entry, timeRec),
+        sizeof(double)
+    );
+    return time;
+}
+
+std::string_view IndexedRecording::nodeName(uint32_t index) const {
+    ghoul_assert(index < _nodeNames.size(), "Index out of range");
+    return _nodeNames[index];
+}
+
+std::string_view IndexedRecording::script(uint32_t index) const {
+    ghoul_assert(index < _scripts.size(), "Index out of range");
+    return _scripts[index];
+}
+
+size_t IndexedRecording::findEntry(double time) const {
+    size_t first = 0;
+    size_t count = nEntries();
+    while (count > 0) {
+        const size_t step = count / 2;
+        if (recordedTime(first + step) <= time) {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+void IndexedRecording::convert(const std::string& source,
+                               const std::string& destination)
+{
+    std::ifstream file(source, std::ifstream::binary);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Unable to open file {}", source),
+            "IndexedRecording"
+        );
+    }
+
+    std::string title(FileHeaderTitle.size(), '\0');
+    file.read(title.data(), title.size());
+    std::string version(FileHeaderVersionLength, '\0');
+    file.read(version.data(), version.size());
+    const char tag = readValue<char>(file);
+    // The rest of the line is empty, apart from a carriage return in ASCII files that
+    // were written on Windows
+    std::string rest;
+    std::getline(file, rest);
+    if (!file || title != FileHeaderTitle || !(rest.empty() || rest == "\r")) {
+        throw ghoul::RuntimeError(
+            fmt::format("File {} does not contain a session recording header", source),
+            "IndexedRecording"
+        );
+    }
+
+    Builder builder;
+    if (tag == DataFormatBinaryTag) {
+        convertBinaryEntries(file, builder);
+    }
+    else if (tag == DataFormatAsciiTag) {
+        convertAsciiEntries(file, builder);
+    }
+    else {
+        throw ghoul::RuntimeError(
+            fmt::format("Unsupported data format {} in file {}", tag, source),
+            "IndexedRecording"
+        );
+    }
+    builder.save(destination);
+}
+
+} // namespace openspace::interaction
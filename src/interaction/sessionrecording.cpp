@@ -26,6 +26,7 @@
 
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
+#include <openspace/interaction/indexedrecording.h>
 #include <openspace/interaction/keyframenavigator.h>
 #include <openspace/interaction/navigationhandler.h>
 #include <openspace/interaction/orbitalnavigator.h>
@@ -42,7 +43,10 @@
 #include <ghoul/font/fontmanager.h>
 #include <ghoul/font/fontrenderer.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/misc/profiling.h>
+#include <algorithm>
 #include <iomanip>
 
 namespace {
@@ -55,6 +59,15 @@ namespace {
         "recording is rendering to screen"
     };
 
+    constexpr openspace::properties::Property::PropertyInfo SkipUnchangedInfo = {
+        "SkipUnchangedCameraKeyframes",
+        "Skip Unchanged Camera Keyframes",
+        "If enabled, camera keyframes are not recorded while the camera does not move. "
+        "The last keyframe before the camera moves again is still recorded, so the "
+        "playback of the recording is unchanged, but recordings with long pauses become "
+        "considerably smaller"
+    };
+
     constexpr const bool UsingTimeKeyframes = false;
     const std::string FileHeaderTitle = "OpenSpace_record/playback";
     constexpr const size_t FileHeaderVersionLength = 5;
@@ -96,6 +109,14 @@ namespace {
         return temp.data();
     }
 
+    bool isSameCameraPose(const openspace::datamessagestructures::CameraKeyframe& lhs,
+                          const openspace::datamessagestructures::CameraKeyframe& rhs)
+    {
+        return lhs._position == rhs._position && lhs._rotation == rhs._rotation &&
+            lhs._scale == rhs._scale && lhs._focusNode == rhs._focusNode &&
+            lhs._followNodeRotation == rhs._followNodeRotation;
+    }
+
     std::string readHeaderElement(std::ifstream& stream, size_t readLen_chars) {
         std::vector<char> readTemp(readLen_chars);
         stream.read(&readTemp[0], readLen_chars);
@@ -111,8 +132,10 @@ namespace openspace::interaction {
 SessionRecording::SessionRecording()
     : properties::PropertyOwner({ "SessionRecording", "Session Recording" })
     , _renderPlaybackInformation(RenderPlaybackInfo, false)
+    , _skipUnchangedCameraKeyframes(SkipUnchangedInfo, false)
 {
     addProperty(_renderPlaybackInformation);
+    addProperty(_skipUnchangedCameraKeyframes);
 }
 
 SessionRecording::~SessionRecording() {} // NOLINT
@@ -158,28 +181,28 @@ bool SessionRecording::startRecording(const std::string& filename) {
     _playbackActive_camera = false;
     _playbackActive_time = false;
     _playbackActive_script = false;
-    if (_recordingDataMode == RecordedDataMode::Binary) {
-        _recordFile.open(absFilename, std::ios::binary);
-    }
-    else {
-        _recordFile.open(absFilename);
-    }
-
-    if (!_recordFile.is_open() || !_recordFile.good()) {
+    _hasSavedCameraKeyframe = false;
+    _hasSkippedCameraKeyframe = false;
+    const bool isOpen = _recordFile.open(
+        absFilename,
+        AsyncFileWriter::Binary(_recordingDataMode == RecordedDataMode::Binary)
+    );
+    if (!isOpen) {
         LERROR(fmt::format(
             "Unable to open file {} for keyframe recording", absFilename.c_str()
         ));
         return false;
     }
-    _recordFile << FileHeaderTitle;
-    _recordFile.write(FileHeaderVersion, FileHeaderVersionLength);
+    std::string header = FileHeaderTitle;
+    header.append(FileHeaderVersion, FileHeaderVersionLength);
     if (_recordingDataMode == RecordedDataMode::Binary) {
-        _recordFile << DataFormatBinaryTag;
+        header += DataFormatBinaryTag;
     }
     else {
-        _recordFile << DataFormatAsciiTag;
+        header += DataFormatAsciiTag;
     }
-    _recordFile << '\n';
+    header += '\n';
+    _recordFile.write(header.data(), header.size());
 
     LINFO("Session recording started");
     _timestampRecordStarted = global::windowDelegate.applicationTime();
@@ -188,11 +211,32 @@ bool SessionRecording::startRecording(const std::string& filename) {
 
 void SessionRecording::stopRecording() {
     if (_state == SessionState::Recording) {
+        if (_hasSkippedCameraKeyframe) {
+            // The recording has to end with the current camera pose
+            saveCameraKeyframeToFile(
+                _skippedCameraKeyframe,
+                _skippedCameraKeyframeSimulationTime
+            );
+            _hasSkippedCameraKeyframe = false;
+        }
         _state = SessionState::Idle;
         LINFO("Session recording stopped");
     }
-    // Close the recording file
-    _recordFile.close();
+
+    if (!_recordFile.isOpen()) {
+        return;
+    }
+    // Close the recording file, which waits until all keyframes have been written
+    if (!_recordFile.close()) {
+        LERROR("Error writing the session recording file");
+    }
+    if (_recordFile.nDroppedWrites() > 0 || _recordFile.nBlockedWrites() > 0) {
+        LWARNING(fmt::format(
+            "Writing the session recording could not keep up. {} camera keyframes were "
+            "dropped and {} keyframes had to wait",
+            _recordFile.nDroppedWrites(), _recordFile.nBlockedWrites()
+        ));
+    }
 }
 
 bool SessionRecording::startPlayback(const std::string& filename,
@@ -236,12 +280,16 @@ bool SessionRecording::startPlayback(const std::string& filename,
     }
     readHeaderElement(_playbackFile, FileHeaderVersionLength);
     std::string readDataMode = readHeaderElement(_playbackFile, 1);
+    _isPlaybackIndexed = false;
     if (readDataMode[0] == DataFormatAsciiTag) {
         _recordingDataMode = RecordedDataMode::Ascii;
     }
     else if (readDataMode[0] == DataFormatBinaryTag) {
         _recordingDataMode = RecordedDataMode::Binary;
     }
+    else if (readDataMode[0] == IndexedRecording::DataFormatTag) {
+        _isPlaybackIndexed = true;
+    }
     else {
         LERROR("Unknown data type in header (should be Ascii or Binary)");
         cleanUpPlayback();
@@ -347,6 +395,137 @@ void SessionRecording::signalPlaybackFinishedForComponent(RecordedType type) {
     }
 }
 
+bool SessionRecording::seekPlayback(double recordedTime) {
+    if (_state != SessionState::Playback) {
+        LERROR("Unable to seek while no session playback is in progress");
+        return false;
+    }
+    if (_playbackTimeReferenceMode != KeyframeTimeRef::Relative_recordedStart) {
+        LERROR("Seeking is only possible in playbacks relative to the recorded time");
+        return false;
+    }
+    if (_timeline.empty()) {
+        return false;
+    }
+
+    recordedTime = std::clamp(recordedTime, 0.0, _timeline.back().timestamp);
+    if (isSavingFramesDuringPlayback()) {
+        _saveRenderingCurrentRecordedTime = recordedTime;
+    }
+    else {
+        _timestampPlaybackStarted_application =
+            global::windowDelegate.applicationTime() - recordedTime;
+        global::navigationHandler.keyframeNavigator().setTimeReferenceMode(
+            _playbackTimeReferenceMode,
+            _timestampPlaybackStarted_application
+        );
+    }
+
+    const SeekPosition position = findSeekPosition(_timeline, recordedTime);
+
+    // Scripts that lie between the previous and the new time are skipped. When seeking
+    // to the end, the index points past the last entry, which must not be replayed, and
+    // the playback of the non-camera keyframes is finished
+    _idxTimeline_nonCamera = position.next;
+    const bool hasNextEntry = position.next < _timeline.size();
+    _playbackActive_script = hasNextEntry;
+    if (UsingTimeKeyframes) {
+        _playbackActive_time = hasNextEntry;
+    }
+
+    // The next camera keyframe is found by the regular playback in
+    // findNextFutureCameraIndex. If the camera playback had already finished, seeking
+    // back in front of the last camera keyframe starts it again
+    _idxTimeline_cameraPtrPrev = position.camera;
+    _idxTimeline_cameraPtrNext = position.camera;
+    _hasHitEndOfCameraKeyframes = false;
+    if (position.hasRemainingCameraEntries) {
+        _playbackActive_camera = true;
+    }
+
+    // The keyframes only interpolate the simulation time between neighboring keyframes,
+    // so the jump to the new position has to be made explicitly
+    global::timeManager.setTimeNextFrame(Time(position.simulationTime));
+    return true;
+}
+
+SessionRecording::SeekPosition SessionRecording::findSeekPosition(
+                         const std::vector<timelineEntry>& timeline, double recordedTime)
+{
+    ghoul_assert(!timeline.empty(), "Timeline must not be empty");
+
+    SeekPosition position;
+
+    // The first entry of the timeline that lies after the requested time
+    const auto it = std::upper_bound(
+        timeline.begin(),
+        timeline.end(),
+        recordedTime,
+        [](double time, const timelineEntry& entry) { return time < entry.timestamp; }
+    );
+    position.next = static_cast<unsigned int>(it - timeline.begin());
+    position.simulationTime = timeline[position.next > 0 ? position.next - 1 : 0].timeSim;
+
+    auto isCamera = [&timeline](size_t i) {
+        return timeline[i].keyframeType == RecordedType::Camera;
+    };
+
+    // The camera keyframe preceding the new time is usually at most a few non-camera
+    // entries in front of the entry that was found
+    bool hasPreviousCamera = false;
+    for (unsigned int i = position.next; i > 0; --i) {
+        if (isCamera(i - 1)) {
+            position.camera = i - 1;
+            hasPreviousCamera = true;
+            break;
+        }
+    }
+    for (size_t i = position.next; i < timeline.size(); ++i) {
+        if (isCamera(i)) {
+            if (!hasPreviousCamera) {
+                position.camera = static_cast<unsigned int>(i);
+            }
+            position.hasRemainingCameraEntries = true;
+            break;
+        }
+    }
+    return position;
+}
+
+bool SessionRecording::convertToIndexedFormat(const std::string& source,
+                                              const std::string& destination) const
+{
+    if (source.find("/") != std::string::npos ||
+        destination.find("/") != std::string::npos)
+    {
+        LERROR("Conversion filenames must not contain path (/) elements");
+        return false;
+    }
+    const std::string absSource = absPath("${RECORDINGS}/" + source);
+    const std::string absDestination = absPath("${RECORDINGS}/" + destination);
+
+    if (!FileSys.fileExists(absSource)) {
+        LERROR(fmt::format("Cannot find the recording {}", absSource));
+        return false;
+    }
+    if (FileSys.fileExists(absDestination)) {
+        LERROR(fmt::format(
+            "Unable to convert recording; file {} already exists", absDestination
+        ));
+        return false;
+    }
+
+    try {
+        IndexedRecording::convert(absSource, absDestination);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Unable to convert recording {}: {}", absSource, e.message));
+        return false;
+    }
+    LINFO(fmt::format("Converted recording {} to {}", absSource, absDestination));
+    return true;
+}
+
 void SessionRecording::enableTakeScreenShotDuringPlayback(int fps) {
     _saveRenderingDuringPlayback = true;
     _saveRenderingDeltaTime = 1.0 / fps;
@@ -380,6 +559,7 @@ void SessionRecording::cleanUpPlayback() {
     global::scriptScheduler.stopPlayback();
 
     _playbackFile.close();
+    _isPlaybackIndexed = false;
 
     // Clear all timelines and keyframes
     _timeline.clear();
@@ -431,7 +611,7 @@ void SessionRecording::saveStringToFile(const std::string& s) {
     _bufferIndex += static_cast<unsigned int>(writeSize_bytes);
     saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex);
 
-    _recordFile.write(s.c_str(), s.size());
+    _recordFile.write(s.data(), s.size());
 }
 
 bool SessionRecording::hasCameraChangedFromPrev(
@@ -467,6 +647,40 @@ void SessionRecording::saveCameraKeyframe() {
     // Create a camera keyframe, then call to populate it with current position
     // & orientation of camera
     datamessagestructures::CameraKeyframe kf = _externInteract.generateCameraKeyframe();
+    const double simulationTime = global::timeManager.time().j2000Seconds();
+
+    if (_skipUnchangedCameraKeyframes) {
+        if (_hasSavedCameraKeyframe && isSameCameraPose(kf, _lastSavedCameraKeyframe)) {
+            // Only the last keyframe of a series without movement is needed, as the
+            // playback would otherwise interpolate over the entire series once the
+            // camera moves again
+            _skippedCameraKeyframe = std::move(kf);
+            _skippedCameraKeyframeSimulationTime = simulationTime;
+            _hasSkippedCameraKeyframe = true;
+            return;
+        }
+        if (_hasSkippedCameraKeyframe) {
+            saveCameraKeyframeToFile(
+                _skippedCameraKeyframe,
+                _skippedCameraKeyframeSimulationTime
+            );
+            _hasSkippedCameraKeyframe = false;
+        }
+    }
+
+    if (saveCameraKeyframeToFile(kf, simulationTime)) {
+        _lastSavedCameraKeyframe = std::move(kf);
+        _hasSavedCameraKeyframe = true;
+    }
+}
+
+bool SessionRecording::saveCameraKeyframeToFile(
+                                         const datamessagestructures::CameraKeyframe& kf,
+                                                double simulationTime)
+{
+    // Camera keyframes are dropped if they cannot be written fast enough, as the playback
+    // interpolates between the remaining ones
+    constexpr const AsyncFileWriter::DropIfFull Drop = AsyncFileWriter::DropIfFull::Yes;
 
     if (_recordingDataMode == RecordedDataMode::Binary) {
         // Writing to a binary session recording file
@@ -476,12 +690,12 @@ void SessionRecording::saveCameraKeyframe() {
         // Writing to internal buffer, and then to file, for performance reasons
         writeToFileBuffer(kf._timestamp);
         writeToFileBuffer(kf._timestamp - _timestampRecordStarted);
-        writeToFileBuffer(global::timeManager.time().j2000Seconds());
+        writeToFileBuffer(simulationTime);
         std::vector<char> kfBuffer;
         kf.serialize(kfBuffer);
         writeToFileBuffer(kfBuffer);
 
-        saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex);
+        return saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex, Drop);
     }
     else {
         // Writing to an ASCII session recording file
@@ -491,8 +705,7 @@ void SessionRecording::saveCameraKeyframe() {
         keyframeLine << "camera ";
         keyframeLine << kf._timestamp << ' ';
         keyframeLine << (kf._timestamp - _timestampRecordStarted) << ' ';
-        keyframeLine << std::fixed << std::setprecision(3) <<
-                        global::timeManager.time().j2000Seconds();
+        keyframeLine << std::fixed << std::setprecision(3) << simulationTime;
         keyframeLine << ' ';
         // Add camera position
         keyframeLine << std::fixed << std::setprecision(7) << kf._position.x << ' '
@@ -512,7 +725,7 @@ void SessionRecording::saveCameraKeyframe() {
         }
         keyframeLine << kf._focusNode;
 
-        saveKeyframeToFile(keyframeLine.str());
+        return saveKeyframeToFile(keyframeLine.str(), Drop);
     }
 }
 
@@ -666,6 +879,13 @@ SessionRecording::SessionState SessionRecording::state() const {
 }
 
 bool SessionRecording::playbackAddEntriesToTimeline() {
+    if (_isPlaybackIndexed) {
+        // The stream was only needed to read the header, the entries of the indexed
+        // format are read from a memory map
+        _playbackFile.close();
+        return playbackAddIndexedEntriesToTimeline();
+    }
+
     bool parsingErrorsFound = false;
 
     if (_recordingDataMode == RecordedDataMode::Binary) {
@@ -745,6 +965,92 @@ bool SessionRecording::playbackAddEntriesToTimeline() {
     return !parsingErrorsFound;
 }
 
+bool SessionRecording::playbackAddIndexedEntriesToTimeline() {
+    try {
+        const IndexedRecording recording(_playbackFilename);
+        const size_t nEntries = recording.nEntries();
+
+        // As the number of entries is known upfront, the timeline is allocated only once
+        _timeline.reserve(nEntries);
+        // The number of scripts is validated against the number of entries when the
+        // recording is opened
+        _keyframesCamera.reserve(nEntries - recording.nScripts());
+        _keyframesScript.reserve(recording.nScripts());
+
+        for (size_t i = 0; i < nEntries; ++i) {
+            const IndexedRecording::Entry e = recording.entry(i);
+            switch (e.type) {
+                case IndexedRecording::EntryType::Camera: {
+                    interaction::KeyframeNavigator::CameraPose pose;
+                    pose.position = glm::dvec3(
+                        e.position[0],
+                        e.position[1],
+                        e.position[2]
+                    );
+                    pose.rotation = glm::dquat(
+                        e.rotation[3],
+                        e.rotation[0],
+                        e.rotation[1],
+                        e.rotation[2]
+                    );
+                    pose.scale = e.scale;
+                    pose.followFocusNodeRotation = e.followNodeRotation;
+                    pose.focusNode = std::string(recording.nodeName(e.index));
+
+                    if (_setSimulationTimeWithNextCameraKeyframe) {
+                        global::timeManager.setTimeNextFrame(Time(e.timeSim));
+                        _setSimulationTimeWithNextCameraKeyframe = false;
+                        _saveRenderingCurrentRecordedTime = e.timeRec;
+                    }
+                    addKeyframe(
+                        appropriateTimestamp(e.timeOs, e.timeRec, e.timeSim),
+                        e.timeSim,
+                        std::move(pose)
+                    );
+                    break;
+                }
+                case IndexedRecording::EntryType::Time: {
+                    datamessagestructures::TimeKeyframe kf;
+                    kf._dt = e.deltaTime;
+                    kf._paused = e.paused;
+                    kf._requiresTimeJump = e.requiresTimeJump;
+                    kf._timestamp = equivalentApplicationTime(
+                        e.timeOs,
+                        e.timeRec,
+                        e.timeSim
+                    );
+                    kf._time = kf._timestamp + _timestampApplicationStarted_simulation;
+                    addKeyframe(kf._timestamp, e.timeSim, kf);
+                    break;
+                }
+                case IndexedRecording::EntryType::Script:
+                    addKeyframe(
+                        appropriateTimestamp(e.timeOs, e.timeRec, e.timeSim),
+                        e.timeSim,
+                        std::string(recording.script(e.index))
+                    );
+                    break;
+                default:
+                    LERROR(fmt::format(
+                        "Unknown frame type {} @ index {} of playback file {}",
+                        static_cast<char>(e.type), i, _playbackFilename
+                    ));
+                    return false;
+            }
+        }
+
+        LINFO(fmt::format(
+            "Finished loading {} entries from playback file {}",
+            nEntries, _playbackFilename
+        ));
+        return true;
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(e.message);
+        return false;
+    }
+}
+
 double SessionRecording::appropriateTimestamp(double timeOs, double timeRec,
                                               double timeSim)
 {
@@ -893,7 +1199,7 @@ void SessionRecording::playbackCamera() {
     double timeRef = appropriateTimestamp(timeOs, timeRec, timeSim);
 
     //global::navigationHandler.keyframeNavigator().addKeyframe(timeRef, pbFrame);
-    addKeyframe(timeRef, pbFrame);
+    addKeyframe(timeRef, timeSim, pbFrame);
 }
 
 void SessionRecording::playbackTimeChange() {
@@ -940,7 +1246,7 @@ void SessionRecording::playbackTimeChange() {
     pbFrame._time = pbFrame._timestamp + _timestampApplicationStarted_simulation;
     //global::timeManager.addKeyframe(timeRef, pbFrame._timestamp);
     //_externInteract.timeInteraction(pbFrame);
-    addKeyframe(pbFrame._timestamp, pbFrame);
+    addKeyframe(pbFrame._timestamp, timeSim, pbFrame);
 }
 
 void SessionRecording::playbackScript() {
@@ -1025,10 +1331,10 @@ void SessionRecording::playbackScript() {
     //}
     //                            );
     //global::scriptScheduler.loadScripts({ { "1", scriptDict } });
-    addKeyframe(timeRef, pbFrame._script);
+    addKeyframe(timeRef, timeSim, pbFrame._script);
 }
 
-void SessionRecording::addKeyframe(double timestamp,
+void SessionRecording::addKeyframe(double timestamp, double timeSim,
                                    interaction::KeyframeNavigator::CameraPose keyframe)
 {
     size_t indexIntoCameraKeyframesFromMainTimeline = _keyframesCamera.size();
@@ -1036,11 +1342,12 @@ void SessionRecording::addKeyframe(double timestamp,
     _timeline.push_back({
         RecordedType::Camera,
         static_cast<unsigned int>(indexIntoCameraKeyframesFromMainTimeline),
-        timestamp
+        timestamp,
+        timeSim
     });
 }
 
-void SessionRecording::addKeyframe(double timestamp,
+void SessionRecording::addKeyframe(double timestamp, double timeSim,
                                    datamessagestructures::TimeKeyframe keyframe)
 {
     size_t indexIntoTimeKeyframesFromMainTimeline = _keyframesTime.size();
@@ -1048,17 +1355,21 @@ void SessionRecording::addKeyframe(double timestamp,
     _timeline.push_back({
         RecordedType::Time,
         static_cast<unsigned int>(indexIntoTimeKeyframesFromMainTimeline),
-        timestamp
+        timestamp,
+        timeSim
     });
 }
 
-void SessionRecording::addKeyframe(double timestamp, std::string scriptToQueue) {
+void SessionRecording::addKeyframe(double timestamp, double timeSim,
+                                   std::string scriptToQueue)
+{
     size_t indexIntoScriptKeyframesFromMainTimeline = _keyframesScript.size();
     _keyframesScript.push_back(std::move(scriptToQueue));
     _timeline.push_back({
         RecordedType::Script,
         static_cast<unsigned int>(indexIntoScriptKeyframesFromMainTimeline),
-        timestamp
+        timestamp,
+        timeSim
     });
 }
 
@@ -1350,12 +1661,17 @@ SessionRecording::RecordedType SessionRecording::getPrevKeyframeType() {
     }
 }
 
-void SessionRecording::saveKeyframeToFileBinary(unsigned char* buffer, size_t size) {
-    _recordFile.write(reinterpret_cast<char*>(buffer), size);
+bool SessionRecording::saveKeyframeToFileBinary(unsigned char* buffer, size_t size,
+                                                AsyncFileWriter::DropIfFull drop)
+{
+    return _recordFile.write(reinterpret_cast<const char*>(buffer), size, drop);
 }
 
-void SessionRecording::saveKeyframeToFile(std::string entry) {
-    _recordFile << std::move(entry) << std::endl;
+bool SessionRecording::saveKeyframeToFile(std::string entry,
+                                          AsyncFileWriter::DropIfFull drop)
+{
+    entry += '\n';
+    return _recordFile.write(entry.data(), entry.size(), drop);
 }
 
 SessionRecording::CallbackHandle SessionRecording::addStateChangeCallback(
@@ -1471,6 +1787,25 @@ scripting::LuaLibrary SessionRecording::luaLibrary() {
                 "void",
                 "Stops a playback session before playback of all keyframes is complete"
             },
+            {
+                "seekPlayback",
+                &luascriptfunctions::seekPlayback,
+                {},
+                "number",
+                "Moves a playback session that is relative to the recorded time to the "
+                "provided number of seconds since the start of the recording. Scripts "
+                "between the current and the new time are not executed."
+            },
+            {
+                "convertToIndexedFormat",
+                &luascriptfunctions::convertToIndexedFormat,
+                {},
+                "string, string",
+                "Converts the ASCII or binary recording with the filename provided as "
+                "the first argument into the indexed format, which is written to the "
+                "filename provided as the second argument. A recording in the indexed "
+                "format is loaded from a memory-mapped file and supports seeking."
+            },
             {
                 "enableTakeScreenShotDuringPlayback",
                 &luascriptfunctions::enableTakeScreenShotDuringPlayback,
@@ -0,0 +1,409 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/network/camerakeyframecodec.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    constexpr const uint8_t FullKeyframeFlag = 1 << 0;
+    constexpr const uint8_t FollowNodeRotationFlag = 1 << 1;
+    constexpr const uint8_t ScaleFlag = 1 << 2;
+    // The index of the largest quaternion component is stored in bits 4 and 5
+    constexpr const int RotationIndexShift = 4;
+
+    // The number of steps per unit of the quantized quaternion components
+    constexpr const double RotationResolution = 1 << 20;
+
+    // The number of steps per unit of distance to the focus node that are used for the
+    // position differences ...
+    constexpr const double PositionResolution = 1 << 24;
+
+    // ... with the distance being at least this many meters
+    constexpr const double MinimumDistance = 1.0;
+
+    // Position differences that require more steps than this are sent as full keyframes
+    constexpr const double MaximumPositionSteps = static_cast<double>(1ull << 40);
+
+    // The number of steps per second of the timestamp difference
+    constexpr const double TimestampResolution = 1e6;
+
+    uint64_t zigzagEncode(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t zigzagDecode(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    void writeVarint(std::vector<char>& buffer, uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    template <typename T>
+    void writeValue(std::vector<char>& buffer, const T& value) {
+        const char* data = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), data, data + sizeof(T));
+    }
+
+    // Reads values from a message and remembers if it tried to read past its end
+    struct Reader {
+        uint8_t readByte() {
+            if (offset >= size) {
+                hasFailed = true;
+                return 0;
+            }
+            return static_cast<uint8_t>(data[offset++]);
+        }
+
+        uint64_t readVarint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const uint64_t byte = readByte();
+                value |= (byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+            return value;
+        }
+
+        template <typename T>
+        T readValue() {
+            T value = T();
+            if (size - offset < sizeof(T)) {
+                hasFailed = true;
+                return value;
+            }
+            std::memcpy(&value, data + offset, sizeof(T));
+            offset += sizeof(T);
+            return value;
+        }
+
+        void readString(std::string& value, uint64_t length) {
+            if (size - offset < length) {
+                hasFailed = true;
+                return;
+            }
+            value.assign(data + offset, static_cast<size_t>(length));
+            offset += static_cast<size_t>(length);
+        }
+
+        const char* data;
+        size_t size;
+        size_t offset = 0;
+        bool hasFailed = false;
+    };
+
+    struct QuantizedRotation {
+        std::array<int32_t, 3> values;
+        int index;
+    };
+
+    // Stores the three smallest components of the normalized quaternion. As q and -q
+    // describe the same rotation, the largest component can be made positive and be
+    // computed from the other components
+    QuantizedRotation quantizeRotation(const glm::dquat& rotation) {
+        const double components[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+        int index = 0;
+        double length = 0.0;
+        for (int i = 0; i < 4; ++i) {
+            if (std::abs(components[i]) > std::abs(components[index])) {
+                index = i;
+            }
+            length += components[i] * components[i];
+        }
+        length = std::sqrt(length);
+        const double factor =
+            (components[index] < 0.0 ? -1.0 : 1.0) * RotationResolution / length;
+
+        QuantizedRotation result;
+        result.index = index;
+        int j = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (i != index) {
+                result.values[j] = static_cast<int32_t>(
+                    std::llround(components[i] * factor)
+                );
+                ++j;
+            }
+        }
+        return result;
+    }
+
+    glm::dquat dequantizeRotation(const std::array<int32_t, 3>& values, int index) {
+        double components[4];
+        double sumSquared = 0.0;
+        int j = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (i != index) {
+                components[i] = values[j] / RotationResolution;
+                sumSquared += components[i] * components[i];
+                ++j;
+            }
+        }
+        components[index] = std::sqrt(std::max(1.0 - sumSquared, 0.0));
+        return glm::dquat(components[3], components[0], components[1], components[2]);
+    }
+
+    double positionStep(const glm::dvec3& previousPosition) {
+        return std::max(glm::length(previousPosition), MinimumDistance) /
+            PositionResolution;
+    }
+
+    // The Encoder and the Decoder have to use the same function to get the same result
+    glm::dvec3 applyPositionSteps(const glm::dvec3& previousPosition,
+                                  const std::array<int64_t, 3>& steps)
+    {
+        const double step = positionStep(previousPosition);
+        return glm::dvec3(
+            previousPosition.x + steps[0] * step,
+            previousPosition.y + steps[1] * step,
+            previousPosition.z + steps[2] * step
+        );
+    }
+} // namespace
+
+namespace openspace {
+
+void CameraKeyframeCodec::Encoder::encode(const CameraKeyframe& keyframe,
+                                          double referenceTimestamp,
+                                          std::vector<char>& buffer)
+{
+    uint32_t nodeIndex = 0;
+    const auto it = _nodeIndices.find(keyframe._focusNode);
+    if (it == _nodeIndices.end()) {
+        // The Decoder only learns about new node names through a full keyframe
+        nodeIndex = static_cast<uint32_t>(_nodeNames.size());
+        _nodeNames.push_back(keyframe._focusNode);
+        _nodeIndices.emplace(keyframe._focusNode, nodeIndex);
+        _needsFullKeyframe = true;
+    }
+    else {
+        nodeIndex = it->second;
+    }
+
+    bool isFull = _needsFullKeyframe || _nKeyframesSinceFull >= FullKeyframeInterval;
+
+    std::array<int64_t, 3> positionSteps = { 0, 0, 0 };
+    if (!isFull) {
+        const double step = positionStep(_previous._position);
+        const double differences[3] = {
+            (keyframe._position.x - _previous._position.x) / step,
+            (keyframe._position.y - _previous._position.y) / step,
+            (keyframe._position.z - _previous._position.z) / step
+        };
+        for (int i = 0; i < 3; ++i) {
+            if (!(std::abs(differences[i]) <= MaximumPositionSteps)) {
+                isFull = true;
+                break;
+            }
+            positionSteps[i] = std::llround(differences[i]);
+        }
+    }
+
+    const QuantizedRotation rotation = quantizeRotation(keyframe._rotation);
+
+    uint8_t flags = static_cast<uint8_t>(rotation.index << RotationIndexShift);
+    if (isFull) {
+        flags |= FullKeyframeFlag;
+    }
+    else if (keyframe._scale != _previous._scale) {
+        flags |= ScaleFlag;
+    }
+    if (keyframe._followNodeRotation) {
+        flags |= FollowNodeRotationFlag;
+    }
+    buffer.push_back(static_cast<char>(flags));
+
+    writeVarint(
+        buffer,
+        zigzagEncode(std::llround(
+            (referenceTimestamp - keyframe._timestamp) * TimestampResolution
+        ))
+    );
+
+    if (isFull) {
+        writeVarint(buffer, _nodeNames.size());
+        for (const std::string& name : _nodeNames) {
+            writeVarint(buffer, name.size());
+            buffer.insert(buffer.end(), name.begin(), name.end());
+        }
+        writeVarint(buffer, nodeIndex);
+
+        writeValue(buffer, keyframe._position);
+        for (int32_t value : rotation.values) {
+            writeVarint(buffer, zigzagEncode(value));
+        }
+        writeValue(buffer, keyframe._scale);
+
+        _previous._position = keyframe._position;
+        _needsFullKeyframe = false;
+        _nKeyframesSinceFull = 0;
+    }
+    else {
+        writeVarint(buffer, nodeIndex);
+
+        for (int64_t step : positionSteps) {
+            writeVarint(buffer, zigzagEncode(step));
+        }
+        for (int i = 0; i < 3; ++i) {
+            writeVarint(
+                buffer,
+                zigzagEncode(static_cast<int64_t>(rotation.values[i]) -
+                    _previousRotation[i])
+            );
+        }
+        if (flags & ScaleFlag) {
+            writeValue(buffer, keyframe._scale);
+        }
+
+        _previous._position = applyPositionSteps(_previous._position, positionSteps);
+        ++_nKeyframesSinceFull;
+    }
+
+    _previous._rotation = dequantizeRotation(rotation.values, rotation.index);
+    _previous._followNodeRotation = keyframe._followNodeRotation;
+    _previous._focusNode = keyframe._focusNode;
+    _previous._scale = keyframe._scale;
+    _previousRotation = rotation.values;
+}
+
+bool CameraKeyframeCodec::Encoder::hasChanged(const CameraKeyframe& keyframe,
+                                              double threshold) const
+{
+    if (_needsFullKeyframe || keyframe._focusNode != _previous._focusNode ||
+        keyframe._followNodeRotation != _previous._followNodeRotation ||
+        keyframe._scale != _previous._scale)
+    {
+        return true;
+    }
+
+    const double distance = glm::length(keyframe._position - _previous._position);
+    const double maximumDistance =
+        threshold * std::max(glm::length(_previous._position), MinimumDistance);
+    if (distance > maximumDistance) {
+        return true;
+    }
+
+    // The angle between two rotations is 2 * acos(|dot(q1, q2)|) for unit quaternions
+    const double dot = std::abs(glm::dot(keyframe._rotation, _previous._rotation)) /
+        (glm::length(keyframe._rotation) * glm::length(_previous._rotation));
+    return 2.0 * std::acos(std::min(dot, 1.0)) > threshold;
+}
+
+void CameraKeyframeCodec::Encoder::reset() {
+    _needsFullKeyframe = true;
+}
+
+bool CameraKeyframeCodec::Decoder::decode(const char* data, size_t size,
+                                          double referenceTimestamp,
+                                          CameraKeyframe& keyframe)
+{
+    Reader reader = { data, size };
+
+    const uint8_t flags = reader.readByte();
+    const bool isFull = flags & FullKeyframeFlag;
+    if (reader.hasFailed || (!isFull && !_hasFullKeyframe)) {
+        return false;
+    }
+    const int rotationIndex = (flags >> RotationIndexShift) & 0x3;
+
+    const int64_t timestampSteps = zigzagDecode(reader.readVarint());
+
+    glm::dvec3 position;
+    std::array<int32_t, 3> rotation;
+    float scale = _previousScale;
+    if (isFull) {
+        // Any failure from here on leaves the node name table in an undefined state
+        _hasFullKeyframe = false;
+
+        const uint64_t nNodeNames = reader.readVarint();
+        // Every node name requires at least one byte for its length
+        if (nNodeNames > size - reader.offset) {
+            return false;
+        }
+        _nodeNames.resize(static_cast<size_t>(nNodeNames));
+        for (std::string& name : _nodeNames) {
+            reader.readString(name, reader.readVarint());
+        }
+    }
+
+    const uint64_t nodeIndex = reader.readVarint();
+
+    if (isFull) {
+        position = reader.readValue<glm::dvec3>();
+        for (int32_t& value : rotation) {
+            value = static_cast<int32_t>(zigzagDecode(reader.readVarint()));
+        }
+        scale = reader.readValue<float>();
+    }
+    else {
+        std::array<int64_t, 3> positionSteps;
+        for (int64_t& step : positionSteps) {
+            step = zigzagDecode(reader.readVarint());
+        }
+        position = applyPositionSteps(_previousPosition, positionSteps);
+
+        for (int i = 0; i < 3; ++i) {
+            rotation[i] = static_cast<int32_t>(
+                _previousRotation[i] + zigzagDecode(reader.readVarint())
+            );
+        }
+        if (flags & ScaleFlag) {
+            scale = reader.readValue<float>();
+        }
+    }
+
+    if (reader.hasFailed || nodeIndex >= _nodeNames.size()) {
+        return false;
+    }
+
+    _hasFullKeyframe = true;
+    _previousPosition = position;
+    _previousScale = scale;
+    _previousRotation = rotation;
+
+    keyframe._position = position;
+    keyframe._rotation = dequantizeRotation(rotation, rotationIndex);
+    keyframe._followNodeRotation = flags & FollowNodeRotationFlag;
+    keyframe._focusNode = _nodeNames[static_cast<size_t>(nodeIndex)];
+    keyframe._scale = scale;
+    keyframe._timestamp = referenceTimestamp - timestampSteps / TimestampResolution;
+    return true;
+}
+
+void CameraKeyframeCodec::Decoder::reset() {
+    _nodeNames.clear();
+    _hasFullKeyframe = false;
+}
+
+} // namespace openspace
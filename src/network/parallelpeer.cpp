@@ -95,6 +95,25 @@ namespace {
         "Camera Keyframe interval",
         "" // @TODO Missing documentation
     };
+
+    constexpr openspace::properties::Property::PropertyInfo CompactCameraKeyframesInfo = {
+        "CompactCameraKeyframes",
+        "Compact Camera Keyframes",
+        "If this value is enabled, the host sends camera keyframes in a compact format, "
+        "in which the positions and rotations are quantized and only the changes to the "
+        "previous keyframe are sent. In addition, keyframes are only sent when the "
+        "camera has moved more than the camera motion threshold. This reduces the "
+        "required bandwidth considerably, but all connected clients have to support "
+        "the compact format."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo CameraMotionThresholdInfo = {
+        "CameraMotionThreshold",
+        "Camera Motion Threshold",
+        "If compact camera keyframes are enabled, a camera keyframe is only sent if the "
+        "camera has rotated by more than this angle (in radians) or has moved by more "
+        "than this fraction of its distance to the focus node."
+    };
 } // namespace
 
 namespace openspace {
@@ -109,6 +128,8 @@ ParallelPeer::ParallelPeer()
     , _bufferTime(BufferTimeInfo, 0.2f, 0.01f, 5.0f)
     , _timeKeyframeInterval(TimeKeyFrameInfo, 0.1f, 0.f, 1.f)
     , _cameraKeyframeInterval(CameraKeyFrameInfo, 0.1f, 0.f, 1.f)
+    , _compactCameraKeyframes(CompactCameraKeyframesInfo, false)
+    , _cameraMotionThreshold(CameraMotionThresholdInfo, 1e-4f, 0.f, 1e-2f)
     , _connectionEvent(std::make_shared<ghoul::Event<>>())
     , _connection(nullptr)
 {
@@ -122,6 +143,13 @@ ParallelPeer::ParallelPeer()
 
     addProperty(_timeKeyframeInterval);
     addProperty(_cameraKeyframeInterval);
+
+    _compactCameraKeyframes.onChange([this]() {
+        _cameraKeyframeEncoder.reset();
+        _hasSkippedCameraKeyframe = false;
+    });
+    addProperty(_compactCameraKeyframes);
+    addProperty(_cameraMotionThreshold);
 }
 
 ParallelPeer::~ParallelPeer() {
@@ -276,26 +304,35 @@ void ParallelPeer::dataMessageReceived(const std::vector<char>& message)
 
     analyzeTimeDifference(timestamp);
 
+    // Compact camera keyframes are decoded directly from the message, as they are sent
+    // with a high frequency
+    if (static_cast<datamessagestructures::Type>(type) ==
+        datamessagestructures::Type::CompactCameraData)
+    {
+        const bool success = _cameraKeyframeDecoder.decode(
+            message.data() + offset,
+            message.size() - offset,
+            timestamp,
+            _receivedCameraKeyframe
+        );
+        // Keyframes that arrive before the first full keyframe cannot be decoded
+        if (success) {
+            addCameraKeyframe(
+                _receivedCameraKeyframe,
+                convertTimestamp(_receivedCameraKeyframe._timestamp)
+            );
+            _isHoldingCameraKeyframe = true;
+        }
+        return;
+    }
+
     std::vector<char> buffer(message.begin() + offset, message.end());
 
     switch (static_cast<datamessagestructures::Type>(type)) {
         case datamessagestructures::Type::CameraData: {
             datamessagestructures::CameraKeyframe kf(buffer);
-            const double convertedTimestamp = convertTimestamp(kf._timestamp);
-
-            global::navigationHandler.keyframeNavigator().removeKeyframesAfter(
-                convertedTimestamp
-            );
-
-            interaction::KeyframeNavigator::CameraPose pose;
-            pose.focusNode = kf._focusNode;
-            pose.position = kf._position;
-            pose.rotation = kf._rotation;
-            pose.scale = kf._scale;
-            pose.followFocusNodeRotation = kf._followNodeRotation;
-
-            global::navigationHandler.keyframeNavigator().addKeyframe(convertedTimestamp,
-                                                                      pose);
+            addCameraKeyframe(kf, convertTimestamp(kf._timestamp));
+            _isHoldingCameraKeyframe = false;
             break;
         }
         case datamessagestructures::Type::TimelineData: {
@@ -409,6 +446,11 @@ void ParallelPeer::connectionStatusMessageReceived(const std::vector<char>& mess
 
     global::navigationHandler.keyframeNavigator().clearKeyframes();
     global::timeManager.clearKeyframes();
+
+    _cameraKeyframeEncoder.reset();
+    _hasSkippedCameraKeyframe = false;
+    _cameraKeyframeDecoder.reset();
+    _isHoldingCameraKeyframe = false;
 }
 
 void ParallelPeer::nConnectionsMessageReceived(const std::vector<char>& message)
@@ -418,6 +460,10 @@ void ParallelPeer::nConnectionsMessageReceived(const std::vector<char>& message)
         return;
     }
     const uint32_t nConnections = *(reinterpret_cast<const uint32_t*>(&message[0]));
+    if (nConnections > _nConnections) {
+        // A new client needs a full keyframe before it can decode compact keyframes
+        _cameraKeyframeEncoder.reset();
+    }
     setNConnections(nConnections);
 }
 
@@ -529,6 +575,9 @@ void ParallelPeer::preSynchronization() {
             _timeTimelineChanged = false;
         }
     }
+    else if (_isHoldingCameraKeyframe) {
+        holdCameraKeyframe();
+    }
     if (_shouldDisconnect) {
         disconnect();
     }
@@ -616,6 +665,21 @@ void ParallelPeer::sendCameraKeyframe() {
     // Timestamp as current runtime of OpenSpace instance
     kf._timestamp = global::windowDelegate.applicationTime();
 
+    if (_compactCameraKeyframes) {
+        if (!_cameraKeyframeEncoder.hasChanged(kf, _cameraMotionThreshold)) {
+            _skippedCameraKeyframe = std::move(kf);
+            _hasSkippedCameraKeyframe = true;
+            return;
+        }
+
+        if (_hasSkippedCameraKeyframe) {
+            sendCompactCameraKeyframe(_skippedCameraKeyframe);
+            _hasSkippedCameraKeyframe = false;
+        }
+        sendCompactCameraKeyframe(kf);
+        return;
+    }
+
     // Create a buffer for the keyframe
     std::vector<char> buffer;
 
@@ -631,6 +695,50 @@ void ParallelPeer::sendCameraKeyframe() {
     ));
 }
 
+void ParallelPeer::sendCompactCameraKeyframe(
+                                          const datamessagestructures::CameraKeyframe& kf)
+{
+    const double timestamp = global::windowDelegate.applicationTime();
+
+    std::vector<char> buffer;
+    _cameraKeyframeEncoder.encode(kf, timestamp, buffer);
+
+    _connection.sendDataMessage(ParallelConnection::DataMessage(
+        datamessagestructures::Type::CompactCameraData,
+        timestamp,
+        std::move(buffer)
+    ));
+}
+
+void ParallelPeer::addCameraKeyframe(const datamessagestructures::CameraKeyframe& kf,
+                                     double convertedTimestamp)
+{
+    global::navigationHandler.keyframeNavigator().removeKeyframesAfter(
+        convertedTimestamp
+    );
+
+    interaction::KeyframeNavigator::CameraPose pose;
+    pose.focusNode = kf._focusNode;
+    pose.position = kf._position;
+    pose.rotation = kf._rotation;
+    pose.scale = kf._scale;
+    pose.followFocusNodeRotation = kf._followNodeRotation;
+
+    global::navigationHandler.keyframeNavigator().addKeyframe(convertedTimestamp, pose);
+    _lastCameraKeyframeConvertedTimestamp = convertedTimestamp;
+}
+
+void ParallelPeer::holdCameraKeyframe() {
+    const double now = global::windowDelegate.applicationTime();
+    if (_lastCameraKeyframeConvertedTimestamp >= now) {
+        return;
+    }
+
+    // The repeated keyframe is removed again if the host continues with an earlier
+    // keyframe, as the KeyframeNavigator removes all keyframes after a new one
+    addCameraKeyframe(_receivedCameraKeyframe, now + _bufferTime);
+}
+
 void ParallelPeer::sendTimeTimeline() {
     // Create a keyframe with current position and orientation of camera
     const Timeline<TimeKeyframeData>& timeline = global::timeManager.timeline();
@@ -29,6 +29,7 @@
 #include <ghoul/lua/ghoul_lua.h>
 
 #include <algorithm>
+#include <mutex>
 
 #include <ghoul/logging/logmanager.h>
 
@@ -39,6 +40,33 @@ namespace {
 
     constexpr const char* _metaDataKeyViewPrefix = "view.";
 
+    // The list of all properties whose change flag is set. The flag of a Property is only
+    // modified while the mutex is held, so that a Property is on the list if and only if
+    // its flag is set. Repeated changes of the same Property do not take the mutex
+    struct ChangedPropertyList {
+        std::mutex mutex;
+        std::vector<openspace::properties::Property*> properties;
+    };
+
+    ChangedPropertyList& changedPropertyList() {
+        // Properties might be destroyed during static deinitialization, so the list is
+        // intentionally never destroyed
+        static ChangedPropertyList* list = new ChangedPropertyList;
+        return *list;
+    }
+
+    bool isOwnedBy(const openspace::properties::Property& property,
+                   const openspace::properties::PropertyOwner& owner)
+    {
+        const openspace::properties::PropertyOwner* o = property.owner();
+        while (o) {
+            if (o == &owner) {
+                return true;
+            }
+            o = o->owner();
+        }
+        return false;
+    }
 } // namespace
 
 namespace openspace::properties {
@@ -114,6 +142,9 @@ Property::Property(PropertyInfo info)
 
 Property::~Property() {
     notifyDeleteListeners();
+    resetToUnchanged();
+    // Cached lookups might still refer to this Property
+    PropertyOwner::invalidateHierarchy();
 }
 
 const std::string& Property::identifier() const {
@@ -317,7 +348,54 @@ bool Property::hasChanged() const {
 }
 
 void Property::resetToUnchanged() {
-    _isValueDirty = false;
+    if (!_isValueDirty) {
+        return;
+    }
+
+    ChangedPropertyList& list = changedPropertyList();
+    std::lock_guard lock(list.mutex);
+    if (_isValueDirty) {
+        _isValueDirty = false;
+        list.properties.erase(
+            std::find(list.properties.begin(), list.properties.end(), this)
+        );
+    }
+}
+
+void Property::markAsChanged() {
+    if (_isValueDirty) {
+        return;
+    }
+
+    ChangedPropertyList& list = changedPropertyList();
+    std::lock_guard lock(list.mutex);
+    if (!_isValueDirty) {
+        _isValueDirty = true;
+        list.properties.push_back(this);
+    }
+}
+
+std::vector<Property*> Property::changedProperties() {
+    ChangedPropertyList& list = changedPropertyList();
+    std::lock_guard lock(list.mutex);
+    return list.properties;
+}
+
+void Property::resetChangedProperties(const PropertyOwner* owner) {
+    ChangedPropertyList& list = changedPropertyList();
+    std::lock_guard lock(list.mutex);
+    auto it = std::remove_if(
+        list.properties.begin(),
+        list.properties.end(),
+        [owner](Property* p) {
+            if (owner && !isOwnedBy(*p, *owner)) {
+                return false;
+            }
+            p->_isValueDirty = false;
+            return true;
+        }
+    );
+    list.properties.erase(it, list.properties.end());
 }
 
 std::string Property::generateBaseJsonDescription() const {
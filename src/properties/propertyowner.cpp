@@ -31,11 +31,14 @@
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/invariants.h>
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 
 namespace {
     constexpr const char* _loggerCat = "PropertyOwner";
 
+    std::atomic<uint64_t> HierarchyVersion = 0;
+
     std::string escapedJson(const std::string& text) {
         std::string jsonString;
         for (const char& c : text) {
@@ -171,6 +174,9 @@ PropertyOwner::PropertyOwner(PropertyOwnerInfo info)
 PropertyOwner::~PropertyOwner() {
     _properties.clear();
     _subOwners.clear();
+    _propertyIndex.clear();
+    _subOwnerIndex.clear();
+    invalidateHierarchy();
 }
 
 const std::vector<Property*>& PropertyOwner::properties() const {
@@ -188,38 +194,27 @@ std::vector<Property*> PropertyOwner::propertiesRecursive() const {
     return props;
 }
 
-Property* PropertyOwner::property(const std::string& uri) const {
-    auto it = std::find_if(
-        _properties.begin(),
-        _properties.end(),
-        [&uri](Property* prop) { return prop->identifier() == uri; }
-    );
+Property* PropertyOwner::property(std::string_view uri) const {
+    const PropertyOwner* owner = this;
+    while (owner) {
+        // The unordered_map can't be queried with a string_view, so we have to create a
+        // temporary string for each component of the URI
+        const auto it = owner->_propertyIndex.find(std::string(uri));
+        if (it != owner->_propertyIndex.end()) {
+            return it->second;
+        }
 
-    if (it == _properties.end() || (*it)->identifier() != uri) {
         // if we do not own the searched property, it must consist of a concatenated
         // name and we can delegate it to a subowner
         const size_t ownerSeparator = uri.find(URISeparator);
-        if (ownerSeparator == std::string::npos) {
+        if (ownerSeparator == std::string_view::npos) {
             // if we do not own the property and there is no separator, it does not exist
             return nullptr;
         }
-        else {
-            const std::string ownerName = uri.substr(0, ownerSeparator);
-            const std::string propertyName = uri.substr(ownerSeparator + 1);
-
-            PropertyOwner* owner = propertySubOwner(ownerName);
-            if (!owner) {
-                return nullptr;
-            }
-            else {
-                // Recurse into the subOwner
-                return owner->property(propertyName);
-            }
-        }
-    }
-    else {
-        return *it;
+        owner = owner->propertySubOwner(uri.substr(0, ownerSeparator));
+        uri = uri.substr(ownerSeparator + 1);
     }
+    return nullptr;
 }
 
 bool PropertyOwner::hasProperty(const std::string& uri) const {
@@ -240,19 +235,9 @@ const std::vector<PropertyOwner*>& PropertyOwner::propertySubOwners() const {
     return _subOwners;
 }
 
-PropertyOwner* PropertyOwner::propertySubOwner(const std::string& identifier) const {
-    std::vector<PropertyOwner*>::const_iterator it = std::find_if(
-        _subOwners.begin(),
-        _subOwners.end(),
-        [&identifier](PropertyOwner* owner) { return owner->identifier() == identifier; }
-    );
-
-    if (it == _subOwners.end() || (*it)->identifier() != identifier) {
-        return nullptr;
-    }
-    else {
-        return *it;
-    }
+PropertyOwner* PropertyOwner::propertySubOwner(std::string_view identifier) const {
+    const auto it = _subOwnerIndex.find(std::string(identifier));
+    return it != _subOwnerIndex.end() ? it->second : nullptr;
 }
 
 bool PropertyOwner::hasPropertySubOwner(const std::string& identifier) const {
@@ -280,15 +265,8 @@ void PropertyOwner::addProperty(Property* prop) {
         LERROR("No property identifier specified");
         return;
     }
-    // See if we can find the identifier of the property to add in the properties list
-    std::vector<Property*>::const_iterator it = std::find_if(
-        _properties.begin(),
-        _properties.end(),
-        [id = prop->identifier()](Property* p) { return p->identifier() == id; }
-    );
-
-    // If we found the property identifier, we need to bail out
-    if (it != _properties.end() && (*it)->identifier() == prop->identifier()) {
+    // If we find the property identifier, we need to bail out
+    if (_propertyIndex.find(prop->identifier()) != _propertyIndex.end()) {
         LERROR(fmt::format(
             "Property identifier '{}' already present in PropertyOwner '{}'",
             prop->identifier(),
@@ -308,7 +286,9 @@ void PropertyOwner::addProperty(Property* prop) {
         }
         else {
             _properties.push_back(prop);
+            _propertyIndex[prop->identifier()] = prop;
             prop->setPropertyOwner(this);
+            invalidateHierarchy();
         }
     }
 }
@@ -324,17 +304,8 @@ void PropertyOwner::addPropertySubOwner(openspace::properties::PropertyOwner* ow
         "PropertyOwner must have an identifier"
     );
 
-    // See if we can find the name of the propertyowner to add using the lower bound
-    std::vector<PropertyOwner*>::const_iterator it = std::find_if(
-        _subOwners.begin(),
-        _subOwners.end(),
-        [identifier = owner->identifier()](PropertyOwner* o) {
-            return o->identifier() == identifier;
-        }
-    );
-
-    // If we found the propertyowner's name, we need to bail out
-    if (it != _subOwners.end() && (*it)->identifier() == owner->identifier()) {
+    // If we find the propertyowner's name, we need to bail out
+    if (hasPropertySubOwner(owner->identifier())) {
         LERROR(fmt::format(
             "PropertyOwner '{}' already present in PropertyOwner '{}'",
             owner->identifier(),
@@ -353,7 +324,9 @@ void PropertyOwner::addPropertySubOwner(openspace::properties::PropertyOwner* ow
         }
         else {
             _subOwners.push_back(owner);
+            _subOwnerIndex[owner->identifier()] = owner;
             owner->setPropertyOwner(this);
+            invalidateHierarchy();
         }
     }
 }
@@ -366,16 +339,15 @@ void PropertyOwner::removeProperty(Property* prop) {
     ghoul_precondition(prop != nullptr, "prop must not be nullptr");
 
     // See if we can find the identifier of the property to add in the properties list
-    std::vector<Property*>::const_iterator it = std::find_if(
-        _properties.begin(),
-        _properties.end(),
-        [id = prop->identifier()](Property* p) { return p->identifier() == id; }
-    );
+    const auto it = _propertyIndex.find(prop->identifier());
 
     // If we found the property identifier, we can delete it
-    if (it != _properties.end() && (*it)->identifier() == prop->identifier()) {
-        (*it)->setPropertyOwner(nullptr);
-        _properties.erase(it);
+    if (it != _propertyIndex.end()) {
+        Property* p = it->second;
+        p->setPropertyOwner(nullptr);
+        _properties.erase(std::find(_properties.begin(), _properties.end(), p));
+        _propertyIndex.erase(it);
+        invalidateHierarchy();
     }
     else {
         LERROR(fmt::format(
@@ -392,17 +364,13 @@ void PropertyOwner::removePropertySubOwner(openspace::properties::PropertyOwner*
     ghoul_precondition(owner != nullptr, "owner must not be nullptr");
 
     // See if we can find the name of the propertyowner to add
-    std::vector<PropertyOwner*>::const_iterator it = std::find_if(
-        _subOwners.begin(),
-        _subOwners.end(),
-        [identifier = owner->identifier()](PropertyOwner* o) {
-            return o->identifier() == identifier;
-        }
-    );
+    const auto it = _subOwnerIndex.find(owner->identifier());
 
     // If we found the propertyowner, we can delete it
-    if (it != _subOwners.end() && (*it)->identifier() == owner->identifier()) {
-        _subOwners.erase(it);
+    if (it != _subOwnerIndex.end()) {
+        _subOwners.erase(std::find(_subOwners.begin(), _subOwners.end(), it->second));
+        _subOwnerIndex.erase(it);
+        invalidateHierarchy();
     }
     else {
         LERROR(fmt::format(
@@ -425,7 +393,17 @@ void PropertyOwner::setIdentifier(std::string identifier) {
         "Identifier must contain any whitespaces"
     );
 
+    // The owner indexes its sub-owners by their identifier
+    if (_owner) {
+        const auto it = _owner->_subOwnerIndex.find(_identifier);
+        if (it != _owner->_subOwnerIndex.end() && it->second == this) {
+            _owner->_subOwnerIndex.erase(it);
+            _owner->_subOwnerIndex[identifier] = this;
+        }
+    }
+
     _identifier = std::move(identifier);
+    invalidateHierarchy();
 }
 
 const std::string& PropertyOwner::identifier() const {
@@ -454,10 +432,12 @@ const std::vector<std::string>& PropertyOwner::tags() const {
 
 void PropertyOwner::addTag(std::string tag) {
     _tags.push_back(std::move(tag));
+    invalidateHierarchy();
 }
 
 void PropertyOwner::removeTag(const std::string& tag) {
     _tags.erase(std::remove(_tags.begin(), _tags.end(), tag), _tags.end());
+    invalidateHierarchy();
 }
 
 std::string PropertyOwner::generateJson() const {
@@ -476,4 +456,12 @@ std::string PropertyOwner::generateJson() const {
     return std::string(res.begin(), res.end());
 }
 
+uint64_t PropertyOwner::hierarchyVersion() {
+    return HierarchyVersion;
+}
+
+void PropertyOwner::invalidateHierarchy() {
+    ++HierarchyVersion;
+}
+
 } // namespace openspace::properties
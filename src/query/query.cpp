@@ -26,8 +26,109 @@
 
 #include <openspace/engine/globals.h>
 #include <openspace/engine/virtualpropertymanager.h>
+#include <openspace/properties/property.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scene.h>
+#include <algorithm>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+    // The number of patterns whose matches are cached before the cache is reset
+    constexpr const size_t MaxCachedPatterns = 1024;
+
+    // A pattern in which '*' matches any sequence of characters. The pattern is split at
+    // the wildcards once, so that matching a string only requires a search for each of
+    // the literal pieces in between
+    struct WildcardPattern {
+        explicit WildcardPattern(std::string_view pattern) {
+            size_t begin = 0;
+            size_t end = pattern.find('*');
+            while (end != std::string_view::npos) {
+                pieces.emplace_back(pattern.substr(begin, end - begin));
+                begin = end + 1;
+                end = pattern.find('*', begin);
+            }
+            pieces.emplace_back(pattern.substr(begin));
+        }
+
+        // Returns whether a string that starts with the prefix can match the pattern
+        bool canMatchPrefix(std::string_view prefix) const {
+            const std::string& first = pieces.front();
+            const size_t n = std::min(prefix.size(), first.size());
+            return prefix.compare(0, n, first, 0, n) == 0;
+        }
+
+        bool matches(std::string_view s) const {
+            if (pieces.size() == 1) {
+                return s == pieces.front();
+            }
+
+            const std::string& first = pieces.front();
+            const std::string& last = pieces.back();
+            if (s.size() < first.size() + last.size() ||
+                s.compare(0, first.size(), first) != 0 ||
+                s.compare(s.size() - last.size(), last.size(), last) != 0)
+            {
+                return false;
+            }
+
+            // Finding the leftmost occurrence of each piece is sufficient as each piece
+            // is surrounded by wildcards
+            size_t pos = first.size();
+            const size_t end = s.size() - last.size();
+            for (size_t i = 1; i < pieces.size() - 1; ++i) {
+                pos = s.find(pieces[i], pos);
+                if (pos == std::string_view::npos || pos + pieces[i].size() > end) {
+                    return false;
+                }
+                pos += pieces[i].size();
+            }
+            return true;
+        }
+
+        std::vector<std::string> pieces;
+    };
+
+    void collectMatches(const openspace::properties::PropertyOwner& owner,
+                        const std::string& prefix, const WildcardPattern& pattern,
+                        const std::string& groupTag, bool hasGroupTag,
+                        std::vector<openspace::properties::Property*>& result)
+    {
+        using namespace openspace::properties;
+
+        const std::vector<std::string>& tags = owner.tags();
+        hasGroupTag = hasGroupTag ||
+            std::find(tags.begin(), tags.end(), groupTag) != tags.end();
+
+        if (groupTag.empty() || hasGroupTag) {
+            for (Property* p : owner.properties()) {
+                if (pattern.matches(prefix + p->identifier())) {
+                    result.push_back(p);
+                }
+            }
+        }
+
+        for (const PropertyOwner* o : owner.propertySubOwners()) {
+            // Owners without an identifier are not part of the URI, which is the same
+            // behavior as in Property::fullyQualifiedIdentifier
+            const std::string p = o->identifier().empty() ?
+                prefix :
+                prefix + o->identifier() + PropertyOwner::URISeparator;
+            if (pattern.canMatchPrefix(p)) {
+                collectMatches(*o, p, pattern, groupTag, hasGroupTag, result);
+            }
+        }
+    }
+
+    struct MatchCache {
+        std::mutex mutex;
+        uint64_t hierarchyVersion = 0;
+        std::unordered_map<std::string, std::vector<openspace::properties::Property*>>
+            matches;
+    };
+} // namespace
 
 namespace openspace {
 
@@ -71,4 +172,50 @@ std::vector<properties::Property*> allProperties() {
     return properties;
 }
 
+bool isWildcardPattern(const std::string& uri) {
+    return uri.find_first_of("[](){}+?^$|\\") == std::string::npos;
+}
+
+std::vector<properties::Property*> matchingProperties(const std::string& uriPattern,
+                                                      const std::string& groupTag)
+{
+    const WildcardPattern pattern(uriPattern);
+    if (pattern.pieces.size() == 1 && groupTag.empty()) {
+        // Without wildcards, the pattern is just a URI. The virtual property manager is
+        // not part of the rootProperty owner (see above) and has to be searched as well
+        std::vector<properties::Property*> result;
+        if (properties::Property* p = property(uriPattern)) {
+            result.push_back(p);
+        }
+        if (properties::Property* p = global::virtualPropertyManager.property(uriPattern))
+        {
+            result.push_back(p);
+        }
+        return result;
+    }
+
+    static MatchCache cache;
+    std::lock_guard lock(cache.mutex);
+    const uint64_t version = properties::PropertyOwner::hierarchyVersion();
+    if (cache.hierarchyVersion != version || cache.matches.size() >= MaxCachedPatterns) {
+        cache.matches.clear();
+        cache.hierarchyVersion = version;
+    }
+
+    // The group tag cannot contain a '.', so it can be used as separator in the key
+    const std::string key = groupTag + '.' + uriPattern;
+    const auto it = cache.matches.find(key);
+    if (it != cache.matches.end()) {
+        return it->second;
+    }
+
+    std::vector<properties::Property*> result;
+    collectMatches(global::rootPropertyOwner, "", pattern, groupTag, false, result);
+    // The virtual property manager is not part of the rootProperty owner (see above)
+    collectMatches(global::virtualPropertyManager, "", pattern, groupTag, false, result);
+
+    cache.matches[key] = result;
+    return result;
+}
+
 }  // namespace
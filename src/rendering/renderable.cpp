@@ -239,6 +239,10 @@ bool Renderable::shouldUpdateIfDisabled() const {
     return _shouldUpdateIfDisabled;
 }
 
+bool Renderable::requiresMainThreadUpdate() const {
+    return _requiresMainThreadUpdate;
+}
+
 void Renderable::onEnabledChange(std::function<void(bool)> callback) {
     _enabled.onChange([this, c = std::move(callback)]() {
         c(isEnabled());
@@ -30,6 +30,7 @@
 #include <ghoul/fmt.h>
 #include <ghoul/misc/misc.h>
 #include <ghoul/misc/profiling.h>
+#include <algorithm>
 
 #include "profile_lua.inl"
 
@@ -70,16 +71,21 @@ namespace {
     std::vector<properties::Property*> changedProperties(
                                                       const properties::PropertyOwner& po)
     {
-        std::vector<properties::Property*> res;
-        for (properties::PropertyOwner* subOwner : po.propertySubOwners()) {
-            std::vector<properties::Property*> ps = changedProperties(*subOwner);
-            res.insert(res.end(), ps.begin(), ps.end());
-        }
-        for (properties::Property* p : po.properties()) {
-            if (p->hasChanged()) {
-                res.push_back(p);
+        // Only the properties on the list of changed properties have to be considered
+        using properties::Property;
+        std::vector<Property*> res = Property::changedProperties();
+        auto it = std::remove_if(
+            res.begin(),
+            res.end(),
+            [&po](Property* p) {
+                const properties::PropertyOwner* owner = p->owner();
+                while (owner && owner != &po) {
+                    owner = owner->owner();
+                }
+                return owner == nullptr;
             }
-        }
+        );
+        res.erase(it, res.end());
         return res;
     }
 
@@ -34,10 +34,12 @@
 #include <openspace/scene/sceneinitializer.h>
 #include <openspace/scripting/lualibrary.h>
 #include <openspace/util/camera.h>
+#include <openspace/util/jobsystem.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/profiling.h>
+#include <condition_variable>
 #include <string>
 #include <stack>
 
@@ -48,6 +50,10 @@ namespace {
     constexpr const char* KeyIdentifier = "Identifier";
     constexpr const char* KeyParent = "Parent";
 
+    // Levels with fewer nodes than this are updated on the main thread as the overhead
+    // of distributing them would be larger than the gain
+    constexpr const size_t MinimumParallelLevelSize = 8;
+
     constexpr const char* renderBinToString(int renderBin) {
         // Synced with Renderable::RenderBin
         if (renderBin == 1) {
@@ -146,9 +152,156 @@ void Scene::updateNodeRegistry() {
     ZoneScoped
 
     sortTopologically();
+    if (_useParallelUpdate) {
+        computeUpdateLevels();
+    }
     _dirtyNodeRegistry = false;
 }
 
+void Scene::setParallelUpdate(bool enabled) {
+    _useParallelUpdate = enabled;
+    if (_useParallelUpdate) {
+        computeUpdateLevels();
+    }
+    else {
+        _updateLevels.clear();
+        _updateLevelTimings.clear();
+    }
+}
+
+const std::vector<Scene::UpdateLevelTiming>& Scene::updateLevelTimings() const {
+    return _updateLevelTimings;
+}
+
+void Scene::computeUpdateLevels() {
+    ZoneScoped
+
+    // As the nodes are sorted topologically, the parent and all dependencies of a node
+    // have already been assigned a level when the node is reached
+    std::unordered_map<const SceneGraphNode*, size_t> levels;
+    levels.reserve(_topologicallySortedNodes.size());
+    _updateLevels.clear();
+
+    for (SceneGraphNode* node : _topologicallySortedNodes) {
+        size_t level = 0;
+        if (node->parent()) {
+            const auto it = levels.find(node->parent());
+            if (it != levels.end()) {
+                level = it->second + 1;
+            }
+        }
+        for (const SceneGraphNode* dep : node->dependencies()) {
+            const auto it = levels.find(dep);
+            if (it != levels.end()) {
+                level = std::max(level, it->second + 1);
+            }
+        }
+        levels[node] = level;
+
+        if (level >= _updateLevels.size()) {
+            _updateLevels.resize(level + 1);
+        }
+        UpdateLevel& l = _updateLevels[level];
+        if (node->requiresMainThreadTransformUpdate()) {
+            l.mainThreadNodes.push_back(node);
+        }
+        else {
+            l.parallelNodes.push_back(node);
+        }
+        if (node->requiresMainThreadRenderableUpdate()) {
+            l.mainThreadRenderables.push_back(node);
+        }
+    }
+
+    _updateLevelTimings.resize(_updateLevels.size());
+}
+
+void Scene::updateParallel(const UpdateData& data) {
+    ZoneScoped
+
+    auto updateNode = [&data](SceneGraphNode* node) {
+        try {
+            node->updateTransform(data);
+            if (!node->requiresMainThreadRenderableUpdate()) {
+                node->updateRenderable(data);
+            }
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.what());
+        }
+    };
+
+    const size_t nThreads = global::jobSystem.numThreads();
+    for (size_t i = 0; i < _updateLevels.size(); ++i) {
+        ZoneScopedN("Level")
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        const UpdateLevel& level = _updateLevels[i];
+        const std::vector<SceneGraphNode*>& nodes = level.parallelNodes;
+
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+        size_t nOpenBatches = 0;
+
+        if (nodes.size() >= MinimumParallelLevelSize) {
+            // Two batches per thread give the work stealing some room for balancing
+            const size_t batchSize = std::max(
+                (nodes.size() + 2 * nThreads - 1) / (2 * nThreads),
+                MinimumParallelLevelSize / 2
+            );
+            nOpenBatches = (nodes.size() + batchSize - 1) / batchSize;
+
+            for (size_t b = 0; b < nodes.size(); b += batchSize) {
+                const size_t end = std::min(b + batchSize, nodes.size());
+                global::jobSystem.enqueue(
+                    [&, b, end]() {
+                        for (size_t j = b; j < end; ++j) {
+                            updateNode(nodes[j]);
+                        }
+                        std::lock_guard lock(doneMutex);
+                        --nOpenBatches;
+                        doneCondition.notify_one();
+                    },
+                    JobSystem::Priority::FrameCritical
+                );
+            }
+        }
+        else {
+            std::for_each(nodes.begin(), nodes.end(), updateNode);
+        }
+
+        {
+            std::unique_lock lock(doneMutex);
+            doneCondition.wait(lock, [&nOpenBatches]() { return nOpenBatches == 0; });
+        }
+
+        // The nodes that are bound to the main thread might read the state of other nodes
+        // of this level, for example the world position in a FixedRotation, so they are
+        // only updated after the workers have finished the level
+        std::for_each(
+            level.mainThreadNodes.begin(),
+            level.mainThreadNodes.end(),
+            updateNode
+        );
+
+        for (SceneGraphNode* node : level.mainThreadRenderables) {
+            try {
+                node->updateRenderable(data);
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LERRORC(e.component, e.what());
+            }
+        }
+
+        const auto end = std::chrono::high_resolution_clock::now();
+        UpdateLevelTiming& timing = _updateLevelTimings[i];
+        timing.nParallelNodes = nodes.size();
+        timing.nMainThreadNodes = level.mainThreadNodes.size();
+        timing.duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    }
+}
+
 void Scene::sortTopologically() {
     _topologicallySortedNodes.insert(
         _topologicallySortedNodes.end(),
@@ -314,6 +467,10 @@ void Scene::update(const UpdateData& data) {
     if (_dirtyNodeRegistry) {
         updateNodeRegistry();
     }
+    if (_useParallelUpdate) {
+        updateParallel(data);
+        return;
+    }
     for (SceneGraphNode* node : _topologicallySortedNodes) {
         try {
             node->update(data);
@@ -691,6 +848,18 @@ scripting::LuaLibrary Scene::luaLibrary() {
                 "Adds an interesting time to the current scene. The first argument is "
                 "the name of the time and the second argument is the time itself in the "
                 "format YYYY-MM-DDThh:mm:ss.uuu"
+            },
+            {
+                "sceneUpdateTimings",
+                &luascriptfunctions::sceneUpdateTimings,
+                {},
+                "",
+                "Returns the timings of the last parallel scene update as a list with "
+                "one table per level. Each table contains the number of nodes that were "
+                "updated in parallel ('ParallelNodes'), the number of nodes that had to "
+                "be updated on the main thread ('MainThreadNodes') and the time it took "
+                "to update the level in milliseconds ('Duration'). The list is empty if "
+                "the parallel scene update is disabled"
             }
         }
     };
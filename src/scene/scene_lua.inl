@@ -58,69 +58,48 @@ properties::PropertyOwner* findPropertyOwnerWithMatchingGroupTag(T* prop,
     return tagMatchOwner;
 }
 
-void applyRegularExpression(lua_State* L, const std::string& regex,
+void setPropertiesValue(lua_State* L, const std::string& uri,
     const std::vector<properties::Property*>& properties,
     double interpolationDuration,
-    const std::string& groupName,
     ghoul::EasingFunction easingFunction)
 {
     using ghoul::lua::errorLocation;
     using ghoul::lua::luaTypeToString;
 
-    const bool isGroupMode = !groupName.empty();
-
     const int type = lua_type(L, -1);
 
     // Stores whether we found at least one matching property. If this is false at the end
     // of the loop, the property name regex was probably misspelled.
     bool foundMatching = false;
-    std::regex r(regex);
     for (properties::Property* prop : properties) {
-        // Check the regular expression for all properties
-        const std::string& id = prop->fullyQualifiedIdentifier();
-
-        if (std::regex_match(id, r)) {
-            // If the fully qualified id matches the regular expression, we queue the
-            // value change if the types agree
-            if (isGroupMode) {
-                properties::PropertyOwner* matchingTaggedOwner =
-                    findPropertyOwnerWithMatchingGroupTag(
-                        prop,
-                        groupName
-                    );
-                if (!matchingTaggedOwner) {
-                    continue;
-                }
-            }
+        // We queue the value change if the types agree
+        if (type != prop->typeLua()) {
+            LERRORC(
+                "property_setValue",
+                fmt::format(
+                    "{}: Property '{}' does not accept input of type '{}'. "
+                    "Requested type: '{}'",
+                    errorLocation(L),
+                    prop->fullyQualifiedIdentifier(),
+                    luaTypeToString(type),
+                    luaTypeToString(prop->typeLua())
+                )
+            );
+        }
+        else {
+            foundMatching = true;
 
-            if (type != prop->typeLua()) {
-                LERRORC(
-                    "property_setValue",
-                    fmt::format(
-                        "{}: Property '{}' does not accept input of type '{}'. "
-                        "Requested type: '{}'",
-                        errorLocation(L),
-                        prop->fullyQualifiedIdentifier(),
-                        luaTypeToString(type),
-                        luaTypeToString(prop->typeLua())
-                    )
-                );
+            if (interpolationDuration == 0.0) {
+                global::renderEngine.scene()->removePropertyInterpolation(prop);
+                prop->setLuaValue(L);
             }
             else {
-                foundMatching = true;
-
-                if (interpolationDuration == 0.0) {
-                    global::renderEngine.scene()->removePropertyInterpolation(prop);
-                    prop->setLuaValue(L);
-                }
-                else {
-                    prop->setLuaInterpolationTarget(L);
-                    global::renderEngine.scene()->addPropertyInterpolation(
-                        prop,
-                        static_cast<float>(interpolationDuration),
-                        easingFunction
-                    );
-                }
+                prop->setLuaInterpolationTarget(L);
+                global::renderEngine.scene()->addPropertyInterpolation(
+                    prop,
+                    static_cast<float>(interpolationDuration),
+                    easingFunction
+                );
             }
         }
     }
@@ -131,12 +110,41 @@ void applyRegularExpression(lua_State* L, const std::string& regex,
             fmt::format(
                 "{}: No property matched the requested URI '{}'",
                 errorLocation(L),
-                regex
+                uri
             )
         );
     }
 }
 
+std::vector<properties::Property*> findRegularExpressionMatches(const std::string& regex,
+                                                           const std::string& groupName)
+{
+    const bool isGroupMode = !groupName.empty();
+
+    std::vector<properties::Property*> result;
+    std::regex r(regex);
+    for (properties::Property* prop : allProperties()) {
+        // Check the regular expression for all properties
+        const std::string& id = prop->fullyQualifiedIdentifier();
+
+        if (std::regex_match(id, r)) {
+            // Filter on the groupname if there was one
+            if (isGroupMode) {
+                properties::PropertyOwner* matchingTaggedOwner =
+                    findPropertyOwnerWithMatchingGroupTag(
+                        prop,
+                        groupName
+                    );
+                if (!matchingTaggedOwner) {
+                    continue;
+                }
+            }
+            result.push_back(prop);
+        }
+    }
+    return result;
+}
+
 // Checks to see if URI contains a group tag (with { } around the first term). If so,
 // returns true and sets groupName with the tag
 bool doesUriContainGroupTag(const std::string& command, std::string& groupName) {
@@ -150,16 +158,35 @@ bool doesUriContainGroupTag(const std::string& command, std::string& groupName)
     }
 }
 
-std::string replaceUriWithGroupName(std::string uri, std::string ownerName) {
-    size_t pos = uri.find_first_of(".");
-    return ownerName + "." + uri.substr(pos);
-}
-
 std::string extractUriWithoutGroupName(std::string uri) {
     size_t pos = uri.find_first_of(".");
     return uri.substr(pos);
 }
 
+// Returns the properties that match the uri, which can contain wildcards (*) and a group
+// tag. Wildcard patterns are resolved through the cached matchingProperties function,
+// other regular expressions are matched against all properties
+std::vector<properties::Property*> findUriMatches(std::string uri) {
+    std::string groupName;
+    if (doesUriContainGroupTag(uri, groupName)) {
+        // Remove group name from start of the uri and replace it with a wildcard
+        uri = "*" + extractUriWithoutGroupName(uri);
+    }
+
+    if (isWildcardPattern(uri)) {
+        return matchingProperties(uri, groupName);
+    }
+
+    // Replace all wildcards * with the correct regex (.*)
+    size_t startPos = uri.find("*");
+    while (startPos != std::string::npos) {
+        uri.replace(startPos, 1, "(.*)");
+        startPos += 4; // (.*)
+        startPos = uri.find("*", startPos);
+    }
+    return findRegularExpressionMatches(uri, groupName);
+}
+
 } // namespace
 } // namespace openspace
 
@@ -274,28 +301,12 @@ int property_setValue(lua_State* L) {
     }
 
     if (optimization.empty()) {
-        // Replace all wildcards * with the correct regex (.*)
-        size_t startPos = uriOrRegex.find("*");
-        while (startPos != std::string::npos) {
-            uriOrRegex.replace(startPos, 1, "(.*)");
-            startPos += 4; // (.*)
-            startPos = uriOrRegex.find("*", startPos);
-        }
-
-        std::string groupName;
-        if (doesUriContainGroupTag(uriOrRegex, groupName)) {
-            std::string pathRemainderToMatch = extractUriWithoutGroupName(uriOrRegex);
-            // Remove group name from start of regex and replace with '.*'
-            uriOrRegex = replaceUriWithGroupName(uriOrRegex, ".*");
-        }
-
         try {
-            applyRegularExpression(
+            setPropertiesValue(
                 L,
                 uriOrRegex,
-                allProperties(),
+                findUriMatches(uriOrRegex),
                 interpolationDuration,
-                groupName,
                 easingMethod
             );
         }
@@ -311,12 +322,11 @@ int property_setValue(lua_State* L) {
     }
     else if (optimization == "regex") {
         try {
-            applyRegularExpression(
+            setPropertiesValue(
                 L,
                 uriOrRegex,
-                allProperties(),
+                findRegularExpressionMatches(uriOrRegex, ""),
                 interpolationDuration,
-                "",
                 easingMethod
             );
         }
@@ -423,46 +433,10 @@ int property_getProperty(lua_State* L) {
     std::string regex = ghoul::lua::value<std::string>(L, 1);
     lua_pop(L, 1);
 
-    std::string groupName;
-    if (doesUriContainGroupTag(regex, groupName)) {
-        std::string pathRemainderToMatch = extractUriWithoutGroupName(regex);
-        // Remove group name from start of regex and replace with '.*'
-        regex = replaceUriWithGroupName(regex, ".*");
-    }
-
-    // Replace all wildcards * with the correct regex (.*)
-    size_t startPos = regex.find("*");
-    while (startPos != std::string::npos) {
-        regex.replace(startPos, 1, "(.*)");
-        startPos += 4; // (.*)
-        startPos = regex.find("*", startPos);
-    }
-
     // Get all matching property uris and save to res
-    std::regex r(regex);
-    std::vector<properties::Property*> props = allProperties();
     std::vector<std::string> res;
-    for (properties::Property* prop : props) {
-        // Check the regular expression for all properties
-        const std::string& id = prop->fullyQualifiedIdentifier();
-
-        if (std::regex_match(id, r)) {
-            // Filter on the groupname if there was one
-            if (!groupName.empty()) {
-                properties::PropertyOwner* matchingTaggedOwner =
-                    findPropertyOwnerWithMatchingGroupTag(
-                        prop,
-                        groupName
-                    );
-                if (!matchingTaggedOwner) {
-                    continue;
-                }
-                res.push_back(id);
-            }
-            else {
-                res.push_back(id);
-            }
-        }
+    for (properties::Property* prop : findUriMatches(regex)) {
+        res.push_back(prop->fullyQualifiedIdentifier());
     }
 
     lua_newtable(L);
@@ -653,4 +627,28 @@ int addInterestingTime(lua_State* L) {
     return 0;
 }
 
+int sceneUpdateTimings(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 0, "lua::sceneUpdateTimings");
+
+    const std::vector<Scene::UpdateLevelTiming>& timings =
+        global::renderEngine.scene()->updateLevelTimings();
+
+    lua_newtable(L);
+    int number = 1;
+    for (const Scene::UpdateLevelTiming& t : timings) {
+        lua_newtable(L);
+        ghoul::lua::push(L, "ParallelNodes", static_cast<int>(t.nParallelNodes));
+        lua_rawset(L, -3);
+        ghoul::lua::push(L, "MainThreadNodes", static_cast<int>(t.nMainThreadNodes));
+        lua_rawset(L, -3);
+        ghoul::lua::push(L, "Duration", t.duration.count() / 1000.0);
+        lua_rawset(L, -3);
+        lua_rawseti(L, -2, number);
+        ++number;
+    }
+
+    ghoul_assert(lua_gettop(L) == 1, "Incorrect number of items left on stack");
+    return 1;
+}
+
 }  // namespace openspace::luascriptfunctions
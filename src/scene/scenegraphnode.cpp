@@ -432,8 +432,13 @@ void SceneGraphNode::update(const UpdateData& data) {
     ZoneScoped
     ZoneName(identifier().c_str(), identifier().size())
 
+    updateTransform(data);
+    updateRenderable(data);
+}
+
+void SceneGraphNode::updateTransform(const UpdateData& data) {
     State s = _state;
-    if (s != State::Initialized && _state != State::GLInitialized) {
+    if (s != State::Initialized && s != State::GLInitialized) {
         return;
     }
     if (!isTimeFrameActive(data.time)) {
@@ -451,29 +456,33 @@ void SceneGraphNode::update(const UpdateData& data) {
     if (_transform.scale) {
         _transform.scale->update(data);
     }
-    UpdateData newUpdateData = data;
 
     // Assumes _worldRotationCached and _worldScaleCached have been calculated for parent
     _worldPositionCached = calculateWorldPosition();
     _worldRotationCached = calculateWorldRotation();
     _worldScaleCached = calculateWorldScale();
 
+    glm::dmat4 translation = glm::translate(glm::dmat4(1.0), _worldPositionCached);
+    glm::dmat4 rotation = glm::dmat4(_worldRotationCached);
+    glm::dmat4 scaling = glm::scale(glm::dmat4(1.0), _worldScaleCached);
+
+    _modelTransformCached = translation * rotation * scaling;
+}
+
+void SceneGraphNode::updateRenderable(const UpdateData& data) {
+    State s = _state;
+    if (s != State::Initialized && s != State::GLInitialized) {
+        return;
+    }
+    if (!isTimeFrameActive(data.time)) {
+        return;
+    }
+
+    UpdateData newUpdateData = data;
     newUpdateData.modelTransform.translation = _worldPositionCached;
     newUpdateData.modelTransform.rotation = _worldRotationCached;
     newUpdateData.modelTransform.scale = _worldScaleCached;
 
-    glm::dmat4 translation = glm::translate(
-        glm::dmat4(1.0),
-        newUpdateData.modelTransform.translation
-    );
-    glm::dmat4 rotation = glm::dmat4(newUpdateData.modelTransform.rotation);
-    glm::dmat4 scaling = glm::scale(
-        glm::dmat4(1.0),
-        newUpdateData.modelTransform.scale
-    );
-
-    _modelTransformCached = translation * rotation * scaling;
-
     if (_renderable && _renderable->isReady() &&
         (_renderable->isEnabled() || _renderable->shouldUpdateIfDisabled()))
     {
@@ -481,6 +490,16 @@ void SceneGraphNode::update(const UpdateData& data) {
     }
 }
 
+bool SceneGraphNode::requiresMainThreadTransformUpdate() const {
+    return (_transform.translation && _transform.translation->requiresMainThreadUpdate())
+        || (_transform.rotation && _transform.rotation->requiresMainThreadUpdate())
+        || (_transform.scale && _transform.scale->requiresMainThreadUpdate());
+}
+
+bool SceneGraphNode::requiresMainThreadRenderableUpdate() const {
+    return _renderable && _renderable->requiresMainThreadUpdate();
+}
+
 void SceneGraphNode::render(const RenderData& data, RendererTasks& tasks) {
     ZoneScoped
     ZoneName(identifier().c_str(), identifier().size())
@@ -96,6 +96,23 @@ void Translation::update(const UpdateData& data) {
     }
 }
 
+std::vector<glm::dvec3> Translation::positions(const std::vector<double>& times) const {
+    std::vector<glm::dvec3> result;
+    result.reserve(times.size());
+    for (double t : times) {
+        result.push_back(position({ {}, Time(t), Time(0.0) }));
+    }
+    return result;
+}
+
+Translation::PositionSampler Translation::positionSampler() const {
+    return [this](const std::vector<double>& times) { return positions(times); };
+}
+
+bool Translation::requiresMainThreadUpdate() const {
+    return false;
+}
+
 glm::dvec3 Translation::position() const {
     return _cachedPosition;
 }
@@ -0,0 +1,197 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/asyncfilewriter.h>
+
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+    // The background thread writes the buffer once this fraction of it is filled ...
+    constexpr const size_t FlushThresholdDivisor = 4;
+
+    // ... or after this time has passed, whichever comes first
+    constexpr const std::chrono::milliseconds FlushInterval(100);
+
+    // The time a blocked write waits before checking again for free space
+    constexpr const std::chrono::milliseconds BlockedWriteInterval(1);
+} // namespace
+
+namespace openspace {
+
+AsyncFileWriter::AsyncFileWriter(size_t bufferSize)
+    : _bufferSize(bufferSize)
+    , _buffer(std::make_unique<char[]>(bufferSize))
+{
+    ghoul_assert(bufferSize > 0, "Buffer size must be positive");
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    close();
+}
+
+bool AsyncFileWriter::open(const std::string& path, Binary binary) {
+    ghoul_precondition(!_isOpen, "File must not be open");
+
+    _file.open(path, binary ? std::ofstream::binary : std::ofstream::out);
+    if (!_file.is_open() || !_file.good()) {
+        _file.close();
+        return false;
+    }
+
+    _isOpen = true;
+    _hasFailed = false;
+    _shouldStop = false;
+    _head = 0;
+    _tail = 0;
+    _nDroppedWrites = 0;
+    _nBlockedWrites = 0;
+    _thread = std::thread([this]() { run(); });
+    return true;
+}
+
+bool AsyncFileWriter::write(const char* data, size_t size, DropIfFull drop) {
+    ghoul_precondition(_isOpen, "File must be open");
+
+    if (_bufferSize - nBufferedBytes() < size) {
+        if (drop) {
+            ++_nDroppedWrites;
+            return false;
+        }
+        ++_nBlockedWrites;
+    }
+
+    // Data that is larger than the free space is added in pieces while the background
+    // thread is writing the buffer
+    size_t head = _head.load(std::memory_order_relaxed);
+    while (size > 0) {
+        const size_t free = _bufferSize - (head - _tail.load(std::memory_order_acquire));
+        if (free == 0) {
+            _condition.notify_one();
+            std::this_thread::sleep_for(BlockedWriteInterval);
+            continue;
+        }
+
+        const size_t n = std::min(size, free);
+        const size_t position = head % _bufferSize;
+        const size_t first = std::min(n, _bufferSize - position);
+        std::memcpy(_buffer.get() + position, data, first);
+        std::memcpy(_buffer.get(), data + first, n - first);
+
+        head += n;
+        _head.store(head, std::memory_order_release);
+        data += n;
+        size -= n;
+    }
+
+    if (nBufferedBytes() >= _bufferSize / FlushThresholdDivisor) {
+        _condition.notify_one();
+    }
+    return true;
+}
+
+bool AsyncFileWriter::close() {
+    if (!_isOpen) {
+        return true;
+    }
+
+    {
+        std::lock_guard lock(_mutex);
+        _shouldStop = true;
+    }
+    _condition.notify_one();
+    // The background thread writes all remaining data before it finishes
+    _thread.join();
+
+    _file.close();
+    _isOpen = false;
+    return !_hasFailed && !_file.fail();
+}
+
+bool AsyncFileWriter::isOpen() const {
+    return _isOpen;
+}
+
+size_t AsyncFileWriter::nDroppedWrites() const {
+    return _nDroppedWrites;
+}
+
+size_t AsyncFileWriter::nBlockedWrites() const {
+    return _nBlockedWrites;
+}
+
+void AsyncFileWriter::run() {
+    while (true) {
+        bool shouldStop = false;
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait_for(
+                lock,
+                FlushInterval,
+                [this]() {
+                    return _shouldStop ||
+                        nBufferedBytes() >= _bufferSize / FlushThresholdDivisor;
+                }
+            );
+            shouldStop = _shouldStop;
+        }
+
+        flush();
+
+        if (shouldStop) {
+            // The producer does not add any more data once it has requested the stop, so
+            // the buffer is empty after this last flush
+            return;
+        }
+    }
+}
+
+void AsyncFileWriter::flush() {
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    const size_t head = _head.load(std::memory_order_acquire);
+    if (head == tail) {
+        return;
+    }
+
+    // The buffered data wraps around the end of the ring buffer at most once
+    const size_t n = head - tail;
+    const size_t position = tail % _bufferSize;
+    const size_t first = std::min(n, _bufferSize - position);
+    _file.write(_buffer.get() + position, first);
+    _file.write(_buffer.get(), n - first);
+    _file.flush();
+    if (_file.fail()) {
+        _hasFailed = true;
+    }
+
+    _tail.store(head, std::memory_order_release);
+}
+
+size_t AsyncFileWriter::nBufferedBytes() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+}
+
+} // namespace openspace
@@ -0,0 +1,266 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/jobsystem.h>
+
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+
+namespace {
+    // Identifies the JobSystem and the worker index of the current thread, so that jobs
+    // that are enqueued from within a job end up in the worker's own queue
+    thread_local const openspace::JobSystem* CurrentJobSystem = nullptr;
+    thread_local size_t CurrentWorkerIndex = 0;
+
+    constexpr const std::array<openspace::JobSystem::Priority, 3> Priorities = {
+        openspace::JobSystem::Priority::FrameCritical,
+        openspace::JobSystem::Priority::Prefetch,
+        openspace::JobSystem::Priority::Background
+    };
+} // namespace
+
+namespace openspace {
+
+JobSystem::JobSystem(size_t numThreads) {
+    if (numThreads == 0) {
+        const unsigned int hw = std::thread::hardware_concurrency();
+        numThreads = hw > 1 ? hw - 1 : 1;
+    }
+
+    _queues.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        _queues.push_back(std::make_unique<WorkerQueue>());
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard lock(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (std::thread& w : _workers) {
+        w.join();
+    }
+}
+
+void JobSystem::startWorkers() {
+    _workers.reserve(_queues.size());
+    for (size_t i = 0; i < _queues.size(); ++i) {
+        _workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+void JobSystem::enqueue(std::function<void()> job, Priority priority, Key key) {
+    std::call_once(_startFlag, [this]() { startWorkers(); });
+
+    const size_t index = CurrentJobSystem == this ?
+        CurrentWorkerIndex :
+        _nextQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+
+    // The counter is incremented before the job becomes visible so that it can never
+    // underflow when a worker picks up the job immediately
+    _nPendingJobs.fetch_add(1);
+    {
+        WorkerQueue& queue = *_queues[index];
+        std::lock_guard lock(queue.mutex);
+        queue.tasks[static_cast<int>(priority)].push_back({ std::move(job), key });
+    }
+
+    {
+        // Acquiring the lock here prevents a lost wakeup for a worker that has just
+        // checked the pending job count but not started waiting yet
+        std::lock_guard lock(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+}
+
+size_t JobSystem::cancel(Key key) {
+    ghoul_assert(key != NoKey, "Jobs without a key cannot be cancelled individually");
+
+    size_t nRemoved = 0;
+    for (const std::unique_ptr<WorkerQueue>& queue : _queues) {
+        std::lock_guard lock(queue->mutex);
+        for (std::deque<Task>& tasks : queue->tasks) {
+            const auto it = std::remove_if(
+                tasks.begin(),
+                tasks.end(),
+                [key](const Task& t) { return t.key == key; }
+            );
+            nRemoved += std::distance(it, tasks.end());
+            tasks.erase(it, tasks.end());
+        }
+    }
+    _nPendingJobs.fetch_sub(nRemoved);
+    return nRemoved;
+}
+
+size_t JobSystem::clear() {
+    size_t nRemoved = 0;
+    for (const std::unique_ptr<WorkerQueue>& queue : _queues) {
+        std::lock_guard lock(queue->mutex);
+        for (std::deque<Task>& tasks : queue->tasks) {
+            nRemoved += tasks.size();
+            tasks.clear();
+        }
+    }
+    _nPendingJobs.fetch_sub(nRemoved);
+    return nRemoved;
+}
+
+void JobSystem::parallelFor(size_t nTasks, std::function<void(size_t)> task,
+                            Priority priority)
+{
+    const size_t nThreads = std::min(numThreads(), nTasks);
+    if (nThreads < 2) {
+        for (size_t i = 0; i < nTasks; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    // The state is shared with the jobs as a job might only be started after this
+    // function has returned, in which case it will find no task left to execute
+    struct State {
+        std::function<void(size_t)> task;
+        size_t nTasks;
+        std::atomic<size_t> nextTask = 0;
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t nFinishedTasks = 0;
+    };
+    auto state = std::make_shared<State>();
+    state->task = std::move(task);
+    state->nTasks = nTasks;
+
+    auto executeTasks = [state]() {
+        while (true) {
+            const size_t i = state->nextTask++;
+            if (i >= state->nTasks) {
+                return;
+            }
+            state->task(i);
+
+            std::lock_guard lock(state->mutex);
+            ++state->nFinishedTasks;
+            state->condition.notify_one();
+        }
+    };
+
+    for (size_t i = 0; i < nThreads - 1; ++i) {
+        enqueue(executeTasks, priority);
+    }
+    executeTasks();
+
+    std::unique_lock lock(state->mutex);
+    state->condition.wait(
+        lock,
+        [&state]() { return state->nFinishedTasks == state->nTasks; }
+    );
+}
+
+JobSystem::Key JobSystem::createKey() {
+    return _nextKey.fetch_add(1);
+}
+
+size_t JobSystem::numThreads() const {
+    return _queues.size();
+}
+
+size_t JobSystem::numPendingJobs() const {
+    return _nPendingJobs;
+}
+
+bool JobSystem::popTask(size_t index, Priority priority, Task& task) {
+    const int p = static_cast<int>(priority);
+
+    // The worker's own queue is worked on in FIFO order to keep the submission order of
+    // external producers. Thieves take from the back so that they are less likely to
+    // contend with the owner for the same cache lines
+    {
+        WorkerQueue& own = *_queues[index];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks[p].empty()) {
+            task = std::move(own.tasks[p].front());
+            own.tasks[p].pop_front();
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < _queues.size(); ++i) {
+        WorkerQueue& victim = *_queues[(index + i) % _queues.size()];
+        std::unique_lock lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            // Someone else is already working on this queue, so try the next one. We
+            // will come back here if none of the other queues have a job for us
+            continue;
+        }
+        if (!victim.tasks[p].empty()) {
+            task = std::move(victim.tasks[p].back());
+            victim.tasks[p].pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::workerLoop(size_t index) {
+    CurrentJobSystem = this;
+    CurrentWorkerIndex = index;
+
+    while (true) {
+        Task task;
+        bool hasTask = false;
+        for (Priority p : Priorities) {
+            if (popTask(index, p, task)) {
+                hasTask = true;
+                break;
+            }
+        }
+
+        if (hasTask) {
+            _nPendingJobs.fetch_sub(1);
+            task.function();
+            continue;
+        }
+
+        std::unique_lock lock(_sleepMutex);
+        if (_stop) {
+            return;
+        }
+        if (_nPendingJobs > 0) {
+            // There are jobs, but we failed to get one as some queues were locked
+            lock.unlock();
+            std::this_thread::yield();
+            continue;
+        }
+        _sleepCondition.wait(lock, [this]() { return _stop || _nPendingJobs > 0; });
+        if (_stop) {
+            return;
+        }
+    }
+}
+
+} // namespace openspace
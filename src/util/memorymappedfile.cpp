@@ -0,0 +1,181 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/memorymappedfile.h>
+
+#include <algorithm>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else // WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace openspace {
+
+MemoryMappedFile::MemoryMappedFile(const std::string& path, AccessPattern pattern) {
+#ifdef WIN32
+    const DWORD flags = pattern == AccessPattern::Random ?
+        FILE_FLAG_RANDOM_ACCESS :
+        FILE_FLAG_SEQUENTIAL_SCAN;
+    HANDLE file = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        // Other handles may write into the file while it is mapped
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr,
+        OPEN_EXISTING,
+        flags,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    _fileHandle = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        unmap();
+        return;
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size == 0) {
+        // Empty files cannot be mapped
+        _isOpen = true;
+        return;
+    }
+
+    _mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!_mappingHandle) {
+        unmap();
+        return;
+    }
+    _data = reinterpret_cast<const char*>(
+        MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0)
+    );
+#else // WIN32
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file == -1) {
+        return;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0) {
+        close(file);
+        return;
+    }
+    _size = static_cast<size_t>(info.st_size);
+    if (_size == 0) {
+        // Empty files cannot be mapped
+        close(file);
+        _isOpen = true;
+        return;
+    }
+
+    void* data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, file, 0);
+    // The mapping keeps its own reference to the file
+    close(file);
+    if (data != MAP_FAILED) {
+        _data = reinterpret_cast<const char*>(data);
+        madvise(
+            data,
+            _size,
+            pattern == AccessPattern::Random ? MADV_RANDOM : MADV_SEQUENTIAL
+        );
+    }
+#endif // WIN32
+
+    if (!_data) {
+        unmap();
+        return;
+    }
+    _isOpen = true;
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+    unmap();
+}
+
+bool MemoryMappedFile::isOpen() const {
+    return _isOpen;
+}
+
+const char* MemoryMappedFile::data() const {
+    return _data;
+}
+
+size_t MemoryMappedFile::size() const {
+    return _size;
+}
+
+void MemoryMappedFile::release(size_t offset, size_t size) const {
+#ifdef WIN32
+    // Pages of a read-only file mapping are never dirty, so Windows can reuse them
+    // without any additional work and there is no need to remove them explicitly
+    (void)offset;
+    (void)size;
+#else // WIN32
+    if (!_data || offset >= _size) {
+        return;
+    }
+
+    // Only release pages that are fully covered by the range, as the pages at the
+    // borders might still be used by someone else
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = (offset + pageSize - 1) / pageSize * pageSize;
+    const size_t end = std::min(offset + size, _size) / pageSize * pageSize;
+    if (begin < end) {
+        madvise(const_cast<char*>(_data) + begin, end - begin, MADV_DONTNEED);
+    }
+#endif // WIN32
+}
+
+void MemoryMappedFile::unmap() {
+#ifdef WIN32
+    if (_data) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mappingHandle) {
+        CloseHandle(_mappingHandle);
+        _mappingHandle = nullptr;
+    }
+    if (_fileHandle) {
+        CloseHandle(_fileHandle);
+        _fileHandle = nullptr;
+    }
+#else // WIN32
+    if (_data) {
+        munmap(const_cast<char*>(_data), _size);
+    }
+#endif // WIN32
+    _data = nullptr;
+    _size = 0;
+    _isOpen = false;
+}
+
+} // namespace openspace
@@ -0,0 +1,352 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/speckfile.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/util/jobsystem.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+    // Files smaller than this are parsed on the calling thread as the overhead of
+    // distributing the work would outweigh the gain
+    constexpr const size_t MinimumParallelSize = 4 * 1024 * 1024;
+
+    // The powers of ten that are exactly representable as a double
+    constexpr const std::array<double, 23> PowersOfTen = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+        1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    // The number of decimal digits that always fit into the mantissa accumulator
+    constexpr const int MaxMantissaDigits = 19;
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    std::string_view nextToken(std::string_view& line) {
+        size_t begin = 0;
+        while (begin < line.size() && isSpace(line[begin])) {
+            ++begin;
+        }
+        size_t end = begin;
+        while (end < line.size() && !isSpace(line[end])) {
+            ++end;
+        }
+        std::string_view token = line.substr(begin, end - begin);
+        line.remove_prefix(end);
+        return token;
+    }
+
+    int parseInt(std::string_view token) {
+        int value = 0;
+        std::from_chars(token.data(), token.data() + token.size(), value);
+        return value;
+    }
+
+    // Parses a decimal floating point number of the form [+-]digits[.digits][e[+-]digits]
+    // that has to span the entire token. std::from_chars would do the same, but is not
+    // available for floating point numbers on all of our compilers yet
+    bool parseFloat(std::string_view token, float& value) {
+        const char* p = token.data();
+        const char* end = p + token.size();
+
+        bool isNegative = false;
+        if (p != end && (*p == '-' || *p == '+')) {
+            isNegative = *p == '-';
+            ++p;
+        }
+
+        uint64_t mantissa = 0;
+        int nDigits = 0;
+        int exponent = 0;
+        bool hasDigits = false;
+        while (p != end && isDigit(*p)) {
+            hasDigits = true;
+            if (nDigits < MaxMantissaDigits) {
+                mantissa = mantissa * 10 + (*p - '0');
+                nDigits += (mantissa != 0) ? 1 : 0;
+            }
+            else {
+                // Digits beyond the precision of the accumulator only scale the value
+                ++exponent;
+            }
+            ++p;
+        }
+        if (p != end && *p == '.') {
+            ++p;
+            while (p != end && isDigit(*p)) {
+                hasDigits = true;
+                if (nDigits < MaxMantissaDigits) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    nDigits += (mantissa != 0) ? 1 : 0;
+                    --exponent;
+                }
+                ++p;
+            }
+        }
+        if (!hasDigits) {
+            return false;
+        }
+
+        if (p != end && (*p == 'e' || *p == 'E')) {
+            ++p;
+            bool isExponentNegative = false;
+            if (p != end && (*p == '-' || *p == '+')) {
+                isExponentNegative = *p == '-';
+                ++p;
+            }
+            if (p == end || !isDigit(*p)) {
+                return false;
+            }
+            int e = 0;
+            while (p != end && isDigit(*p)) {
+                // Larger exponents are out of range for a float anyway
+                if (e < 10000) {
+                    e = e * 10 + (*p - '0');
+                }
+                ++p;
+            }
+            exponent += isExponentNegative ? -e : e;
+        }
+        if (p != end) {
+            return false;
+        }
+
+        double result = static_cast<double>(mantissa);
+        if (mantissa != 0 && exponent != 0) {
+            if (exponent > 0 && exponent < static_cast<int>(PowersOfTen.size())) {
+                result *= PowersOfTen[exponent];
+            }
+            else if (exponent < 0 && -exponent < static_cast<int>(PowersOfTen.size())) {
+                result /= PowersOfTen[-exponent];
+            }
+            else {
+                result *= std::pow(10.0, exponent);
+            }
+        }
+        value = static_cast<float>(isNegative ? -result : result);
+        return true;
+    }
+
+    void parseLines(std::string_view text, int nValuesPerObject, std::vector<float>& data)
+    {
+        while (!text.empty()) {
+            const size_t remaining = text.size();
+            std::string_view line = openspace::speck::nextLine(text);
+            size_t begin = 0;
+            while (begin < line.size() && isSpace(line[begin])) {
+                ++begin;
+            }
+            if (begin == line.size() || line[begin] == '#') {
+                continue;
+            }
+
+            if (data.empty()) {
+                // The lines of a file have a similar length, so the first data line
+                // gives a good estimate for the total number of values
+                data.reserve((remaining / (line.size() + 1) + 1) * nValuesPerObject);
+            }
+
+            const size_t offset = data.size();
+            data.resize(offset + nValuesPerObject, 0.f);
+            openspace::speck::parseNumbers(line, data.data() + offset, nValuesPerObject);
+        }
+    }
+} // namespace
+
+namespace openspace {
+
+SpeckFile::SpeckFile(const std::string& path)
+    : _file(path, MemoryMappedFile::AccessPattern::Sequential)
+{
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    // The beginning of the speck file has a header that either contains comments
+    // (signaled by a preceding '#') or information about the structure of the file
+    // (signaled by the keywords 'datavar', 'texturevar', 'texture', 'polyorivar', and
+    // 'maxcomment'). The data starts with the first line that is neither
+    std::string_view text(_file.data(), _file.size());
+    while (!text.empty()) {
+        const size_t lineOffset = _file.size() - text.size();
+        std::string_view line = speck::nextLine(text);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::string_view command = nextToken(line);
+        if (command == "datavar") {
+            // datavar lines are structured as follows:  datavar # description
+            Variable variable;
+            variable.index = parseInt(nextToken(line));
+            variable.name = std::string(nextToken(line));
+            _variables.push_back(std::move(variable));
+        }
+        else if (command == "texturevar") {
+            _textureVariable = parseInt(nextToken(line));
+        }
+        else if (command == "polyorivar") {
+            _polygonOrientationVariable = parseInt(nextToken(line));
+        }
+        else if (command == "texture") {
+            // texture lines are structured as follows:  texture [-options] # filename
+            std::string_view token = nextToken(line);
+            while (!token.empty() && token[0] == '-') {
+                token = nextToken(line);
+            }
+            Texture texture;
+            texture.index = parseInt(token);
+            texture.file = std::string(nextToken(line));
+            _textures.push_back(std::move(texture));
+        }
+        else if (command != "maxcomment") {
+            _dataOffset = lineOffset;
+            return;
+        }
+    }
+    _dataOffset = _file.size();
+}
+
+bool SpeckFile::isOpen() const {
+    return _file.isOpen();
+}
+
+const std::vector<SpeckFile::Variable>& SpeckFile::variables() const {
+    return _variables;
+}
+
+const std::vector<SpeckFile::Texture>& SpeckFile::textures() const {
+    return _textures;
+}
+
+int SpeckFile::textureVariable() const {
+    return _textureVariable;
+}
+
+int SpeckFile::polygonOrientationVariable() const {
+    return _polygonOrientationVariable;
+}
+
+int SpeckFile::nValuesPerObject() const {
+    int nValues = 0;
+    for (const Variable& v : _variables) {
+        nValues = std::max(nValues, v.index + 1);
+    }
+    // X Y Z are not counted in the Speck file indices
+    return nValues + 3;
+}
+
+std::vector<float> SpeckFile::readData(int nValuesPerObject, bool useThreads) const {
+    std::vector<float> result;
+    const std::string_view data = dataSection();
+    if (nValuesPerObject <= 0 || data.empty()) {
+        return result;
+    }
+
+    const size_t nThreads = global::jobSystem.numThreads();
+    if (!useThreads || nThreads < 2 || data.size() < MinimumParallelSize) {
+        parseLines(data, nValuesPerObject, result);
+        return result;
+    }
+
+    // Two chunks per thread give the work stealing some room for balancing. The chunks
+    // are split at line boundaries so that every line is parsed by exactly one job
+    const size_t nChunks = 2 * nThreads;
+    const size_t chunkSize = data.size() / nChunks;
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    while (begin < data.size()) {
+        size_t end = std::min(begin + chunkSize, data.size());
+        end = data.find('\n', end);
+        end = (end == std::string_view::npos) ? data.size() : end + 1;
+        chunks.push_back(data.substr(begin, end - begin));
+        begin = end;
+    }
+    std::vector<std::vector<float>> results(chunks.size());
+
+    // The calling thread takes part in the parsing, so this function can safely be
+    // called from a job itself
+    global::jobSystem.parallelFor(
+        chunks.size(),
+        [&chunks, &results, nValuesPerObject](size_t i) {
+            parseLines(chunks[i], nValuesPerObject, results[i]);
+        }
+    );
+
+    size_t nValues = 0;
+    for (const std::vector<float>& r : results) {
+        nValues += r.size();
+    }
+    result.reserve(nValues);
+    for (const std::vector<float>& r : results) {
+        result.insert(result.end(), r.begin(), r.end());
+    }
+    return result;
+}
+
+std::string_view SpeckFile::dataSection() const {
+    if (!_file.data()) {
+        return std::string_view();
+    }
+    return std::string_view(_file.data() + _dataOffset, _file.size() - _dataOffset);
+}
+
+namespace speck {
+
+std::string_view nextLine(std::string_view& text) {
+    const size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+    // Guard against wrong line endings (copying files from Windows to Mac)
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+size_t parseNumbers(std::string_view line, float* values, size_t nValues) {
+    for (size_t i = 0; i < nValues; ++i) {
+        const std::string_view token = nextToken(line);
+        if (token.empty() || !parseFloat(token, values[i])) {
+            return i;
+        }
+    }
+    return nValues;
+}
+
+} // namespace speck
+
+} // namespace openspace
@@ -24,7 +24,9 @@
 
 #include <openspace/util/spicemanager.h>
 
+#include <openspace/engine/globals.h>
 #include <openspace/scripting/lualibrary.h>
+#include <openspace/util/jobsystem.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/filesystem/file.h>
@@ -32,6 +34,8 @@
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/profiling.h>
 #include <algorithm>
+#include <cmath>
+#include <functional>
 #include "SpiceUsr.h"
 #include "SpiceZpr.h"
 
@@ -43,6 +47,84 @@ namespace {
     // as the maximum message length
     constexpr const unsigned SpiceErrorBufferSize = 1841;
 
+    // The interpolation segments are aligned to a grid of powers of two seconds, which
+    // guarantees that two segments of the same interpolation never overlap
+    constexpr const double MaximumSegmentLength = 262144.0; // 2^18 s, about 3 days
+    constexpr const double MinimumSegmentLength = 1.0;
+
+    // If an interpolation accumulates more segments than this, for example because a
+    // long time range was swept with a low tolerance, its segments are discarded
+    constexpr const size_t MaximumSegmentsPerInterpolation = 65536;
+
+    // Evaluates the cubic Hermite polynomial through (p0, v0) at t0 and (p1, v1) at t1
+    // at the time t and returns its derivative in the velocity parameter
+    glm::dvec3 hermite(double t0, const glm::dvec3& p0, const glm::dvec3& v0, double t1,
+                       const glm::dvec3& p1, const glm::dvec3& v1, double t,
+                       glm::dvec3& velocity)
+    {
+        const double h = t1 - t0;
+        const double s = (t - t0) / h;
+        const double s2 = s * s;
+        const double s3 = s2 * s;
+
+        velocity = (6.0 * s2 - 6.0 * s) / h * (p0 - p1) +
+            (3.0 * s2 - 4.0 * s + 1.0) * v0 + (3.0 * s2 - 2.0 * s) * v1;
+        return (2.0 * s3 - 3.0 * s2 + 1.0) * p0 + (s3 - 2.0 * s2 + s) * h * v0 +
+            (-2.0 * s3 + 3.0 * s2) * p1 + (s3 - s2) * h * v1;
+    }
+
+    // Returns the constant angular velocity with which the spherical interpolation
+    // rotates from q0 to q1 in the time h
+    glm::dvec3 slerpAngularVelocity(const glm::dquat& q0, const glm::dquat& q1, double h)
+    {
+        glm::dquat delta = q1 * glm::inverse(q0);
+        if (delta.w < 0.0) {
+            delta = -delta;
+        }
+        const double angle = 2.0 * std::acos(std::min(delta.w, 1.0));
+        if (angle == 0.0) {
+            return glm::dvec3(0.0);
+        }
+        return glm::axis(delta) * angle / h;
+    }
+
+    double angleBetween(const glm::dquat& q0, const glm::dquat& q1) {
+        const double d = std::abs(glm::dot(q0, q1));
+        return 2.0 * std::acos(std::min(d, 1.0));
+    }
+
+    // Merges the interval [begin, end] into the coverage, which stores the sorted and
+    // disjoint intervals of an object as a flat list of their start and end times
+    void addCoverage(std::vector<double>& coverage, double begin, double end) {
+        // All intervals that overlap with or touch the new interval are replaced by their
+        // union. 'first' is the first time that is not before 'begin' and 'last' the
+        // first time that is after 'end'
+        auto first = std::lower_bound(coverage.begin(), coverage.end(), begin);
+        auto last = std::upper_bound(first, coverage.end(), end);
+
+        // An odd index means that the time lies inside of an existing interval, whose
+        // start or end has to be kept instead of the new value
+        const bool beginInside = (first - coverage.begin()) % 2 == 1;
+        const bool endInside = (last - coverage.begin()) % 2 == 1;
+
+        std::vector<double> replacement;
+        if (!beginInside) {
+            replacement.push_back(begin);
+        }
+        if (!endInside) {
+            replacement.push_back(end);
+        }
+        const auto it = coverage.erase(first, last);
+        coverage.insert(it, replacement.begin(), replacement.end());
+    }
+
+    // Returns whether the time lies strictly inside one of the intervals of the coverage
+    bool isCovered(const std::vector<double>& coverage, double et) {
+        const auto it = std::lower_bound(coverage.begin(), coverage.end(), et);
+        const bool isInside = (it - coverage.begin()) % 2 == 1;
+        return (it != coverage.end()) && isInside && (*it != et);
+    }
+
     const char* toString(openspace::SpiceManager::FieldOfViewMethod m) {
         using SM = openspace::SpiceManager;
         switch (m) {
@@ -155,6 +237,14 @@ SpiceManager::SpiceManager() {
 }
 
 SpiceManager::~SpiceManager() {
+    {
+        // Batches that have not been started are dropped, which breaks the promises of
+        // their futures, but a batch that is currently executing has to finish first
+        std::unique_lock lock(_requestMutex);
+        _requests.clear();
+        _requestCondition.wait(lock, [this]() { return !_isProcessingRequests; });
+    }
+
     for (const KernelInformation& i : _loadedKernels) {
         unload_c(i.path.c_str());
     }
@@ -210,6 +300,8 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
         )
     );
 
+    std::lock_guard lock(_mutex);
+
     std::string path = absPath(std::move(filePath));
     const auto it = std::find_if(
         _loadedKernels.begin(),
@@ -255,6 +347,9 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
         findSpkCoverage(path); // binary spk kernel
     }
 
+    // The kernel might provide new data for bodies or frames that are already cached
+    clearInterpolationCache();
+
     KernelHandle kernelId = ++_lastAssignedKernel;
     ghoul_assert(kernelId != 0, fmt::format("Kernel Handle wrapped around to 0"));
     _loadedKernels.push_back({std::move(path), kernelId, 1});
@@ -265,6 +360,8 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
     ghoul_assert(kernelId <= _lastAssignedKernel, "Invalid unassigned kernel");
     ghoul_assert(kernelId != KernelHandle(0), "Invalid zero handle");
 
+    std::lock_guard lock(_mutex);
+
     const auto it = std::find_if(
         _loadedKernels.begin(),
         _loadedKernels.end(),
@@ -278,6 +375,7 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
             LINFO(fmt::format("Unloading SPICE kernel '{}'", it->path));
             unload_c(it->path.c_str());
             _loadedKernels.erase(it);
+            clearInterpolationCache();
         }
         // Otherwise, we hold on to it, but reduce the reference counter by 1
         else {
@@ -290,6 +388,8 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
 void SpiceManager::unloadKernel(std::string filePath) {
     ghoul_assert(!filePath.empty(), "Empty filename");
 
+    std::lock_guard lock(_mutex);
+
     std::string path = absPath(std::move(filePath));
 
     const auto it = std::find_if(
@@ -314,6 +414,7 @@ void SpiceManager::unloadKernel(std::string filePath) {
             LINFO(fmt::format("Unloading SPICE kernel '{}'", path));
             unload_c(path.c_str());
             _loadedKernels.erase(it);
+            clearInterpolationCache();
         }
         else {
             // Otherwise, we hold on to it, but reduce the reference counter by 1
@@ -326,36 +427,32 @@ void SpiceManager::unloadKernel(std::string filePath) {
 bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
     ghoul_assert(!target.empty(), "Empty target");
 
-    const int id = naifId(target);
-    const auto it = _spkIntervals.find(id);
-    if (it != _spkIntervals.end()) {
-        const std::vector<std::pair<double, double>>& intervalVector = it->second;
-        for (const std::pair<double, double>& vecElement : intervalVector) {
-            if ((vecElement.first < et) && (vecElement.second > et)) {
-                return true;
-            }
-        }
-    }
-    return false;
+    return hasSpkCoverage(naifId(target), et);
+}
+
+bool SpiceManager::hasSpkCoverage(int id, double et) const {
+    std::lock_guard lock(_mutex);
+
+    const auto it = _spkCoverage.find(id);
+    return (it != _spkCoverage.end()) && isCovered(it->second, et);
 }
 
 bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
     ghoul_assert(!frame.empty(), "Empty target");
 
-    const int id = frameId(frame);
-    const auto it = _ckIntervals.find(id);
-    if (it != _ckIntervals.end()) {
-        const std::vector<std::pair<double, double>>& intervalVector = it->second;
-        for (const std::pair<double, double>& i : intervalVector) {
-            if ((i.first < et) && (i.second > et)) {
-                return true;
-            }
-        }
-    }
-    return false;
+    return hasCkCoverage(frameId(frame), et);
+}
+
+bool SpiceManager::hasCkCoverage(int id, double et) const {
+    std::lock_guard lock(_mutex);
+
+    const auto it = _ckCoverage.find(id);
+    return (it != _ckCoverage.end()) && isCovered(it->second, et);
 }
 
 bool SpiceManager::hasValue(int naifId, const std::string& item) const {
+    std::lock_guard lock(_mutex);
+
     return bodfnd_c(naifId, item.c_str());
 }
 
@@ -370,18 +467,30 @@ bool SpiceManager::hasValue(const std::string& body, const std::string& item) co
 int SpiceManager::naifId(const std::string& body) const {
     ghoul_assert(!body.empty(), "Empty body");
 
+    std::lock_guard lock(_mutex);
+
+    const auto it = _naifIds.find(body);
+    if (it != _naifIds.end()) {
+        return it->second;
+    }
+
     SpiceBoolean success;
     SpiceInt id;
     bods2c_c(body.c_str(), &id, &success);
     if (!success && _useExceptions) {
         throw SpiceException(fmt::format("Could not find NAIF ID of body '{}'", body));
     }
+    if (success) {
+        _naifIds[body] = id;
+    }
     return id;
 }
 
 bool SpiceManager::hasNaifId(const std::string& body) const {
     ghoul_assert(!body.empty(), "Empty body");
 
+    std::lock_guard lock(_mutex);
+
     SpiceBoolean success;
     SpiceInt id;
     bods2c_c(body.c_str(), &id, &success);
@@ -392,22 +501,88 @@ bool SpiceManager::hasNaifId(const std::string& body) const {
 int SpiceManager::frameId(const std::string& frame) const {
     ghoul_assert(!frame.empty(), "Empty frame");
 
+    std::lock_guard lock(_mutex);
+
+    const auto it = _frameIds.find(frame);
+    if (it != _frameIds.end()) {
+        return it->second;
+    }
+
     SpiceInt id;
     namfrm_c(frame.c_str(), &id);
     if (id == 0 && _useExceptions) {
         throw SpiceException(fmt::format("Could not find NAIF ID of frame '{}'", frame));
     }
+    if (id != 0) {
+        _frameIds[frame] = id;
+    }
     return id;
 }
 
 bool SpiceManager::hasFrameId(const std::string& frame) const {
     ghoul_assert(!frame.empty(), "Empty frame");
 
+    std::lock_guard lock(_mutex);
+
     SpiceInt id;
     namfrm_c(frame.c_str(), &id);
     return id != 0;
 }
 
+SpiceManager::NaifObject SpiceManager::body(const std::string& body) const {
+    std::lock_guard lock(_mutex);
+
+    NaifObject result;
+    result.name = body;
+    if (body.empty()) {
+        return result;
+    }
+
+    const auto it = _naifIds.find(body);
+    if (it != _naifIds.end()) {
+        result.id = it->second;
+        result.isResolved = true;
+        return result;
+    }
+
+    SpiceBoolean success;
+    SpiceInt id;
+    bods2c_c(body.c_str(), &id, &success);
+    reset_c();
+    if (success) {
+        _naifIds[body] = id;
+        result.id = id;
+        result.isResolved = true;
+    }
+    return result;
+}
+
+SpiceManager::NaifObject SpiceManager::frame(const std::string& frame) const {
+    std::lock_guard lock(_mutex);
+
+    NaifObject result;
+    result.name = frame;
+    if (frame.empty()) {
+        return result;
+    }
+
+    const auto it = _frameIds.find(frame);
+    if (it != _frameIds.end()) {
+        result.id = it->second;
+        result.isResolved = true;
+        return result;
+    }
+
+    SpiceInt id;
+    namfrm_c(frame.c_str(), &id);
+    if (id != 0) {
+        _frameIds[frame] = id;
+        result.id = id;
+        result.isResolved = true;
+    }
+    return result;
+}
+
 void getValueInternal(const std::string& body, const std::string& value, int size,
                       double* v)
 {
@@ -428,24 +603,32 @@ void getValueInternal(const std::string& body, const std::string& value, int siz
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             double& v) const
 {
+    std::lock_guard lock(_mutex);
+
     getValueInternal(body, value, 1, &v);
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec2& v) const
 {
+    std::lock_guard lock(_mutex);
+
     getValueInternal(body, value, 2, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec3& v) const
 {
+    std::lock_guard lock(_mutex);
+
     getValueInternal(body, value, 3, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec4& v) const
 {
+    std::lock_guard lock(_mutex);
+
     getValueInternal(body, value, 4, glm::value_ptr(v));
 }
 
@@ -454,12 +637,16 @@ void SpiceManager::getValue(const std::string& body, const std::string& value,
 {
     ghoul_assert(!v.empty(), "Array for values has to be preallocaed");
 
+    std::lock_guard lock(_mutex);
+
     getValueInternal(body, value, static_cast<int>(v.size()), v.data());
 }
 
 double SpiceManager::spacecraftClockToET(const std::string& craft, double craftTicks) {
     ghoul_assert(!craft.empty(), "Empty craft");
 
+    std::lock_guard lock(_mutex);
+
     int craftId = naifId(craft);
     double et;
     sct2e_c(craftId, craftTicks, &et);
@@ -478,6 +665,8 @@ double SpiceManager::ephemerisTimeFromDate(const std::string& timeString) const
 }
 
 double SpiceManager::ephemerisTimeFromDate(const char* timeString) const {
+    std::lock_guard lock(_mutex);
+
     double et;
     str2et_c(timeString, &et);
     if (failed_c()) {
@@ -496,8 +685,52 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
     ghoul_assert(!observer.empty(), "Observer is not empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
 
-    bool targetHasCoverage = hasSpkCoverage(target, ephemerisTime);
-    bool observerHasCoverage = hasSpkCoverage(observer, ephemerisTime);
+    return computeTargetPosition(
+        target,
+        naifId(target),
+        observer,
+        naifId(observer),
+        referenceFrame,
+        aberrationCorrection,
+        ephemerisTime,
+        lightTime
+    );
+}
+
+glm::dvec3 SpiceManager::targetPosition(const NaifObject& target,
+                                        const NaifObject& observer,
+                                        const NaifObject& referenceFrame,
+                                        AberrationCorrection aberrationCorrection,
+                                        double ephemerisTime, double& lightTime) const
+{
+    ghoul_assert(!target.name.empty(), "Target is not empty");
+    ghoul_assert(!observer.name.empty(), "Observer is not empty");
+    ghoul_assert(!referenceFrame.name.empty(), "Reference frame is not empty");
+
+    return computeTargetPosition(
+        target.name,
+        target.isResolved ? target.id : naifId(target.name),
+        observer.name,
+        observer.isResolved ? observer.id : naifId(observer.name),
+        referenceFrame.name,
+        aberrationCorrection,
+        ephemerisTime,
+        lightTime
+    );
+}
+
+glm::dvec3 SpiceManager::computeTargetPosition(const std::string& target, int targetId,
+                                               const std::string& observer,
+                                               int observerId,
+                                               const std::string& referenceFrame,
+                                               AberrationCorrection aberrationCorrection,
+                                               double ephemerisTime,
+                                               double& lightTime) const
+{
+    std::lock_guard lock(_mutex);
+
+    const bool targetHasCoverage = hasSpkCoverage(targetId, ephemerisTime);
+    const bool observerHasCoverage = hasSpkCoverage(observerId, ephemerisTime);
     if (!targetHasCoverage && !observerHasCoverage) {
         if (_useExceptions) {
             throw SpiceException(
@@ -578,6 +811,8 @@ glm::dmat3 SpiceManager::frameTransformationMatrix(const std::string& from,
     ghoul_assert(!from.empty(), "From must not be empty");
     ghoul_assert(!to.empty(), "To must not be empty");
 
+    std::lock_guard lock(_mutex);
+
     // get rotation matrix from frame A - frame B
     glm::dmat3 transform;
     pxform_c(
@@ -616,6 +851,8 @@ SpiceManager::SurfaceInterceptResult SpiceManager::surfaceIntercept(
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
     ghoul_assert(directionVector != glm::dvec3(0.0), "Direction vector must not be zero");
 
+    std::lock_guard lock(_mutex);
+
     const std::string ComputationMethod = "ELLIPSOID";
 
     SurfaceInterceptResult result;
@@ -647,6 +884,33 @@ SpiceManager::SurfaceInterceptResult SpiceManager::surfaceIntercept(
     return result;
 }
 
+std::vector<SpiceManager::SurfaceInterceptResult> SpiceManager::surfaceIntercepts(
+                                                                const std::string& target,
+                                                              const std::string& observer,
+                                                              const std::string& fovFrame,
+                                                        const std::string& referenceFrame,
+                                                AberrationCorrection aberrationCorrection,
+                                                                     double ephemerisTime,
+                                    const std::vector<glm::dvec3>& directionVectors) const
+{
+    std::lock_guard lock(_mutex);
+
+    std::vector<SurfaceInterceptResult> result;
+    result.reserve(directionVectors.size());
+    for (const glm::dvec3& directionVector : directionVectors) {
+        result.push_back(surfaceIntercept(
+            target,
+            observer,
+            fovFrame,
+            referenceFrame,
+            aberrationCorrection,
+            ephemerisTime,
+            directionVector
+        ));
+    }
+    return result;
+}
+
 bool SpiceManager::isTargetInFieldOfView(const std::string& target,
                                          const std::string& observer,
                                          const std::string& referenceFrame,
@@ -661,6 +925,8 @@ bool SpiceManager::isTargetInFieldOfView(const std::string& target,
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
     ghoul_assert(!instrument.empty(), "Instrument must not be empty");
 
+    std::lock_guard lock(_mutex);
+
     int visible;
     fovtrg_c(instrument.c_str(),
         target.c_str(),
@@ -692,6 +958,8 @@ SpiceManager::TargetStateResult SpiceManager::targetState(const std::string& tar
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
 
+    std::lock_guard lock(_mutex);
+
     TargetStateResult result;
     result.lightTime = 0.0;
 
@@ -728,6 +996,8 @@ SpiceManager::TransformMatrix SpiceManager::stateTransformMatrix(
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "toFrame must not be empty");
 
+    std::lock_guard lock(_mutex);
+
     TransformMatrix m;
     sxform_c(
         sourceFrame.c_str(),
@@ -752,6 +1022,8 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
+    std::lock_guard lock(_mutex);
+
     glm::dmat3 result;
     pxform_c(
         sourceFrame.c_str(),
@@ -784,6 +1056,8 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
+    std::lock_guard lock(_mutex);
+
     glm::dmat3 result;
 
     pxfrm2_c(
@@ -803,6 +1077,503 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
     return glm::transpose(result);
 }
 
+glm::dvec3 SpiceManager::interpolatedTargetPosition(
+                                                                const std::string& target,
+                                                              const std::string& observer,
+                                                        const std::string& referenceFrame,
+                                                AberrationCorrection aberrationCorrection,
+                                                                     double ephemerisTime,
+                                                                         double tolerance,
+                                                                  double& lightTime) const
+{
+    ghoul_assert(!target.empty(), "Target is not empty");
+    ghoul_assert(!observer.empty(), "Observer is not empty");
+    ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
+
+    return computeInterpolatedTargetPosition(
+        target,
+        naifId(target),
+        observer,
+        naifId(observer),
+        referenceFrame,
+        frameId(referenceFrame),
+        aberrationCorrection,
+        ephemerisTime,
+        tolerance,
+        lightTime
+    );
+}
+
+glm::dvec3 SpiceManager::interpolatedTargetPosition(const NaifObject& target,
+                                                    const NaifObject& observer,
+                                                    const NaifObject& referenceFrame,
+                                                AberrationCorrection aberrationCorrection,
+                                                    double ephemerisTime,
+                                                    double tolerance,
+                                                    double& lightTime) const
+{
+    ghoul_assert(!target.name.empty(), "Target is not empty");
+    ghoul_assert(!observer.name.empty(), "Observer is not empty");
+    ghoul_assert(!referenceFrame.name.empty(), "Reference frame is not empty");
+
+    return computeInterpolatedTargetPosition(
+        target.name,
+        target.isResolved ? target.id : naifId(target.name),
+        observer.name,
+        observer.isResolved ? observer.id : naifId(observer.name),
+        referenceFrame.name,
+        referenceFrame.isResolved ? referenceFrame.id : frameId(referenceFrame.name),
+        aberrationCorrection,
+        ephemerisTime,
+        tolerance,
+        lightTime
+    );
+}
+
+glm::dvec3 SpiceManager::computeInterpolatedTargetPosition(const std::string& target,
+                                                           int targetId,
+                                                           const std::string& observer,
+                                                           int observerId,
+                                                        const std::string& referenceFrame,
+                                                           int referenceFrameId,
+                                                AberrationCorrection aberrationCorrection,
+                                                           double ephemerisTime,
+                                                           double tolerance,
+                                                           double& lightTime) const
+{
+    std::lock_guard lock(_mutex);
+
+    if (tolerance <= 0.0) {
+        return computeTargetPosition(
+            target,
+            targetId,
+            observer,
+            observerId,
+            referenceFrame,
+            aberrationCorrection,
+            ephemerisTime,
+            lightTime
+        );
+    }
+
+    const InterpolationKey key = {
+        targetId,
+        observerId,
+        referenceFrameId,
+        static_cast<int>(aberrationCorrection.type) * 2 +
+            static_cast<int>(aberrationCorrection.direction),
+        tolerance
+    };
+    Segments<PositionSample>& segments = _positionSegments[key];
+
+    auto evaluate = [ephemerisTime, &lightTime](const PositionSample& p0,
+                                                const PositionSample& p1)
+    {
+        const double s = (ephemerisTime - p0.time) / (p1.time - p0.time);
+        lightTime = p0.lightTime + s * (p1.lightTime - p0.lightTime);
+        glm::dvec3 velocity;
+        return hermite(
+            p0.time, p0.position, p0.velocity,
+            p1.time, p1.position, p1.velocity,
+            ephemerisTime,
+            velocity
+        );
+    };
+
+    auto it = segments.upper_bound(ephemerisTime);
+    if (it != segments.begin()) {
+        --it;
+        const auto& [p0, p1] = it->second;
+        if (ephemerisTime <= p1.time) {
+            return evaluate(p0, p1);
+        }
+    }
+
+    // Find the largest segment of the grid that contains the requested time and that is
+    // precise enough by repeatedly halving the segment
+    const double start = std::floor(ephemerisTime / MaximumSegmentLength) *
+        MaximumSegmentLength;
+    PositionSample p0;
+    PositionSample p1;
+    bool success =
+        samplePosition(key, referenceFrame, aberrationCorrection, start, p0) &&
+        samplePosition(
+            key,
+            referenceFrame,
+            aberrationCorrection,
+            start + MaximumSegmentLength,
+            p1
+        );
+    while (success) {
+        const double center = (p0.time + p1.time) / 2.0;
+        PositionSample pc;
+        if (!samplePosition(key, referenceFrame, aberrationCorrection, center, pc)) {
+            break;
+        }
+
+        glm::dvec3 velocity;
+        const glm::dvec3 position = hermite(
+            p0.time, p0.position, p0.velocity,
+            p1.time, p1.position, p1.velocity,
+            center,
+            velocity
+        );
+        // The velocity error is included as it catches segments whose length is a
+        // multiple of an orbital period, for which the position error vanishes
+        const double length = p1.time - p0.time;
+        const double error = std::max(
+            glm::distance(position, pc.position),
+            glm::distance(velocity, pc.velocity) * length / 4.0
+        );
+        if (error <= tolerance) {
+            if (segments.size() >= MaximumSegmentsPerInterpolation) {
+                segments.clear();
+            }
+            segments[p0.time] = { p0, p1 };
+            return evaluate(p0, p1);
+        }
+
+        if (length <= MinimumSegmentLength) {
+            break;
+        }
+        if (ephemerisTime < center) {
+            p1 = pc;
+        }
+        else {
+            p0 = pc;
+        }
+    }
+
+    // There is no sufficiently precise segment, so we have to ask SPICE directly
+    return computeTargetPosition(
+        target,
+        targetId,
+        observer,
+        observerId,
+        referenceFrame,
+        aberrationCorrection,
+        ephemerisTime,
+        lightTime
+    );
+}
+
+glm::dmat3 SpiceManager::interpolatedPositionTransformMatrix(
+                                                           const std::string& sourceFrame,
+                                                      const std::string& destinationFrame,
+                                                                     double ephemerisTime,
+                                                                   double tolerance) const
+{
+    ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
+    ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
+
+    return computeInterpolatedTransformMatrix(
+        sourceFrame,
+        frameId(sourceFrame),
+        destinationFrame,
+        frameId(destinationFrame),
+        ephemerisTime,
+        tolerance
+    );
+}
+
+glm::dmat3 SpiceManager::interpolatedPositionTransformMatrix(
+                                                            const NaifObject& sourceFrame,
+                                                       const NaifObject& destinationFrame,
+                                                                     double ephemerisTime,
+                                                                   double tolerance) const
+{
+    ghoul_assert(!sourceFrame.name.empty(), "sourceFrame must not be empty");
+    ghoul_assert(!destinationFrame.name.empty(), "destinationFrame must not be empty");
+
+    return computeInterpolatedTransformMatrix(
+        sourceFrame.name,
+        sourceFrame.isResolved ? sourceFrame.id : frameId(sourceFrame.name),
+        destinationFrame.name,
+        destinationFrame.isResolved ?
+            destinationFrame.id :
+            frameId(destinationFrame.name),
+        ephemerisTime,
+        tolerance
+    );
+}
+
+glm::dmat3 SpiceManager::computeInterpolatedTransformMatrix(
+                                                           const std::string& sourceFrame,
+                                                                        int sourceFrameId,
+                                                      const std::string& destinationFrame,
+                                                                   int destinationFrameId,
+                                                                     double ephemerisTime,
+                                                                   double tolerance) const
+{
+    std::lock_guard lock(_mutex);
+
+    if (tolerance <= 0.0) {
+        return positionTransformMatrix(sourceFrame, destinationFrame, ephemerisTime);
+    }
+
+    const InterpolationKey key = {
+        sourceFrameId,
+        destinationFrameId,
+        0,
+        0,
+        tolerance
+    };
+    Segments<RotationSample>& segments = _rotationSegments[key];
+
+    auto evaluate = [ephemerisTime](const RotationSample& r0, const RotationSample& r1) {
+        const double s = (ephemerisTime - r0.time) / (r1.time - r0.time);
+        return glm::mat3_cast(glm::slerp(r0.rotation, r1.rotation, s));
+    };
+
+    auto it = segments.upper_bound(ephemerisTime);
+    if (it != segments.begin()) {
+        --it;
+        const auto& [r0, r1] = it->second;
+        if (ephemerisTime <= r1.time) {
+            return evaluate(r0, r1);
+        }
+    }
+
+    const double start = std::floor(ephemerisTime / MaximumSegmentLength) *
+        MaximumSegmentLength;
+    RotationSample r0;
+    RotationSample r1;
+    bool success = sampleRotation(sourceFrame, destinationFrame, start, r0) &&
+        sampleRotation(sourceFrame, destinationFrame, start + MaximumSegmentLength, r1);
+    while (success) {
+        const double center = (r0.time + r1.time) / 2.0;
+        RotationSample rc;
+        if (!sampleRotation(sourceFrame, destinationFrame, center, rc)) {
+            break;
+        }
+
+        // Just as for the positions, the angular velocity error catches segments whose
+        // length is a multiple of the rotation period
+        const double length = r1.time - r0.time;
+        const glm::dquat rotation = glm::slerp(r0.rotation, r1.rotation, 0.5);
+        const glm::dvec3 angularVelocity = slerpAngularVelocity(
+            r0.rotation,
+            r1.rotation,
+            length
+        );
+        const double error = std::max(
+            angleBetween(rotation, rc.rotation),
+            glm::distance(angularVelocity, rc.angularVelocity) * length / 4.0
+        );
+        if (error <= tolerance) {
+            if (segments.size() >= MaximumSegmentsPerInterpolation) {
+                segments.clear();
+            }
+            segments[r0.time] = { r0, r1 };
+            return evaluate(r0, r1);
+        }
+
+        if (length <= MinimumSegmentLength) {
+            break;
+        }
+        if (ephemerisTime < center) {
+            r1 = rc;
+        }
+        else {
+            r0 = rc;
+        }
+    }
+
+    return positionTransformMatrix(sourceFrame, destinationFrame, ephemerisTime);
+}
+
+void SpiceManager::clearInterpolationCache() {
+    std::lock_guard lock(_mutex);
+
+    _naifIds.clear();
+    _frameIds.clear();
+    _positionSegments.clear();
+    _rotationSegments.clear();
+}
+
+std::vector<glm::dvec3> SpiceManager::targetPositions(const PositionBatch& batch) const {
+    ghoul_assert(!batch.target.name.empty(), "Target is not empty");
+    ghoul_assert(!batch.observer.name.empty(), "Observer is not empty");
+    ghoul_assert(!batch.referenceFrame.name.empty(), "Reference frame is not empty");
+
+    std::lock_guard lock(_mutex);
+
+    std::vector<glm::dvec3> result;
+    result.reserve(batch.times.size());
+    for (double t : batch.times) {
+        double lightTime = 0.0;
+        result.push_back(interpolatedTargetPosition(
+            batch.target,
+            batch.observer,
+            batch.referenceFrame,
+            batch.aberrationCorrection,
+            t,
+            batch.tolerance,
+            lightTime
+        ));
+    }
+    return result;
+}
+
+std::vector<glm::dmat3> SpiceManager::positionTransformMatrices(
+                                                        const TransformBatch& batch) const
+{
+    ghoul_assert(!batch.sourceFrame.name.empty(), "sourceFrame must not be empty");
+    ghoul_assert(
+        !batch.destinationFrame.name.empty(),
+        "destinationFrame must not be empty"
+    );
+
+    std::lock_guard lock(_mutex);
+
+    std::vector<glm::dmat3> result;
+    result.reserve(batch.times.size());
+    for (double t : batch.times) {
+        result.push_back(interpolatedPositionTransformMatrix(
+            batch.sourceFrame,
+            batch.destinationFrame,
+            t,
+            batch.tolerance
+        ));
+    }
+    return result;
+}
+
+std::future<std::vector<glm::dvec3>> SpiceManager::submit(PositionBatch batch) const {
+    auto promise = std::make_shared<std::promise<std::vector<glm::dvec3>>>();
+    std::future<std::vector<glm::dvec3>> future = promise->get_future();
+    enqueueRequest([this, promise, b = std::move(batch)]() {
+        try {
+            promise->set_value(targetPositions(b));
+        }
+        catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+
+std::future<std::vector<glm::dmat3>> SpiceManager::submit(TransformBatch batch) const {
+    auto promise = std::make_shared<std::promise<std::vector<glm::dmat3>>>();
+    std::future<std::vector<glm::dmat3>> future = promise->get_future();
+    enqueueRequest([this, promise, b = std::move(batch)]() {
+        try {
+            promise->set_value(positionTransformMatrices(b));
+        }
+        catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+
+void SpiceManager::enqueueRequest(std::function<void()> request) const {
+    std::lock_guard lock(_requestMutex);
+    _requests.push_back(std::move(request));
+    if (!_isProcessingRequests) {
+        // As all CSPICE calls are serialized anyway, a single job works through all
+        // submitted batches instead of occupying one worker per batch
+        _isProcessingRequests = true;
+        global::jobSystem.enqueue(
+            [this]() { processRequests(); },
+            JobSystem::Priority::FrameCritical
+        );
+    }
+}
+
+void SpiceManager::processRequests() const {
+    while (true) {
+        std::function<void()> request;
+        {
+            std::lock_guard lock(_requestMutex);
+            if (_requests.empty()) {
+                _isProcessingRequests = false;
+                _requestCondition.notify_all();
+                return;
+            }
+            request = std::move(_requests.front());
+            _requests.pop_front();
+        }
+        request();
+    }
+}
+
+bool SpiceManager::InterpolationKey::operator==(const InterpolationKey& rhs) const {
+    return source == rhs.source && destination == rhs.destination &&
+        frame == rhs.frame && aberrationCorrection == rhs.aberrationCorrection &&
+        tolerance == rhs.tolerance;
+}
+
+size_t SpiceManager::InterpolationKeyHash::operator()(const InterpolationKey& key) const
+{
+    size_t hash = std::hash<double>()(key.tolerance);
+    for (int v : { key.source, key.destination, key.frame, key.aberrationCorrection }) {
+        hash ^= std::hash<int>()(v) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+bool SpiceManager::samplePosition(const InterpolationKey& key,
+                                  const std::string& referenceFrame,
+                                  AberrationCorrection aberrationCorrection, double et,
+                                  PositionSample& sample) const
+{
+    if (!hasSpkCoverage(key.source, et) || !hasSpkCoverage(key.destination, et)) {
+        return false;
+    }
+
+    std::array<double, 6> state;
+    spkez_c(
+        key.source,
+        et,
+        referenceFrame.c_str(),
+        aberrationCorrection,
+        key.destination,
+        state.data(),
+        &sample.lightTime
+    );
+    if (failed_c()) {
+        reset_c();
+        return false;
+    }
+
+    sample.time = et;
+    sample.position = glm::dvec3(state[0], state[1], state[2]);
+    sample.velocity = glm::dvec3(state[3], state[4], state[5]);
+    return true;
+}
+
+bool SpiceManager::sampleRotation(const std::string& sourceFrame,
+                                  const std::string& destinationFrame, double et,
+                                  RotationSample& sample) const
+{
+    double transform[6][6];
+    sxform_c(sourceFrame.c_str(), destinationFrame.c_str(), et, transform);
+    if (failed_c()) {
+        reset_c();
+        return false;
+    }
+
+    // The state transformation consists of the rotation in the upper left and its
+    // derivative in the lower left block, both in row-major order
+    glm::dmat3 rotation;
+    glm::dmat3 derivative;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            rotation[j][i] = transform[i][j];
+            derivative[j][i] = transform[i + 3][j];
+        }
+    }
+
+    // The derivative is the cross product with the angular velocity applied to the
+    // rotation, so we can extract the angular velocity from the skew-symmetric matrix
+    const glm::dmat3 w = derivative * glm::transpose(rotation);
+    sample.time = et;
+    sample.rotation = glm::quat_cast(rotation);
+    sample.angularVelocity = glm::dvec3(w[1][2], w[2][0], w[0][1]);
+    return true;
+}
+
 SpiceManager::FieldOfViewResult
 SpiceManager::fieldOfView(const std::string& instrument) const
 {
@@ -811,6 +1582,8 @@ SpiceManager::fieldOfView(const std::string& instrument) const
 }
 
 SpiceManager::FieldOfViewResult SpiceManager::fieldOfView(int instrument) const {
+    std::lock_guard lock(_mutex);
+
     constexpr int MaxBoundsSize = 64;
     constexpr int BufferSize = 128;
 
@@ -872,6 +1645,8 @@ SpiceManager::TerminatorEllipseResult SpiceManager::terminatorEllipse(
     ghoul_assert(!lightSource.empty(), "Light source must not be empty");
     ghoul_assert(numberOfTerminatorPoints >= 1, "Terminator points must be >= 1");
 
+    std::lock_guard lock(_mutex);
+
     TerminatorEllipseResult res;
 
     // Warning: This assumes std::vector<glm::dvec3> to have all values memory contiguous
@@ -949,9 +1724,7 @@ void SpiceManager::findCkCoverage(const std::string& path) {
                 throwSpiceError("Error finding Ck Coverage");
             }
 
-            _ckCoverageTimes[frame].insert(e);
-            _ckCoverageTimes[frame].insert(b);
-            _ckIntervals[frame].emplace_back(b, e);
+            addCoverage(_ckCoverage[frame], b, e);
         }
     }
 }
@@ -1005,10 +1778,7 @@ void SpiceManager::findSpkCoverage(const std::string& path) {
                 throwSpiceError("Error finding Spk coverage");
             }
 
-            // insert all into coverage time set, the windows could be merged @AA
-            _spkCoverageTimes[obj].insert(e);
-            _spkCoverageTimes[obj].insert(b);
-            _spkIntervals[obj].emplace_back(b, e);
+            addCoverage(_spkCoverage[obj], b, e);
         }
     }
 }
@@ -1034,7 +1804,8 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
         return glm::dvec3(0.0);
     }
 
-    if (_spkCoverageTimes.find(targetId) == _spkCoverageTimes.end()) {
+    const auto coverageIt = _spkCoverage.find(targetId);
+    if (coverageIt == _spkCoverage.end()) {
         if (_useExceptions) {
             // no coverage
             throw SpiceException(fmt::format("No position for '{}' at any time", target));
@@ -1044,14 +1815,20 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
         }
     }
 
-    const std::set<double>& coveredTimes = _spkCoverageTimes.find(targetId)->second;
+    const Coverage& coveredTimes = coverageIt->second;
+    const auto lower = std::lower_bound(
+        coveredTimes.begin(),
+        coveredTimes.end(),
+        ephemerisTime
+    );
+    const auto upper = std::upper_bound(lower, coveredTimes.end(), ephemerisTime);
 
     glm::dvec3 pos = glm::dvec3(0.0);
-    if (coveredTimes.lower_bound(ephemerisTime) == coveredTimes.begin()) {
+    if (lower == coveredTimes.begin()) {
         // coverage later, fetch first position
         spkpos_c(
             target.c_str(),
-            *(coveredTimes.begin()),
+            coveredTimes.front(),
             referenceFrame.c_str(),
             aberrationCorrection,
             observer.c_str(),
@@ -1066,11 +1843,11 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
         }
 
     }
-    else if (coveredTimes.upper_bound(ephemerisTime) == coveredTimes.end()) {
+    else if (upper == coveredTimes.end()) {
         // coverage earlier, fetch last position
         spkpos_c(
             target.c_str(),
-            *(coveredTimes.rbegin()),
+            coveredTimes.back(),
             referenceFrame.c_str(),
             aberrationCorrection,
             observer.c_str(),
@@ -1088,7 +1865,7 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
         // coverage both earlier and later, interpolate these positions
         glm::dvec3 posEarlier = glm::dvec3(0.0);
         double ltEarlier;
-        double timeEarlier = *std::prev((coveredTimes.lower_bound(ephemerisTime)));
+        double timeEarlier = *std::prev(lower);
         spkpos_c(
             target.c_str(),
             timeEarlier,
@@ -1101,7 +1878,7 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
 
         glm::dvec3 posLater = glm::dvec3(0.0);
         double ltLater;
-        double timeLater = *(coveredTimes.upper_bound(ephemerisTime));
+        double timeLater = *upper;
         spkpos_c(
             target.c_str(),
             timeLater,
@@ -1135,7 +1912,8 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
     glm::dmat3 result = glm::dmat3(1.0);
     const int idFrame = frameId(fromFrame);
 
-    if (_ckCoverageTimes.find(idFrame) == _ckCoverageTimes.end()) {
+    const auto coverageIt = _ckCoverage.find(idFrame);
+    if (coverageIt == _ckCoverage.end()) {
         if (_useExceptions) {
             // no coverage
             throw SpiceException(fmt::format(
@@ -1148,14 +1926,16 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
         }
     }
 
-    std::set<double> coveredTimes = _ckCoverageTimes.find(idFrame)->second;
+    const Coverage& coveredTimes = coverageIt->second;
+    const auto lower = std::lower_bound(coveredTimes.begin(), coveredTimes.end(), time);
+    const auto upper = std::upper_bound(lower, coveredTimes.end(), time);
 
-    if (coveredTimes.lower_bound(time) == coveredTimes.begin()) {
+    if (lower == coveredTimes.begin()) {
         // coverage later, fetch first transform
         pxform_c(
             fromFrame.c_str(),
             toFrame.c_str(),
-            *(coveredTimes.begin()),
+            coveredTimes.front(),
             reinterpret_cast<double(*)[3]>(glm::value_ptr(result))
         );
         if (failed_c()) {
@@ -1165,12 +1945,12 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
             ));
         }
     }
-    else if (coveredTimes.upper_bound(time) == coveredTimes.end()) {
+    else if (upper == coveredTimes.end()) {
         // coverage earlier, fetch last transform
         pxform_c(
             fromFrame.c_str(),
             toFrame.c_str(),
-            *(coveredTimes.rbegin()),
+            coveredTimes.back(),
             reinterpret_cast<double(*)[3]>(glm::value_ptr(result))
         );
         if (failed_c()) {
@@ -1182,8 +1962,8 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
     }
     else {
         // coverage both earlier and later, interpolate these transformations
-        double earlier = *std::prev((coveredTimes.lower_bound(time)));
-        double later = *(coveredTimes.upper_bound(time));
+        double earlier = *std::prev(lower);
+        double later = *upper;
 
         glm::dmat3 earlierTransform = glm::dmat3(1.0);
         pxform_c(
@@ -25,6 +25,8 @@
 #include <openspace/util/syncbuffer.h>
 
 #include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <cstring>
 
 namespace openspace {
 
@@ -32,6 +34,8 @@ SyncBuffer::SyncBuffer(size_t n)
     : _n(n)
 {
     _dataStream.resize(_n);
+    _decodeData = _dataStream.data();
+    _decodeSize = _dataStream.size();
 }
 
 SyncBuffer::~SyncBuffer() {} // NOLINT
@@ -39,48 +43,59 @@ SyncBuffer::~SyncBuffer() {} // NOLINT
 void SyncBuffer::encode(const std::string& s) {
     ZoneScoped
 
-    int32_t anticpatedBufferSize = static_cast<int32_t>(
-        _encodeOffset + (sizeof(char) * s.size()) + sizeof(int32_t)
-    );
-    if (anticpatedBufferSize >= _n) {
-        _dataStream.resize(anticpatedBufferSize);
+    encodeVarint(s.size());
+    if (!s.empty()) {
+        memcpy(encodeSpace(s.size()), s.data(), s.size());
     }
+}
 
-    int32_t length = static_cast<int32_t>(s.size() * sizeof(char));
-    memcpy(
-        _dataStream.data() + _encodeOffset,
-        reinterpret_cast<const char*>(&length),
-        sizeof(int32_t)
-    );
-    _encodeOffset += sizeof(int32_t);
-    memcpy(_dataStream.data() + _encodeOffset, s.c_str(), length);
-    _encodeOffset += length;
+void SyncBuffer::encodeVarint(uint64_t value) {
+    // A 64 bit value requires at most 10 bytes with 7 bits each
+    std::byte* data = encodeSpace(10);
+    size_t size = 0;
+    while (value >= 0x80) {
+        data[size++] = static_cast<std::byte>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    data[size++] = static_cast<std::byte>(value);
+    _encodeOffset -= 10 - size;
 }
 
 std::string SyncBuffer::decode() {
     ZoneScoped
 
-    int32_t length;
-    memcpy(
-        reinterpret_cast<char*>(&length),
-        _dataStream.data() + _decodeOffset,
-        sizeof(int32_t)
-    );
-    std::vector<char> tmp(length + 1);
-    _decodeOffset += sizeof(int32_t);
-    memcpy(tmp.data(), _dataStream.data() + _decodeOffset, length);
-    _decodeOffset += length;
-    tmp[length] = '\0';
-    std::string ret(tmp.data());
-    return ret;
+    const size_t length = static_cast<size_t>(decodeVarint());
+    const std::byte* data = decodeSpace(length);
+    return std::string(reinterpret_cast<const char*>(data), length);
 }
 
 void SyncBuffer::decode(std::string& s) {
     s = decode();
 }
 
+uint64_t SyncBuffer::decodeVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const uint64_t byte = static_cast<uint64_t>(*decodeSpace(1));
+        value |= (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+    return value;
+}
+
 void SyncBuffer::setData(std::vector<std::byte> data) {
     _dataStream = std::move(data);
+    _decodeData = _dataStream.data();
+    _decodeSize = _dataStream.size();
+    _decodeOffset = 0;
+}
+
+void SyncBuffer::setData(const std::byte* data, size_t size) {
+    _decodeData = data;
+    _decodeSize = size;
+    _decodeOffset = 0;
 }
 
 std::vector<std::byte> SyncBuffer::data() {
@@ -89,10 +104,39 @@ std::vector<std::byte> SyncBuffer::data() {
     return _dataStream;
 }
 
+const std::byte* SyncBuffer::encodedData() const {
+    return _dataStream.data();
+}
+
+size_t SyncBuffer::encodedSize() const {
+    return _encodeOffset;
+}
+
 void SyncBuffer::reset() {
     _dataStream.resize(_n);
     _encodeOffset = 0;
     _decodeOffset = 0;
+    _decodeData = _dataStream.data();
+    _decodeSize = _dataStream.size();
+}
+
+std::byte* SyncBuffer::encodeSpace(size_t size) {
+    const size_t requiredSize = _encodeOffset + size;
+    if (requiredSize > _dataStream.size()) {
+        _dataStream.resize(std::max(requiredSize, 2 * _dataStream.size()));
+    }
+
+    std::byte* data = _dataStream.data() + _encodeOffset;
+    _encodeOffset += size;
+    return data;
+}
+
+const std::byte* SyncBuffer::decodeSpace(size_t size) {
+    ghoul_assert(_decodeOffset + size <= _decodeSize, "Reading past the end of the data");
+
+    const std::byte* data = _decodeData + _decodeOffset;
+    _decodeOffset += size;
+    return data;
 }
 
 } // namespace openspace
@@ -26,77 +26,69 @@
 
 namespace openspace {
 
-Worker::Worker(ThreadPool& p) : pool(p) {}
+ThreadPool::ThreadPool(size_t numThreads)
+    : _ownedJobSystem(std::make_unique<JobSystem>(numThreads))
+    , _jobSystem(*_ownedJobSystem)
+    , _priority(JobSystem::Priority::Background)
+    , _key(_jobSystem.createKey())
+{}
+
+ThreadPool::ThreadPool(JobSystem& jobSystem, JobSystem::Priority priority)
+    : _jobSystem(jobSystem)
+    , _priority(priority)
+    , _key(_jobSystem.createKey())
+{}
+
+ThreadPool::ThreadPool(const ThreadPool& toCopy)
+    : _ownedJobSystem(
+        toCopy._ownedJobSystem ?
+            std::make_unique<JobSystem>(toCopy._ownedJobSystem->numThreads()) :
+            nullptr
+    )
+    , _jobSystem(_ownedJobSystem ? *_ownedJobSystem : toCopy._jobSystem)
+    , _priority(toCopy._priority)
+    , _key(_jobSystem.createKey())
+{}
 
-void Worker::operator()() {
-    std::function<void()> task;
-    while (true) {
-        // acquire lock
-        {
-            std::unique_lock<std::mutex> lock(pool.queue_mutex);
-
-            // look for a work item
-            while (!pool.stop && pool.tasks.empty()) {
-                // if there are none wait for notification
-                pool.condition.wait(lock);
-            }
-
-            if (pool.stop) { // exit if the pool is stopped
-                return;
-            }
-
-            // get the task from the queue
-            task = pool.tasks.front();
-            pool.tasks.pop_front();
-
-        } // release lock
-
-        // execute the task
-        task();
-    }
-}
+ThreadPool::~ThreadPool() {
+    clearTasks();
 
-ThreadPool::ThreadPool(size_t numThreads) : stop(false) {
-    for (size_t i = 0; i < numThreads; ++i) {
-        workers.emplace_back(std::thread(Worker(*this)));
-    }
+    // The jobs that are still running hold a reference to this object
+    std::unique_lock lock(_outstandingMutex);
+    _outstandingCondition.wait(lock, [this]() { return _nOutstandingTasks == 0; });
 }
 
-ThreadPool::ThreadPool(const ThreadPool& toCopy) : ThreadPool(toCopy.workers.size()) {}
-
-// the destructor joins all threads
-ThreadPool::~ThreadPool() {
-    // stop all threads
+void ThreadPool::enqueue(std::function<void()> f) {
     {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        stop = true;
+        std::lock_guard lock(_outstandingMutex);
+        ++_nOutstandingTasks;
     }
-    condition.notify_all();
 
-    // join them
-    for (std::thread& w : workers) {
-        w.join();
-    }
+    _jobSystem.enqueue(
+        [this, f = std::move(f)]() {
+            f();
+            finishTasks(1);
+        },
+        _priority,
+        _key
+    );
 }
 
-// add new work item to the pool
-void ThreadPool::enqueue(std::function<void()> f) {
-    { // acquire lock
-        std::unique_lock<std::mutex> lock(queue_mutex);
-
-        // add the task
-        tasks.push_back(std::move(f));
-    } // release lock
-
-    // wake up one thread
-    condition.notify_one();
+void ThreadPool::clearTasks() {
+    const size_t nRemoved = _jobSystem.cancel(_key);
+    finishTasks(nRemoved);
 }
 
-void ThreadPool::clearTasks() {
-    { // acquire lock
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        tasks.clear();
-    } // release lock
+void ThreadPool::finishTasks(size_t n) {
+    if (n == 0) {
+        return;
+    }
+
+    // Notifying while holding the lock guarantees that the destructor cannot finish
+    // before this function has stopped touching the condition variable
+    std::lock_guard lock(_outstandingMutex);
+    _nOutstandingTasks -= n;
+    _outstandingCondition.notify_all();
 }
 
 } // namespace openspace
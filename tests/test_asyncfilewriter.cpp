@@ -0,0 +1,107 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include "testutilities.h"
+
+#include <openspace/util/asyncfilewriter.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using openspace::test::tempPath;
+
+namespace {
+    std::string readFile(const std::string& path) {
+        std::ifstream file(path, std::ifstream::binary);
+        return std::string(
+            std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>()
+        );
+    }
+} // namespace
+
+TEST_CASE("AsyncFileWriter: Complete File", "[asyncfilewriter]") {
+    using openspace::AsyncFileWriter;
+
+    // A small buffer forces the writes to wrap around the end of the buffer and to wait
+    // for the background thread
+    const std::string path = tempPath("openspace_test_asyncfilewriter_complete.bin");
+    AsyncFileWriter writer(1000);
+    REQUIRE(writer.open(path));
+    CHECK(writer.isOpen());
+
+    std::string expected;
+    for (int i = 0; i < 20000; ++i) {
+        const std::string entry = "entry " + std::to_string(i) + '\n';
+        expected += entry;
+        CHECK(writer.write(entry.data(), entry.size()));
+    }
+
+    // Data that is larger than the whole buffer is written in pieces
+    const std::string large(5000, 'x');
+    expected += large;
+    CHECK(writer.write(large.data(), large.size()));
+
+    CHECK(writer.close());
+    CHECK_FALSE(writer.isOpen());
+    CHECK(writer.nDroppedWrites() == 0);
+    CHECK(readFile(path) == expected);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("AsyncFileWriter: Dropped Writes", "[asyncfilewriter]") {
+    using openspace::AsyncFileWriter;
+
+    const std::string path = tempPath("openspace_test_asyncfilewriter_dropped.bin");
+    AsyncFileWriter writer(64);
+    REQUIRE(writer.open(path));
+
+    // Data that can never fit into the buffer is dropped if that is allowed ...
+    constexpr const AsyncFileWriter::DropIfFull Drop = AsyncFileWriter::DropIfFull::Yes;
+    const std::string large(100, 'x');
+    CHECK_FALSE(writer.write(large.data(), large.size(), Drop));
+    CHECK(writer.nDroppedWrites() == 1);
+
+    // ... while other writes are kept
+    const std::string small = "abc";
+    CHECK(writer.write(small.data(), small.size(), Drop));
+    CHECK(writer.nDroppedWrites() == 1);
+
+    CHECK(writer.close());
+    CHECK(readFile(path) == "abc");
+
+    // Closing a writer twice has no effect
+    CHECK(writer.close());
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("AsyncFileWriter: Invalid Path", "[asyncfilewriter]") {
+    openspace::AsyncFileWriter writer;
+    CHECK_FALSE(writer.open(tempPath("openspace_test_missing_folder/file.bin")));
+    CHECK_FALSE(writer.isOpen());
+}
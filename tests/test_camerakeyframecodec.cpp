@@ -0,0 +1,222 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <openspace/network/camerakeyframecodec.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+    using openspace::CameraKeyframeCodec;
+    using CameraKeyframe = openspace::datamessagestructures::CameraKeyframe;
+
+    // A camera that orbits around the focus node at distances between 1e4 and 1e8 meters
+    // while rotating around its own axis
+    CameraKeyframe cameraPath(int frame) {
+        const double t = frame * 0.01;
+        const double distance = std::pow(10.0, 6.0 + 2.0 * std::sin(t * 0.1));
+
+        CameraKeyframe kf;
+        kf._position = glm::dvec3(
+            distance * std::cos(t),
+            distance * std::sin(t),
+            distance * 0.1
+        );
+        kf._rotation = glm::dquat(std::cos(t * 0.5), 0.0, std::sin(t * 0.5), 0.0);
+        kf._followNodeRotation = (frame / 500) % 2 == 0;
+        kf._focusNode = (frame / 300) % 2 == 0 ? "Earth" : "Moon";
+        kf._scale = 1.f;
+        kf._timestamp = t;
+        return kf;
+    }
+
+    double rotationDifference(const glm::dquat& q1, const glm::dquat& q2) {
+        return 2.0 * std::acos(std::min(std::abs(glm::dot(q1, q2)), 1.0));
+    }
+} // namespace
+
+TEST_CASE("CameraKeyframeCodec: Loopback", "[camerakeyframecodec]") {
+    CameraKeyframeCodec::Encoder encoder;
+    CameraKeyframeCodec::Decoder decoder;
+
+    size_t nCompactBytes = 0;
+    size_t nFullBytes = 0;
+    std::vector<char> buffer;
+    CameraKeyframe decoded;
+    for (int i = 0; i < 2000; ++i) {
+        const CameraKeyframe kf = cameraPath(i);
+
+        buffer.clear();
+        kf.serialize(buffer);
+        nFullBytes += buffer.size();
+
+        buffer.clear();
+        const double timestamp = kf._timestamp;
+        encoder.encode(kf, timestamp, buffer);
+        nCompactBytes += buffer.size();
+
+        REQUIRE(decoder.decode(buffer.data(), buffer.size(), timestamp, decoded));
+        const double distance = glm::length(kf._position);
+        CHECK(glm::length(decoded._position - kf._position) < distance * 1e-7);
+        CHECK(rotationDifference(decoded._rotation, kf._rotation) < 1e-5);
+        CHECK(decoded._followNodeRotation == kf._followNodeRotation);
+        CHECK(decoded._focusNode == kf._focusNode);
+        CHECK(decoded._scale == kf._scale);
+        CHECK(decoded._timestamp == kf._timestamp);
+    }
+
+    // The changes to the scale and the timestamp are transmitted as well
+    CameraKeyframe kf = cameraPath(2000);
+    kf._scale = 0.5f;
+    buffer.clear();
+    encoder.encode(kf, kf._timestamp + 0.25, buffer);
+    REQUIRE(decoder.decode(buffer.data(), buffer.size(), kf._timestamp + 0.25, decoded));
+    CHECK(decoded._scale == 0.5f);
+    CHECK(decoded._timestamp == Approx(kf._timestamp));
+
+    // The compact keyframes need less than a fourth of the bandwidth
+    CHECK(nCompactBytes * 4 < nFullBytes);
+}
+
+TEST_CASE("CameraKeyframeCodec: Late Decoder", "[camerakeyframecodec]") {
+    CameraKeyframeCodec::Encoder encoder;
+    CameraKeyframeCodec::Decoder first;
+    CameraKeyframeCodec::Decoder late;
+
+    std::vector<char> buffer;
+    CameraKeyframe decoded;
+    for (int i = 0; i < 10; ++i) {
+        buffer.clear();
+        encoder.encode(cameraPath(i), 0.0, buffer);
+        CHECK(first.decode(buffer.data(), buffer.size(), 0.0, decoded));
+    }
+
+    // The late Decoder can not decode keyframes that depend on earlier ones ...
+    buffer.clear();
+    encoder.encode(cameraPath(10), 0.0, buffer);
+    CHECK(first.decode(buffer.data(), buffer.size(), 0.0, decoded));
+    CHECK_FALSE(late.decode(buffer.data(), buffer.size(), 0.0, decoded));
+
+    // ... until the Encoder sends a full keyframe
+    encoder.reset();
+    for (int i = 11; i < 20; ++i) {
+        buffer.clear();
+        encoder.encode(cameraPath(i), 0.0, buffer);
+        CHECK(first.decode(buffer.data(), buffer.size(), 0.0, decoded));
+        CHECK(late.decode(buffer.data(), buffer.size(), 0.0, decoded));
+        CHECK(decoded._focusNode == "Earth");
+    }
+}
+
+TEST_CASE("CameraKeyframeCodec: Motion Threshold", "[camerakeyframecodec]") {
+    CameraKeyframeCodec::Encoder encoder;
+
+    CameraKeyframe kf;
+    kf._position = glm::dvec3(1e7, 0.0, 0.0);
+    kf._focusNode = "Earth";
+    kf._scale = 1.f;
+
+    // The first keyframe always has to be sent
+    CHECK(encoder.hasChanged(kf, 1e-3));
+    std::vector<char> buffer;
+    encoder.encode(kf, 0.0, buffer);
+    CHECK_FALSE(encoder.hasChanged(kf, 1e-3));
+
+    // Movements are relative to the distance to the focus node
+    CameraKeyframe moved = kf;
+    moved._position.x += 5e3;
+    CHECK_FALSE(encoder.hasChanged(moved, 1e-3));
+    moved._position.x += 1e4;
+    CHECK(encoder.hasChanged(moved, 1e-3));
+
+    CameraKeyframe rotated = kf;
+    rotated._rotation = glm::dquat(std::cos(1e-4), std::sin(1e-4), 0.0, 0.0);
+    CHECK_FALSE(encoder.hasChanged(rotated, 1e-3));
+    rotated._rotation = glm::dquat(std::cos(1e-3), std::sin(1e-3), 0.0, 0.0);
+    CHECK(encoder.hasChanged(rotated, 1e-3));
+
+    CameraKeyframe refocused = kf;
+    refocused._focusNode = "Moon";
+    CHECK(encoder.hasChanged(refocused, 1e-3));
+}
+
+TEST_CASE("CameraKeyframeCodec: Malformed Data", "[camerakeyframecodec]") {
+    CameraKeyframeCodec::Encoder encoder;
+    CameraKeyframeCodec::Decoder decoder;
+
+    std::vector<char> buffer;
+    encoder.encode(cameraPath(0), 0.0, buffer);
+
+    CameraKeyframe decoded;
+    CHECK_FALSE(decoder.decode(buffer.data(), 0, 0.0, decoded));
+    for (size_t size = 1; size < buffer.size(); ++size) {
+        CHECK_FALSE(decoder.decode(buffer.data(), size, 0.0, decoded));
+    }
+    CHECK(decoder.decode(buffer.data(), buffer.size(), 0.0, decoded));
+}
+
+TEST_CASE("CameraKeyframeCodec: Benchmark", "[camerakeyframecodec][.benchmark]") {
+    constexpr const int NFrames = 100000;
+
+    std::vector<std::vector<char>> full(NFrames);
+    std::vector<std::vector<char>> compact(NFrames);
+    CameraKeyframeCodec::Encoder encoder;
+    size_t nFullBytes = 0;
+    size_t nCompactBytes = 0;
+    for (int i = 0; i < NFrames; ++i) {
+        const CameraKeyframe kf = cameraPath(i);
+        kf.serialize(full[i]);
+        nFullBytes += full[i].size();
+        encoder.encode(kf, kf._timestamp, compact[i]);
+        nCompactBytes += compact[i].size();
+    }
+
+    // Decoding the full keyframes requires a copy of the message, see ParallelPeer
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NFrames; ++i) {
+        const std::vector<char> buffer(full[i].begin(), full[i].end());
+        const CameraKeyframe kf(buffer);
+        REQUIRE(!kf._focusNode.empty());
+    }
+    const std::chrono::nanoseconds fullDuration =
+        std::chrono::high_resolution_clock::now() - begin;
+
+    CameraKeyframeCodec::Decoder decoder;
+    CameraKeyframe decoded;
+    begin = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NFrames; ++i) {
+        const double timestamp = i * 0.01;
+        REQUIRE(decoder.decode(compact[i].data(), compact[i].size(), timestamp, decoded));
+    }
+    const std::chrono::nanoseconds compactDuration =
+        std::chrono::high_resolution_clock::now() - begin;
+
+    std::cout << "Full keyframes: " << static_cast<double>(nFullBytes) / NFrames
+        << " bytes, " << fullDuration.count() / NFrames << " ns decode time\n"
+        << "Compact keyframes: " << static_cast<double>(nCompactBytes) / NFrames
+        << " bytes, " << compactDuration.count() / NFrames << " ns decode time\n";
+}
@@ -0,0 +1,313 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include "testutilities.h"
+
+#include <modules/globebrowsing/src/disktilecache.h>
+#include <modules/globebrowsing/src/rawtile.h>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace {
+    using namespace openspace::globebrowsing;
+    using openspace::test::tempPath;
+
+    std::string cacheDirectory() {
+        const std::string path = tempPath("openspace_test_disktilecache");
+        std::filesystem::remove_all(path);
+        return path;
+    }
+
+    TileTextureInitData initData() {
+        return TileTextureInitData(
+            16,
+            16,
+            GL_UNSIGNED_BYTE,
+            ghoul::opengl::Texture::Format::RGBA,
+            TileTextureInitData::PadTiles::No
+        );
+    }
+
+    RawTile createTile(const TileTextureInitData& data, TileIndex index, int value) {
+        RawTile tile;
+        tile.imageData = std::unique_ptr<std::byte[]>(new std::byte[data.totalNumBytes]);
+        std::fill(
+            tile.imageData.get(),
+            tile.imageData.get() + data.totalNumBytes,
+            static_cast<std::byte>(value)
+        );
+        tile.tileMetaData.nValues = 4;
+        tile.tileMetaData.maxValues = { 1.f, 2.f, 3.f, 4.f };
+        tile.tileMetaData.minValues = { -1.f, -2.f, -3.f, -4.f };
+        tile.tileMetaData.hasMissingData = { true, false, true, false };
+        tile.tileIndex = index;
+        tile.textureInitData = data;
+        return tile;
+    }
+} // namespace
+
+TEST_CASE("DiskTileCache: Put And Get", "[disktilecache]") {
+    using namespace openspace::globebrowsing;
+    const TileTextureInitData data = initData();
+    const std::string directory = cacheDirectory();
+    {
+        cache::DiskTileCache cache(directory, 1024 * 1024);
+
+        const uint64_t provider = cache::DiskTileCache::providerHash("provider");
+        const cache::DiskTileCache::Key key = {
+            provider,
+            TileIndex(1, 2, 3),
+            data.hashKey
+        };
+        REQUIRE_FALSE(cache.get(key, data).has_value());
+
+        cache.put(key, createTile(data, key.tileIndex, 42));
+        std::optional<RawTile> tile = cache.get(key, data);
+        REQUIRE(tile.has_value());
+        CHECK(tile->tileIndex == key.tileIndex);
+        CHECK(tile->error == RawTile::ReadError::None);
+        CHECK(tile->tileMetaData.nValues == 4);
+        CHECK(tile->tileMetaData.maxValues[3] == 4.f);
+        CHECK(tile->tileMetaData.minValues[1] == -2.f);
+        CHECK(tile->tileMetaData.hasMissingData[0]);
+        CHECK_FALSE(tile->tileMetaData.hasMissingData[1]);
+        CHECK(tile->imageData[0] == std::byte(42));
+        CHECK(tile->imageData[data.totalNumBytes - 1] == std::byte(42));
+
+        // A different provider or tile must not return the stored tile
+        const cache::DiskTileCache::Key other = {
+            cache::DiskTileCache::providerHash("other"),
+            key.tileIndex,
+            data.hashKey
+        };
+        CHECK_FALSE(cache.get(other, data).has_value());
+        const cache::DiskTileCache::Key otherTile = {
+            provider,
+            TileIndex(2, 2, 3),
+            data.hashKey
+        };
+        CHECK_FALSE(cache.get(otherTile, data).has_value());
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("DiskTileCache: Failed Tiles Are Not Stored", "[disktilecache]") {
+    using namespace openspace::globebrowsing;
+    const TileTextureInitData data = initData();
+    const std::string directory = cacheDirectory();
+    {
+        cache::DiskTileCache cache(directory, 1024 * 1024);
+
+        const cache::DiskTileCache::Key key = { 1, TileIndex(0, 0, 1), data.hashKey };
+        RawTile tile = createTile(data, key.tileIndex, 1);
+        tile.error = RawTile::ReadError::Failure;
+        cache.put(key, tile);
+        CHECK_FALSE(cache.get(key, data).has_value());
+        CHECK(cache.size() == 0);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("DiskTileCache: Eviction", "[disktilecache]") {
+    using namespace openspace::globebrowsing;
+    const TileTextureInitData data = initData();
+
+    // Room for a little more than three tiles
+    const uint64_t tileSize = data.totalNumBytes + 128;
+    const std::string directory = cacheDirectory();
+    {
+        cache::DiskTileCache cache(directory, 3 * tileSize + tileSize / 2);
+
+        auto key = [&data](uint32_t x) -> cache::DiskTileCache::Key {
+            return { 1, TileIndex(x, 0, 5), data.hashKey };
+        };
+
+        cache.put(key(0), createTile(data, key(0).tileIndex, 0));
+        cache.put(key(1), createTile(data, key(1).tileIndex, 1));
+        cache.put(key(2), createTile(data, key(2).tileIndex, 2));
+        CHECK(cache.size() == 3 * tileSize);
+
+        // Touching the first tile makes the second one the least recently used
+        REQUIRE(cache.get(key(0), data).has_value());
+        cache.put(key(3), createTile(data, key(3).tileIndex, 3));
+        CHECK(cache.size() == 3 * tileSize);
+
+        CHECK(cache.get(key(0), data).has_value());
+        CHECK_FALSE(cache.get(key(1), data).has_value());
+        CHECK(cache.get(key(2), data).has_value());
+        CHECK(cache.get(key(3), data).has_value());
+
+        cache.setMaximumSize(tileSize);
+        CHECK(cache.size() == tileSize);
+        CHECK(cache.get(key(3), data).has_value());
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("DiskTileCache: Persistence", "[disktilecache]") {
+    using namespace openspace::globebrowsing;
+    const TileTextureInitData data = initData();
+    const std::string directory = cacheDirectory();
+    const uint64_t tileSize = data.totalNumBytes + 128;
+
+    auto key = [&data](uint32_t x) -> cache::DiskTileCache::Key {
+        return { 1, TileIndex(x, 0, 5), data.hashKey };
+    };
+
+    {
+        cache::DiskTileCache cache(directory, 1024 * 1024);
+        cache.put(key(0), createTile(data, key(0).tileIndex, 0));
+        cache.put(key(1), createTile(data, key(1).tileIndex, 1));
+        REQUIRE(cache.get(key(0), data).has_value());
+    }
+
+    {
+        // The recency order has to survive as well, so reducing the size has to remove
+        // the tile that was not accessed last
+        cache::DiskTileCache cache(directory, tileSize);
+        CHECK(cache.size() == tileSize);
+        std::optional<RawTile> tile = cache.get(key(0), data);
+        REQUIRE(tile.has_value());
+        CHECK(tile->imageData[0] == std::byte(0));
+        CHECK_FALSE(cache.get(key(1), data).has_value());
+    }
+
+    {
+        cache::DiskTileCache cache(directory, tileSize);
+        cache.clear();
+        CHECK(cache.size() == 0);
+        CHECK_FALSE(cache.get(key(0), data).has_value());
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("DiskTileCache: Corrupted Index", "[disktilecache]") {
+    using namespace openspace::globebrowsing;
+    const TileTextureInitData data = initData();
+    const std::string directory = cacheDirectory();
+    const cache::DiskTileCache::Key key = { 1, TileIndex(0, 0, 5), data.hashKey };
+
+    {
+        cache::DiskTileCache cache(directory, 1024 * 1024);
+        cache.put(key, createTile(data, key.tileIndex, 0));
+    }
+
+    // An index with a valid header that claims to contain far more entries than fit
+    // into the file
+    {
+        std::ofstream index(
+            directory + "/index.bin",
+            std::ofstream::binary | std::ofstream::trunc
+        );
+        const uint32_t magic = 0x58444E49;
+        const uint32_t version = 2;
+        const uint64_t nEntries = std::numeric_limits<uint64_t>::max() / 2;
+        index.write(reinterpret_cast<const char*>(&magic), sizeof(uint32_t));
+        index.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
+        index.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
+    }
+
+    {
+        // The index is ignored, but the tiles in the directory are still found
+        cache::DiskTileCache cache(directory, 1024 * 1024);
+        CHECK(cache.get(key, data).has_value());
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("DiskTileCache: Packed Segments", "[disktilecache]") {
+    using namespace openspace::globebrowsing;
+    const TileTextureInitData data = initData();
+    const std::string directory = cacheDirectory();
+    const uint64_t tileSize = data.totalNumBytes + 128;
+
+    auto key = [&data](uint32_t x) -> cache::DiskTileCache::Key {
+        return { 1, TileIndex(x, 0, 5), data.hashKey };
+    };
+
+    {
+        cache::DiskTileCache cache(directory, 1024 * 1024);
+        for (uint32_t x = 0; x < 8; ++x) {
+            cache.put(key(x), createTile(data, key(x).tileIndex, x));
+        }
+        for (uint32_t x = 0; x < 8; ++x) {
+            std::optional<RawTile> tile = cache.get(key(x), data);
+            REQUIRE(tile.has_value());
+            CHECK(tile->imageData[data.totalNumBytes - 1] == std::byte(x));
+        }
+    }
+
+    // All tiles are packed into a single segment whose unused space is released when
+    // the cache is destroyed
+    std::vector<std::filesystem::path> segments;
+    for (const std::filesystem::directory_entry& e :
+         std::filesystem::directory_iterator(directory))
+    {
+        if (e.path().filename() != "index.bin") {
+            segments.push_back(e.path());
+        }
+    }
+    REQUIRE(segments.size() == 1);
+    CHECK(std::filesystem::file_size(segments[0]) == 8 * tileSize);
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("DiskTileCache: Corrupted Record", "[disktilecache]") {
+    using namespace openspace::globebrowsing;
+    const TileTextureInitData data = initData();
+    const std::string directory = cacheDirectory();
+    const cache::DiskTileCache::Key key = { 1, TileIndex(0, 0, 5), data.hashKey };
+
+    {
+        cache::DiskTileCache cache(directory, 1024 * 1024);
+        cache.put(key, createTile(data, key.tileIndex, 0));
+        REQUIRE(cache.get(key, data).has_value());
+
+        // Overwriting the header of the record while the segment is in use
+        for (const std::filesystem::directory_entry& e :
+             std::filesystem::directory_iterator(directory))
+        {
+            std::fstream file(
+                e.path(),
+                std::fstream::in | std::fstream::out | std::fstream::binary
+            );
+            const std::array<char, 16> zeros = {};
+            file.write(zeros.data(), zeros.size());
+        }
+
+        // The broken record is removed instead of being read again on every request
+        CHECK_FALSE(cache.get(key, data).has_value());
+        CHECK(cache.size() == 0);
+
+        cache.put(key, createTile(data, key.tileIndex, 7));
+        std::optional<RawTile> tile = cache.get(key, data);
+        REQUIRE(tile.has_value());
+        CHECK(tile->imageData[0] == std::byte(7));
+    }
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,195 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
+
+#include "catch2/catch.hpp"
+
+#include <modules/fieldlinessequence/util/fieldlinesstatestreamer.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using openspace::FieldlinesState;
+    using openspace::FieldlinesStateStreamer;
+
+    constexpr const int NStates = 40;
+
+    // Instead of reading files, the states are identified by their trigger time, which
+    // is the index of the state
+    struct Loader {
+        bool load(const std::string& path, FieldlinesState& state) {
+            std::this_thread::sleep_for(duration);
+            const int index = std::stoi(path);
+            state.setTriggerTime(static_cast<double>(index));
+
+            std::lock_guard lock(mutex);
+            loadedIndices.push_back(index);
+            states.insert(&state);
+            return true;
+        }
+
+        bool hasLoaded(int index) {
+            std::lock_guard lock(mutex);
+            return std::find(loadedIndices.begin(), loadedIndices.end(), index) !=
+                loadedIndices.end();
+        }
+
+        std::chrono::milliseconds duration = std::chrono::milliseconds(1);
+        std::mutex mutex;
+        std::vector<int> loadedIndices;
+        std::set<const FieldlinesState*> states;
+    };
+
+    FieldlinesStateStreamer createStreamer(Loader& loader, size_t nPrefetchStates) {
+        std::vector<std::string> files;
+        std::vector<double> triggerTimes;
+        for (int i = 0; i < NStates; ++i) {
+            files.push_back(std::to_string(i));
+            triggerTimes.push_back(static_cast<double>(i));
+        }
+        return FieldlinesStateStreamer(
+            std::move(files),
+            std::move(triggerTimes),
+            nPrefetchStates,
+            [&loader](const std::string& path, FieldlinesState& state) {
+                return loader.load(path, state);
+            }
+        );
+    }
+
+    // Calls the function every millisecond until it returns true or a timeout occurs
+    bool waitUntil(const std::function<bool()>& function) {
+        const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (std::chrono::steady_clock::now() < end) {
+            if (function()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    // Plays the sequence from state \p first to state \p last and waits for each state
+    void play(FieldlinesStateStreamer& streamer, FieldlinesState& state, int first,
+              int last, double deltaTime)
+    {
+        const int direction = first <= last ? 1 : -1;
+        for (int i = first; i != last + direction; i += direction) {
+            REQUIRE(waitUntil([&]() {
+                streamer.update(i, i + 0.5, deltaTime);
+                return streamer.takeState(i, state);
+            }));
+            CHECK(state.triggerTime() == static_cast<double>(i));
+        }
+    }
+} // namespace
+
+TEST_CASE("FieldlinesStateStreamer: Prefetch", "[fieldlinesstatestreamer]") {
+    Loader loader;
+    FieldlinesStateStreamer streamer = createStreamer(loader, 3);
+    FieldlinesState state;
+
+    play(streamer, state, 5, 5, 1.0);
+
+    // The following states in the direction of time are prefetched ...
+    REQUIRE(waitUntil([&]() {
+        streamer.update(5, 5.5, 1.0);
+        return loader.hasLoaded(6) && loader.hasLoaded(7) && loader.hasLoaded(8);
+    }));
+    CHECK_FALSE(loader.hasLoaded(4));
+
+    // ... so that they are already loaded when they are needed
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    play(streamer, state, 6, 6, 1.0);
+    CHECK(streamer.nRequests() == 2);
+    CHECK(streamer.nHits() == 1);
+
+    // The previously displayed state is kept
+    streamer.update(5, 5.5, 1.0);
+    CHECK(streamer.takeState(5, state));
+    CHECK(state.triggerTime() == 5.0);
+    CHECK(streamer.nHits() == 2);
+}
+
+TEST_CASE("FieldlinesStateStreamer: Backwards", "[fieldlinesstatestreamer]") {
+    Loader loader;
+    FieldlinesStateStreamer streamer = createStreamer(loader, 3);
+    FieldlinesState state;
+
+    play(streamer, state, 20, 20, -1.0);
+    REQUIRE(waitUntil([&]() {
+        streamer.update(20, 20.5, -1.0);
+        return loader.hasLoaded(19) && loader.hasLoaded(18) && loader.hasLoaded(17);
+    }));
+    CHECK_FALSE(loader.hasLoaded(21));
+}
+
+TEST_CASE("FieldlinesStateStreamer: High Delta Time", "[fieldlinesstatestreamer]") {
+    Loader loader;
+    loader.duration = std::chrono::milliseconds(20);
+    FieldlinesStateStreamer streamer = createStreamer(loader, 3);
+    FieldlinesState state;
+
+    // After the first load, the streamer knows that a load takes at least 20 ms, during
+    // which the simulation time passes through at least 4 states
+    play(streamer, state, 0, 0, 200.0);
+    REQUIRE(waitUntil([&]() {
+        streamer.update(0, 0.5, 200.0);
+        std::lock_guard lock(loader.mutex);
+        return std::any_of(
+            loader.loadedIndices.begin(),
+            loader.loadedIndices.end(),
+            [](int index) { return index >= 8; }
+        );
+    }));
+}
+
+TEST_CASE("FieldlinesStateStreamer: Reuse States", "[fieldlinesstatestreamer]") {
+    Loader loader;
+    FieldlinesStateStreamer streamer = createStreamer(loader, 3);
+    FieldlinesState state;
+
+    // Play the sequence forwards and backwards slowly enough for the prefetching
+    for (int i = 0; i < NStates; ++i) {
+        play(streamer, state, i, i, 1.0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    for (int i = NStates - 1; i >= 0; --i) {
+        play(streamer, state, i, i, -1.0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    // All states are loaded into the same few slots
+    CHECK(loader.states.size() <= 5);
+    CHECK(streamer.hitRate() > 0.5f);
+}
+
+#endif // OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
@@ -0,0 +1,218 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include "testutilities.h"
+
+#include <openspace/interaction/indexedrecording.h>
+#include <ghoul/misc/exception.h>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    using openspace::interaction::IndexedRecording;
+    using openspace::test::tempPath;
+
+    std::string writeFile(const std::string& name, const std::string& content) {
+        const std::string path = tempPath(name);
+        std::ofstream file(path, std::ofstream::binary);
+        file << content;
+        return path;
+    }
+
+    template <typename T>
+    void write(std::ostream& file, T value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+} // namespace
+
+TEST_CASE("IndexedRecording: Convert Ascii", "[indexedrecording]") {
+    const std::string source = writeFile(
+        "openspace_test_indexedrecording.osrectxt",
+        "OpenSpace_record/playback00.85A\r\n"
+        "camera 10.5 0.5 100.0 1 2 3 0 0 0 1 1e-2 F Earth\r\n"
+        "script 11.0 1.0 101.0 2 first line\r\n"
+        "second line\r\n"
+        "camera 11.5 1.5 102.0 4 5 6 0 0 1 0 2e-2 - Moon\r\n"
+        "time 12.0 2.0 103.0 60 P J\r\n"
+        "camera 12.5 2.5 104.0 7 8 9 0 1 0 0 3e-2 F Earth\r\n"
+    );
+    const std::string destination = tempPath("openspace_test_indexedrecording.osrec");
+    IndexedRecording::convert(source, destination);
+
+    {
+        IndexedRecording recording(destination);
+        REQUIRE(recording.nEntries() == 5);
+        CHECK(recording.nNodeNames() == 2);
+        REQUIRE(recording.nScripts() == 1);
+
+        const IndexedRecording::Entry first = recording.entry(0);
+        CHECK(first.type == IndexedRecording::EntryType::Camera);
+        CHECK(first.timeOs == 10.5);
+        CHECK(first.timeRec == 0.5);
+        CHECK(first.timeSim == 100.0);
+        CHECK(first.position[2] == 3.0);
+        CHECK(first.rotation[3] == 1.0);
+        CHECK(first.scale == 1e-2f);
+        CHECK(first.followNodeRotation);
+        CHECK(recording.nodeName(first.index) == "Earth");
+
+        const IndexedRecording::Entry script = recording.entry(1);
+        CHECK(script.type == IndexedRecording::EntryType::Script);
+        CHECK(recording.script(script.index) == "first line\nsecond line");
+
+        const IndexedRecording::Entry second = recording.entry(2);
+        CHECK_FALSE(second.followNodeRotation);
+        CHECK(recording.nodeName(second.index) == "Moon");
+
+        const IndexedRecording::Entry time = recording.entry(3);
+        CHECK(time.type == IndexedRecording::EntryType::Time);
+        CHECK(time.deltaTime == 60.0);
+        CHECK(time.paused);
+        CHECK(time.requiresTimeJump);
+
+        // The node name of the last keyframe is interned
+        CHECK(recording.entry(4).index == first.index);
+    }
+
+    // The mapping has to be closed before the files can be removed
+    std::filesystem::remove(source);
+    std::filesystem::remove(destination);
+}
+
+TEST_CASE("IndexedRecording: Convert Binary", "[indexedrecording]") {
+    const std::string source = tempPath("openspace_test_indexedrecording.osrecbin");
+    {
+        std::ofstream file(source, std::ofstream::binary);
+        file << "OpenSpace_record/playback00.85B\n";
+        for (int i = 0; i < 1000; ++i) {
+            file << 'c';
+            write(file, 100.0 + i);
+            write(file, static_cast<double>(i));
+            write(file, 1000.0 + i);
+            // The CameraKeyframe consists of the position, rotation, follow flag, focus
+            // node, scale, and timestamp
+            write(file, glm::dvec3(i, 0.0, 0.0));
+            write(file, glm::dquat(1.0, 0.0, 0.0, 0.0));
+            write(file, static_cast<unsigned char>(0));
+            const std::string node = (i % 2 == 0) ? "Earth" : "Mars";
+            write(file, static_cast<int>(node.size()));
+            file << node;
+            write(file, 1.f);
+            write(file, 100.0 + i);
+
+            if (i % 100 == 0) {
+                const std::string s = "openspace.printInfo('" + std::to_string(i) + "')";
+                file << 's';
+                write(file, 100.0 + i);
+                write(file, static_cast<double>(i));
+                write(file, 1000.0 + i);
+                write(file, s.size());
+                file << s;
+            }
+        }
+    }
+    const std::string destination = tempPath("openspace_test_indexedrecording.osrec");
+    IndexedRecording::convert(source, destination);
+
+    {
+        IndexedRecording recording(destination);
+        REQUIRE(recording.nEntries() == 1010);
+        CHECK(recording.nNodeNames() == 2);
+        CHECK(recording.nScripts() == 10);
+
+        // The first entry after the requested time is found
+        CHECK(recording.findEntry(-1.0) == 0);
+        const size_t index = recording.findEntry(500.5);
+        REQUIRE(index < recording.nEntries());
+        CHECK(recording.recordedTime(index) == 501.0);
+        CHECK(recording.recordedTime(index - 1) == 500.5 - 0.5);
+        CHECK(recording.entry(index).position[0] == 501.0);
+        CHECK(recording.nodeName(recording.entry(index).index) == "Mars");
+        CHECK(recording.findEntry(999.0) == recording.nEntries());
+
+        // The script stays behind the camera keyframe that was recorded at the same time
+        const size_t scriptIndex = recording.findEntry(199.5) + 1;
+        CHECK(recording.recordedTime(scriptIndex) == 200.0);
+        CHECK(recording.entry(scriptIndex).type == IndexedRecording::EntryType::Script);
+        CHECK(recording.script(recording.entry(scriptIndex).index) ==
+            "openspace.printInfo('200')");
+    }
+
+    // The mapping has to be closed before the files can be removed
+    std::filesystem::remove(source);
+    std::filesystem::remove(destination);
+}
+
+TEST_CASE("IndexedRecording: Invalid Files", "[indexedrecording]") {
+    const std::string missing = tempPath("openspace_test_indexedrecording_missing.osrec");
+    CHECK_THROWS_AS(IndexedRecording(missing), ghoul::RuntimeError);
+
+    const std::string version1 = writeFile(
+        "openspace_test_indexedrecording_version1.osrec",
+        "OpenSpace_record/playback00.85A\ncamera 0 0 0 0 0 0 0 0 0 1 1 F Earth\n"
+    );
+    CHECK_THROWS_AS(IndexedRecording(version1), ghoul::RuntimeError);
+
+    const std::string truncated = writeFile(
+        "openspace_test_indexedrecording_truncated.osrec",
+        "OpenSpace_record/playback02.00I\n" + std::string(60, '\0')
+    );
+    CHECK_THROWS_AS(IndexedRecording(truncated), ghoul::RuntimeError);
+
+    // The number of strings in the tables has to fit the entries and the file size
+    const std::string corrupted = tempPath("openspace_test_indexedrecording_count.osrec");
+    IndexedRecording::Builder builder;
+    builder.addScript(0.0, 0.0, 0.0, "openspace.printInfo('test')");
+    builder.save(corrupted);
+    {
+        std::fstream file(corrupted, std::fstream::in | std::fstream::out |
+                                     std::fstream::binary);
+        file.seekp(
+            -static_cast<std::streamoff>(sizeof(IndexedRecording::Footer)) +
+                offsetof(IndexedRecording::Footer, nScripts),
+            std::fstream::end
+        );
+        write(file, uint64_t(1) << 60);
+    }
+    CHECK_THROWS_AS(IndexedRecording(corrupted), ghoul::RuntimeError);
+
+    const std::string unknown = writeFile(
+        "openspace_test_indexedrecording_unknown.osrectxt",
+        "OpenSpace_record/playback00.85A\nunknown 0 0 0\n"
+    );
+    const std::string unknownDestination = tempPath("openspace_test_unknown.osrec");
+    CHECK_THROWS_AS(
+        IndexedRecording::convert(unknown, unknownDestination),
+        ghoul::RuntimeError
+    );
+
+    std::filesystem::remove(version1);
+    std::filesystem::remove(truncated);
+    std::filesystem::remove(corrupted);
+    std::filesystem::remove(unknown);
+    std::filesystem::remove(unknownDestination);
+}
@@ -0,0 +1,377 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <modules/globebrowsing/src/lruthreadpool.h>
+#include <openspace/util/jobsystem.h>
+#include <openspace/util/threadpool.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iostream>
+
+namespace {
+    // Copy of the single-queue thread pool that the JobSystem replaced. It is only used
+    // as the baseline in the benchmark below
+    class LegacyThreadPool {
+    public:
+        LegacyThreadPool(size_t numThreads) {
+            for (size_t i = 0; i < numThreads; ++i) {
+                _workers.emplace_back([this]() {
+                    while (true) {
+                        std::function<void()> task;
+                        {
+                            std::unique_lock lock(_mutex);
+                            _condition.wait(
+                                lock,
+                                [this]() { return _stop || !_tasks.empty(); }
+                            );
+                            if (_stop) {
+                                return;
+                            }
+                            task = std::move(_tasks.front());
+                            _tasks.pop_front();
+                        }
+                        task();
+                    }
+                });
+            }
+        }
+
+        ~LegacyThreadPool() {
+            {
+                std::unique_lock lock(_mutex);
+                _stop = true;
+            }
+            _condition.notify_all();
+            for (std::thread& w : _workers) {
+                w.join();
+            }
+        }
+
+        void enqueue(std::function<void()> f) {
+            {
+                std::unique_lock lock(_mutex);
+                _tasks.push_back(std::move(f));
+            }
+            _condition.notify_one();
+        }
+
+    private:
+        std::vector<std::thread> _workers;
+        std::deque<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stop = false;
+    };
+
+    void waitFor(const std::atomic<int>& counter, int value) {
+        while (counter < value) {
+            std::this_thread::yield();
+        }
+    }
+
+    template <typename Func>
+    double measureMilliseconds(Func f) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        f();
+        const auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+} // namespace
+
+TEST_CASE("JobSystem: Executes All Jobs", "[jobsystem]") {
+    openspace::JobSystem jobSystem(4);
+
+    constexpr const int NJobs = 10000;
+    std::atomic<int> counter = 0;
+    for (int i = 0; i < NJobs; ++i) {
+        jobSystem.enqueue([&counter]() { ++counter; });
+    }
+    waitFor(counter, NJobs);
+
+    REQUIRE(counter == NJobs);
+    REQUIRE(jobSystem.numPendingJobs() == 0);
+}
+
+TEST_CASE("JobSystem: Nested Jobs", "[jobsystem]") {
+    openspace::JobSystem jobSystem(2);
+
+    constexpr const int NJobs = 100;
+    std::atomic<int> counter = 0;
+    for (int i = 0; i < NJobs; ++i) {
+        jobSystem.enqueue([&jobSystem, &counter]() {
+            jobSystem.enqueue([&counter]() { ++counter; });
+        });
+    }
+    waitFor(counter, NJobs);
+
+    REQUIRE(counter == NJobs);
+}
+
+TEST_CASE("JobSystem: Parallel For", "[jobsystem]") {
+    openspace::JobSystem jobSystem(4);
+
+    constexpr const size_t NTasks = 1000;
+    std::vector<std::atomic<int>> executions(NTasks);
+    jobSystem.parallelFor(NTasks, [&executions](size_t i) { ++executions[i]; });
+
+    for (const std::atomic<int>& e : executions) {
+        REQUIRE(e == 1);
+    }
+}
+
+TEST_CASE("JobSystem: Nested Parallel For", "[jobsystem]") {
+    // Both workers are busy with the outer tasks, so the inner loops can only finish as
+    // the calling thread takes part in the execution of the tasks
+    openspace::JobSystem jobSystem(2);
+
+    std::atomic<int> counter = 0;
+    std::atomic<bool> isDone = false;
+    jobSystem.enqueue([&]() {
+        jobSystem.parallelFor(10, [&](size_t) {
+            jobSystem.parallelFor(10, [&counter](size_t) { ++counter; });
+        });
+        isDone = true;
+    });
+    while (!isDone) {
+        std::this_thread::yield();
+    }
+
+    REQUIRE(counter == 100);
+}
+
+TEST_CASE("JobSystem: Priorities", "[jobsystem]") {
+    using Priority = openspace::JobSystem::Priority;
+    openspace::JobSystem jobSystem(1);
+
+    // Block the only worker until all jobs are enqueued
+    std::atomic<bool> isBlocked = true;
+    std::atomic<int> counter = 0;
+    jobSystem.enqueue([&]() {
+        while (isBlocked) {
+            std::this_thread::yield();
+        }
+        ++counter;
+    });
+    // Make sure that the blocking job has been picked up
+    while (jobSystem.numPendingJobs() > 0) {
+        std::this_thread::yield();
+    }
+
+    std::mutex orderMutex;
+    std::vector<Priority> order;
+    auto record = [&](Priority p) {
+        return [&, p]() {
+            {
+                std::lock_guard lock(orderMutex);
+                order.push_back(p);
+            }
+            ++counter;
+        };
+    };
+    jobSystem.enqueue(record(Priority::Background), Priority::Background);
+    jobSystem.enqueue(record(Priority::Prefetch), Priority::Prefetch);
+    jobSystem.enqueue(record(Priority::FrameCritical), Priority::FrameCritical);
+
+    isBlocked = false;
+    waitFor(counter, 4);
+
+    REQUIRE(order.size() == 3);
+    CHECK(order[0] == Priority::FrameCritical);
+    CHECK(order[1] == Priority::Prefetch);
+    CHECK(order[2] == Priority::Background);
+}
+
+TEST_CASE("JobSystem: Cancel By Key", "[jobsystem]") {
+    using Priority = openspace::JobSystem::Priority;
+    openspace::JobSystem jobSystem(1);
+
+    std::atomic<bool> isBlocked = true;
+    jobSystem.enqueue([&]() {
+        while (isBlocked) {
+            std::this_thread::yield();
+        }
+    });
+    while (jobSystem.numPendingJobs() > 0) {
+        std::this_thread::yield();
+    }
+
+    const openspace::JobSystem::Key cancelKey = jobSystem.createKey();
+    const openspace::JobSystem::Key keepKey = jobSystem.createKey();
+    REQUIRE(cancelKey != keepKey);
+
+    std::atomic<int> cancelled = 0;
+    std::atomic<int> kept = 0;
+    for (int i = 0; i < 10; ++i) {
+        jobSystem.enqueue([&]() { ++cancelled; }, Priority::Prefetch, cancelKey);
+        jobSystem.enqueue([&]() { ++kept; }, Priority::Prefetch, keepKey);
+    }
+
+    REQUIRE(jobSystem.cancel(cancelKey) == 10);
+    isBlocked = false;
+    waitFor(kept, 10);
+
+    REQUIRE(cancelled == 0);
+    REQUIRE(kept == 10);
+}
+
+TEST_CASE("JobSystem: Shared ThreadPool", "[jobsystem]") {
+    openspace::JobSystem jobSystem(2);
+
+    std::atomic<int> counter = 0;
+    {
+        openspace::ThreadPool pool(jobSystem);
+        for (int i = 0; i < 100; ++i) {
+            pool.enqueue([&counter]() { ++counter; });
+        }
+        // The destructor has to wait for or cancel all jobs of this pool
+    }
+    const int valueAfterDestruction = counter;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    REQUIRE(counter == valueAfterDestruction);
+}
+
+TEST_CASE("JobSystem: LRUThreadPool", "[jobsystem]") {
+    using namespace openspace::globebrowsing;
+    openspace::JobSystem jobSystem(2);
+
+    std::atomic<int> counter = 0;
+    {
+        LRUThreadPool<int> pool(jobSystem, 1, 100);
+        for (int i = 0; i < 50; ++i) {
+            pool.enqueue([&counter]() { ++counter; }, i);
+        }
+        waitFor(counter, 50);
+    }
+    REQUIRE(counter == 50);
+}
+
+TEST_CASE("JobSystem: LRUThreadPool Prefetch", "[jobsystem]") {
+    using namespace openspace::globebrowsing;
+    openspace::JobSystem jobSystem(1);
+
+    std::atomic<bool> isBlocked = true;
+    std::atomic<int> counter = 0;
+    std::mutex orderMutex;
+    std::vector<int> order;
+    auto record = [&](int value) {
+        return [&, value]() {
+            {
+                std::lock_guard lock(orderMutex);
+                order.push_back(value);
+            }
+            ++counter;
+        };
+    };
+
+    {
+        LRUThreadPool<int> pool(jobSystem, 1, 100);
+        // Occupy the only job of the pool until all tasks are enqueued
+        pool.enqueue([&]() {
+            while (isBlocked) {
+                std::this_thread::yield();
+            }
+            ++counter;
+        }, 0);
+        while (jobSystem.numPendingJobs() > 0) {
+            std::this_thread::yield();
+        }
+
+        pool.enqueuePrefetch(record(1), 1);
+        pool.enqueuePrefetch(record(2), 2);
+        pool.enqueuePrefetch(record(3), 3);
+        // Regular tasks are executed before all prefetch tasks
+        pool.enqueue(record(4), 4);
+        // A prefetch for a key that is already enqueued regularly is ignored
+        pool.enqueuePrefetch(record(-1), 4);
+        // Promoting a prefetch task moves it into the regular queue
+        REQUIRE(pool.promote(1));
+        REQUIRE_FALSE(pool.promote(4));
+
+        isBlocked = false;
+        waitFor(counter, 5);
+    }
+
+    REQUIRE(order.size() == 4);
+    CHECK(order[0] == 1);
+    CHECK(order[1] == 4);
+    CHECK(order[2] == 3);
+    CHECK(order[3] == 2);
+}
+
+TEST_CASE("JobSystem: Throughput Benchmark", "[.][benchmark][jobsystem]") {
+    constexpr const int NJobs = 1000000;
+    const size_t nThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    std::atomic<int> counter = 0;
+    const double legacy = measureMilliseconds([&]() {
+        LegacyThreadPool pool(nThreads);
+        for (int i = 0; i < NJobs; ++i) {
+            pool.enqueue([&counter]() { ++counter; });
+        }
+        waitFor(counter, NJobs);
+    });
+
+    counter = 0;
+    const double threadPool = measureMilliseconds([&]() {
+        openspace::ThreadPool pool(nThreads);
+        for (int i = 0; i < NJobs; ++i) {
+            pool.enqueue([&counter]() { ++counter; });
+        }
+        waitFor(counter, NJobs);
+    });
+
+    counter = 0;
+    const double jobSystem = measureMilliseconds([&]() {
+        openspace::JobSystem js(nThreads);
+        for (int i = 0; i < NJobs; ++i) {
+            js.enqueue([&counter]() { ++counter; });
+        }
+        waitFor(counter, NJobs);
+    });
+
+    // Jobs that spawn jobs stay on their worker's queue and do not touch shared state
+    counter = 0;
+    const double nested = measureMilliseconds([&]() {
+        openspace::JobSystem js(nThreads);
+        constexpr const int NProducers = 1000;
+        for (int i = 0; i < NProducers; ++i) {
+            js.enqueue([&js, &counter]() {
+                for (int j = 0; j < NJobs / NProducers; ++j) {
+                    js.enqueue([&counter]() { ++counter; });
+                }
+            });
+        }
+        waitFor(counter, NJobs);
+    });
+
+    std::cout << "Enqueue/dequeue of " << NJobs << " jobs on " << nThreads
+        << " threads\n"
+        << "  Legacy ThreadPool:      " << legacy << " ms\n"
+        << "  ThreadPool (JobSystem): " << threadPool << " ms\n"
+        << "  JobSystem:              " << jobSystem << " ms\n"
+        << "  JobSystem (nested):     " << nested << " ms\n";
+}
@@ -0,0 +1,188 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <modules/space/translation/keplertranslation.h>
+#include <modules/space/util/keplerpropagator.h>
+#include <openspace/util/updatestructures.h>
+#include <ghoul/misc/exception.h>
+#include <cmath>
+
+namespace {
+    openspace::KeplerPropagator::Elements elements(int i) {
+        openspace::KeplerPropagator::Elements e;
+        e.eccentricity = std::fmod(i * 0.0137, 0.99);
+        e.semiMajorAxis = 7000.0 + i;
+        e.inclination = std::fmod(i * 7.3, 180.0);
+        e.ascendingNode = std::fmod(i * 13.1, 360.0);
+        e.argumentOfPeriapsis = std::fmod(i * 3.7, 360.0);
+        e.meanAnomalyAtEpoch = std::fmod(i * 11.9, 360.0);
+        e.period = 5400.0 + i;
+        e.epoch = i * 100.0;
+        return e;
+    }
+} // namespace
+
+TEST_CASE("KeplerPropagator: Eccentric Anomaly", "[keplerpropagator]") {
+    std::vector<double> meanAnomalies;
+    std::vector<double> eccentricities;
+    for (double e : { 0.0, 0.1, 0.5, 0.9, 0.99, 0.999999 }) {
+        for (double m = -20.0; m <= 20.0; m += 0.25) {
+            meanAnomalies.push_back(m);
+            eccentricities.push_back(e);
+        }
+        meanAnomalies.push_back(1e-8);
+        eccentricities.push_back(e);
+    }
+
+    std::vector<double> result(meanAnomalies.size());
+    openspace::KeplerPropagator::eccentricAnomalies(
+        meanAnomalies.data(),
+        eccentricities.data(),
+        result.data(),
+        result.size()
+    );
+
+    for (size_t i = 0; i < result.size(); ++i) {
+        const double m = std::remainder(meanAnomalies[i], 2.0 * 3.14159265358979323846);
+        const double residual = result[i] - eccentricities[i] * std::sin(result[i]) - m;
+        CHECK(std::abs(residual) < 1e-12);
+    }
+}
+
+TEST_CASE("KeplerPropagator: Matches KeplerTranslation", "[keplerpropagator]") {
+    // The KeplerTranslation only uses a few fixed-point iterations for eccentricities
+    // below 0.2, so we only compare orbits with larger eccentricities
+    openspace::KeplerPropagator propagator;
+    for (int i = 15; i < 65; ++i) {
+        propagator.addOrbit(elements(i));
+    }
+
+    const double time = 123456.0;
+    const std::vector<glm::dvec3> positions = propagator.positions(time);
+    REQUIRE(positions.size() == 50);
+
+    for (int i = 0; i < 50; ++i) {
+        const openspace::KeplerPropagator::Elements e = elements(i + 15);
+        openspace::KeplerTranslation translation;
+        translation.setKeplerElements(
+            e.eccentricity,
+            e.semiMajorAxis,
+            e.inclination,
+            e.ascendingNode,
+            e.argumentOfPeriapsis,
+            e.meanAnomalyAtEpoch,
+            e.period,
+            e.epoch
+        );
+        const glm::dvec3 expected = translation.position({
+            {},
+            openspace::Time(time),
+            openspace::Time(0.0)
+        });
+        CHECK(glm::distance(positions[i], expected) < 1e-3);
+    }
+}
+
+TEST_CASE("KeplerPropagator: Batches", "[keplerpropagator]") {
+    // Enough orbits that the positions are computed by multiple jobs
+    openspace::KeplerPropagator propagator;
+    propagator.reserve(20000);
+    for (int i = 0; i < 20000; ++i) {
+        propagator.addOrbit(elements(i));
+    }
+    REQUIRE(propagator.nOrbits() == 20000);
+
+    const std::vector<glm::dvec3> positions = propagator.positions(1000.0);
+    REQUIRE(positions.size() == 20000);
+    for (size_t i : { 0, 1, 8191, 8192, 19999 }) {
+        const double time = 1000.0;
+        glm::dvec3 p;
+        propagator.positions(i, &time, 1, &p);
+        CHECK(glm::distance(positions[i], p) < 1e-6);
+    }
+
+    const std::vector<size_t> nSegments(20000, 4);
+    const std::vector<glm::dvec3> samples = propagator.sampleOrbits(nSegments);
+    REQUIRE(samples.size() == 20000 * 5);
+    for (size_t i : { 0, 12345, 19999 }) {
+        const openspace::KeplerPropagator::Elements e = elements(static_cast<int>(i));
+        const double time = e.epoch + e.period / 2.0;
+        glm::dvec3 p;
+        propagator.positions(i, &time, 1, &p);
+        CHECK(glm::distance(samples[i * 5 + 2], p) < 1e-3);
+        CHECK(glm::distance(samples[i * 5], samples[i * 5 + 4]) < 1e-3);
+    }
+}
+
+TEST_CASE("KeplerPropagator: Invalid Orbits", "[keplerpropagator]") {
+    openspace::KeplerPropagator propagator;
+    openspace::KeplerPropagator::Elements e = elements(1);
+    e.eccentricity = 1.0;
+    CHECK_THROWS_AS(propagator.addOrbit(e), ghoul::RuntimeError);
+    e.eccentricity = 0.5;
+    e.period = 0.0;
+    CHECK_THROWS_AS(propagator.addOrbit(e), ghoul::RuntimeError);
+    CHECK(propagator.nOrbits() == 0);
+}
+
+TEST_CASE("KeplerPropagator: Translation Sampler Is A Snapshot", "[keplerpropagator]") {
+    const openspace::KeplerPropagator::Elements e = elements(30);
+    openspace::KeplerTranslation translation;
+    translation.setKeplerElements(
+        e.eccentricity,
+        e.semiMajorAxis,
+        e.inclination,
+        e.ascendingNode,
+        e.argumentOfPeriapsis,
+        e.meanAnomalyAtEpoch,
+        e.period,
+        e.epoch
+    );
+
+    const std::vector<double> times = { 0.0, 1000.0, 123456.0 };
+    const std::vector<glm::dvec3> expected = translation.positions(times);
+    const openspace::Translation::PositionSampler sampler =
+        translation.positionSampler();
+
+    // Changing the elements afterwards must not affect the sampler, which might be
+    // running in a background job at that time
+    translation.setKeplerElements(
+        0.5,
+        2.0 * e.semiMajorAxis,
+        e.inclination,
+        e.ascendingNode,
+        e.argumentOfPeriapsis,
+        e.meanAnomalyAtEpoch,
+        2.0 * e.period,
+        e.epoch
+    );
+    const std::vector<glm::dvec3> positions = sampler(times);
+    REQUIRE(positions.size() == times.size());
+    for (size_t i = 0; i < times.size(); ++i) {
+        CHECK(glm::distance(positions[i], expected[i]) < 1e-6);
+    }
+    CHECK(glm::distance(translation.positions(times)[2], expected[2]) > 1.0);
+}
@@ -26,6 +26,12 @@
 
 #include <modules/globebrowsing/src/lrucache.h>
 #include <glm/glm.hpp>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <random>
+#include <thread>
+#include <unordered_map>
 
 namespace {
     struct DefaultHasher {
@@ -52,6 +58,64 @@ namespace {
             return s.x ^ (s.y << 1);
         }
     };
+
+    // The std::list + std::unordered_map based implementation that the LRUCache used
+    // before. It is only used as the baseline in the benchmark
+    template <typename KeyType, typename ValueType, typename HasherType>
+    class LegacyLRUCache {
+    public:
+        using Item = std::pair<KeyType, ValueType>;
+
+        LegacyLRUCache(size_t size) : _maximumCacheSize(size) {}
+
+        std::vector<Item> putAndFetchPopped(KeyType key, ValueType value) {
+            const auto it = _itemMap.find(key);
+            if (it != _itemMap.end()) {
+                _itemList.erase(it->second);
+                _itemMap.erase(it);
+            }
+            _itemList.emplace_front(key, std::move(value));
+            _itemMap.emplace(std::move(key), _itemList.begin());
+
+            std::vector<Item> toReturn;
+            while (_itemMap.size() > _maximumCacheSize) {
+                _itemMap.erase(_itemList.back().first);
+                toReturn.push_back(_itemList.back());
+                _itemList.pop_back();
+            }
+            return toReturn;
+        }
+
+        bool touch(const KeyType& key) {
+            const auto it = _itemMap.find(key);
+            if (it == _itemMap.end()) {
+                return false;
+            }
+            ValueType value = it->second->second;
+            _itemList.erase(it->second);
+            _itemMap.erase(it);
+            _itemList.emplace_front(key, value);
+            _itemMap.emplace(key, _itemList.begin());
+            return true;
+        }
+
+        bool isEmpty() const {
+            return _itemMap.empty();
+        }
+
+        Item popMRU() {
+            _itemMap.erase(_itemList.front().first);
+            Item item = _itemList.front();
+            _itemList.pop_front();
+            return item;
+        }
+
+    private:
+        std::list<Item> _itemList;
+        std::unordered_map<KeyType, typename std::list<Item>::const_iterator, HasherType>
+            _itemMap;
+        size_t _maximumCacheSize;
+    };
 } // namespace
 
 TEST_CASE("LRUCache: Get", "[lrucache]") {
@@ -96,3 +160,153 @@ TEST_CASE("LRUCache: StructKey", "[lrucache]") {
     REQUIRE(lru.get(key1) == val2);
     REQUIRE(lru.get(key2) == val2);
 }
+
+TEST_CASE("LRUCache: Pop Order", "[lrucache]") {
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(8);
+    for (int i = 0; i < 5; ++i) {
+        lru.put(i, i * 10);
+    }
+    // Bump the oldest item to the front
+    REQUIRE(lru.touch(0));
+    REQUIRE_FALSE(lru.touch(42));
+
+    REQUIRE(lru.popMRU() == std::pair(0, 0));
+    REQUIRE(lru.popLRU() == std::pair(1, 10));
+    REQUIRE(lru.popMRU() == std::pair(4, 40));
+    REQUIRE(lru.size() == 2);
+    REQUIRE(lru.popLRU() == std::pair(2, 20));
+    REQUIRE(lru.popLRU() == std::pair(3, 30));
+    REQUIRE(lru.isEmpty());
+}
+
+TEST_CASE("LRUCache: FetchPopped", "[lrucache]") {
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(2);
+    REQUIRE(lru.putAndFetchPopped(1, 1).empty());
+    REQUIRE(lru.putAndFetchPopped(2, 2).empty());
+    lru.touch(1);
+
+    const std::vector<std::pair<int, int>> popped = lru.putAndFetchPopped(3, 3);
+    REQUIRE(popped.size() == 1);
+    REQUIRE(popped[0] == std::pair(2, 2));
+    REQUIRE(lru.exist(1));
+    REQUIRE(lru.exist(3));
+}
+
+TEST_CASE("LRUCache: Matches Reference", "[lrucache]") {
+    // Runs a random sequence of operations against the cache and against a simple
+    // reference implementation based on std::list
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(16);
+    std::list<std::pair<int, int>> reference;
+    auto find = [&reference](int key) {
+        return std::find_if(
+            reference.begin(),
+            reference.end(),
+            [key](const std::pair<int, int>& p) { return p.first == key; }
+        );
+    };
+
+    std::mt19937 random(1337);
+    for (int i = 0; i < 20000; ++i) {
+        const int key = random() % 64;
+        switch (random() % 4) {
+            case 0: {
+                const auto it = find(key);
+                if (it != reference.end()) {
+                    reference.erase(it);
+                }
+                reference.emplace_front(key, i);
+                std::vector<std::pair<int, int>> expected;
+                while (reference.size() > 16) {
+                    expected.push_back(reference.back());
+                    reference.pop_back();
+                }
+                REQUIRE(lru.putAndFetchPopped(key, i) == expected);
+                break;
+            }
+            case 1: {
+                const auto it = find(key);
+                REQUIRE(lru.touch(key) == (it != reference.end()));
+                if (it != reference.end()) {
+                    reference.splice(reference.begin(), reference, it);
+                }
+                break;
+            }
+            case 2:
+                if (!reference.empty()) {
+                    REQUIRE(lru.popLRU() == reference.back());
+                    reference.pop_back();
+                }
+                break;
+            case 3:
+                if (!reference.empty()) {
+                    REQUIRE(lru.popMRU() == reference.front());
+                    reference.pop_front();
+                }
+                break;
+        }
+        REQUIRE(lru.size() == reference.size());
+    }
+}
+
+TEST_CASE("LRUCache: Sharded", "[lrucache]") {
+    openspace::globebrowsing::cache::ShardedLRUCache<int, int, DefaultHasher, 4> lru(64);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&lru, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                lru.put(t * 1000 + i, i);
+                lru.touch(t * 1000 + i / 2);
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    REQUIRE(lru.size() <= 64);
+    lru.put(-1, 1);
+    REQUIRE(lru.exist(-1));
+    REQUIRE(lru.get(-1) == 1);
+}
+
+TEST_CASE("LRUCache: Benchmark", "[.][benchmark][lrucache]") {
+    // Same operations as the tile cache and the LRUThreadPool: put with eviction,
+    // touch for lookups, and draining via popMRU
+    constexpr const int NOperations = 2000000;
+    constexpr const size_t CacheSize = 4096;
+
+    std::vector<MyKey> keys(NOperations);
+    std::mt19937 random(1337);
+    for (MyKey& k : keys) {
+        k = { static_cast<int>(random() % 8192), static_cast<int>(random() % 4) };
+    }
+
+    auto run = [&keys](auto& lru) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        size_t nPopped = 0;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (!lru.touch(keys[i])) {
+                nPopped += lru.putAndFetchPopped(keys[i], i).size();
+            }
+            if (i % 64 == 0 && !lru.isEmpty()) {
+                lru.popMRU();
+            }
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        return std::pair(std::chrono::duration<double, std::milli>(end - start), nPopped);
+    };
+
+    LegacyLRUCache<MyKey, size_t, DefaultHasherMyKey> legacy(CacheSize);
+    const auto [legacyTime, legacyPopped] = run(legacy);
+
+    openspace::globebrowsing::cache::LRUCache<MyKey, size_t, DefaultHasherMyKey> flat(
+        CacheSize
+    );
+    const auto [flatTime, flatPopped] = run(flat);
+
+    REQUIRE(legacyPopped == flatPopped);
+    std::cout << NOperations << " operations with a cache size of " << CacheSize << '\n'
+        << "  std::list + std::unordered_map: " << legacyTime.count() << " ms\n"
+        << "  LRUCache:                       " << flatTime.count() << " ms\n";
+}
@@ -0,0 +1,93 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <openspace/util/mpscqueue.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("MpscQueue: Basic", "[mpscqueue]") {
+    openspace::MpscQueue<std::unique_ptr<int>> queue;
+
+    std::unique_ptr<int> value;
+    CHECK_FALSE(queue.pop(value));
+
+    queue.push(std::make_unique<int>(1));
+    queue.push(std::make_unique<int>(2));
+    REQUIRE(queue.pop(value));
+    CHECK(*value == 1);
+    REQUIRE(queue.pop(value));
+    CHECK(*value == 2);
+    CHECK_FALSE(queue.pop(value));
+
+    // Values that are never popped are destroyed together with the queue
+    queue.push(std::make_unique<int>(3));
+}
+
+TEST_CASE("MpscQueue: Simulated Clients", "[mpscqueue]") {
+    // Each producer simulates a client connection that sends messages while the consumer
+    // drains the queue, similar to the main thread consuming messages every frame
+    constexpr const int NClients = 64;
+    constexpr const int NMessages = 5000;
+
+    struct Message {
+        int client = -1;
+        int sequence = -1;
+        std::string payload;
+    };
+    openspace::MpscQueue<Message> queue;
+
+    std::vector<std::thread> clients;
+    for (int c = 0; c < NClients; ++c) {
+        clients.emplace_back([&queue, c]() {
+            for (int i = 0; i < NMessages; ++i) {
+                queue.push({ c, i, "{\"topic\":" + std::to_string(i) + "}" });
+            }
+        });
+    }
+
+    std::vector<int> nextSequence(NClients, 0);
+    int nReceived = 0;
+    bool isInOrder = true;
+    Message m;
+    while (nReceived < NClients * NMessages) {
+        while (queue.pop(m)) {
+            isInOrder &= (m.sequence == nextSequence[m.client]);
+            nextSequence[m.client] = m.sequence + 1;
+            ++nReceived;
+        }
+        std::this_thread::yield();
+    }
+
+    for (std::thread& t : clients) {
+        t.join();
+    }
+
+    CHECK(isInOrder);
+    CHECK(nReceived == NClients * NMessages);
+    CHECK_FALSE(queue.pop(m));
+}
@@ -0,0 +1,155 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_GAIA_ENABLED
+
+#include "catch2/catch.hpp"
+
+#include "testutilities.h"
+
+#include <modules/gaia/rendering/octreenodearchive.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+    using openspace::OctreeNodeArchive;
+    using openspace::test::tempPath;
+
+    constexpr const int32_t ValuesPerStar = 8;
+
+    std::vector<float> values(size_t n, float first) {
+        std::vector<float> result(n);
+        for (size_t i = 0; i < n; ++i) {
+            result[i] = first + static_cast<float>(i);
+        }
+        return result;
+    }
+
+    // Writes an archive with three nodes, which are added out of order, and a node
+    // without any data
+    std::string writeArchive(const std::string& name) {
+        const std::string path = tempPath(name);
+        OctreeNodeArchive::Writer writer(path, ValuesPerStar);
+        writer.addNode(42, values(6, 0.f), values(4, 100.f), values(6, 200.f));
+        writer.addNode(7, values(3, 300.f), values(2, 400.f), values(3, 500.f));
+        writer.addNode(13, {}, {}, {});
+        writer.addNode(1000, values(3, 600.f), {}, {});
+        writer.finish();
+        return path;
+    }
+
+    // Copies the first nBytes of the file at source into a new file at destination
+    void truncate(const std::string& source, const std::string& destination,
+                  size_t nBytes)
+    {
+        std::ifstream in(source, std::ifstream::binary);
+        std::vector<char> content(
+            (std::istreambuf_iterator<char>(in)),
+            std::istreambuf_iterator<char>()
+        );
+        REQUIRE(nBytes < content.size());
+        std::ofstream out(destination, std::ofstream::binary);
+        out.write(content.data(), nBytes);
+    }
+
+    void checkNode(const OctreeNodeArchive& archive, uint64_t index,
+                   const std::vector<float>& expected)
+    {
+        const OctreeNodeArchive::NodeData node = archive.nodeData(index);
+        REQUIRE(node.nValues == expected.size());
+        REQUIRE(node.data != nullptr);
+        CHECK(std::vector<float>(node.data, node.data + node.nValues) == expected);
+    }
+} // namespace
+
+TEST_CASE("OctreeNodeArchive: Round Trip", "[octreenodearchive]") {
+    const std::string path = writeArchive("openspace_test_octreenodearchive.bin");
+
+    {
+        OctreeNodeArchive archive(path);
+        REQUIRE(archive.isOpen());
+        CHECK(archive.valuesPerStar() == ValuesPerStar);
+
+        // The values of a node are stored as positions, colors, and velocities
+        std::vector<float> node42 = values(6, 0.f);
+        const std::vector<float> col42 = values(4, 100.f);
+        const std::vector<float> vel42 = values(6, 200.f);
+        node42.insert(node42.end(), col42.begin(), col42.end());
+        node42.insert(node42.end(), vel42.begin(), vel42.end());
+        checkNode(archive, 42, node42);
+
+        std::vector<float> node7 = values(3, 300.f);
+        const std::vector<float> col7 = values(2, 400.f);
+        const std::vector<float> vel7 = values(3, 500.f);
+        node7.insert(node7.end(), col7.begin(), col7.end());
+        node7.insert(node7.end(), vel7.begin(), vel7.end());
+        checkNode(archive, 7, node7);
+
+        checkNode(archive, 1000, values(3, 600.f));
+
+        // Nodes without data and unknown nodes are not part of the archive
+        CHECK(archive.nodeData(13).nValues == 0);
+        CHECK(archive.nodeData(13).data == nullptr);
+        CHECK(archive.nodeData(8).nValues == 0);
+        CHECK(archive.nodeData(8).data == nullptr);
+
+        // Releasing a node does not change its contents
+        archive.releaseNode(42);
+        checkNode(archive, 42, node42);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("OctreeNodeArchive: Invalid Files", "[octreenodearchive]") {
+    const std::string missing = tempPath("openspace_test_octreenodearchive_missing.bin");
+    CHECK_FALSE(OctreeNodeArchive(missing).isOpen());
+
+    const std::string path = writeArchive("openspace_test_octreenodearchive.bin");
+    const size_t size = std::filesystem::file_size(path);
+
+    // Cutting off the header or the index makes the whole archive invalid, instead of
+    // reading past the end of the mapping
+    const std::string truncated = tempPath("openspace_test_octreenodearchive_cut.bin");
+    for (size_t nBytes : { size_t(0), size_t(16), size_t(40), size - 8 }) {
+        truncate(path, truncated, nBytes);
+        CHECK_FALSE(OctreeNodeArchive(truncated).isOpen());
+    }
+
+    const std::string wrongMagic = tempPath("openspace_test_octreenodearchive_magic.bin");
+    {
+        std::ofstream file(wrongMagic, std::ofstream::binary);
+        file << std::string(64, 'X');
+    }
+    CHECK_FALSE(OctreeNodeArchive(wrongMagic).isOpen());
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(truncated);
+    std::filesystem::remove(wrongMagic);
+}
+
+#endif // OPENSPACE_MODULE_GAIA_ENABLED
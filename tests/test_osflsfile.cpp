@@ -0,0 +1,427 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
+
+#include "catch2/catch.hpp"
+
+#include "testutilities.h"
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <modules/fieldlinessequence/util/osflsfile.h>
+#include <ghoul/misc/exception.h>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    using openspace::FieldlinesState;
+    using openspace::OsflsFile;
+    using openspace::test::tempPath;
+
+    // A state with a magnetic-field-like set of lines and three extra quantities that
+    // have different ranges of values
+    FieldlinesState createState(int nLines, int nPointsPerLine) {
+        FieldlinesState state;
+        state.setTriggerTime(1.5e8);
+        state.setModel(openspace::fls::Model::Batsrus);
+        state.setExtraQuantityNames({ "rho", "temperature", "j_para" });
+
+        for (int i = 0; i < nLines; ++i) {
+            std::vector<glm::vec3> line;
+            for (int j = 0; j < nPointsPerLine; ++j) {
+                const float t = static_cast<float>(j) / nPointsPerLine;
+                const float angle = static_cast<float>(i) * 0.1f;
+                line.emplace_back(
+                    6.4e6f * (1.f + 4.f * t) * std::cos(angle),
+                    6.4e6f * (1.f + 4.f * t) * std::sin(angle),
+                    3.2e6f * std::sin(t * 3.14f)
+                );
+                state.appendToExtra(0, 1.f + 50.f * t + 0.01f * i);
+                state.appendToExtra(1, 1e4f + 1e6f * t * t);
+                state.appendToExtra(2, -5e-10f * std::cos(t + i));
+            }
+            state.addLine(line);
+        }
+        return state;
+    }
+
+    template <typename T>
+    void write(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // Writes the state in the version 0 format, in which all arrays follow each other
+    void writeVersion0(const FieldlinesState& state, const std::string& path) {
+        std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+
+        std::string names;
+        for (const std::string& name : state.extraQuantityNames()) {
+            names += name + '\0';
+        }
+
+        write(file, int32_t(0));
+        write(file, state.triggerTime());
+        write(file, static_cast<int32_t>(state.model()));
+        write(file, state.isMorphable());
+        write(file, static_cast<uint64_t>(state.lineStart().size()));
+        write(file, static_cast<uint64_t>(state.vertexPositions().size()));
+        write(file, static_cast<uint64_t>(state.nExtraQuantities()));
+        write(file, static_cast<uint64_t>(names.size()));
+        file.write(
+            reinterpret_cast<const char*>(state.lineStart().data()),
+            state.lineStart().size() * sizeof(GLint)
+        );
+        file.write(
+            reinterpret_cast<const char*>(state.lineCount().data()),
+            state.lineCount().size() * sizeof(GLsizei)
+        );
+        file.write(
+            reinterpret_cast<const char*>(state.vertexPositions().data()),
+            state.vertexPositions().size() * sizeof(glm::vec3)
+        );
+        for (const std::vector<float>& quantity : state.extraQuantities()) {
+            file.write(
+                reinterpret_cast<const char*>(quantity.data()),
+                quantity.size() * sizeof(float)
+            );
+        }
+        file.write(names.data(), names.size());
+    }
+
+    void checkEqual(const FieldlinesState& a, const FieldlinesState& b) {
+        CHECK(a.triggerTime() == b.triggerTime());
+        CHECK(a.model() == b.model());
+        CHECK(a.lineStart() == b.lineStart());
+        CHECK(a.lineCount() == b.lineCount());
+        CHECK(a.vertexPositions() == b.vertexPositions());
+        CHECK(a.extraQuantityNames() == b.extraQuantityNames());
+        CHECK(a.extraQuantities() == b.extraQuantities());
+    }
+} // namespace
+
+TEST_CASE("OsflsFile: Write And Map", "[osflsfile]") {
+    const FieldlinesState state = createState(20, 50);
+    const std::string path = tempPath("openspace_test_osflsfile.osfls");
+    OsflsFile::write(state, path);
+
+    // The mapping has to be closed before the file can be removed
+    {
+        const OsflsFile file(path);
+        CHECK(file.triggerTime() == state.triggerTime());
+        CHECK(file.model() == state.model());
+        CHECK_FALSE(file.isMorphable());
+        REQUIRE(file.nLines() == 20);
+        REQUIRE(file.nPoints() == 1000);
+        REQUIRE(file.nExtraQuantities() == 3);
+
+        // The arrays can be used directly from the mapping
+        const uintptr_t address = reinterpret_cast<uintptr_t>(file.vertexPositions());
+        CHECK(address % OsflsFile::Alignment == 0);
+        CHECK(file.lineStart()[19] == state.lineStart()[19]);
+        CHECK(file.lineCount()[19] == state.lineCount()[19]);
+        CHECK(file.vertexPositions()[999] == state.vertexPositions()[999]);
+        CHECK(file.extraQuantityName(1) == "temperature");
+        REQUIRE(file.extraQuantity(2) != nullptr);
+        CHECK(file.extraQuantity(2)[999] == state.extraQuantities()[2][999]);
+    }
+
+    // The state keeps the arrays in the mapped file until they have to be copied
+    FieldlinesState loaded;
+    REQUIRE(loaded.loadStateFromOsfls(path));
+    REQUIRE(loaded.osflsFile() != nullptr);
+    CHECK(loaded.osflsFile()->nPoints() == 1000);
+    CHECK(loaded.vertexPositions().empty());
+    CHECK(loaded.nExtraQuantities() == 3);
+    CHECK(loaded.extraQuantityNames() == state.extraQuantityNames());
+    bool isSuccessful = false;
+    CHECK(loaded.extraQuantity(2, isSuccessful) == state.extraQuantities()[2]);
+    CHECK(isSuccessful);
+
+    loaded.copyArraysFromOsflsFile();
+    CHECK(loaded.osflsFile() == nullptr);
+    checkEqual(loaded, state);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("OsflsFile: Encodings", "[osflsfile]") {
+    const FieldlinesState state = createState(20, 50);
+    const std::string float32Path = tempPath("openspace_test_osflsfile_float32.osfls");
+    const std::string encodedPath = tempPath("openspace_test_osflsfile_encoded.osfls");
+    OsflsFile::write(state, float32Path);
+    OsflsFile::write(
+        state,
+        encodedPath,
+        { OsflsFile::Encoding::Float16, OsflsFile::Encoding::Quantized16 }
+    );
+
+    {
+        const OsflsFile file(encodedPath);
+        CHECK(file.extraQuantityEncoding(0) == OsflsFile::Encoding::Float16);
+        CHECK(file.extraQuantityEncoding(1) == OsflsFile::Encoding::Quantized16);
+        CHECK(file.extraQuantityEncoding(2) == OsflsFile::Encoding::Float32);
+        CHECK(file.extraQuantity(0) == nullptr);
+        CHECK(file.extraQuantity(1) == nullptr);
+
+        // Float16 keeps the relative and Quantized16 the absolute precision
+        std::vector<float> values(file.nPoints());
+        file.decodeExtraQuantity(0, values.data());
+        const std::vector<float>& rho = state.extraQuantities()[0];
+        for (size_t i = 0; i < values.size(); ++i) {
+            CHECK(values[i] == Approx(rho[i]).epsilon(1e-3));
+        }
+        file.decodeExtraQuantity(1, values.data());
+        const std::vector<float>& temperature = state.extraQuantities()[1];
+        for (size_t i = 0; i < values.size(); ++i) {
+            CHECK(values[i] == Approx(temperature[i]).margin(1e6 / 65535.0));
+        }
+    }
+
+    // Only the 16 bit quantities are decoded into the state when it is loaded
+    FieldlinesState loaded;
+    REQUIRE(loaded.loadStateFromOsfls(encodedPath));
+    REQUIRE(loaded.osflsFile() != nullptr);
+    CHECK(loaded.extraQuantities()[0].size() == 1000);
+    CHECK(loaded.extraQuantities()[1].size() == 1000);
+    CHECK(loaded.extraQuantities()[2].empty());
+
+    loaded.copyArraysFromOsflsFile();
+    CHECK(loaded.vertexPositions() == state.vertexPositions());
+    CHECK(loaded.extraQuantities()[2] == state.extraQuantities()[2]);
+
+    // Two of the three quantities need half of the space, apart from the padding
+    const uintmax_t float32Size = std::filesystem::file_size(float32Path);
+    const uintmax_t encodedSize = std::filesystem::file_size(encodedPath);
+    const size_t savedSize = 1000 * sizeof(uint16_t) - OsflsFile::Alignment;
+    CHECK(float32Size - encodedSize > 2 * savedSize);
+
+    std::filesystem::remove(float32Path);
+    std::filesystem::remove(encodedPath);
+}
+
+TEST_CASE("OsflsFile: Float16 Range", "[osflsfile]") {
+    FieldlinesState state;
+    state.setExtraQuantityNames({ "valid", "large", "small", "infinite" });
+    const std::vector<float> valid = { 0.f, -6e-5f, 1.5f, -65504.f };
+    const std::vector<float> large = { 0.f, 1.f, 1e5f, 2.f };
+    const std::vector<float> small = { 0.f, 1.f, -1e-10f, 2.f };
+    const std::vector<float> infinite = { 0.f, 1.f, INFINITY, 2.f };
+    std::vector<glm::vec3> line;
+    for (size_t i = 0; i < valid.size(); ++i) {
+        line.emplace_back(static_cast<float>(i), 0.f, 0.f);
+        state.appendToExtra(0, valid[i]);
+        state.appendToExtra(1, large[i]);
+        state.appendToExtra(2, small[i]);
+        state.appendToExtra(3, infinite[i]);
+    }
+    state.addLine(line);
+
+    const std::string path = tempPath("openspace_test_osflsfile_half.osfls");
+    OsflsFile::write(
+        state,
+        path,
+        std::vector<OsflsFile::Encoding>(4, OsflsFile::Encoding::Float16)
+    );
+
+    // Only the quantity whose values fit into a half precision float is stored as such,
+    // the other ones would be decoded as infinity or zero and are stored without loss
+    {
+        const OsflsFile file(path);
+        CHECK(file.extraQuantityEncoding(0) == OsflsFile::Encoding::Float16);
+        CHECK(file.extraQuantityEncoding(1) == OsflsFile::Encoding::Float32);
+        CHECK(file.extraQuantityEncoding(2) == OsflsFile::Encoding::Float32);
+        CHECK(file.extraQuantityEncoding(3) == OsflsFile::Encoding::Float32);
+
+        for (size_t i = 0; i < file.nExtraQuantities(); ++i) {
+            const std::vector<float>& expected = state.extraQuantities()[i];
+            std::vector<float> values(file.nPoints());
+            file.decodeExtraQuantity(i, values.data());
+            for (size_t j = 0; j < values.size(); ++j) {
+                CHECK(values[j] == Approx(expected[j]).epsilon(1e-3));
+            }
+        }
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("OsflsFile: Non-finite Quantized Values", "[osflsfile]") {
+    FieldlinesState state = createState(1, 3);
+    state.appendToExtra(0, std::nanf(""));
+    std::vector<glm::vec3> line = { glm::vec3(0.f, 0.f, 0.f) };
+    state.addLine(line);
+    state.appendToExtra(1, 0.f);
+    state.appendToExtra(2, 0.f);
+
+    const std::string path = tempPath("openspace_test_osflsfile_nan.osfls");
+    OsflsFile::write(state, path, { OsflsFile::Encoding::Quantized16 });
+
+    // The quantity can not be quantized, so it is stored without loss instead
+    {
+        const OsflsFile file(path);
+        CHECK(file.extraQuantityEncoding(0) == OsflsFile::Encoding::Float32);
+        CHECK(std::isnan(file.extraQuantity(0)[3]));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("OsflsFile: Convert Version 0", "[osflsfile]") {
+    const FieldlinesState state = createState(20, 50);
+    const std::string source = tempPath("openspace_test_osflsfile_v0.osfls");
+    const std::string destination = tempPath("openspace_test_osflsfile_v1.osfls");
+    writeVersion0(state, source);
+
+    FieldlinesState version0;
+    REQUIRE(version0.loadStateFromOsfls(source));
+    checkEqual(version0, state);
+
+    OsflsFile::convert(source, destination);
+    FieldlinesState version1;
+    REQUIRE(version1.loadStateFromOsfls(destination));
+    version1.copyArraysFromOsflsFile();
+    checkEqual(version1, state);
+
+    // Version 1 files can be converted as well
+    const std::string copy = tempPath("openspace_test_osflsfile_v1_copy.osfls");
+    OsflsFile::convert(destination, copy);
+    FieldlinesState converted;
+    REQUIRE(converted.loadStateFromOsfls(copy));
+    converted.copyArraysFromOsflsFile();
+    checkEqual(converted, state);
+    std::filesystem::remove(copy);
+
+    // The temperature and j_para are outside of the half precision range and are
+    // therefore not converted. The decoded values have to match the original ones
+    OsflsFile::convert(source, destination, OsflsFile::Encoding::Float16);
+    {
+        const OsflsFile file(destination);
+        CHECK(file.extraQuantityEncoding(0) == OsflsFile::Encoding::Float16);
+        CHECK(file.extraQuantityEncoding(1) == OsflsFile::Encoding::Float32);
+        CHECK(file.extraQuantityEncoding(2) == OsflsFile::Encoding::Float32);
+        for (size_t i = 0; i < file.nExtraQuantities(); ++i) {
+            const std::vector<float>& expected = state.extraQuantities()[i];
+            std::vector<float> values(file.nPoints());
+            file.decodeExtraQuantity(i, values.data());
+            for (size_t j = 0; j < values.size(); ++j) {
+                CHECK(values[j] == Approx(expected[j]).epsilon(1e-3));
+            }
+        }
+    }
+
+    CHECK_THROWS_AS(
+        OsflsFile::convert(tempPath("openspace_test_missing.osfls"), destination),
+        ghoul::RuntimeError
+    );
+
+    std::filesystem::remove(source);
+    std::filesystem::remove(destination);
+}
+
+TEST_CASE("OsflsFile: Malformed Files", "[osflsfile]") {
+    const FieldlinesState state = createState(4, 10);
+    const std::string path = tempPath("openspace_test_osflsfile_malformed.osfls");
+    OsflsFile::write(state, path);
+
+    std::vector<char> content(std::filesystem::file_size(path));
+    std::ifstream(path, std::ifstream::binary).read(content.data(), content.size());
+
+    // Every truncated version of the file is rejected
+    const std::string truncatedPath = tempPath("openspace_test_osflsfile_cut.osfls");
+    for (size_t size = 0; size < content.size(); size += 7) {
+        std::ofstream(truncatedPath, std::ofstream::binary | std::ofstream::trunc)
+            .write(content.data(), size);
+        CHECK_THROWS_AS(OsflsFile(truncatedPath), ghoul::RuntimeError);
+
+        FieldlinesState loaded;
+        CHECK_FALSE(loaded.loadStateFromOsfls(truncatedPath));
+    }
+
+    // So are version 0 files
+    writeVersion0(state, truncatedPath);
+    CHECK_THROWS_AS(OsflsFile(truncatedPath), ghoul::RuntimeError);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(truncatedPath);
+}
+
+TEST_CASE("OsflsFile: Benchmark", "[osflsfile][.benchmark]") {
+    // The size of a typical state of the sample sequences
+    constexpr const int NIterations = 50;
+    const FieldlinesState state = createState(1000, 400);
+
+    const std::string version0Path = tempPath("openspace_test_osflsfile_bench_v0.osfls");
+    const std::string float32Path = tempPath("openspace_test_osflsfile_bench_v1.osfls");
+    const std::string float16Path = tempPath("openspace_test_osflsfile_bench_f16.osfls");
+    writeVersion0(state, version0Path);
+    OsflsFile::convert(version0Path, float32Path);
+    OsflsFile::convert(version0Path, float16Path, OsflsFile::Encoding::Float16);
+
+    // The state is reused just as in the FieldlinesStateStreamer
+    FieldlinesState loaded;
+    auto measure = [&loaded](const std::string& path) {
+        REQUIRE(loaded.loadStateFromOsfls(path));
+        const auto begin = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < NIterations; ++i) {
+            REQUIRE(loaded.loadStateFromOsfls(path));
+        }
+        const std::chrono::duration<double, std::milli> duration =
+            std::chrono::high_resolution_clock::now() - begin;
+        return duration.count() / NIterations;
+    };
+
+    const double version0Duration = measure(version0Path);
+    const double float32Duration = measure(float32Path);
+    const double float16Duration = measure(float16Path);
+
+    // Mapping the file without copying only touches the required pages
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NIterations; ++i) {
+        const OsflsFile file(float32Path);
+        REQUIRE(file.vertexPositions() != nullptr);
+    }
+    const std::chrono::duration<double, std::milli> mapDuration =
+        std::chrono::high_resolution_clock::now() - begin;
+
+    std::cout << "Version 0: " << version0Duration << " ms ("
+        << std::filesystem::file_size(version0Path) << " bytes)\n"
+        << "Version 1, Float32: " << float32Duration << " ms ("
+        << std::filesystem::file_size(float32Path) << " bytes)\n"
+        << "Version 1, Float16: " << float16Duration << " ms ("
+        << std::filesystem::file_size(float16Path) << " bytes)\n"
+        << "Version 1, mapping only: " << mapDuration.count() / NIterations << " ms\n";
+
+    // The mapping has to be closed before the files can be removed
+    loaded = FieldlinesState();
+
+    std::filesystem::remove(version0Path);
+    std::filesystem::remove(float32Path);
+    std::filesystem::remove(float16Path);
+}
+
+#endif // OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
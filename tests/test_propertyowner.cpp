@@ -0,0 +1,168 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <openspace/engine/globals.h>
+#include <openspace/engine/virtualpropertymanager.h>
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/query/query.h>
+#include <algorithm>
+#include <memory>
+
+namespace {
+    constexpr openspace::properties::Property::PropertyInfo EnabledInfo = {
+        "Enabled", "Enabled", ""
+    };
+    constexpr openspace::properties::Property::PropertyInfo FadeInfo = {
+        "Fade", "Fade", ""
+    };
+    constexpr openspace::properties::Property::PropertyInfo VirtualInfo = {
+        "TestMatchVirtual", "Test Match Virtual", ""
+    };
+
+    struct TestOwner : public openspace::properties::PropertyOwner {
+        TestOwner(std::string identifier)
+            : PropertyOwner({ std::move(identifier) })
+            , enabled(EnabledInfo)
+            , fade(FadeInfo)
+        {
+            addProperty(enabled);
+            addProperty(fade);
+        }
+
+        openspace::properties::BoolProperty enabled;
+        openspace::properties::FloatProperty fade;
+    };
+} // namespace
+
+TEST_CASE("PropertyOwner: Property Lookup", "[propertyowner]") {
+    TestOwner root("TestRoot");
+    TestOwner child("Child");
+    TestOwner grandChild("GrandChild");
+    root.addPropertySubOwner(child);
+    child.addPropertySubOwner(grandChild);
+
+    CHECK(root.property("Enabled") == &root.enabled);
+    CHECK(root.property("Child.Fade") == &child.fade);
+    CHECK(root.property("Child.GrandChild.Enabled") == &grandChild.enabled);
+    CHECK(root.property("Child.Missing") == nullptr);
+    CHECK(root.property("Missing.Enabled") == nullptr);
+    CHECK(root.propertySubOwner("Child") == &child);
+
+    // Renaming a sub-owner has to update the index of its owner
+    grandChild.setIdentifier("Renamed");
+    CHECK(root.property("Child.GrandChild.Enabled") == nullptr);
+    CHECK(root.property("Child.Renamed.Enabled") == &grandChild.enabled);
+
+    child.removePropertySubOwner(grandChild);
+    CHECK(root.property("Child.Renamed.Enabled") == nullptr);
+}
+
+TEST_CASE("PropertyOwner: Matching Properties", "[propertyowner]") {
+    using namespace openspace;
+
+    TestOwner root("TestMatchRoot");
+    TestOwner earth("Earth");
+    TestOwner moon("Moon");
+    earth.addTag("planets");
+    root.addPropertySubOwner(earth);
+    root.addPropertySubOwner(moon);
+    global::rootPropertyOwner.addPropertySubOwner(root);
+
+    using Props = std::vector<properties::Property*>;
+    CHECK(matchingProperties("TestMatchRoot.*.Enabled") == Props{
+        &earth.enabled, &moon.enabled
+    });
+    CHECK(matchingProperties("TestMatchRoot.*Fa*") == Props{
+        &root.fade, &earth.fade, &moon.fade
+    });
+    CHECK(matchingProperties("TestMatchRoot.Moon.Fade") == Props{ &moon.fade });
+    CHECK(matchingProperties("*.Enabled", "planets") == Props{ &earth.enabled });
+    CHECK(matchingProperties("TestMatchRoot.Mars.*").empty());
+
+    // Changes to the hierarchy invalidate the cached matches
+    uint64_t version = properties::PropertyOwner::hierarchyVersion();
+    root.removePropertySubOwner(moon);
+    CHECK(properties::PropertyOwner::hierarchyVersion() != version);
+    CHECK(matchingProperties("TestMatchRoot.*.Enabled") == Props{ &earth.enabled });
+
+    // Virtual properties are found with and without wildcards
+    auto virtualProperty = std::make_unique<properties::BoolProperty>(VirtualInfo);
+    properties::Property* virtualPtr = virtualProperty.get();
+    global::virtualPropertyManager.addProperty(std::move(virtualProperty));
+    CHECK(matchingProperties("TestMatchVirtual") == Props{ virtualPtr });
+    CHECK(matchingProperties("TestMatchVirt*") == Props{ virtualPtr });
+    global::virtualPropertyManager.removeProperty(virtualPtr);
+    CHECK(matchingProperties("TestMatchVirtual").empty());
+    CHECK(matchingProperties("TestMatchVirt*").empty());
+
+    CHECK(isWildcardPattern("Scene.*.Renderable.Enabled"));
+    CHECK_FALSE(isWildcardPattern("Scene.(Earth|Moon).Renderable.Enabled"));
+
+    global::rootPropertyOwner.removePropertySubOwner(root);
+}
+
+TEST_CASE("PropertyOwner: Changed Properties", "[propertyowner]") {
+    using namespace openspace::properties;
+
+    auto isChanged = [](Property* p) {
+        std::vector<Property*> changed = Property::changedProperties();
+        return std::find(changed.begin(), changed.end(), p) != changed.end();
+    };
+
+    TestOwner root("TestChangedRoot");
+    TestOwner child("Child");
+    root.addPropertySubOwner(child);
+
+    CHECK_FALSE(isChanged(&root.enabled));
+    root.enabled = !root.enabled.value();
+    child.fade = 0.5f;
+    child.fade = 0.25f;
+    CHECK(root.enabled.hasChanged());
+    CHECK(isChanged(&root.enabled));
+    CHECK(isChanged(&child.fade));
+    CHECK_FALSE(isChanged(&child.enabled));
+
+    // Only the properties of the owner are reset
+    Property::resetChangedProperties(&child);
+    CHECK_FALSE(child.fade.hasChanged());
+    CHECK_FALSE(isChanged(&child.fade));
+    CHECK(isChanged(&root.enabled));
+
+    // Destroyed properties remove themselves from the list
+    size_t nChanged = Property::changedProperties().size();
+    {
+        TestOwner temporary("Temporary");
+        temporary.fade = 0.75f;
+        CHECK(isChanged(&temporary.fade));
+        CHECK(Property::changedProperties().size() == nChanged + 1);
+    }
+    CHECK(Property::changedProperties().size() == nChanged);
+
+    root.enabled.resetToUnchanged();
+    CHECK_FALSE(isChanged(&root.enabled));
+}
@@ -0,0 +1,110 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <openspace/interaction/sessionrecording.h>
+
+namespace {
+    using SessionRecording = openspace::interaction::SessionRecording;
+    using Type = SessionRecording::RecordedType;
+
+    // Scripts at 0, 2, and 5 seconds and camera keyframes at 1 and 3 seconds. The
+    // simulation time of each entry is 100 seconds ahead of its timestamp
+    std::vector<SessionRecording::timelineEntry> timeline() {
+        return {
+            { Type::Script, 0, 0.0, 100.0 },
+            { Type::Camera, 0, 1.0, 101.0 },
+            { Type::Script, 1, 2.0, 102.0 },
+            { Type::Camera, 1, 3.0, 103.0 },
+            { Type::Script, 2, 5.0, 105.0 }
+        };
+    }
+} // namespace
+
+TEST_CASE("SessionRecording: Seek Between Camera Keyframes", "[sessionrecording]") {
+    const SessionRecording::SeekPosition p =
+        SessionRecording::findSeekPosition(timeline(), 2.5);
+    CHECK(p.next == 3);
+    CHECK(p.camera == 1);
+    CHECK(p.hasRemainingCameraEntries);
+    CHECK(p.simulationTime == 102.0);
+}
+
+TEST_CASE("SessionRecording: Seek Exactly To An Entry", "[sessionrecording]") {
+    // An entry at the requested time has already been played back
+    const SessionRecording::SeekPosition p =
+        SessionRecording::findSeekPosition(timeline(), 3.0);
+    CHECK(p.next == 4);
+    CHECK(p.camera == 3);
+    CHECK_FALSE(p.hasRemainingCameraEntries);
+    CHECK(p.simulationTime == 103.0);
+}
+
+TEST_CASE("SessionRecording: Seek After Last Camera Keyframe", "[sessionrecording]") {
+    const SessionRecording::SeekPosition p =
+        SessionRecording::findSeekPosition(timeline(), 4.0);
+    CHECK(p.next == 4);
+    CHECK(p.camera == 3);
+    CHECK_FALSE(p.hasRemainingCameraEntries);
+    CHECK(p.simulationTime == 103.0);
+
+    const SessionRecording::SeekPosition end =
+        SessionRecording::findSeekPosition(timeline(), 5.0);
+    CHECK(end.next == 5);
+    CHECK(end.camera == 3);
+    CHECK_FALSE(end.hasRemainingCameraEntries);
+    CHECK(end.simulationTime == 105.0);
+}
+
+TEST_CASE("SessionRecording: Seek Back To The Start", "[sessionrecording]") {
+    // Seeking back in front of the last camera keyframe has to restart the camera
+    // playback, even if it had already finished
+    const SessionRecording::SeekPosition p =
+        SessionRecording::findSeekPosition(timeline(), 0.5);
+    CHECK(p.next == 1);
+    CHECK(p.camera == 1);
+    CHECK(p.hasRemainingCameraEntries);
+    CHECK(p.simulationTime == 100.0);
+
+    // Before the first entry, the simulation time of the first entry is used
+    const SessionRecording::SeekPosition start =
+        SessionRecording::findSeekPosition(timeline(), -1.0);
+    CHECK(start.next == 0);
+    CHECK(start.camera == 1);
+    CHECK(start.hasRemainingCameraEntries);
+    CHECK(start.simulationTime == 100.0);
+}
+
+TEST_CASE("SessionRecording: Seek Without Camera Keyframes", "[sessionrecording]") {
+    const std::vector<SessionRecording::timelineEntry> scripts = {
+        { Type::Script, 0, 0.0, 10.0 },
+        { Type::Script, 1, 1.0, 20.0 }
+    };
+    const SessionRecording::SeekPosition p =
+        SessionRecording::findSeekPosition(scripts, 0.5);
+    CHECK(p.next == 1);
+    CHECK_FALSE(p.hasRemainingCameraEntries);
+    CHECK(p.simulationTime == 10.0);
+}
@@ -0,0 +1,149 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include "testutilities.h"
+
+#include <openspace/util/speckfile.h>
+#include <filesystem>
+#include <fstream>
+
+using openspace::test::tempPath;
+
+namespace {
+    std::string writeSpeckFile(const std::string& name, const std::string& content) {
+        const std::string path = tempPath(name);
+        std::ofstream file(path, std::ofstream::binary);
+        file << content;
+        return path;
+    }
+} // namespace
+
+TEST_CASE("SpeckFile: Header", "[speckfile]") {
+    const std::string path = writeSpeckFile(
+        "openspace_test_speckfile_header.speck",
+        "# A comment\r\n"
+        "datavar 0 lum\r\n"
+        "datavar 1 colorb_v\r\n"
+        "texturevar 1\r\n"
+        "texture -M 3 star.sgi\r\n"
+        "polyorivar 0\r\n"
+        "maxcomment 10\r\n"
+        "1 2 3 4 5\r\n"
+    );
+    {
+        openspace::SpeckFile file(path);
+        REQUIRE(file.isOpen());
+
+        REQUIRE(file.variables().size() == 2);
+        CHECK(file.variables()[0].index == 0);
+        CHECK(file.variables()[0].name == "lum");
+        CHECK(file.variables()[1].index == 1);
+        CHECK(file.variables()[1].name == "colorb_v");
+        CHECK(file.nValuesPerObject() == 5);
+
+        CHECK(file.textureVariable() == 1);
+        CHECK(file.polygonOrientationVariable() == 0);
+        REQUIRE(file.textures().size() == 1);
+        CHECK(file.textures()[0].index == 3);
+        CHECK(file.textures()[0].file == "star.sgi");
+
+        CHECK(file.dataSection() == "1 2 3 4 5\r\n");
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("SpeckFile: Data", "[speckfile]") {
+    const std::string path = writeSpeckFile(
+        "openspace_test_speckfile_data.speck",
+        "datavar 0 lum\n"
+        "1 2 3 4\n"
+        "\n"
+        "# A comment between the data\n"
+        "  -1.5e2 .5 +7. 1E-3 # text\n"
+        "8 9\n"
+        "10 11 12 13 14 15"
+    );
+    {
+        openspace::SpeckFile file(path);
+        REQUIRE(file.isOpen());
+        REQUIRE(file.nValuesPerObject() == 4);
+
+        const std::vector<float> data = file.readData(4, false);
+        const std::vector<float> expected = {
+            1.f, 2.f, 3.f, 4.f,
+            -150.f, 0.5f, 7.f, 0.001f,
+            8.f, 9.f, 0.f, 0.f,
+            10.f, 11.f, 12.f, 13.f
+        };
+        CHECK(data == expected);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("SpeckFile: Threaded Data", "[speckfile]") {
+    std::string content = "datavar 0 value\n";
+    for (int i = 0; i < 500000; ++i) {
+        content += std::to_string(i) + " 0.25 -" + std::to_string(i) + " 1e1\n";
+    }
+    const std::string path = writeSpeckFile(
+        "openspace_test_speckfile_threaded.speck",
+        content
+    );
+    {
+        openspace::SpeckFile file(path);
+        REQUIRE(file.isOpen());
+
+        const std::vector<float> serial = file.readData(4, false);
+        const std::vector<float> threaded = file.readData(4, true);
+        REQUIRE(serial.size() == 500000 * 4);
+        CHECK(serial == threaded);
+        CHECK(threaded[4 * 1234 + 0] == 1234.f);
+        CHECK(threaded[4 * 1234 + 2] == -1234.f);
+        CHECK(threaded[4 * 1234 + 3] == 10.f);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("SpeckFile: Parse Numbers", "[speckfile]") {
+    float values[3] = { 0.f, 0.f, 0.f };
+    CHECK(openspace::speck::parseNumbers("1 2 3 4", values, 3) == 3);
+    CHECK(values[2] == 3.f);
+    CHECK(openspace::speck::parseNumbers("5 abc 6", values, 3) == 1);
+    CHECK(values[0] == 5.f);
+    CHECK(openspace::speck::parseNumbers("", values, 3) == 0);
+
+    std::string_view text = "first\r\nsecond\nthird";
+    CHECK(openspace::speck::nextLine(text) == "first");
+    CHECK(openspace::speck::nextLine(text) == "second");
+    CHECK(openspace::speck::nextLine(text) == "third");
+    CHECK(text.empty());
+}
+
+TEST_CASE("SpeckFile: Missing File", "[speckfile]") {
+    openspace::SpeckFile file("this_file_does_not_exist.speck");
+    CHECK_FALSE(file.isOpen());
+    CHECK(file.readData(4).empty());
+}
@@ -336,6 +336,70 @@ TEST_CASE("SpiceManager: Get Target Position", "[spicemanager]") {
     openspace::SpiceManager::deinitialize();
 }
 
+TEST_CASE("SpiceManager: Get Target Position Naif Object", "[spicemanager]") {
+    openspace::SpiceManager::initialize();
+
+    using openspace::SpiceManager;
+    loadMetaKernel();
+
+    const SpiceManager::NaifObject earth = SpiceManager::ref().body("EARTH");
+    REQUIRE(earth.isResolved);
+    REQUIRE(earth.id == 399);
+    const SpiceManager::NaifObject cassini = SpiceManager::ref().body("CASSINI");
+    REQUIRE(cassini.isResolved);
+    const SpiceManager::NaifObject j2000 = SpiceManager::ref().frame("J2000");
+    REQUIRE(j2000.isResolved);
+    REQUIRE_FALSE(SpiceManager::ref().body("NOT_A_BODY").isResolved);
+    REQUIRE_FALSE(SpiceManager::ref().frame("NOT_A_FRAME").isResolved);
+
+    double et = 0.0;
+    str2et_c("2004 jun 11 19:32:00", &et);
+    REQUIRE(SpiceManager::ref().hasSpkCoverage(cassini.id, et));
+
+    double lightTime = 0.0;
+    const glm::dvec3 reference = SpiceManager::ref().targetPosition(
+        "EARTH", "CASSINI", "J2000", {}, et, lightTime
+    );
+    glm::dvec3 position = glm::dvec3(0.0);
+    REQUIRE_NOTHROW(position = SpiceManager::ref().targetPosition(
+        earth, cassini, j2000, {}, et, lightTime
+    ));
+    REQUIRE(position == reference);
+
+    openspace::SpiceManager::deinitialize();
+}
+
+TEST_CASE("SpiceManager: Target Position Batch", "[spicemanager]") {
+    openspace::SpiceManager::initialize();
+
+    using openspace::SpiceManager;
+    loadMetaKernel();
+
+    double et = 0.0;
+    str2et_c("2004 jun 11 19:32:00", &et);
+
+    SpiceManager::PositionBatch batch;
+    batch.target = SpiceManager::ref().body("EARTH");
+    batch.observer = SpiceManager::ref().body("CASSINI");
+    batch.referenceFrame = SpiceManager::ref().frame("J2000");
+    for (int i = 0; i < 50; ++i) {
+        batch.times.push_back(et + i * 3600.0);
+    }
+
+    std::future<std::vector<glm::dvec3>> future = SpiceManager::ref().submit(batch);
+    const std::vector<glm::dvec3> positions = SpiceManager::ref().targetPositions(batch);
+    REQUIRE(positions.size() == batch.times.size());
+    for (size_t i = 0; i < batch.times.size(); ++i) {
+        const glm::dvec3 reference = SpiceManager::ref().targetPosition(
+            "EARTH", "CASSINI", "J2000", {}, batch.times[i]
+        );
+        REQUIRE(positions[i] == reference);
+    }
+    REQUIRE(future.get() == positions);
+
+    openspace::SpiceManager::deinitialize();
+}
+
 TEST_CASE("SpiceManager: Get Target State", "[spicemanager]") {
     openspace::SpiceManager::initialize();
 
@@ -453,6 +517,62 @@ TEST_CASE("SpiceManager: Get Position Transform Matrix", "[spicemanager]") {
     openspace::SpiceManager::deinitialize();
 }
 
+TEST_CASE("SpiceManager: Interpolated Target Position", "[spicemanager]") {
+    openspace::SpiceManager::initialize();
+
+    using openspace::SpiceManager;
+    loadMetaKernel();
+
+    double et = 0.0;
+    str2et_c("2004 jun 11 19:32:00", &et);
+
+    // 1 meter
+    constexpr const double Tolerance = 0.001;
+    for (int i = 0; i < 100; ++i) {
+        const double t = et + i * 60.0;
+        const glm::dvec3 reference = SpiceManager::ref().targetPosition(
+            "PHOEBE", "CASSINI", "J2000", {}, t
+        );
+
+        double lightTime = 0.0;
+        glm::dvec3 position = glm::dvec3(0.0);
+        REQUIRE_NOTHROW(position = SpiceManager::ref().interpolatedTargetPosition(
+            "PHOEBE", "CASSINI", "J2000", {}, t, Tolerance, lightTime
+        ));
+        REQUIRE(glm::distance(position, reference) < 10.0 * Tolerance);
+    }
+
+    openspace::SpiceManager::deinitialize();
+}
+
+TEST_CASE("SpiceManager: Interpolated Position Transform Matrix", "[spicemanager]") {
+    openspace::SpiceManager::initialize();
+
+    using openspace::SpiceManager;
+    loadMetaKernel();
+
+    double et = 0.0;
+    str2et_c("2004 jun 11 19:32:00", &et);
+
+    constexpr const double Tolerance = 1e-6;
+    for (int i = 0; i < 100; ++i) {
+        const double t = et + i * 600.0;
+        const glm::dmat3 reference = SpiceManager::ref().positionTransformMatrix(
+            "IAU_PHOEBE", "J2000", t
+        );
+
+        glm::dmat3 matrix = glm::dmat3(1.0);
+        REQUIRE_NOTHROW(matrix = SpiceManager::ref().interpolatedPositionTransformMatrix(
+            "IAU_PHOEBE", "J2000", t, Tolerance
+        ));
+        for (int j = 0; j < 3; ++j) {
+            REQUIRE(glm::distance(matrix[j], reference[j]) < 10.0 * Tolerance);
+        }
+    }
+
+    openspace::SpiceManager::deinitialize();
+}
+
 TEST_CASE("SpiceManager: Get Field Of View", "[spicemanager]") {
     openspace::SpiceManager::initialize();
 
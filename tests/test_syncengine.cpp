@@ -0,0 +1,186 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2020                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "catch2/catch.hpp"
+
+#include <openspace/engine/syncengine.h>
+#include <openspace/util/syncbuffer.h>
+#include <openspace/util/syncdata.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    // Similar to the ScriptEngine, this Syncable sends events that must be decoded in
+    // every frame, even if they are identical to the previous frame
+    struct EventSyncable : public openspace::Syncable {
+        void encode(openspace::SyncBuffer* syncBuffer) override {
+            syncBuffer->encode(events.size());
+            for (const std::string& e : events) {
+                syncBuffer->encode(e);
+            }
+            events.clear();
+        }
+
+        void decode(openspace::SyncBuffer* syncBuffer) override {
+            const size_t nEvents = syncBuffer->decode<size_t>();
+            for (size_t i = 0; i < nEvents; ++i) {
+                received.push_back(syncBuffer->decode());
+            }
+        }
+
+        std::vector<std::string> events;
+        std::vector<std::string> received;
+    };
+
+    struct Node {
+        Node() : engine(4096) {
+            engine.addSyncables({ &time, &position, &frameNumber, &events });
+        }
+
+        openspace::SyncEngine engine;
+        openspace::SyncData<double> time;
+        openspace::SyncData<double> position;
+        openspace::SyncData<int64_t> frameNumber;
+        EventSyncable events;
+    };
+
+    // Transfers one frame from the master to the client and returns the number of bytes
+    size_t synchronize(Node& master, Node& client) {
+        using IsMaster = openspace::SyncEngine::IsMaster;
+        master.engine.preSynchronization(IsMaster::Yes);
+        client.engine.preSynchronization(IsMaster::No);
+        const std::vector<std::byte> data = master.engine.encodeSyncables();
+        client.engine.decodeSyncables(data);
+        master.engine.postSynchronization(IsMaster::Yes);
+        client.engine.postSynchronization(IsMaster::No);
+        return data.size();
+    }
+} // namespace
+
+TEST_CASE("SyncBuffer: Varint", "[syncengine]") {
+    openspace::SyncBuffer buffer(16);
+    const std::vector<int64_t> values = {
+        0, 1, -1, 63, -64, 300, -300, INT64_MAX, INT64_MIN
+    };
+    for (int64_t v : values) {
+        buffer.encode(v);
+    }
+    buffer.encode(std::string("a string"));
+    buffer.encode(uint32_t(1) << 31);
+
+    // Small values only need a single byte
+    CHECK(buffer.encodedSize() < values.size() * sizeof(int64_t));
+
+    std::vector<std::byte> data(
+        buffer.encodedData(),
+        buffer.encodedData() + buffer.encodedSize()
+    );
+    buffer.reset();
+    buffer.setData(data.data(), data.size());
+    for (int64_t v : values) {
+        CHECK(buffer.decode<int64_t>() == v);
+    }
+    CHECK(buffer.decode() == "a string");
+    CHECK(buffer.decode<uint32_t>() == uint32_t(1) << 31);
+}
+
+TEST_CASE("SyncEngine: Loopback", "[syncengine]") {
+    Node master;
+    Node client;
+
+    const size_t keyframeSize = synchronize(master, client);
+    for (int i = 1; i < openspace::SyncEngine::KeyframeInterval; ++i) {
+        // The position only changes every tenth frame
+        master.time = i * 0.016;
+        if (i % 10 == 0) {
+            master.position = std::sin(i * 0.01) * 1e6;
+        }
+        master.frameNumber = i;
+        if (i % 3 == 0) {
+            master.events.events = { "openspace.setPropertyValue('A', 1)" };
+        }
+
+        const size_t frameSize = synchronize(master, client);
+        if (i % 3 != 0) {
+            CHECK(frameSize < keyframeSize);
+        }
+
+        CHECK(client.time.data() == master.time.data());
+        CHECK(client.position.data() == master.position.data());
+        CHECK(client.frameNumber.data() == master.frameNumber.data());
+    }
+
+    // Identical events in consecutive frames must arrive every time
+    CHECK(client.events.received.size() == openspace::SyncEngine::KeyframeInterval / 3);
+
+    // This frame is the next keyframe
+    synchronize(master, client);
+
+    // Only the changed syncables are sent between keyframes
+    master.time = 1.0;
+    const size_t unchangedSize = synchronize(master, client);
+    master.time = 1.0;
+    CHECK(synchronize(master, client) < unchangedSize);
+    CHECK(client.time.data() == 1.0);
+}
+
+TEST_CASE("SyncEngine: Mismatched Syncables", "[syncengine]") {
+    Node master;
+    Node client;
+    openspace::SyncData<double> extra;
+    master.engine.addSyncable(&extra);
+
+    // The client ignores the data as it has a different number of syncables
+    master.time = 5.0;
+    synchronize(master, client);
+    CHECK(client.time.data() != 5.0);
+
+    master.engine.removeSyncable(&extra);
+    synchronize(master, client);
+    CHECK(client.time.data() == 5.0);
+}
+
+TEST_CASE("SyncEngine: Benchmark", "[syncengine][.benchmark]") {
+    Node master;
+    Node client;
+
+    constexpr const int NFrames = 100000;
+    size_t nBytes = 0;
+    std::chrono::nanoseconds duration(0);
+    for (int i = 0; i < NFrames; ++i) {
+        master.time = i * 0.016;
+        master.position = std::sin(i * 0.001) * 1e6;
+        master.frameNumber = i;
+
+        const auto begin = std::chrono::high_resolution_clock::now();
+        nBytes += synchronize(master, client);
+        duration += std::chrono::high_resolution_clock::now() - begin;
+    }
+
+    std::cout << "Bytes per frame: " << static_cast<double>(nBytes) / NFrames << '\n'
+        << "Encode and decode time per frame: " << duration.count() / NFrames << " ns\n";
+}